@@ -0,0 +1,1073 @@
+#include "algorithms.h"
+#include "checkpoint.h"
+#include "process_group.h"
+
+#include <list>
+#include <vector>
+#include <set>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <limits>
+#include <unordered_map>
+#include <cstdint>
+#include <bit>
+#include <cmath>
+
+// Weight of each nice value (-20 to 19), same table as the Linux kernel. Nice 0 maps to 1024 and every step is about 10% of CPU share.
+static constexpr unsigned long long nice_to_weight[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548,  7620,  6100,  4904,  3906,
+    3121,  2501,  1991,  1586,  1277,
+    1024,  820,   655,   526,   423,
+    335,   272,   215,   172,   137,
+    110,   87,    70,    56,    45,
+    36,    29,    23,    18,    15
+};
+
+static constexpr unsigned long long nice_0_weight = 1024;
+
+/// <summary>
+/// CFS_Policy constructor.
+/// </summary>
+OS_SS_Algorithms::CFS_Policy::CFS_Policy(unsigned target_latency, unsigned min_granularity, unsigned wakeup_granularity)
+    : target_latency(target_latency), min_granularity((min_granularity > 0) ? min_granularity : 1), wakeup_granularity(wakeup_granularity),
+    first_process(nullptr), vruntime(), weight(), ready_processes(), tree(), ready_weight(0), min_vruntime(0) {}
+
+void OS_SS_Algorithms::CFS_Policy::setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) {
+    this->first_process = processes.data();
+    this->vruntime.assign(processes.size(), 0);
+    this->weight.resize(processes.size());
+    this->ready_processes.assign(processes.size(), OS_Scheduler_Simulator::Engine::Running_Process(nullptr));
+    this->tree.clear();
+    this->ready_weight = 0;
+    this->min_vruntime = 0;
+
+    for (size_t i{ 0 }; i < processes.size(); i++)
+        this->weight.at(i) = nice_to_weight[processes.at(i).get_nice() + 20];
+}
+
+void OS_SS_Algorithms::CFS_Policy::enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned /*time*/, bool preempted) {
+    const size_t i = this->index_of(process);
+
+    // Processes returning from I/O are placed near the current minimum, with a bonus of half the latency, so sleeping does not bank CPU time.
+    if (!preempted) {
+        const unsigned long long sleeper_bonus = static_cast<unsigned long long>(this->target_latency) * nice_0_weight / 2;
+        const unsigned long long placement = (this->min_vruntime > sleeper_bonus) ? this->min_vruntime - sleeper_bonus : 0;
+        this->vruntime.at(i) = std::max(this->vruntime.at(i), placement);
+    }
+
+    this->ready_processes.at(i) = process;
+    this->tree.insert(std::pair(this->vruntime.at(i), i));
+    this->ready_weight += this->weight.at(i);
+}
+
+OS_Scheduler_Simulator::Engine::Running_Process OS_SS_Algorithms::CFS_Policy::dispatch(unsigned /*time*/) {
+    const size_t i = this->tree.begin()->second;
+
+    this->tree.erase(this->tree.begin());
+    this->ready_weight -= this->weight.at(i);
+    this->update_min_vruntime(i);
+
+    return this->ready_processes.at(i);
+}
+
+std::list<OS_Scheduler_Simulator::Engine::Running_Process> OS_SS_Algorithms::CFS_Policy::get_ready_list() const {
+    std::list<OS_Scheduler_Simulator::Engine::Running_Process> ready_list;
+
+    for (const auto& [key, i] : this->tree)
+        ready_list.push_back(this->ready_processes.at(i));
+
+    return ready_list;
+}
+
+/// <summary>
+/// The slice is the share of the scheduling period proportional to the weight of the process. The period is the target latency, stretched
+/// so no process gets less than the minimum granularity when many are ready.
+/// </summary>
+unsigned OS_SS_Algorithms::CFS_Policy::get_time_slice(const OS_Scheduler_Simulator::Engine::Running_Process& running) const {
+    const unsigned long long running_weight = this->weight.at(this->index_of(running));
+    const unsigned long long nr_running = this->tree.size() + 1;
+
+    unsigned long long period = this->target_latency;
+    if (nr_running * this->min_granularity > period) period = nr_running * this->min_granularity;
+
+    const unsigned long long slice = period * running_weight / (this->ready_weight + running_weight);
+    return static_cast<unsigned>(std::max<unsigned long long>(slice, this->min_granularity));
+}
+
+void OS_SS_Algorithms::CFS_Policy::on_cpu_time(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) {
+    const size_t i = this->index_of(running);
+
+    this->vruntime.at(i) += static_cast<unsigned long long>(time) * nice_0_weight * nice_0_weight / this->weight.at(i);
+    this->update_min_vruntime(i);
+}
+
+bool OS_SS_Algorithms::CFS_Policy::should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned /*time_in_slice*/) const {
+    if (this->tree.empty()) return false;
+
+    const unsigned long long current = this->vruntime.at(this->index_of(running));
+    const unsigned long long leftmost = this->tree.begin()->first;
+
+    return current > leftmost && current - leftmost > static_cast<unsigned long long>(this->wakeup_granularity) * nice_0_weight;
+}
+
+/// <summary>
+/// The tree is keyed on the virtual runtime a process had when it was enqueued, which does not change while it waits, so saving the virtual
+/// runtimes and the ready processes in tree order is enough to rebuild it.
+/// </summary>
+void OS_SS_Algorithms::CFS_Policy::save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const {
+    for (unsigned long long value : this->vruntime) checkpoint.put(value);
+    checkpoint.put(this->min_vruntime);
+    checkpoint.put_processes(this->get_ready_list());
+}
+
+void OS_SS_Algorithms::CFS_Policy::load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+    for (unsigned long long& value : this->vruntime) value = checkpoint.get();
+    this->min_vruntime = checkpoint.get();
+
+    for (const OS_Scheduler_Simulator::Engine::Running_Process& process : checkpoint.get_processes()) {
+        const size_t i = this->index_of(process);
+
+        this->ready_processes.at(i) = process;
+        this->tree.insert(std::pair(this->vruntime.at(i), i));
+        this->ready_weight += this->weight.at(i);
+    }
+}
+
+/// <summary>
+/// min_vruntime only moves forward; it follows the smallest virtual runtime among the running process and the ready tree.
+/// </summary>
+void OS_SS_Algorithms::CFS_Policy::update_min_vruntime(size_t running_index) {
+    unsigned long long smallest = this->vruntime.at(running_index);
+    if (!this->tree.empty()) smallest = std::min(smallest, this->tree.begin()->first);
+
+    this->min_vruntime = std::max(this->min_vruntime, smallest);
+}
+
+OS_Scheduler_Simulator::Engine::Running_Process OS_SS_Algorithms::FCFS_Policy::dispatch(unsigned /*time*/) {
+    OS_Scheduler_Simulator::Engine::Running_Process next = this->queue.front();
+    this->queue.pop_front();
+    return next;
+}
+
+void OS_SS_Algorithms::FCFS_Policy::save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const {
+    checkpoint.put_processes(this->queue);
+}
+
+void OS_SS_Algorithms::FCFS_Policy::load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+    this->queue = checkpoint.get_processes();
+}
+
+/// <summary>
+/// Empty the queues and size the links for a new run.
+/// </summary>
+/// <param name="processes">- All processes of the simulation; queued processes must point into this vector.</param>
+/// <param name="levels">- Number of queues, from 1 to max_levels.</param>
+void OS_SS_Algorithms::Level_Queues::reset(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, unsigned levels) {
+    this->first_process = processes.data();
+    this->processes.assign(processes.size(), OS_Scheduler_Simulator::Engine::Running_Process(nullptr));
+    this->next.assign(processes.size(), no_process);
+    this->head.assign(std::clamp(levels, 1u, max_levels), no_process);
+    this->tail.assign(this->head.size(), no_process);
+    this->occupied = 0;
+    this->count = 0;
+}
+
+void OS_SS_Algorithms::Level_Queues::push_back(unsigned level, const OS_Scheduler_Simulator::Engine::Running_Process& process) {
+    const size_t i = this->index_of(process);
+
+    if (this->tail.at(level) == no_process) this->head.at(level) = i;
+    else this->next.at(this->tail.at(level)) = i;
+
+    this->processes.at(i) = process;
+    this->next.at(i) = no_process;
+    this->tail.at(level) = i;
+    this->occupied |= std::uint64_t{ 1 } << level;
+    this->count++;
+}
+
+/// <summary>
+/// Remove the first process of a level. The level must have processes.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Running_Process OS_SS_Algorithms::Level_Queues::pop_front(unsigned level) {
+    const size_t i = this->head.at(level);
+    this->head.at(level) = this->next.at(i);
+
+    if (this->head.at(level) == no_process) {
+        this->tail.at(level) = no_process;
+        this->occupied &= ~(std::uint64_t{ 1 } << level);
+    }
+
+    this->count--;
+    return this->processes.at(i);
+}
+
+/// <summary>
+/// Get the queued processes level after level, in the order they would run.
+/// </summary>
+std::list<OS_Scheduler_Simulator::Engine::Running_Process> OS_SS_Algorithms::Level_Queues::get_list() const {
+    std::list<OS_Scheduler_Simulator::Engine::Running_Process> list;
+    for (std::uint64_t rest{ this->occupied }; rest != 0; rest &= rest - 1) this->append(static_cast<unsigned>(std::countr_zero(rest)), list);
+    return list;
+}
+
+std::list<OS_Scheduler_Simulator::Engine::Running_Process> OS_SS_Algorithms::Level_Queues::get_list(unsigned level) const {
+    std::list<OS_Scheduler_Simulator::Engine::Running_Process> list;
+    this->append(level, list);
+    return list;
+}
+
+/// <summary>
+/// Get the queue of every level with processes, for a Data_Point.
+/// </summary>
+std::vector<OS_Scheduler_Simulator::Engine::Data_Point::ready_level> OS_SS_Algorithms::Level_Queues::get_ready_levels() const {
+    std::vector<OS_Scheduler_Simulator::Engine::Data_Point::ready_level> levels;
+
+    for (std::uint64_t rest{ this->occupied }; rest != 0; rest &= rest - 1) {
+        levels.push_back(OS_Scheduler_Simulator::Engine::Data_Point::ready_level{ .level = static_cast<unsigned>(std::countr_zero(rest)), .processes = {} });
+        this->append(levels.back().level, levels.back().processes);
+    }
+
+    return levels;
+}
+
+void OS_SS_Algorithms::Level_Queues::append(unsigned level, std::list<OS_Scheduler_Simulator::Engine::Running_Process>& list) const {
+    for (size_t i{ this->head.at(level) }; i != no_process; i = this->next.at(i)) list.push_back(this->processes.at(i));
+}
+
+/// <summary>
+/// Round_Robin_Policy constructor.
+/// </summary>
+OS_SS_Algorithms::Round_Robin_Policy::Round_Robin_Policy(unsigned quantum, unsigned levels)
+    : quantum(quantum), levels(std::clamp(levels, 1u, Level_Queues::max_levels)), queues() {}
+
+void OS_SS_Algorithms::Round_Robin_Policy::setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) {
+    this->queues.reset(processes, this->levels);
+}
+
+void OS_SS_Algorithms::Round_Robin_Policy::enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned /*time*/, bool preempted) {
+    if (this->levels == 1) {
+        this->queues.push_back(0, process);
+        return;
+    }
+
+    const unsigned level = std::min(this->get_level(process, preempted), this->levels - 1);
+    OS_Scheduler_Simulator::Engine::Running_Process queued = process;
+
+    queued.set_level(level + 1);
+    this->queues.push_back(level, queued);
+}
+
+OS_Scheduler_Simulator::Engine::Running_Process OS_SS_Algorithms::Round_Robin_Policy::dispatch(unsigned /*time*/) {
+    return this->queues.pop_front(this->queues.first_level());
+}
+
+/// <summary>
+/// Processes carry their level when there are several, so the ready list in run order is enough to rebuild the queues.
+/// </summary>
+void OS_SS_Algorithms::Round_Robin_Policy::save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const {
+    checkpoint.put_processes(this->queues.get_list());
+}
+
+void OS_SS_Algorithms::Round_Robin_Policy::load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+    for (const OS_Scheduler_Simulator::Engine::Running_Process& process : checkpoint.get_processes()) {
+        const unsigned level = (this->levels > 1 && process.get_level() > 0) ? std::min(process.get_level() - 1, this->levels - 1) : 0;
+        this->queues.push_back(level, process);
+    }
+}
+
+/// <summary>
+/// Priority_Policy constructor.
+/// </summary>
+OS_SS_Algorithms::Priority_Policy::Priority_Policy(unsigned quantum, unsigned aging)
+    : Round_Robin_Policy(quantum, 40), aging(aging), since() {}
+
+void OS_SS_Algorithms::Priority_Policy::setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) {
+    Round_Robin_Policy::setup(processes);
+    this->since.assign(processes.size(), 0);
+}
+
+void OS_SS_Algorithms::Priority_Policy::enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned time, bool preempted) {
+    Round_Robin_Policy::enqueue(process, time, preempted);
+    this->since.at(this->queues.index_of(process)) = time;
+}
+
+/// <summary>
+/// Move up the processes that waited an aging interval in their level. Every level is in the order its processes joined it, so only the
+/// front of each level needs to be checked.
+/// </summary>
+void OS_SS_Algorithms::Priority_Policy::on_time(unsigned time) {
+    if (this->aging == 0) return;
+
+    for (std::uint64_t rest{ this->queues.get_occupied() & ~std::uint64_t{ 1 } }; rest != 0; rest &= rest - 1) {
+        const unsigned level = static_cast<unsigned>(std::countr_zero(rest));
+
+        while (!this->queues.empty(level) && this->since.at(this->queues.front(level)) + this->aging <= time) {
+            this->since.at(this->queues.front(level)) = time;
+
+            OS_Scheduler_Simulator::Engine::Running_Process process = this->queues.pop_front(level);
+            process.set_level(level);
+            this->queues.push_back(level - 1, process);
+        }
+    }
+}
+
+unsigned OS_SS_Algorithms::Priority_Policy::get_timer(const OS_Scheduler_Simulator::Engine::Running_Process& /*running*/, unsigned time) const {
+    if (this->aging == 0) return 0;
+
+    unsigned long long earliest = std::numeric_limits<unsigned long long>::max();
+
+    for (std::uint64_t rest{ this->queues.get_occupied() & ~std::uint64_t{ 1 } }; rest != 0; rest &= rest - 1)
+        earliest = std::min(earliest, this->since.at(this->queues.front(static_cast<unsigned>(std::countr_zero(rest)))) + this->aging);
+
+    return (earliest == std::numeric_limits<unsigned long long>::max()) ? 0 : static_cast<unsigned>(earliest - std::min<unsigned long long>(earliest, time));
+}
+
+bool OS_SS_Algorithms::Priority_Policy::should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned /*time_in_slice*/) const {
+    return this->has_ready() && this->queues.first_level() + 1 < running.get_level();
+}
+
+void OS_SS_Algorithms::Priority_Policy::save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const {
+    Round_Robin_Policy::save_state(checkpoint);
+    for (unsigned long long value : this->since) checkpoint.put(value);
+}
+
+void OS_SS_Algorithms::Priority_Policy::load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+    Round_Robin_Policy::load_state(checkpoint);
+    for (unsigned long long& value : this->since) value = checkpoint.get();
+}
+
+void OS_SS_Algorithms::Shortest_First_Policy::setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) {
+    this->first_process = processes.data();
+    this->heap = decltype(this->heap)();
+    this->arrival_order.clear();
+    this->sequence = 0;
+}
+
+void OS_SS_Algorithms::Shortest_First_Policy::enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned /*time*/, bool /*preempted*/) {
+    this->arrival_order.push_back(process);
+    this->heap.push(entry{
+        .key = this->get_key(process),
+        .sequence = this->sequence++,
+        .position = std::prev(this->arrival_order.end())
+    });
+}
+
+OS_Scheduler_Simulator::Engine::Running_Process OS_SS_Algorithms::Shortest_First_Policy::dispatch(unsigned /*time*/) {
+    const entry top = this->heap.top();
+    const OS_Scheduler_Simulator::Engine::Running_Process process = *top.position;
+
+    this->heap.pop();
+    this->arrival_order.erase(top.position);
+
+    return process;
+}
+
+/// <summary>
+/// Save the ready processes in arrival order, each with the key and sequence number it was pushed on the heap with. Keys can depend on state
+/// that changed since (the predictions of ASJF), so they are not computed again.
+/// </summary>
+void OS_SS_Algorithms::Shortest_First_Policy::save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const {
+    std::unordered_map<const OS_Scheduler_Simulator::Engine::Running_Process*, entry> entries;
+
+    for (auto heap = this->heap; !heap.empty(); heap.pop())
+        entries.emplace(&*heap.top().position, heap.top());
+
+    checkpoint.put(this->sequence);
+    checkpoint.put(this->arrival_order.size());
+
+    for (const OS_Scheduler_Simulator::Engine::Running_Process& process : this->arrival_order) {
+        checkpoint.put_process(process);
+        checkpoint.put(entries.at(&process).key);
+        checkpoint.put(entries.at(&process).sequence);
+    }
+}
+
+void OS_SS_Algorithms::Shortest_First_Policy::load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+    this->sequence = checkpoint.get();
+
+    for (unsigned long long count = checkpoint.get(); count > 0 && checkpoint.is_valid(); count--) {
+        this->arrival_order.push_back(checkpoint.get_process());
+
+        const unsigned long long key = checkpoint.get();
+        const unsigned long long sequence = checkpoint.get();
+
+        this->heap.push(entry{ .key = key, .sequence = sequence, .position = std::prev(this->arrival_order.end()) });
+    }
+}
+
+bool OS_SS_Algorithms::SRTF_Policy::should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned /*time_in_slice*/) const {
+    return this->has_ready() && this->get_top_key() < running.time_to_end_current_burst();
+}
+
+OS_SS_Algorithms::ASJF_Policy::ASJF_Policy(double alpha, double initial_prediction)
+    : alpha((alpha < 0) ? 0 : (alpha > 1) ? 1 : alpha), initial_prediction(initial_prediction), prediction(), current_burst() {}
+
+void OS_SS_Algorithms::ASJF_Policy::setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) {
+    Shortest_First_Policy::setup(processes);
+    this->prediction.assign(processes.size(), this->initial_prediction);
+    this->current_burst.assign(processes.size(), 0);
+}
+
+void OS_SS_Algorithms::ASJF_Policy::on_cpu_time(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) {
+    const size_t i = running.get_process_data() - this->first_process;
+    this->current_burst.at(i) += time;
+
+    // The burst is over when the process leaves the CPU on its own.
+    if (running.get_status() != OS_Scheduler_Simulator::Engine::Running_Process::status_type::running) {
+        this->prediction.at(i) = this->alpha * this->current_burst.at(i) + (1 - this->alpha) * this->prediction.at(i);
+        this->current_burst.at(i) = 0;
+    }
+}
+
+void OS_SS_Algorithms::ASJF_Policy::save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const {
+    Shortest_First_Policy::save_state(checkpoint);
+
+    for (size_t i{ 0 }; i < this->prediction.size(); i++) {
+        checkpoint.put_double(this->prediction.at(i));
+        checkpoint.put(this->current_burst.at(i));
+    }
+}
+
+void OS_SS_Algorithms::ASJF_Policy::load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+    Shortest_First_Policy::load_state(checkpoint);
+
+    for (size_t i{ 0 }; i < this->prediction.size(); i++) {
+        this->prediction.at(i) = checkpoint.get_double();
+        this->current_burst.at(i) = static_cast<unsigned>(checkpoint.get());
+    }
+}
+
+unsigned long long OS_SS_Algorithms::ASJF_Policy::get_key(const OS_Scheduler_Simulator::Engine::Running_Process& process) const {
+    // Fixed point keeps fractional predictions ordered.
+    return static_cast<unsigned long long>(this->prediction.at(process.get_process_data() - this->first_process) * 1024);
+}
+
+void OS_SS_Algorithms::EDF_Policy::setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) {
+    Shortest_First_Policy::setup(processes);
+    this->deadline.assign(processes.size(), std::numeric_limits<unsigned long long>::max());
+}
+
+void OS_SS_Algorithms::EDF_Policy::enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned time, bool preempted) {
+    // A preempted burst keeps the deadline it got when it became ready.
+    if (!preempted) {
+        const unsigned relative = process.get_process_data()->get_deadline(process.get_operation_index());
+        this->deadline.at(process.get_process_data() - this->first_process) = (relative > 0) ? static_cast<unsigned long long>(time) + relative : std::numeric_limits<unsigned long long>::max();
+    }
+
+    Shortest_First_Policy::enqueue(process, time, preempted);
+}
+
+void OS_SS_Algorithms::EDF_Policy::save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const {
+    Shortest_First_Policy::save_state(checkpoint);
+    for (unsigned long long value : this->deadline) checkpoint.put(value);
+}
+
+void OS_SS_Algorithms::EDF_Policy::load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+    Shortest_First_Policy::load_state(checkpoint);
+    for (unsigned long long& value : this->deadline) value = checkpoint.get();
+}
+
+bool OS_SS_Algorithms::EDF_Policy::should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned /*time_in_slice*/) const {
+    return this->has_ready() && this->get_top_key() < this->get_key(running);
+}
+
+unsigned long long OS_SS_Algorithms::RM_Policy::get_key(const OS_Scheduler_Simulator::Engine::Running_Process& process) const {
+    const OS_Scheduler_Simulator::Engine::Process_Data* data = process.get_process_data();
+    const unsigned long long no_deadline = std::numeric_limits<unsigned>::max();
+
+    // Processes with a period come first, then the others by relative deadline, then the ones without any.
+    if (data->get_period() > 0) return data->get_period();
+
+    const unsigned relative = data->get_deadline(process.get_operation_index());
+    return (relative > 0) ? no_deadline + relative : 2 * no_deadline + 1;
+}
+
+bool OS_SS_Algorithms::RM_Policy::should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned /*time_in_slice*/) const {
+    return this->has_ready() && this->get_top_key() < this->get_key(running);
+}
+
+/// <summary>
+/// Group_Policy constructor.
+/// </summary>
+OS_SS_Algorithms::Group_Policy::Group_Policy(unsigned target_latency, unsigned min_granularity, unsigned wakeup_granularity)
+    : target_latency(target_latency), min_granularity((min_granularity > 0) ? min_granularity : 1), wakeup_granularity(wakeup_granularity),
+    first_process(nullptr), nodes(), node_index(), process_node(), vruntime(), weight(), ready_processes(), ready_count(0), throttled(), now(0), used_in_slice(0) {}
+
+void OS_SS_Algorithms::Group_Policy::setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) {
+    this->first_process = processes.data();
+    this->nodes.clear();
+    this->node_index.clear();
+    this->process_node.clear();
+    this->vruntime.assign(processes.size(), 0);
+    this->weight.resize(processes.size());
+    this->ready_processes.assign(processes.size(), OS_Scheduler_Simulator::Engine::Running_Process(nullptr));
+    this->ready_count = 0;
+    this->throttled.clear();
+    this->now = 0;
+    this->used_in_slice = 0;
+
+    this->nodes.push_back(node{ .parent = 0, .weight = nice_0_weight, .quota = 0, .period = 0, .queue = {}, .queue_weight = 0, .min_vruntime = 0,
+        .vruntime = 0, .queued = false, .period_index = 0, .used = 0, .throttled = false });
+
+    // Nodes are created parents first, so a parent always has a lower index than its children.
+    for (size_t i{ 0 }; i < processes.size(); i++) {
+        this->weight.at(i) = nice_to_weight[processes.at(i).get_nice() + 20];
+        this->process_node.push_back(this->find_node(processes.at(i).get_group().get()));
+    }
+}
+
+void OS_SS_Algorithms::Group_Policy::enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned /*time*/, bool preempted) {
+    const size_t i = this->index_of(process);
+    const size_t group = this->process_node.at(i);
+
+    this->ready_processes.at(i) = process;
+    this->insert(group, i, !preempted);
+    this->ready_count++;
+
+    // The process joins its group's run queue even if the group is throttled; the group only rejoins its parent's when it may run.
+    this->activate(group);
+}
+
+/// <summary>
+/// Walk down from the root taking the entity with the smallest virtual runtime at every level. Only groups with ready processes that are
+/// not throttled are in the run queues, so the walk always ends on a process.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Running_Process OS_SS_Algorithms::Group_Policy::dispatch(unsigned /*time*/) {
+    size_t group{ 0 };
+    size_t entity = this->nodes.front().queue.begin()->second;
+
+    while (this->is_group(entity)) {
+        group = entity - this->process_node.size();
+        entity = this->nodes.at(group).queue.begin()->second;
+    }
+
+    this->erase(group, entity);
+    this->ready_count--;
+    this->used_in_slice = 0;
+
+    this->update_min_vruntime(group, this->vruntime.at(entity));
+    for (size_t child{ group }; child != 0; child = this->nodes.at(child).parent)
+        this->update_min_vruntime(this->nodes.at(child).parent, this->nodes.at(child).vruntime);
+
+    this->deactivate(group);
+    return this->ready_processes.at(entity);
+}
+
+/// <summary>
+/// The processes that may run come first, in the order they would be dispatched if none ran in between; the ones held back by a throttled
+/// group come after them, group by group.
+/// </summary>
+std::list<OS_Scheduler_Simulator::Engine::Running_Process> OS_SS_Algorithms::Group_Policy::get_ready_list() const {
+    std::list<OS_Scheduler_Simulator::Engine::Running_Process> ready_list;
+    if (this->ready_count == 0) return ready_list;
+
+    std::vector<bool> reachable(this->nodes.size(), false);
+    reachable.front() = true;
+
+    for (size_t group{ 1 }; group < this->nodes.size(); group++)
+        reachable.at(group) = this->nodes.at(group).queued && reachable.at(this->nodes.at(group).parent);
+
+    std::function<void(size_t)> add_queue = [this, &ready_list, &add_queue](size_t group) {
+        for (const auto& [key, entity] : this->nodes.at(group).queue) {
+            if (this->is_group(entity)) add_queue(entity - this->process_node.size());
+            else ready_list.push_back(this->ready_processes.at(entity));
+        }
+    };
+
+    add_queue(0);
+
+    for (size_t group{ 1 }; group < this->nodes.size(); group++)
+        if (!reachable.at(group))
+            for (const auto& [key, entity] : this->nodes.at(group).queue)
+                if (!this->is_group(entity)) ready_list.push_back(this->ready_processes.at(entity));
+
+    return ready_list;
+}
+
+/// <summary>
+/// The slice is the CFS slice scaled by the share of the process at every level of the hierarchy, cut to the quota left to its groups.
+/// </summary>
+unsigned OS_SS_Algorithms::Group_Policy::get_time_slice(const OS_Scheduler_Simulator::Engine::Running_Process& running) const {
+    const size_t i = this->index_of(running);
+    const size_t group = this->process_node.at(i);
+
+    unsigned long long period = this->target_latency;
+    if ((this->ready_count + 1) * this->min_granularity > period) period = (this->ready_count + 1) * this->min_granularity;
+
+    // The running process is out of its run queue; its groups are out of theirs unless they have other ready processes.
+    double share = static_cast<double>(this->weight.at(i)) / static_cast<double>(this->nodes.at(group).queue_weight + this->weight.at(i));
+
+    for (size_t child{ group }; child != 0; child = this->nodes.at(child).parent) {
+        const node& current = this->nodes.at(child);
+        const unsigned long long siblings = this->nodes.at(current.parent).queue_weight + ((current.queued) ? 0 : current.weight);
+        share *= static_cast<double>(current.weight) / static_cast<double>(siblings);
+    }
+
+    unsigned long long slice = std::max<unsigned long long>(static_cast<unsigned long long>(static_cast<double>(period) * share), this->min_granularity);
+
+    const unsigned quota_left = this->get_quota_left(group, this->now);
+    if (quota_left < std::numeric_limits<unsigned>::max())
+        slice = std::min<unsigned long long>(slice, static_cast<unsigned long long>(this->used_in_slice) + quota_left);
+
+    // 0 would mean no slice at all.
+    return static_cast<unsigned>(std::max<unsigned long long>(slice, 1));
+}
+
+/// <summary>
+/// Charge the CPU time to the process and to every group above it. The step started at the last time seen by on_time, and it never spans
+/// the period boundary of a group with a quota (see get_timer), so the time goes to the period it started in.
+/// </summary>
+void OS_SS_Algorithms::Group_Policy::on_cpu_time(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) {
+    const size_t i = this->index_of(running);
+
+    this->vruntime.at(i) += static_cast<unsigned long long>(time) * nice_0_weight * nice_0_weight / this->weight.at(i);
+    this->used_in_slice += time;
+    this->update_min_vruntime(this->process_node.at(i), this->vruntime.at(i));
+
+    for (size_t group{ this->process_node.at(i) }; group != 0; group = this->nodes.at(group).parent) {
+        node& current = this->nodes.at(group);
+
+        // Queued groups are keyed on their virtual runtime.
+        const bool queued = current.queued;
+        if (queued) this->erase(current.parent, this->group_entity(group));
+
+        current.vruntime += static_cast<unsigned long long>(time) * nice_0_weight * nice_0_weight / current.weight;
+
+        if (queued) this->insert(current.parent, this->group_entity(group), false);
+        this->update_min_vruntime(current.parent, current.vruntime);
+
+        if (current.quota == 0) continue;
+
+        if (current.period_index != this->now / current.period) {
+            current.period_index = this->now / current.period;
+            current.used = 0;
+        }
+
+        current.used += time;
+
+        if (current.used >= current.quota && !current.throttled) {
+            current.throttled = true;
+            this->throttled.insert(std::pair((current.period_index + 1) * current.period, group));
+            this->deactivate(group);
+        }
+    }
+}
+
+/// <summary>
+/// Put back the groups whose throttling period ended.
+/// </summary>
+void OS_SS_Algorithms::Group_Policy::on_time(unsigned time) {
+    this->now = time;
+
+    while (!this->throttled.empty() && this->throttled.begin()->first <= time) {
+        const size_t group = this->throttled.begin()->second;
+        node& current = this->nodes.at(group);
+
+        this->throttled.erase(this->throttled.begin());
+        current.throttled = false;
+        current.period_index = time / current.period;
+        current.used = 0;
+
+        this->activate(group);
+    }
+}
+
+/// <summary>
+/// Wake up when the first throttled group may run again, and at the next period boundary of the groups of the running process.
+/// </summary>
+unsigned OS_SS_Algorithms::Group_Policy::get_timer(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) const {
+    unsigned long long next = std::numeric_limits<unsigned long long>::max();
+    if (!this->throttled.empty()) next = this->throttled.begin()->first;
+
+    if (running.is_valid())
+        for (size_t group{ this->process_node.at(this->index_of(running)) }; group != 0; group = this->nodes.at(group).parent)
+            if (this->nodes.at(group).quota > 0)
+                next = std::min<unsigned long long>(next, (time / this->nodes.at(group).period + 1) * this->nodes.at(group).period);
+
+    return (next > time && next != std::numeric_limits<unsigned long long>::max()) ? static_cast<unsigned>(next - time) : 0;
+}
+
+/// <summary>
+/// The running process is compared with the leftmost entity of the first run queue, from the root down, where it is not itself leftmost.
+/// </summary>
+bool OS_SS_Algorithms::Group_Policy::should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned /*time_in_slice*/) const {
+    const size_t i = this->index_of(running);
+
+    // Entities on the path of the running process, from the root down.
+    std::vector<size_t> path{ i };
+    for (size_t group{ this->process_node.at(i) }; group != 0; group = this->nodes.at(group).parent) path.push_back(this->group_entity(group));
+
+    size_t group{ 0 };
+
+    for (auto it = path.rbegin(); it != path.rend(); it++) {
+        const node& current = this->nodes.at(group);
+        if (current.queue.empty()) return false;
+
+        if (current.queue.begin()->second != *it) {
+            const unsigned long long vruntime = (this->is_group(*it)) ? this->nodes.at(*it - this->process_node.size()).vruntime : this->vruntime.at(*it);
+            const unsigned long long leftmost = current.queue.begin()->first;
+
+            return vruntime > leftmost && vruntime - leftmost > static_cast<unsigned long long>(this->wakeup_granularity) * nice_0_weight;
+        }
+
+        if (this->is_group(*it)) group = *it - this->process_node.size();
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Run queues are keyed on the current virtual runtimes, and a group is in its parent's run queue exactly when it has ready processes and
+/// is not throttled, so the queues are rebuilt from the virtual runtimes, the quota state and the ready processes.
+/// </summary>
+void OS_SS_Algorithms::Group_Policy::save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const {
+    for (unsigned long long value : this->vruntime) checkpoint.put(value);
+
+    for (const node& current : this->nodes) {
+        checkpoint.put(current.vruntime);
+        checkpoint.put(current.min_vruntime);
+        checkpoint.put(current.period_index);
+        checkpoint.put(current.used);
+        checkpoint.put(current.throttled);
+    }
+
+    checkpoint.put(this->now);
+    checkpoint.put(this->used_in_slice);
+    checkpoint.put_processes(this->get_ready_list());
+}
+
+void OS_SS_Algorithms::Group_Policy::load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+    for (unsigned long long& value : this->vruntime) value = checkpoint.get();
+
+    for (node& current : this->nodes) {
+        current.vruntime = checkpoint.get();
+        current.min_vruntime = checkpoint.get();
+        current.period_index = checkpoint.get();
+        current.used = static_cast<unsigned>(checkpoint.get());
+        current.throttled = checkpoint.get() != 0;
+    }
+
+    this->now = static_cast<unsigned>(checkpoint.get());
+    this->used_in_slice = static_cast<unsigned>(checkpoint.get());
+
+    for (const OS_Scheduler_Simulator::Engine::Running_Process& process : checkpoint.get_processes()) {
+        const size_t i = this->index_of(process);
+
+        this->ready_processes.at(i) = process;
+        this->insert(this->process_node.at(i), i, false);
+        this->ready_count++;
+    }
+
+    // Children have higher indexes than their parents, so every group knows if it has ready processes before its parent is looked at.
+    for (size_t group{ this->nodes.size() - 1 }; group > 0; group--) {
+        node& current = this->nodes.at(group);
+
+        if (current.throttled) this->throttled.insert(std::pair((current.period_index + 1) * current.period, group));
+
+        else if (!current.queue.empty()) {
+            this->insert(current.parent, this->group_entity(group), false);
+            current.queued = true;
+        }
+    }
+}
+
+/// <summary>
+/// Add an entity to the run queue of a group. New and waking entities are placed near the minimum of the queue, as in CFS_Policy.
+/// </summary>
+void OS_SS_Algorithms::Group_Policy::insert(size_t group, size_t entity, bool placed) {
+    node& current = this->nodes.at(group);
+    unsigned long long& entity_vruntime = (this->is_group(entity)) ? this->nodes.at(entity - this->process_node.size()).vruntime : this->vruntime.at(entity);
+
+    if (placed) {
+        const unsigned long long sleeper_bonus = static_cast<unsigned long long>(this->target_latency) * nice_0_weight / 2;
+        const unsigned long long placement = (current.min_vruntime > sleeper_bonus) ? current.min_vruntime - sleeper_bonus : 0;
+        entity_vruntime = std::max(entity_vruntime, placement);
+    }
+
+    current.queue.insert(std::pair(entity_vruntime, entity));
+    current.queue_weight += (this->is_group(entity)) ? this->nodes.at(entity - this->process_node.size()).weight : this->weight.at(entity);
+}
+
+void OS_SS_Algorithms::Group_Policy::erase(size_t group, size_t entity) {
+    node& current = this->nodes.at(group);
+    const bool entity_is_group = this->is_group(entity);
+
+    current.queue.erase(std::pair((entity_is_group) ? this->nodes.at(entity - this->process_node.size()).vruntime : this->vruntime.at(entity), entity));
+    current.queue_weight -= (entity_is_group) ? this->nodes.at(entity - this->process_node.size()).weight : this->weight.at(entity);
+}
+
+/// <summary>
+/// Put a group and its ancestors in their parents' run queues, up to the first one already there or throttled.
+/// </summary>
+void OS_SS_Algorithms::Group_Policy::activate(size_t group) {
+    for (; group != 0 && !this->nodes.at(group).queued && !this->nodes.at(group).throttled && !this->nodes.at(group).queue.empty(); group = this->nodes.at(group).parent) {
+        this->insert(this->nodes.at(group).parent, this->group_entity(group), true);
+        this->nodes.at(group).queued = true;
+    }
+}
+
+/// <summary>
+/// Take a group out of its parent's run queue if it has no ready processes left or is throttled, and its ancestors left empty by it.
+/// </summary>
+void OS_SS_Algorithms::Group_Policy::deactivate(size_t group) {
+    for (; group != 0 && this->nodes.at(group).queued && (this->nodes.at(group).queue.empty() || this->nodes.at(group).throttled); group = this->nodes.at(group).parent) {
+        this->erase(this->nodes.at(group).parent, this->group_entity(group));
+        this->nodes.at(group).queued = false;
+    }
+}
+
+/// <summary>
+/// min_vruntime of a run queue only moves forward; it follows the smallest virtual runtime among the running entity and the queue.
+/// </summary>
+void OS_SS_Algorithms::Group_Policy::update_min_vruntime(size_t group, unsigned long long current) {
+    node& queue_node = this->nodes.at(group);
+    if (!queue_node.queue.empty()) current = std::min(current, queue_node.queue.begin()->first);
+
+    queue_node.min_vruntime = std::max(queue_node.min_vruntime, current);
+}
+
+/// <summary>
+/// Get the smallest quota left in the current period to a group and its ancestors.
+/// </summary>
+/// <returns>The time left, or the largest unsigned value if none of them has a quota.</returns>
+unsigned OS_SS_Algorithms::Group_Policy::get_quota_left(size_t group, unsigned time) const {
+    unsigned left = std::numeric_limits<unsigned>::max();
+
+    for (; group != 0; group = this->nodes.at(group).parent) {
+        const node& current = this->nodes.at(group);
+        if (current.quota == 0) continue;
+
+        const unsigned used = (current.period_index == time / current.period) ? current.used : 0;
+        left = std::min(left, (used < current.quota) ? current.quota - used : 0);
+    }
+
+    return left;
+}
+
+/// <summary>
+/// Get the node of a group, creating it and the nodes of its ancestors the first time.
+/// </summary>
+size_t OS_SS_Algorithms::Group_Policy::find_node(const OS_Scheduler_Simulator::Engine::Process_Group* group) {
+    if (group == nullptr) return 0;
+
+    auto it = this->node_index.find(group);
+    if (it != this->node_index.end()) return it->second;
+
+    const size_t parent = this->find_node(group->get_parent().get());
+
+    this->nodes.push_back(node{ .parent = parent, .weight = group->get_weight(), .quota = group->get_quota(), .period = group->get_period(), .queue = {}, .queue_weight = 0,
+        .min_vruntime = 0, .vruntime = 0, .queued = false, .period_index = 0, .used = 0, .throttled = false });
+
+    this->node_index.emplace(group, this->nodes.size() - 1);
+    return this->nodes.size() - 1;
+}
+
+/// <summary>
+/// Build a CFS algorithm with custom parameters, ready to be registered with Simulation::register_algorithm.
+/// </summary>
+std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> OS_SS_Algorithms::make_CFS(unsigned target_latency, unsigned min_granularity, unsigned wakeup_granularity) {
+    return [=](const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+        CFS_Policy policy(target_latency, min_granularity, wakeup_granularity);
+        OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+    };
+}
+
+/// <summary>
+/// Completely Fair Scheduler with target latency = 24, minimum granularity = 3 and wakeup granularity = 4.
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::CFS(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    CFS_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// Build an ASJF algorithm with a custom exponential average, ready to be registered with Simulation::register_algorithm.
+/// </summary>
+std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> OS_SS_Algorithms::make_ASJF(double alpha, double initial_prediction) {
+    return [=](const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+        ASJF_Policy policy(alpha, initial_prediction);
+        OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+    };
+}
+
+/// <summary>
+/// Shortest Remaining Time First algorithm (preemptive SJF). Like SJF, it needs to know the CPU bursts beforehand.
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::SRTF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    SRTF_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// Approximate Shortest Job First algorithm with alpha = 0.5 and an initial prediction of 10.
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::ASJF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    ASJF_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// Earliest Deadline First algorithm. Every CPU burst has to complete within its deadline after it becomes ready (see Process_Data::set_deadline).
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::EDF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    EDF_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// Rate Monotonic algorithm. Processes with shorter periods (see Process_Data::set_period) always preempt the others.
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::RM(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    RM_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// Build a round robin algorithm with a custom quantum, ready to be registered with Simulation::register_algorithm.
+/// </summary>
+std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> OS_SS_Algorithms::make_RR(unsigned quantum) {
+    return [=](const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+        Round_Robin_Policy policy(quantum);
+        OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+    };
+}
+
+/// <summary>
+/// Round robin algorithm with a quantum of 5.
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::RR(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    Round_Robin_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// Build a priority algorithm with a custom quantum and aging interval, ready to be registered with Simulation::register_algorithm.
+/// </summary>
+std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> OS_SS_Algorithms::make_Priority(unsigned quantum, unsigned aging) {
+    return [=](const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+        Priority_Policy policy(quantum, aging);
+        OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+    };
+}
+
+/// <summary>
+/// Priority algorithm: the nice values are the priorities, with a quantum of 5 and processes moving up one level every 20 units ready.
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::Priority(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    Priority_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// Build a Group algorithm with custom parameters, ready to be registered with Simulation::register_algorithm.
+/// </summary>
+std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> OS_SS_Algorithms::make_Group(unsigned target_latency, unsigned min_granularity, unsigned wakeup_granularity) {
+    return [=](const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+        Group_Policy policy(target_latency, min_granularity, wakeup_granularity);
+        OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+    };
+}
+
+/// <summary>
+/// Hierarchical group scheduling with CPU bandwidth quotas (see Process_Group), with the same parameters as CFS.
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::Group(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    Group_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// Build an algorithm from its name and a set of named parameters (used by the batch runner and other tools driven by text input).
+/// Missing parameters take their default values.
+/// </summary>
+/// <param name="name">- Algorithm name, as registered by default in the Simulation.</param>
+/// <param name="parameters">- Parameter values by name (for example "alpha" for ASJF).</param>
+/// <param name="error">- Optional description of the problem if the algorithm or a parameter is unknown, or a value is out of range.</param>
+/// <returns>The algorithm, or an empty function on error.</returns>
+std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> OS_SS_Algorithms::create_algorithm(const std::string& name, const std::map<std::string, double>& parameters, std::string* error) {
+    std::vector<std::string> accepted;
+    std::string invalid; // First parameter out of its range.
+    std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> algorithm;
+
+    // Values are checked before the casts, which are undefined for values the target type cannot hold.
+    auto real = [&parameters, &accepted, &invalid](const std::string& key, double default_value, double min, double max) -> double {
+        accepted.push_back(key);
+        auto it = parameters.find(key);
+        if (it == parameters.end()) return default_value;
+
+        if (!std::isfinite(it->second) || it->second < min || it->second > max) {
+            if (invalid.empty()) invalid = key;
+            return default_value;
+        }
+
+        return it->second;
+    };
+
+    auto integer = [&real, &parameters, &invalid](const std::string& key, unsigned default_value, unsigned min) -> unsigned {
+        const double value = real(key, default_value, min, std::numeric_limits<unsigned>::max());
+
+        if (value != std::floor(value)) {
+            if (invalid.empty()) invalid = key;
+            return default_value;
+        }
+
+        return static_cast<unsigned>(value);
+    };
+
+    if (name == "FCFS") algorithm = FCFS;
+    else if (name == "SJF") algorithm = SJF;
+    else if (name == "SRTF") algorithm = SRTF;
+    else if (name == "EDF") algorithm = EDF;
+    else if (name == "RM") algorithm = RM;
+    else if (name == "MLFQ")
+        algorithm = make_MLFQ(integer("quantum_1", 5, 1), integer("quantum_2", 10, 1), integer("boost_period", 0, 0));
+    else if (name == "CFS")
+        algorithm = make_CFS(integer("target_latency", 24, 1), integer("min_granularity", 3, 1), integer("wakeup_granularity", 4, 0));
+    else if (name == "ASJF")
+        algorithm = make_ASJF(real("alpha", 0.5, 0, 1), real("initial_prediction", 10, 0, std::numeric_limits<double>::max()));
+    else if (name == "RR")
+        algorithm = make_RR(integer("quantum", 5, 1));
+    else if (name == "Priority")
+        algorithm = make_Priority(integer("quantum", 5, 1), integer("aging", 20, 0));
+    else if (name == "Group")
+        algorithm = make_Group(integer("target_latency", 24, 1), integer("min_granularity", 3, 1), integer("wakeup_granularity", 4, 0));
+
+    else {
+        if (error != nullptr) *error = "unknown algorithm \"" + name + "\"";
+        return nullptr;
+    }
+
+    for (const auto& [key, value] : parameters)
+        if (std::find(accepted.begin(), accepted.end(), key) == accepted.end()) {
+            if (error != nullptr) *error = "algorithm \"" + name + "\" has no parameter \"" + key + "\"";
+            return nullptr;
+        }
+
+    if (!invalid.empty()) {
+        if (error != nullptr) *error = "invalid value for parameter \"" + invalid + "\" of algorithm \"" + name + "\"";
+        return nullptr;
+    }
+
+    return algorithm;
+}
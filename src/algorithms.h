@@ -0,0 +1,416 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_ALGORITHMS_
+#define _OS_SCHEDULER_SIMULATOR_ALGORITHMS_
+
+#include "engine.h"
+#include "scheduling_policy.h"
+
+#include <list>
+#include <vector>
+#include <set>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <bit>
+
+// Policy-based algorithms.
+// These run through the Policy_Runner; the plain functions declared in engine.h use their default parameters.
+namespace OS_SS_Algorithms {
+	/// <summary>
+	/// First Come, First Serve as a policy: a FIFO ready queue and no preemption. It gives the same timelines as the FCFS function, which
+	/// stays the registered algorithm; this one lets FCFS share its work with the other policies (see Shared_Prefix_Runner).
+	/// </summary>
+	class FCFS_Policy : public OS_Scheduler_Simulator::Engine::Scheduling_Policy {
+	public:
+		FCFS_Policy() : queue() {}
+
+		void setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& /*processes*/) override { this->queue.clear(); }
+		void enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned /*time*/, bool /*preempted*/) override { this->queue.push_back(process); }
+		OS_Scheduler_Simulator::Engine::Running_Process dispatch(unsigned time) override;
+		bool has_ready() const override { return !this->queue.empty(); }
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> get_ready_list() const override { return this->queue; }
+		bool keeps_arrival_order() const override { return true; }
+
+		bool can_checkpoint() const override { return true; }
+		void save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const override;
+		void load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) override;
+
+	private:
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> queue;
+	};
+
+	/// <summary>
+	/// FIFO ready queues, one per level, for the round robin family. The queues are linked through arrays indexed by process, which works
+	/// because a process is queued at most once, so pushing, popping and moving a process to another level are O(1) and never allocate. A
+	/// bitmap of the levels with processes finds the first one in O(1), as in the Linux O(1) scheduler. Level 0 comes first.
+	/// </summary>
+	class Level_Queues {
+	public:
+		static constexpr unsigned max_levels = 64;
+		static constexpr size_t no_process = static_cast<size_t>(-1);
+
+		Level_Queues() : first_process(nullptr), processes(), next(), head(), tail(), occupied(0), count(0) {}
+
+		void reset(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, unsigned levels);
+		void push_back(unsigned level, const OS_Scheduler_Simulator::Engine::Running_Process& process);
+		OS_Scheduler_Simulator::Engine::Running_Process pop_front(unsigned level);
+
+		/// <summary>Get the index of the first process of a level, or no_process.</summary>
+		size_t front(unsigned level) const { return this->head.at(level); }
+
+		/// <summary>Get the first level with processes. Only valid if the queues are not empty.</summary>
+		unsigned first_level() const { return static_cast<unsigned>(std::countr_zero(this->occupied)); }
+
+		/// <summary>Get the levels with processes as a bitmap, level i being bit i.</summary>
+		std::uint64_t get_occupied() const { return this->occupied; }
+
+		bool empty() const { return this->count == 0; }
+		bool empty(unsigned level) const { return (this->occupied & (std::uint64_t{ 1 } << level)) == 0; }
+		size_t size() const { return this->count; }
+		unsigned get_levels() const { return static_cast<unsigned>(this->head.size()); }
+
+		size_t index_of(const OS_Scheduler_Simulator::Engine::Running_Process& process) const { return process.get_process_data() - this->first_process; }
+
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> get_list() const;
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> get_list(unsigned level) const;
+		std::vector<OS_Scheduler_Simulator::Engine::Data_Point::ready_level> get_ready_levels() const;
+
+	private:
+		void append(unsigned level, std::list<OS_Scheduler_Simulator::Engine::Running_Process>& list) const;
+
+		const OS_Scheduler_Simulator::Engine::Process_Data* first_process;
+		std::vector<OS_Scheduler_Simulator::Engine::Running_Process> processes; // State of every queued process, by index.
+		std::vector<size_t> next;
+		std::vector<size_t> head;
+		std::vector<size_t> tail;
+		std::uint64_t occupied;
+		size_t count;
+	};
+
+	/// <summary>
+	/// Round robin: processes run in FIFO order for at most a quantum, then go to the back of the queue. Processes returning from I/O do not
+	/// preempt. Subclasses can spread the processes over several levels, the first level with processes running first, and give every
+	/// process its own quantum (see get_level and get_quantum). The Data_Points hold every level apart, and their processes carry the level plus
+	/// one when there are several.
+	/// </summary>
+	class Round_Robin_Policy : public OS_Scheduler_Simulator::Engine::Scheduling_Policy {
+	public:
+		/// <param name="quantum">- Time a process may run before going back to the queue.</param>
+		/// <param name="levels">- Number of queues, at most Level_Queues::max_levels.</param>
+		Round_Robin_Policy(unsigned quantum = 5, unsigned levels = 1);
+
+		void setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) override;
+		void enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned time, bool preempted) override;
+		OS_Scheduler_Simulator::Engine::Running_Process dispatch(unsigned time) override;
+		bool has_ready() const override { return !this->queues.empty(); }
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> get_ready_list() const override { return this->queues.get_list(); }
+		std::vector<OS_Scheduler_Simulator::Engine::Data_Point::ready_level> get_ready_levels() const override { return this->queues.get_ready_levels(); }
+		bool keeps_arrival_order() const override { return this->levels == 1; }
+
+		unsigned get_time_slice(const OS_Scheduler_Simulator::Engine::Running_Process& running) const override { return this->get_quantum(running); }
+
+		bool can_checkpoint() const override { return true; }
+		void save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const override;
+		void load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) override;
+
+	protected:
+		/// <summary>Get the level a process joins when it is enqueued.</summary>
+		virtual unsigned get_level(const OS_Scheduler_Simulator::Engine::Running_Process& /*process*/, bool /*preempted*/) const { return 0; }
+
+		/// <summary>Get the time slice of a process that was just dispatched.</summary>
+		virtual unsigned get_quantum(const OS_Scheduler_Simulator::Engine::Running_Process& /*process*/) const { return this->quantum; }
+
+		unsigned quantum;
+		unsigned levels;
+		Level_Queues queues;
+	};
+
+	/// <summary>
+	/// Preemptive priorities with aging: one round robin level per nice value, -20 first. A process returning from I/O preempts a running
+	/// process of a lower level. Every aging interval a process spends ready moves it up one level, so low priorities do not starve; it goes
+	/// back to the level of its nice value the next time it is enqueued. A timer wakes the policy at every move, so they happen on time.
+	/// </summary>
+	class Priority_Policy : public Round_Robin_Policy {
+	public:
+		/// <param name="quantum">- Time a process may run before going back to the queue.</param>
+		/// <param name="aging">- Time ready after which a process moves up one level, or 0 for no aging.</param>
+		Priority_Policy(unsigned quantum = 5, unsigned aging = 20);
+
+		void setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) override;
+		void enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned time, bool preempted) override;
+
+		void on_time(unsigned time) override;
+		unsigned get_timer(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) const override;
+		bool should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time_in_slice) const override;
+
+		void save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const override;
+		void load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) override;
+
+	protected:
+		unsigned get_level(const OS_Scheduler_Simulator::Engine::Running_Process& process, bool /*preempted*/) const override { return process.get_process_data()->get_nice() + 20; }
+
+	private:
+		unsigned aging;
+		std::vector<unsigned long long> since; // Time every ready process joined its level.
+	};
+
+	/// <summary>
+	/// Completely Fair Scheduler in the style of Linux CFS. Ready processes are kept in a red-black tree ordered by virtual runtime, which
+	/// advances slower for processes with more weight (lower nice value). The process with the smallest virtual runtime always runs next.
+	/// </summary>
+	class CFS_Policy : public OS_Scheduler_Simulator::Engine::Scheduling_Policy {
+	public:
+		/// <param name="target_latency">- Period in which every ready process should run once.</param>
+		/// <param name="min_granularity">- Smallest time slice given to a process, even with many ready processes.</param>
+		/// <param name="wakeup_granularity">- Virtual runtime advantage a waking process needs to preempt the running one.</param>
+		CFS_Policy(unsigned target_latency = 24, unsigned min_granularity = 3, unsigned wakeup_granularity = 4);
+
+		void setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) override;
+		void enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned time, bool preempted) override;
+		OS_Scheduler_Simulator::Engine::Running_Process dispatch(unsigned time) override;
+		bool has_ready() const override { return !this->tree.empty(); }
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> get_ready_list() const override;
+
+		unsigned get_time_slice(const OS_Scheduler_Simulator::Engine::Running_Process& running) const override;
+		void on_cpu_time(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) override;
+		bool should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time_in_slice) const override;
+
+		bool can_checkpoint() const override { return true; }
+		void save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const override;
+		void load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) override;
+
+	private:
+		size_t index_of(const OS_Scheduler_Simulator::Engine::Running_Process& process) const { return process.get_process_data() - this->first_process; }
+		void update_min_vruntime(size_t running_index);
+
+		unsigned target_latency;
+		unsigned min_granularity;
+		unsigned wakeup_granularity;
+
+		const OS_Scheduler_Simulator::Engine::Process_Data* first_process;
+		std::vector<unsigned long long> vruntime;  // Fixed point: nice 0 processes advance 1024 per time unit.
+		std::vector<unsigned long long> weight;
+		std::vector<OS_Scheduler_Simulator::Engine::Running_Process> ready_processes;
+
+		std::set<std::pair<unsigned long long, size_t>> tree; // (vruntime, process index)
+		unsigned long long ready_weight;
+		unsigned long long min_vruntime;
+	};
+
+	/// <summary>
+	/// Base for policies that always run the ready process with the smallest key. Ready processes are kept in a binary heap, so dispatch is
+	/// O(log n), and ties are broken by arrival order. A list in arrival order is kept next to it for the Data_Points; it is only copied
+	/// when the timeline needs the whole ready queue (Timeline::needs_queues), so streamed runs take O(log n) per step.
+	/// </summary>
+	class Shortest_First_Policy : public OS_Scheduler_Simulator::Engine::Scheduling_Policy {
+	public:
+		Shortest_First_Policy() : first_process(nullptr), heap(), arrival_order(), sequence(0) {}
+
+		void setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) override;
+		void enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned time, bool preempted) override;
+		OS_Scheduler_Simulator::Engine::Running_Process dispatch(unsigned time) override;
+		bool has_ready() const override { return !this->heap.empty(); }
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> get_ready_list() const override { return this->arrival_order; }
+		bool keeps_arrival_order() const override { return true; }
+
+		bool can_checkpoint() const override { return true; }
+		void save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const override;
+		void load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) override;
+
+	protected:
+		virtual unsigned long long get_key(const OS_Scheduler_Simulator::Engine::Running_Process& process) const = 0;
+		unsigned long long get_top_key() const { return this->heap.top().key; }
+
+		const OS_Scheduler_Simulator::Engine::Process_Data* first_process;
+
+	private:
+		typedef struct {
+			unsigned long long key;
+			unsigned long long sequence;
+			std::list<OS_Scheduler_Simulator::Engine::Running_Process>::iterator position;
+		} entry;
+
+		struct entry_greater {
+			bool operator()(const entry& a, const entry& b) const { return (a.key != b.key) ? a.key > b.key : a.sequence > b.sequence; }
+		};
+
+		std::priority_queue<entry, std::vector<entry>, entry_greater> heap;
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> arrival_order;
+		unsigned long long sequence;
+	};
+
+	/// <summary>
+	/// Shortest Job First: non-preemptive, keyed on the remaining time of the current CPU burst.
+	/// </summary>
+	class SJF_Policy : public Shortest_First_Policy {
+	protected:
+		unsigned long long get_key(const OS_Scheduler_Simulator::Engine::Running_Process& process) const override { return process.time_to_end_current_burst(); }
+	};
+
+	/// <summary>
+	/// Shortest Remaining Time First: preemptive SJF. A process returning from I/O takes the CPU if its burst is shorter than what is left of the running one.
+	/// </summary>
+	class SRTF_Policy : public SJF_Policy {
+	public:
+		bool should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time_in_slice) const override;
+	};
+
+	/// <summary>
+	/// Approximate SJF: the burst lengths are not known in advance, so each process is keyed on a prediction of its next CPU burst.
+	/// After every burst the prediction is updated with an exponential average: next = alpha * last_burst + (1 - alpha) * prediction.
+	/// </summary>
+	class ASJF_Policy : public Shortest_First_Policy {
+	public:
+		/// <param name="alpha">- Weight of the last burst in the prediction (0 to 1).</param>
+		/// <param name="initial_prediction">- Prediction used for the first burst of every process.</param>
+		ASJF_Policy(double alpha = 0.5, double initial_prediction = 10);
+
+		void setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) override;
+		void on_cpu_time(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) override;
+
+		void save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const override;
+		void load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) override;
+
+	protected:
+		unsigned long long get_key(const OS_Scheduler_Simulator::Engine::Running_Process& process) const override;
+
+	private:
+		double alpha;
+		double initial_prediction;
+
+		std::vector<double> prediction;
+		std::vector<unsigned> current_burst; // CPU time received in the current burst.
+	};
+
+	/// <summary>
+	/// Earliest Deadline First: preemptive, keyed on the absolute deadline of the current CPU burst (the time it became ready plus its
+	/// relative deadline, see Process_Data::get_deadline). Bursts without a deadline only run when no burst with one is ready.
+	/// </summary>
+	class EDF_Policy : public Shortest_First_Policy {
+	public:
+		EDF_Policy() : Shortest_First_Policy(), deadline() {}
+
+		void setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) override;
+		void enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned time, bool preempted) override;
+		bool should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time_in_slice) const override;
+
+		void save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const override;
+		void load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) override;
+
+	protected:
+		unsigned long long get_key(const OS_Scheduler_Simulator::Engine::Running_Process& process) const override { return this->deadline.at(process.get_process_data() - this->first_process); }
+
+	private:
+		std::vector<unsigned long long> deadline; // Absolute deadline of the current burst of every process.
+	};
+
+	/// <summary>
+	/// Rate Monotonic: preemptive fixed priorities, the shorter the period the higher the priority. Processes without a period are ranked
+	/// by their relative deadline (deadline monotonic), and after every process with one.
+	/// </summary>
+	class RM_Policy : public Shortest_First_Policy {
+	public:
+		bool should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time_in_slice) const override;
+
+	protected:
+		unsigned long long get_key(const OS_Scheduler_Simulator::Engine::Running_Process& process) const override;
+	};
+
+	/// <summary>
+	/// Hierarchical CFS with CPU bandwidth control, in the style of Linux control groups (see Process_Group). Every group has its own CFS
+	/// run queue holding its ready processes and its child groups that have ready processes, each as one entity with its own virtual
+	/// runtime and weight. Dispatching walks down from the root, taking the entity with the smallest virtual runtime at every level, and CPU
+	/// time is charged to the process and to every group above it, so sibling groups share the CPU by weight whatever their size.
+	///
+	/// A group with a quota is charged for the CPU time of all its descendants in the current period. The time slice never goes past the
+	/// quota left along the path, and a group using it up is throttled: it leaves its parent's run queue until the period ends, when a timer
+	/// puts it back. Steps are also forced at the period boundaries of the groups of the running process, so quotas are charged exactly.
+	/// Every operation is O(depth * log(entities in a run queue)).
+	/// </summary>
+	class Group_Policy : public OS_Scheduler_Simulator::Engine::Scheduling_Policy {
+	public:
+		/// <param name="target_latency">- Period in which every ready process should run once.</param>
+		/// <param name="min_granularity">- Smallest time slice given to a process, even with many ready processes.</param>
+		/// <param name="wakeup_granularity">- Virtual runtime advantage a waking process needs to preempt the running one, at the level where their paths part.</param>
+		Group_Policy(unsigned target_latency = 24, unsigned min_granularity = 3, unsigned wakeup_granularity = 4);
+
+		void setup(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) override;
+		void enqueue(const OS_Scheduler_Simulator::Engine::Running_Process& process, unsigned time, bool preempted) override;
+		OS_Scheduler_Simulator::Engine::Running_Process dispatch(unsigned time) override;
+		bool has_ready() const override { return !this->nodes.front().queue.empty(); }
+		std::list<OS_Scheduler_Simulator::Engine::Running_Process> get_ready_list() const override;
+
+		unsigned get_time_slice(const OS_Scheduler_Simulator::Engine::Running_Process& running) const override;
+		void on_cpu_time(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) override;
+		void on_time(unsigned time) override;
+		unsigned get_timer(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time) const override;
+		bool should_preempt(const OS_Scheduler_Simulator::Engine::Running_Process& running, unsigned time_in_slice) const override;
+
+		bool can_checkpoint() const override { return true; }
+		void save_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) const override;
+		void load_state(OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) override;
+
+	private:
+		typedef struct {
+			size_t parent;                   // Node of the parent group; the root is node 0 and its own parent.
+			unsigned long long weight;
+			unsigned quota;
+			unsigned period;
+
+			std::set<std::pair<unsigned long long, size_t>> queue; // (vruntime, entity) of the ready children.
+			unsigned long long queue_weight;
+			unsigned long long min_vruntime;
+
+			unsigned long long vruntime;     // As an entity of the parent's run queue.
+			bool queued;                     // In the parent's run queue.
+
+			unsigned long long period_index; // Period the used time belongs to.
+			unsigned used;
+			bool throttled;
+		} node;
+
+		// Entities are processes (their index) and groups (the number of processes plus their node).
+		size_t index_of(const OS_Scheduler_Simulator::Engine::Running_Process& process) const { return process.get_process_data() - this->first_process; }
+		bool is_group(size_t entity) const { return entity >= this->process_node.size(); }
+		size_t group_entity(size_t node_index) const { return this->process_node.size() + node_index; }
+
+		void insert(size_t node_index, size_t entity, bool placed);
+		void erase(size_t node_index, size_t entity);
+		void activate(size_t node_index);
+		void deactivate(size_t node_index);
+		void update_min_vruntime(size_t node_index, unsigned long long current);
+		unsigned get_quota_left(size_t node_index, unsigned time) const;
+		size_t find_node(const OS_Scheduler_Simulator::Engine::Process_Group* group);
+
+		unsigned target_latency;
+		unsigned min_granularity;
+		unsigned wakeup_granularity;
+
+		const OS_Scheduler_Simulator::Engine::Process_Data* first_process;
+		std::vector<node> nodes;
+		std::unordered_map<const OS_Scheduler_Simulator::Engine::Process_Group*, size_t> node_index;
+		std::vector<size_t> process_node;
+		std::vector<unsigned long long> vruntime;
+		std::vector<unsigned long long> weight;
+		std::vector<OS_Scheduler_Simulator::Engine::Running_Process> ready_processes;
+		size_t ready_count;
+
+		std::set<std::pair<unsigned long long, size_t>> throttled; // (end of the period, node) of the throttled groups.
+		unsigned now;
+		unsigned used_in_slice;        // CPU time of the running process since it was dispatched.
+	};
+
+	std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> make_CFS(unsigned target_latency, unsigned min_granularity, unsigned wakeup_granularity);
+	std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> make_ASJF(double alpha, double initial_prediction);
+	std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> make_RR(unsigned quantum);
+	std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> make_Priority(unsigned quantum, unsigned aging);
+	std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> make_Group(unsigned target_latency, unsigned min_granularity, unsigned wakeup_granularity);
+	std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> make_MLFQ(unsigned quantum_1, unsigned quantum_2, unsigned boost_period);
+
+	std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> create_algorithm(const std::string& name, const std::map<std::string, double>& parameters, std::string* error = nullptr);
+}
+
+#endif
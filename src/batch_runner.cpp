@@ -0,0 +1,338 @@
+#include "batch_runner.h"
+#include "thread_pool.h"
+#include "workload_file.h"
+#include "algorithms.h"
+#include "steady_state.h"
+#include "dependency_graph.h"
+#include "trace_export.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <exception>
+
+/// <summary>
+/// Quote a field for CSV output if it contains separators or quotes.
+/// </summary>
+static std::string csv_field(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) return text;
+
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+
+    return quoted + "\"";
+}
+
+/// <summary>
+/// Batch_Runner constructor.
+/// </summary>
+/// <param name="threads">- Number of worker threads. 0 uses one per hardware thread.</param>
+OS_Scheduler_Simulator::Batch_Runner::Batch_Runner(unsigned threads)
+    : threads(threads), scenarios(), cache_mutex(), cache(), output_mutex() {}
+
+/// <summary>
+/// Add all the scenarios of a manifest file.
+/// </summary>
+/// <returns>False if the file could not be read or a line is invalid.</returns>
+bool OS_Scheduler_Simulator::Batch_Runner::load_manifest(const std::string& path, std::string* error) {
+    std::ifstream file(path);
+
+    if (!file.is_open()) {
+        if (error != nullptr) *error = "could not open manifest \"" + path + "\"";
+        return false;
+    }
+
+    return this->parse_manifest(file, std::filesystem::path(path).parent_path().string(), error);
+}
+
+/// <summary>
+/// Add all the scenarios of a manifest.
+/// </summary>
+/// <param name="base_directory">- Directory relative workload paths are resolved from.</param>
+bool OS_Scheduler_Simulator::Batch_Runner::parse_manifest(std::istream& stream, const std::string& base_directory, std::string* error) {
+    std::string line;
+    unsigned line_number{ 0 };
+
+    while (std::getline(stream, line)) {
+        line_number++;
+
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.resize(comment);
+
+        std::istringstream fields(line);
+        scenario new_scenario;
+
+        if (!(fields >> new_scenario.workload)) continue; // Blank line.
+
+        if (!(fields >> new_scenario.algorithm)) {
+            if (error != nullptr) *error = "line " + std::to_string(line_number) + ": missing algorithm";
+            return false;
+        }
+
+        std::string parameter;
+        while (fields >> parameter) {
+            const size_t equals = parameter.find('=');
+            size_t parsed{ 0 };
+            double value{ 0 };
+
+            if (equals != std::string::npos) {
+                try { value = std::stod(parameter.substr(equals + 1), &parsed); }
+                catch (...) { parsed = 0; }
+            }
+
+            if (equals == std::string::npos || parsed == 0 || equals + 1 + parsed != parameter.size()) {
+                if (error != nullptr) *error = "line " + std::to_string(line_number) + ": invalid parameter \"" + parameter + "\"";
+                return false;
+            }
+
+            new_scenario.parameters[parameter.substr(0, equals)] = value;
+        }
+
+        std::filesystem::path workload_path(new_scenario.workload);
+        if (workload_path.is_relative() && !base_directory.empty())
+            new_scenario.workload = (std::filesystem::path(base_directory) / workload_path).string();
+
+        this->scenarios.push_back(new_scenario);
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Run every scenario. Each result line is written (and flushed) as soon as its scenario finishes, so lines come in completion order;
+/// the "id" column is the position of the scenario in the manifest.
+/// </summary>
+/// <param name="output">- Stream receiving the results.</param>
+/// <param name="format">- CSV (with a header line) or JSON lines.</param>
+/// <returns>Number of scenarios that failed.</returns>
+size_t OS_Scheduler_Simulator::Batch_Runner::run(std::ostream& output, output_format format) {
+    std::atomic<size_t> failures{ 0 };
+
+    if (format == output_format::csv)
+        output << "id,workload,algorithm,parameters,status,processes,execution_time,cpu_utilization,avg_waiting_time,avg_turnaround_time,avg_response_time,effective_cpu_utilization,switch_overhead,avg_io_queueing_delay,deadline_misses,worst_lateness,wall_time_ms" << std::endl;
+
+    {
+        Work_Stealing_Pool pool(this->threads);
+
+        for (size_t i{ 0 }; i < this->scenarios.size(); i++)
+            pool.submit([this, i, &output, format, &failures]() {
+                if (!this->run_scenario(i, output, format)) failures++;
+            });
+
+        // Scenarios catch their own exceptions, so this only counts the ones writing their line failed.
+        failures += pool.wait();
+    }
+
+    return failures;
+}
+
+/// <summary>
+/// Get a workload from the cache, loading it the first time. Concurrent requests for the same file wait for a single load.
+/// </summary>
+std::shared_ptr<OS_Scheduler_Simulator::Batch_Runner::workload_entry> OS_Scheduler_Simulator::Batch_Runner::get_workload(const std::string& path) {
+    std::shared_ptr<workload_entry> entry;
+
+    {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        std::shared_ptr<workload_entry>& cached = this->cache[path];
+        if (cached == nullptr) cached = std::make_shared<workload_entry>();
+        entry = cached;
+    }
+
+    std::call_once(entry->loaded, [&entry, &path]() {
+        entry->valid = Engine::Workload_File::load(path, entry->processes, &entry->error, &entry->bursts);
+        if (entry->valid && entry->processes.empty()) {
+            entry->valid = false;
+            entry->error = "workload \"" + path + "\" has no processes";
+        }
+    });
+
+    return entry;
+}
+
+/// <summary>
+/// Run one scenario on a set of processes. Besides the parameters of the algorithm, the parameters may hold the scenario options:
+/// "fast_forward", "memory_budget" and the context switch costs ("switch_cost", "cache_penalty", "cache_decay").
+/// </summary>
+/// <param name="result">- Totals, deadline report and execution time of the run.</param>
+/// <param name="error">- Optional description of the problem if the scenario is invalid.</param>
+/// <returns>True if the scenario ran.</returns>
+bool OS_Scheduler_Simulator::Batch_Runner::simulate(const std::vector<Engine::Process_Data>& processes, const std::string& algorithm_name, const std::map<std::string, double>& parameters,
+    scenario_result& result, std::string* error) {
+    result = scenario_result{ .totals = { 0, 0, 0, 0, 0, 0, 0 }, .deadlines = { .jobs = 0, .misses = 0, .worst_lateness = 0, .total_tardiness = 0, .max_tardiness = 0, .tardiness_histogram = {} },
+        .execution_time = 0 };
+
+    std::string problem;
+
+    // The scenario options are counts, so the casts below need values an unsigned can hold.
+    for (const char* option : { "fast_forward", "memory_budget", "switch_cost", "cache_penalty", "cache_decay" }) {
+        auto it = parameters.find(option);
+
+        if (it != parameters.end() && (!std::isfinite(it->second) || it->second < 0 || it->second > std::numeric_limits<unsigned>::max())) {
+            if (error != nullptr) *error = "invalid value for option \"" + std::string(option) + "\"";
+            return false;
+        }
+    }
+
+    // "fast_forward", "memory_budget" and the context switch costs are scenario options, not parameters of the algorithm.
+    std::map<std::string, double> algorithm_parameters = parameters;
+    const bool fast_forward = algorithm_parameters.erase("fast_forward") > 0 && parameters.at("fast_forward") != 0;
+    const size_t memory_budget = (algorithm_parameters.erase("memory_budget") > 0) ? static_cast<size_t>(parameters.at("memory_budget")) : 0;
+
+    Engine::Timeline::switch_costs switch_costs{ .switch_cost = 0, .cache_penalty = 0, .cache_decay = 0 };
+    for (auto [option, cost] : { std::pair{ "switch_cost", &switch_costs.switch_cost }, std::pair{ "cache_penalty", &switch_costs.cache_penalty }, std::pair{ "cache_decay", &switch_costs.cache_decay } })
+        if (algorithm_parameters.erase(option) > 0) *cost = static_cast<unsigned>(parameters.at(option));
+
+    auto algorithm = OS_SS_Algorithms::create_algorithm(algorithm_name, algorithm_parameters, &problem);
+
+    if (!algorithm) {}
+
+    // Processes on a cycle or waiting for unknown processes would never run.
+    else if (Engine::Dependency_Graph::has_dependencies(processes) && !Engine::Dependency_Graph(processes).is_valid(&problem)) {}
+
+    // These keep state outside of the data points, so their schedules cannot be fast-forwarded.
+    else if (fast_forward && (algorithm_name == "CFS" || algorithm_name == "ASJF" || algorithm_name == "EDF" || algorithm_name == "Group" || algorithm_name == "RR" || algorithm_name == "Priority"))
+        problem = "algorithm \"" + algorithm_name + "\" cannot be fast-forwarded";
+
+    // The boost depends on the time, which the data points do not repeat.
+    else if (fast_forward && algorithm_name == "MLFQ" && algorithm_parameters.contains("boost_period") && algorithm_parameters.at("boost_period") > 0)
+        problem = "MLFQ with a boost period cannot be fast-forwarded";
+
+    else if (fast_forward && (switch_costs.switch_cost > 0 || switch_costs.cache_penalty > 0))
+        problem = "runs with context switch costs cannot be fast-forwarded";
+
+    // The skipped cycles are only added back to the totals, not to the deadline report.
+    else if (fast_forward && std::any_of(processes.begin(), processes.end(), [](const Engine::Process_Data& process) { return process.has_deadlines(); }))
+        problem = "workloads with deadlines cannot be fast-forwarded";
+
+    else if (fast_forward && Engine::Dependency_Graph::has_dependencies(processes))
+        problem = "workloads with dependencies cannot be fast-forwarded";
+
+    else if (fast_forward && Engine::Process_Data::has_arrivals(processes))
+        problem = "workloads with arrival times cannot be fast-forwarded";
+
+    else if (fast_forward) {
+        std::vector<Engine::Process_Data> copy = processes;
+        const Engine::Cycle_Detector::result fast_forwarded = Engine::Cycle_Detector::fast_forward(algorithm, copy);
+
+        result.totals = fast_forwarded.totals;
+        result.execution_time = fast_forwarded.execution_time;
+    }
+
+    else {
+        Engine::Simulation sim(processes);
+        sim.register_algorithm("Batch scenario", algorithm);
+        sim.set_switch_costs(switch_costs);
+        sim.set_memory_budget(memory_budget);
+
+        result.totals = sim.execute_algorithm("Batch scenario");
+        result.deadlines = sim.get_deadline_report();
+        result.execution_time = sim.get_execution_time();
+    }
+
+    if (!problem.empty() && error != nullptr) *error = problem;
+    return problem.empty();
+}
+
+bool OS_Scheduler_Simulator::Batch_Runner::run_scenario(size_t index, std::ostream& output, output_format format) {
+    const scenario& current = this->scenarios.at(index);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::string error;
+    scenario_result outcome;
+    size_t process_count{ 0 };
+
+    // A scenario that throws (running out of memory, for one) still gets its line, as a failure.
+    try {
+        std::shared_ptr<workload_entry> workload = this->get_workload(current.workload);
+
+        if (!workload->valid) error = workload->error;
+        else if (simulate(workload->processes, current.algorithm, current.parameters, outcome, &error)) process_count = workload->processes.size();
+    }
+    catch (const std::exception& exception) {
+        error = std::string("exception: ") + exception.what();
+    }
+    catch (...) {
+        error = "unknown exception";
+    }
+
+    const Engine::Evaluator::results_table& results = outcome.totals;
+    const Engine::Evaluator::deadline_report& deadlines = outcome.deadlines;
+    const unsigned long long execution_time = outcome.execution_time;
+
+    const double wall_time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // No lateness to report without any job with a deadline.
+    const long long worst_lateness = (deadlines.jobs > 0) ? deadlines.worst_lateness : 0;
+
+    std::string parameters;
+    for (const auto& [key, value] : current.parameters) {
+        std::ostringstream value_text;
+        value_text << value;
+        parameters += ((parameters.empty()) ? "" : ";") + key + "=" + value_text.str();
+    }
+
+    // Build the whole line first so only the write is serialized.
+    std::ostringstream line;
+    line.precision(10);
+
+    if (format == output_format::csv) {
+        line << index << "," << csv_field(current.workload) << "," << csv_field(current.algorithm) << "," << csv_field(parameters) << ",";
+
+        if (error.empty())
+            line << "ok," << process_count << "," << execution_time << "," << results.cpu_utilization << "," << results.avg_waiting_time << ","
+                 << results.avg_turnaround_time << "," << results.avg_response_time << "," << results.effective_cpu_utilization << "," << results.switch_overhead << ","
+                 << results.avg_io_queueing_delay << "," << deadlines.misses << "," << worst_lateness << "," << wall_time_ms;
+        else
+            line << csv_field("error: " + error) << ",,,,,,,,,,,," << wall_time_ms;
+    }
+
+    else {
+        line << "{\"id\":" << index << ",\"workload\":" << Engine::Trace_Exporter::json_string(current.workload)
+             << ",\"algorithm\":" << Engine::Trace_Exporter::json_string(current.algorithm) << ",\"parameters\":{";
+
+        bool first = true;
+        for (const auto& [key, value] : current.parameters) {
+            // JSON has no NaN or infinity.
+            line << ((first) ? "" : ",") << Engine::Trace_Exporter::json_string(key) << ":";
+            if (std::isfinite(value)) line << value;
+            else line << "null";
+
+            first = false;
+        }
+
+        line << "},";
+
+        if (error.empty())
+            line << "\"status\":\"ok\",\"processes\":" << process_count << ",\"execution_time\":" << execution_time << ",\"cpu_utilization\":" << results.cpu_utilization
+                 << ",\"avg_waiting_time\":" << results.avg_waiting_time << ",\"avg_turnaround_time\":" << results.avg_turnaround_time
+                 << ",\"avg_response_time\":" << results.avg_response_time << ",\"effective_cpu_utilization\":" << results.effective_cpu_utilization
+                 << ",\"switch_overhead\":" << results.switch_overhead << ",\"avg_io_queueing_delay\":" << results.avg_io_queueing_delay
+                 << ",\"deadline_misses\":" << deadlines.misses << ",\"worst_lateness\":" << worst_lateness << ",";
+        else
+            line << "\"status\":\"error\",\"error\":" << Engine::Trace_Exporter::json_string(error) << ",";
+
+        line << "\"wall_time_ms\":" << wall_time_ms << "}";
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->output_mutex);
+        output << line.str() << std::endl;
+    }
+
+    return error.empty();
+}
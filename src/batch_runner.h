@@ -0,0 +1,70 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_BATCH_RUNNER_
+#define _OS_SCHEDULER_SIMULATOR_BATCH_RUNNER_
+
+#include "engine.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <istream>
+#include <ostream>
+
+/// <summary>
+/// Runs many (workload, algorithm, parameters) scenarios on a Work_Stealing_Pool and streams one result line per scenario as soon as it finishes.
+///
+/// Manifest format: one scenario per line, "workload_path algorithm [key=value ...]", with '#' starting a comment. Relative workload paths are
+/// resolved from the directory of the manifest. Every workload file is loaded once and shared by all the scenarios that use it.
+/// </summary>
+class OS_Scheduler_Simulator::Batch_Runner {
+public:
+	typedef enum { csv, json } output_format;
+
+	typedef struct {
+		std::string workload;
+		std::string algorithm;
+		std::map<std::string, double> parameters;
+	} scenario;
+
+	typedef struct {
+		Engine::Evaluator::results_table totals;
+		Engine::Evaluator::deadline_report deadlines;
+		unsigned long long execution_time;
+	} scenario_result;
+
+	Batch_Runner(unsigned threads = 0);
+
+	bool load_manifest(const std::string& path, std::string* error = nullptr);
+	bool parse_manifest(std::istream& stream, const std::string& base_directory, std::string* error = nullptr);
+	void add_scenario(const scenario& new_scenario) { this->scenarios.push_back(new_scenario); }
+
+	size_t run(std::ostream& output, output_format format);
+
+	const std::vector<scenario>& get_scenarios() const { return this->scenarios; }
+
+	static bool simulate(const std::vector<Engine::Process_Data>& processes, const std::string& algorithm, const std::map<std::string, double>& parameters,
+		scenario_result& result, std::string* error = nullptr);
+
+private:
+	typedef struct {
+		std::once_flag loaded;
+		bool valid;
+		std::string error;
+		std::vector<Engine::Process_Data> processes;
+		std::shared_ptr<const Engine::Burst_Store> bursts; // Of traces, which the processes read their bursts from.
+	} workload_entry;
+
+	std::shared_ptr<workload_entry> get_workload(const std::string& path);
+	bool run_scenario(size_t index, std::ostream& output, output_format format);
+
+	unsigned threads;
+	std::vector<scenario> scenarios;
+
+	std::mutex cache_mutex;
+	std::map<std::string, std::shared_ptr<workload_entry>> cache;
+
+	std::mutex output_mutex;
+};
+
+#endif
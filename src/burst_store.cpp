@@ -0,0 +1,137 @@
+#include "burst_store.h"
+
+#include <vector>
+#include <array>
+#include <span>
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr size_t rows = OS_Scheduler_Simulator::Engine::Burst_Store::block_size / OS_Scheduler_Simulator::Engine::Burst_Store::block_lanes;
+
+    std::uint64_t width_mask(unsigned width) {
+        return (std::uint64_t{ 1 } << width) - 1;
+    }
+
+    // Unpack the 4 lanes of a block at once. The lanes need the same word and shift for every row, so the inner loop is a plain SIMD loop.
+    void unpack(const std::uint32_t* data, unsigned width, std::array<unsigned, OS_Scheduler_Simulator::Engine::Burst_Store::block_size>& values) {
+        constexpr size_t lanes = OS_Scheduler_Simulator::Engine::Burst_Store::block_lanes;
+        const std::uint64_t mask = width_mask(width);
+
+        for (size_t row{ 0 }; row < rows; row++) {
+            const unsigned bit = static_cast<unsigned>(row) * width;
+            const std::uint32_t* low = data + (bit / 32) * lanes;
+            const unsigned shift = bit % 32;
+
+            for (size_t lane{ 0 }; lane < lanes; lane++)
+                values[row * lanes + lane] = static_cast<unsigned>(((static_cast<std::uint64_t>(low[lane + lanes]) << 32 | low[lane]) >> shift) & mask);
+        }
+    }
+}
+
+/// <summary>
+/// Burst_Store constructor. The store starts empty.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Burst_Store::Burst_Store() : words(block_lanes, 0), blocks(), tail(), tail_size(0) {}
+
+/// <summary>
+/// Add the bursts of a process at the end of the store.
+/// </summary>
+/// <param name="bursts">- Bursts of the process, in order.</param>
+/// <returns>Index of the first burst in the store, for the Process_Data constructor.</returns>
+size_t OS_Scheduler_Simulator::Engine::Burst_Store::append(std::span<const unsigned> bursts) {
+    const size_t first = this->size();
+
+    for (unsigned burst : bursts) {
+        this->tail.at(this->tail_size++) = burst;
+        if (this->tail_size == block_size) this->pack_tail();
+    }
+
+    return first;
+}
+
+/// <summary>
+/// Release the memory reserved for bursts not appended yet, once the store is complete.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Burst_Store::shrink_to_fit() {
+    this->words.shrink_to_fit();
+    this->blocks.shrink_to_fit();
+}
+
+/// <summary>
+/// Read consecutive bursts, a whole block at a time.
+/// </summary>
+/// <param name="first">- Index of the first burst to read.</param>
+/// <param name="bursts">- Output. Bursts past the end of the store are left untouched.</param>
+void OS_Scheduler_Simulator::Engine::Burst_Store::decode(size_t first, std::span<unsigned> bursts) const {
+    std::array<unsigned, block_size> values;
+    size_t done{ 0 };
+
+    while (done < bursts.size() && first + done < this->size()) {
+        const size_t index = first + done;
+        const size_t block_index = index / block_size;
+        const size_t offset = index % block_size;
+        size_t count = std::min(block_size - offset, bursts.size() - done);
+
+        if (block_index < this->blocks.size()) {
+            unpack(this->words.data() + this->blocks.at(block_index).first_word, this->blocks.at(block_index).width, values);
+            std::copy_n(values.begin() + offset, count, bursts.begin() + done);
+        }
+
+        else {
+            count = std::min(count, this->tail_size - offset);
+            std::copy_n(this->tail.begin() + offset, count, bursts.begin() + done);
+        }
+
+        done += count;
+    }
+}
+
+/// <summary>
+/// Read one burst.
+/// </summary>
+/// <param name="index">- Index of the burst in the store. Past the end, fails as std::vector::at does.</param>
+unsigned OS_Scheduler_Simulator::Engine::Burst_Store::get(size_t index) const {
+    const size_t block_index = index / block_size;
+    const size_t offset = index % block_size;
+
+    if (block_index == this->blocks.size() && offset < this->tail_size) return this->tail[offset];
+
+    const block& packed = this->blocks.at(block_index);
+    const unsigned bit = static_cast<unsigned>(offset / block_lanes) * packed.width;
+    const size_t word = packed.first_word + (bit / 32) * block_lanes + offset % block_lanes;
+
+    // The next word of the lane is read even when the burst does not reach it: the padding at the end keeps it in bounds.
+    const std::uint64_t pair = static_cast<std::uint64_t>(this->words[word + block_lanes]) << 32 | this->words[word];
+    return static_cast<unsigned>((pair >> (bit % 32)) & width_mask(packed.width));
+}
+
+/// <summary>
+/// Get the memory allocated by the store, in bytes.
+/// </summary>
+size_t OS_Scheduler_Simulator::Engine::Burst_Store::get_memory_usage() const {
+    return sizeof(*this) + this->words.capacity() * sizeof(std::uint32_t) + this->blocks.capacity() * sizeof(block);
+}
+
+/// <summary>
+/// Pack the full tail as a new block, in place of the padding.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Burst_Store::pack_tail() {
+    const unsigned width = static_cast<unsigned>(std::bit_width(*std::max_element(this->tail.begin(), this->tail.end())));
+    const size_t first_word = this->words.size() - block_lanes;
+
+    // The padding is all zeros, so it becomes the start of the block.
+    this->words.resize(first_word + block_lanes * width + block_lanes, 0);
+
+    for (size_t k{ 0 }; k < block_size; k++) {
+        const std::uint64_t value = this->tail[k];
+        const unsigned bit = static_cast<unsigned>(k / block_lanes) * width;
+        const size_t word = first_word + (bit / 32) * block_lanes + k % block_lanes;
+
+        this->words[word] |= static_cast<std::uint32_t>(value << (bit % 32));
+        if (bit % 32 + width > 32) this->words[word + block_lanes] |= static_cast<std::uint32_t>(value >> (32 - bit % 32));
+    }
+
+    this->blocks.push_back(block{ .first_word = first_word, .width = static_cast<unsigned char>(width) });
+    this->tail_size = 0;
+}
@@ -0,0 +1,54 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_BURST_STORE_
+#define _OS_SCHEDULER_SIMULATOR_BURST_STORE_
+
+#include "engine.h"
+
+#include <vector>
+#include <array>
+#include <span>
+#include <cstdint>
+
+/// <summary>
+/// Compact storage for the bursts of many processes, shared by the Process_Data that read from it, for traces where a std::vector of 32-bit
+/// bursts per process takes most of the memory.
+///
+/// Bursts are appended one process after the other and packed in blocks of 128 with the fewest bits that hold the largest burst of the
+/// block. A block is laid out in 4 lanes of 32-bit words, burst k going to lane k % 4, so a block of width w takes exactly 4 * w words and
+/// the same shifts unpack the 4 lanes at once: decode() is a loop the compiler vectorizes. Any burst can still be read on its own in
+/// constant time, which is what Process_Data::get_operation does. The bursts of the last, incomplete block are kept unpacked until it fills.
+///
+/// Appending does not invalidate the processes already reading from the store, but it must not happen while they are being simulated.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Burst_Store {
+public:
+	static constexpr size_t block_size = 128;
+	static constexpr size_t block_lanes = 4;
+
+	Burst_Store();
+
+	size_t append(std::span<const unsigned> bursts);
+	void shrink_to_fit();
+	void decode(size_t first, std::span<unsigned> bursts) const;
+
+	unsigned get(size_t index) const;
+
+	/// <summary>Get the number of bursts stored.</summary>
+	size_t size() const { return this->blocks.size() * block_size + this->tail_size; }
+
+	size_t get_memory_usage() const;
+
+private:
+	typedef struct {
+		std::uint64_t first_word;
+		unsigned char width;
+	} block;
+
+	void pack_tail();
+
+	std::vector<std::uint32_t> words;          // Packed blocks, followed by block_lanes words of padding.
+	std::vector<block> blocks;
+	std::array<unsigned, block_size> tail;     // Bursts of the incomplete block.
+	size_t tail_size;
+};
+
+#endif
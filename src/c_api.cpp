@@ -0,0 +1,204 @@
+#define OSS_BUILDING_LIBRARY
+#include "c_api.h"
+
+#include "engine.h"
+#include "algorithms.h"
+#include "thread_pool.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <atomic>
+#include <exception>
+
+namespace {
+    /// <summary>
+    /// Copy a flat workload into processes named P1, P2... (the evaluator tells processes apart by name).
+    /// </summary>
+    int32_t convert_workload(const oss_workload& workload, std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes) {
+        if (workload.process_count == 0 || workload.burst_counts == nullptr || workload.burst_offsets == nullptr || workload.bursts == nullptr)
+            return OSS_INVALID_WORKLOAD;
+
+        processes.clear();
+        processes.reserve(workload.process_count);
+
+        std::vector<unsigned> bursts;
+
+        for (uint32_t i{ 0 }; i < workload.process_count; i++) {
+            const uint32_t count = workload.burst_counts[i];
+            if (count % 2 == 0) return OSS_INVALID_WORKLOAD;
+
+            const uint32_t* first = workload.bursts + workload.burst_offsets[i];
+            bursts.assign(first, first + count);
+
+            for (unsigned burst : bursts)
+                if (burst == 0) return OSS_INVALID_WORKLOAD;
+
+            processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P" + std::to_string(i + 1), bursts));
+            if (workload.nice != nullptr) processes.back().set_nice(workload.nice[i]);
+        }
+
+        return OSS_OK;
+    }
+
+    /// <summary>
+    /// Parse "name=value" pairs separated by spaces, commas or semicolons.
+    /// </summary>
+    bool parse_parameters(const char* text, std::map<std::string, double>& parameters) {
+        parameters.clear();
+        if (text == nullptr) return true;
+
+        const std::string all(text);
+        size_t start{ 0 };
+
+        while (start < all.size()) {
+            const size_t end = std::min(all.find_first_of(" \t,;", start), all.size());
+            const std::string parameter = all.substr(start, end - start);
+            start = end + 1;
+
+            if (parameter.empty()) continue;
+
+            const size_t equals = parameter.find('=');
+            if (equals == std::string::npos || equals == 0) return false;
+
+            size_t parsed{ 0 };
+            double value{ 0 };
+
+            try { value = std::stod(parameter.substr(equals + 1), &parsed); }
+            catch (const std::exception&) { return false; }
+
+            if (parsed != parameter.size() - equals - 1) return false;
+            parameters[parameter.substr(0, equals)] = value;
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Run an algorithm on converted processes and fill the caller's buffers.
+    /// </summary>
+    int32_t run_scenario(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& workload, const char* algorithm, const char* parameters, oss_results& result, oss_process_results* per_process) {
+        result = oss_results{};
+        result.status = OSS_INTERNAL_ERROR;
+
+        // Nothing may escape through the C boundary.
+        try {
+            std::map<std::string, double> values;
+
+            if (algorithm == nullptr || !OS_SS_Algorithms::create_algorithm(algorithm, {}))
+                result.status = OSS_UNKNOWN_ALGORITHM;
+
+            else if (!parse_parameters(parameters, values))
+                result.status = OSS_INVALID_PARAMETER;
+
+            else if (auto created = OS_SS_Algorithms::create_algorithm(algorithm, values); !created)
+                result.status = OSS_INVALID_PARAMETER;
+
+            else {
+                OS_Scheduler_Simulator::Engine::Simulation sim(workload);
+                sim.register_algorithm(algorithm, created);
+
+                const OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = sim.execute_algorithm(algorithm);
+
+                result.process_count = static_cast<uint32_t>(workload.size());
+                result.execution_time = sim.get_execution_time();
+                result.cpu_utilization = totals.cpu_utilization;
+                result.avg_waiting_time = totals.avg_waiting_time;
+                result.avg_turnaround_time = totals.avg_turnaround_time;
+                result.avg_response_time = totals.avg_response_time;
+
+                if (per_process != nullptr) {
+                    const std::vector<OS_Scheduler_Simulator::Engine::Evaluator::Process> evaluation = sim.get_per_process_evaluation();
+
+                    for (size_t i{ 0 }; i < evaluation.size(); i++)
+                        per_process[i] = oss_process_results{
+                            .waiting_time = evaluation.at(i).get_total_waiting_time(),
+                            .turnaround_time = evaluation.at(i).get_turnaround_time(),
+                            .response_time = evaluation.at(i).get_response_time()
+                        };
+                }
+
+                result.status = OSS_OK;
+            }
+        }
+        catch (...) {
+            result = oss_results{};
+            result.status = OSS_INTERNAL_ERROR;
+        }
+
+        return result.status;
+    }
+}
+
+uint32_t oss_api_version(void) {
+    return OSS_API_VERSION;
+}
+
+const char* oss_status_message(int32_t status) {
+    switch (status) {
+    case OSS_OK:                return "ok";
+    case OSS_INVALID_ARGUMENT:  return "invalid argument";
+    case OSS_INVALID_WORKLOAD:  return "invalid workload (no processes, missing buffers, an even number of bursts or a burst of 0)";
+    case OSS_UNKNOWN_ALGORITHM: return "unknown algorithm";
+    case OSS_INVALID_PARAMETER: return "invalid or unknown algorithm parameter";
+    case OSS_INTERNAL_ERROR:    return "internal error";
+    default:                    return "unknown status";
+    }
+}
+
+int32_t oss_run(const oss_workload* workload, const char* algorithm, const char* parameters, oss_results* result, oss_process_results* per_process) {
+    if (workload == nullptr || result == nullptr) return OSS_INVALID_ARGUMENT;
+
+    try {
+        std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+
+        result->status = convert_workload(*workload, processes);
+        if (result->status != OSS_OK) return result->status;
+
+        return run_scenario(processes, algorithm, parameters, *result, per_process);
+    }
+    catch (...) {
+        *result = oss_results{};
+        return result->status = OSS_INTERNAL_ERROR;
+    }
+}
+
+int32_t oss_run_batch(const oss_workload* workloads, uint32_t workload_count, const oss_scenario* scenarios, uint32_t scenario_count, oss_results* results, uint32_t threads) {
+    if (scenario_count == 0) return 0;
+    if (workloads == nullptr || scenarios == nullptr || results == nullptr) return OSS_INVALID_ARGUMENT;
+
+    try {
+        // Converted once, then only read by the scenarios (each simulation copies its processes).
+        std::vector<std::vector<OS_Scheduler_Simulator::Engine::Process_Data>> converted(workload_count);
+        std::vector<int32_t> workload_status(workload_count);
+
+        for (uint32_t w{ 0 }; w < workload_count; w++)
+            workload_status.at(w) = convert_workload(workloads[w], converted.at(w));
+
+        std::atomic<int32_t> failures{ 0 };
+        OS_Scheduler_Simulator::Work_Stealing_Pool pool(threads);
+
+        for (uint32_t s{ 0 }; s < scenario_count; s++) {
+            const oss_scenario& current = scenarios[s];
+            oss_results& result = results[s];
+
+            if (current.workload >= workload_count || workload_status.at(current.workload) != OSS_OK) {
+                result = oss_results{};
+                result.status = (current.workload >= workload_count) ? OSS_INVALID_ARGUMENT : workload_status.at(current.workload);
+                failures++;
+                continue;
+            }
+
+            pool.submit([&converted, &current, &result, &failures]() {
+                if (run_scenario(converted.at(current.workload), current.algorithm, current.parameters, result, nullptr) != OSS_OK) failures++;
+            });
+        }
+
+        pool.wait();
+        return failures.load();
+    }
+    catch (...) {
+        return OSS_INTERNAL_ERROR;
+    }
+}
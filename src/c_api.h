@@ -0,0 +1,94 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_C_API_
+#define _OS_SCHEDULER_SIMULATOR_C_API_
+
+/*
+ * Stable C interface of the simulator, for embedding it without linking against the C++ classes.
+ *
+ * Workloads are flat buffers: process i has burst_counts[i] bursts, stored from bursts[burst_offsets[i]]. Bursts alternate CPU and I/O,
+ * starting and ending with CPU, so every count is odd. Results are written into buffers owned by the caller; the library never returns
+ * memory that the caller has to free, and nothing is kept between calls.
+ *
+ * Structures are only ever extended at the end, and oss_api_version() changes when that happens.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(OSS_BUILDING_LIBRARY)
+#define OSS_API __declspec(dllexport)
+#else
+#define OSS_API __declspec(dllimport)
+#endif
+#else
+#define OSS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OSS_API_VERSION 1
+
+/* Status codes. Batch calls return the number of failed scenarios instead, or one of the negative codes if nothing could run. */
+#define OSS_OK                  0
+#define OSS_INVALID_ARGUMENT   -1
+#define OSS_INVALID_WORKLOAD   -2
+#define OSS_UNKNOWN_ALGORITHM  -3
+#define OSS_INVALID_PARAMETER  -4
+#define OSS_INTERNAL_ERROR     -5
+
+typedef struct oss_workload {
+    uint32_t process_count;
+    const uint32_t* burst_counts;   /* Bursts of each process. */
+    const uint64_t* burst_offsets;  /* Position of the first burst of each process in bursts. */
+    const uint32_t* bursts;
+    const int32_t* nice;            /* Nice value of each process (used by CFS and Priority), or NULL for 0. */
+} oss_workload;
+
+typedef struct oss_scenario {
+    uint32_t workload;              /* Index in the array of workloads passed to oss_run_batch. */
+    const char* algorithm;          /* FCFS, SJF, SRTF, ASJF, MLFQ, CFS, EDF, RM, RR or Priority. */
+    const char* parameters;         /* "name=value" pairs separated by spaces, commas or semicolons, or NULL. */
+} oss_scenario;
+
+typedef struct oss_results {
+    int32_t status;
+    uint32_t process_count;
+    uint64_t execution_time;
+    double cpu_utilization;
+    double avg_waiting_time;
+    double avg_turnaround_time;
+    double avg_response_time;
+} oss_results;
+
+typedef struct oss_process_results {
+    uint64_t waiting_time;
+    uint64_t turnaround_time;
+    uint64_t response_time;
+} oss_process_results;
+
+/* Version of this interface (OSS_API_VERSION of the library). */
+OSS_API uint32_t oss_api_version(void);
+
+/* Description of a status code. The string is static. */
+OSS_API const char* oss_status_message(int32_t status);
+
+/*
+ * Run one algorithm on one workload.
+ * per_process may be NULL; otherwise it must hold workload->process_count entries.
+ * Returns a status code, also stored in result->status.
+ */
+OSS_API int32_t oss_run(const oss_workload* workload, const char* algorithm, const char* parameters, oss_results* result, oss_process_results* per_process);
+
+/*
+ * Run many scenarios in parallel. Every workload is converted once and shared by the scenarios that use it.
+ * results must hold scenario_count entries; each gets the status of its scenario. threads = 0 uses one thread per hardware thread.
+ * Returns the number of failed scenarios, or a negative status code if the arguments are invalid.
+ */
+OSS_API int32_t oss_run_batch(const oss_workload* workloads, uint32_t workload_count, const oss_scenario* scenarios, uint32_t scenario_count, oss_results* results, uint32_t threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,281 @@
+#include "calibration.h"
+#include "io_device.h"
+#include "dependency_graph.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif // __linux__
+
+namespace {
+    // Requests enter service in arrival order, "channels" at a time, as on a simulated IO_Device.
+    class device_queue {
+    public:
+        device_queue(unsigned channels) : channels(channels), in_service(0), next_ticket(0), serving(0) {}
+
+        void acquire() {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            const unsigned long long ticket = this->next_ticket++;
+
+            this->changed.wait(lock, [this, ticket]() { return ticket == this->serving && this->in_service < this->channels; });
+            this->serving++;
+            this->in_service++;
+            this->changed.notify_all();
+        }
+
+        void release() {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->in_service--;
+            this->changed.notify_all();
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable changed;
+        unsigned channels;
+        unsigned in_service;
+        unsigned long long next_ticket;
+        unsigned long long serving;
+    };
+
+    // CPU time of the calling thread. Without a thread clock, wall time, which also counts the time the thread was preempted.
+    std::chrono::nanoseconds thread_cpu_time() {
+#ifdef __linux__
+        timespec now{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch());
+#endif // __linux__
+    }
+
+    // First CPU the process may run on, or -1.
+    int choose_cpu() {
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+            for (int cpu{ 0 }; cpu < CPU_SETSIZE; cpu++)
+                if (CPU_ISSET(cpu, &allowed)) return cpu;
+#endif // __linux__
+
+        return -1;
+    }
+
+    // Pin the calling thread and lower its priority by a number of nice levels. Returns true if it was pinned.
+    bool prepare_thread(int cpu, int nice_offset) {
+#ifdef __linux__
+        prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+
+        if (nice_offset > 0) {
+            const pid_t thread = static_cast<pid_t>(syscall(SYS_gettid));
+            const int current = getpriority(PRIO_PROCESS, static_cast<id_t>(thread));
+            setpriority(PRIO_PROCESS, static_cast<id_t>(thread), std::min(current + nice_offset, 19));
+        }
+
+        if (cpu < 0) return false;
+
+        cpu_set_t only;
+        CPU_ZERO(&only);
+        CPU_SET(cpu, &only);
+        return sched_setaffinity(0, sizeof(only), &only) == 0;
+#else
+        (void)cpu;
+        (void)nice_offset;
+        return false;
+#endif // __linux__
+    }
+}
+
+/// <summary>
+/// Calibration constructor.
+/// </summary>
+/// <param name="processes">- Processes to replay. They must outlive the calibration.</param>
+/// <param name="time_unit_us">- Length of one unit of simulated time, in microseconds.</param>
+OS_Scheduler_Simulator::Engine::Calibration::Calibration(const std::vector<Process_Data>& processes, unsigned time_unit_us)
+    : processes(processes), time_unit_us(time_unit_us), measured(), measured_totals{ 0, 0, 0, 0, 0, 0, 0 }, measured_execution_time(0), pinned(false) {}
+
+/// <summary>
+/// Replay the processes on real threads and record their times. Takes about as long as the workload, scaled to real time.
+/// </summary>
+/// <param name="error">- Optional description of the problem if nothing could be measured.</param>
+/// <returns>True if the processes ran.</returns>
+bool OS_Scheduler_Simulator::Engine::Calibration::measure(std::string* error) {
+    std::string problem;
+
+    if (this->processes.empty()) problem = "no processes to replay";
+    else if (this->time_unit_us == 0) problem = "the time unit must be at least 1 microsecond";
+    else if (Dependency_Graph::has_dependencies(this->processes)) problem = "dependencies between processes are not replayed";
+    else if (Process_Data::has_arrivals(this->processes)) problem = "arrival times are not replayed";
+
+    if (!problem.empty()) {
+        if (error != nullptr) *error = problem;
+        return false;
+    }
+
+    const std::chrono::nanoseconds unit = std::chrono::microseconds(this->time_unit_us);
+
+    std::map<const IO_Device*, std::unique_ptr<device_queue>> devices;
+    int lowest_nice{ 19 };
+
+    for (const Process_Data& process : this->processes) {
+        const IO_Device* device = process.get_io_device().get();
+        if (device != nullptr && devices.count(device) == 0) devices.emplace(device, std::make_unique<device_queue>(device->get_channels()));
+
+        lowest_nice = std::min(lowest_nice, process.get_nice());
+    }
+
+    const int cpu = choose_cpu();
+    std::atomic<bool> all_pinned{ true };
+
+    std::mutex start_mutex;
+    std::condition_variable start_signal;
+    bool started{ false };
+    std::chrono::steady_clock::time_point start;
+
+    std::vector<process_times> times(this->processes.size(), process_times{ .waiting_time = 0, .turnaround_time = 0, .response_time = 0, .io_queueing_time = 0, .cpu_time = 0 });
+    std::vector<std::chrono::steady_clock::time_point> ends(this->processes.size());
+    std::vector<std::thread> threads;
+
+    for (size_t i{ 0 }; i < this->processes.size(); i++)
+        threads.emplace_back([&, i]() {
+            const Process_Data& process = this->processes.at(i);
+            device_queue* device = (process.get_io_device() != nullptr) ? devices.at(process.get_io_device().get()).get() : nullptr;
+
+            if (!prepare_thread(cpu, process.get_nice() - lowest_nice)) all_pinned = false;
+
+            {
+                std::unique_lock<std::mutex> lock(start_mutex);
+                start_signal.wait(lock, [&started]() { return started; });
+            }
+
+            const std::chrono::steady_clock::time_point first_run = std::chrono::steady_clock::now();
+            const std::chrono::nanoseconds cpu_start = thread_cpu_time();
+            std::chrono::nanoseconds io{ 0 };
+            std::chrono::nanoseconds queueing{ 0 };
+
+            for (size_t operation{ 0 }; operation < process.get_operations_size(); operation++) {
+                const std::chrono::nanoseconds length = unit * process.get_operation(operation);
+
+                // CPU burst.
+                if (operation % 2 == 0) {
+                    const std::chrono::nanoseconds until = thread_cpu_time() + length;
+                    while (thread_cpu_time() < until) {}
+                    continue;
+                }
+
+                // I/O burst.
+                const std::chrono::steady_clock::time_point requested = std::chrono::steady_clock::now();
+                if (device != nullptr) device->acquire();
+
+                const std::chrono::steady_clock::time_point served = std::chrono::steady_clock::now();
+                std::this_thread::sleep_until(served + length);
+                if (device != nullptr) device->release();
+
+                queueing += served - requested;
+                io += length;
+            }
+
+            ends.at(i) = std::chrono::steady_clock::now();
+
+            const double to_units = 1.0 / static_cast<double>(unit.count());
+            process_times& measured = times.at(i);
+
+            measured.response_time = static_cast<double>((first_run - start).count()) * to_units;
+            measured.turnaround_time = static_cast<double>((ends.at(i) - start).count()) * to_units;
+            measured.cpu_time = static_cast<double>((thread_cpu_time() - cpu_start).count()) * to_units;
+            measured.io_queueing_time = static_cast<double>(queueing.count()) * to_units;
+            measured.waiting_time = std::max(measured.turnaround_time - measured.cpu_time - measured.io_queueing_time - static_cast<double>(io.count()) * to_units, 0.0);
+        });
+
+    {
+        std::lock_guard<std::mutex> lock(start_mutex);
+        start = std::chrono::steady_clock::now();
+        started = true;
+    }
+
+    start_signal.notify_all();
+    for (std::thread& thread : threads) thread.join();
+
+    this->measured = times;
+    this->pinned = all_pinned;
+    this->measured_execution_time = static_cast<double>((*std::max_element(ends.begin(), ends.end()) - start).count()) / static_cast<double>(unit.count());
+
+    // Averages as in Evaluator::finish.
+    Evaluator::results_table& totals = this->measured_totals;
+    totals = Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+    double cpu_time{ 0 };
+
+    for (const process_times& process : this->measured) {
+        totals.avg_waiting_time += process.waiting_time;
+        totals.avg_turnaround_time += process.turnaround_time;
+        totals.avg_response_time += process.response_time;
+        totals.avg_io_queueing_delay += process.io_queueing_time;
+        cpu_time += process.cpu_time;
+    }
+
+    totals.avg_waiting_time /= this->measured.size();
+    totals.avg_turnaround_time /= this->measured.size();
+    totals.avg_response_time /= this->measured.size();
+    totals.avg_io_queueing_delay /= this->measured.size();
+    totals.cpu_utilization = (this->measured_execution_time > 0) ? cpu_time / this->measured_execution_time : 0;
+    totals.effective_cpu_utilization = totals.cpu_utilization;
+
+    return true;
+}
+
+/// <summary>
+/// Run an algorithm and put its results next to the measured ones.
+/// </summary>
+/// <param name="simulation">- Simulation of the same processes, in the same order.</param>
+/// <param name="algorithm">- Algorithm registered in the simulation.</param>
+OS_Scheduler_Simulator::Engine::Calibration::report OS_Scheduler_Simulator::Engine::Calibration::compare(Simulation& simulation, const std::string& algorithm) const {
+    report result{
+        .algorithm = algorithm,
+        .simulated = simulation.execute_algorithm(algorithm),
+        .measured = this->measured_totals,
+        .simulated_execution_time = 0,
+        .measured_execution_time = this->measured_execution_time,
+        .processes = std::vector<process_comparison>(),
+        .pinned = this->pinned
+    };
+
+    result.simulated_execution_time = static_cast<double>(simulation.get_execution_time());
+
+    const std::vector<Evaluator::Process> evaluation = simulation.get_per_process_evaluation();
+
+    for (size_t i{ 0 }; i < this->processes.size() && i < evaluation.size(); i++) {
+        const Process_Data& process = this->processes.at(i);
+
+        unsigned long long cpu_time{ 0 };
+        for (size_t operation{ 0 }; operation < process.get_operations_size(); operation += 2) cpu_time += process.get_operation(operation);
+
+        result.processes.push_back(process_comparison{
+            .name = process.get_name(),
+            .simulated = process_times{
+                .waiting_time = static_cast<double>(evaluation.at(i).get_total_waiting_time()),
+                .turnaround_time = static_cast<double>(evaluation.at(i).get_turnaround_time()),
+                .response_time = static_cast<double>(evaluation.at(i).get_response_time()),
+                .io_queueing_time = static_cast<double>(evaluation.at(i).get_io_queueing_time()),
+                .cpu_time = static_cast<double>(cpu_time)
+            },
+            .measured = (i < this->measured.size()) ? this->measured.at(i) : process_times{ .waiting_time = 0, .turnaround_time = 0, .response_time = 0, .io_queueing_time = 0, .cpu_time = 0 }
+        });
+    }
+
+    return result;
+}
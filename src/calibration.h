@@ -0,0 +1,68 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_CALIBRATION_
+#define _OS_SCHEDULER_SIMULATOR_CALIBRATION_
+
+#include "engine.h"
+
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Replays a workload on real threads, scheduled by the operating system, to check the predictions of the simulator against it.
+///
+/// measure() starts one thread per process. A CPU burst spins until the thread has used that much CPU time, and an I/O burst sleeps,
+/// queueing first for the process's I/O device as the simulator does (arrival order, "channels" requests at a time). One unit of simulated
+/// time is time_unit_us microseconds. On Linux all the threads are pinned to one CPU of the process's affinity mask, since the simulator
+/// models a single CPU, timer slack is reduced to 1 ns, and nice values are applied relative to the lowest one (raising the nice value of a
+/// thread needs no privileges). Groups are not reproduced. Elsewhere the threads are not pinned and CPU bursts spin on wall time, so the
+/// measurement is only indicative.
+///
+/// Measured times are converted back to units. Every process arrives at the start, as in the simulator: its response time is when its
+/// thread first ran, its turnaround time when it finished, and its waiting time whatever is left after its CPU time, its I/O and its I/O
+/// queueing. compare() then runs an algorithm on a Simulation of the same processes and puts both results side by side. Other load on the
+/// machine shows up as waiting time, so calibrate on an idle machine.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Calibration {
+public:
+	typedef struct {
+		double waiting_time;
+		double turnaround_time;
+		double response_time;
+		double io_queueing_time;
+		double cpu_time;
+	} process_times;
+
+	typedef struct {
+		std::string name;
+		process_times simulated;
+		process_times measured;
+	} process_comparison;
+
+	typedef struct {
+		std::string algorithm;
+		Evaluator::results_table simulated;
+		Evaluator::results_table measured;      // The switch overhead cannot be observed, so it is 0.
+		double simulated_execution_time;
+		double measured_execution_time;
+		std::vector<process_comparison> processes;
+		bool pinned;                            // All threads ran on a single CPU.
+	} report;
+
+	Calibration(const std::vector<Process_Data>& processes, unsigned time_unit_us = 1000);
+
+	bool measure(std::string* error = nullptr);
+	report compare(Simulation& simulation, const std::string& algorithm) const;
+
+	/// <summary>Check if measure() succeeded.</summary>
+	bool is_measured() const { return !this->measured.empty(); }
+
+private:
+	const std::vector<Process_Data>& processes;
+	unsigned time_unit_us;
+
+	std::vector<process_times> measured;
+	Evaluator::results_table measured_totals;
+	double measured_execution_time;
+	bool pinned;
+};
+
+#endif
@@ -0,0 +1,415 @@
+#include "checkpoint.h"
+#include "io_device.h"
+#include "process_group.h"
+
+#include <string>
+#include <list>
+#include <vector>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+#include <bit>
+#include <cstdint>
+
+namespace {
+    constexpr char magic[8] = { 'O', 'S', 'S', 'C', 'K', 'P', 'T', '2' };
+
+    constexpr unsigned long long fnv_offset = 14695981039346656037ull;
+    constexpr unsigned long long fnv_prime = 1099511628211ull;
+
+    void hash_bytes(unsigned long long& hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+        for (size_t i{ 0 }; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= fnv_prime;
+        }
+    }
+
+    void hash_value(unsigned long long& hash, unsigned long long value) {
+        unsigned char bytes[8];
+        for (unsigned i{ 0 }; i < 8; i++) bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+        hash_bytes(hash, bytes, sizeof(bytes));
+    }
+
+    void write_fixed(std::ostream& stream, unsigned long long value) {
+        char bytes[8];
+        for (unsigned i{ 0 }; i < 8; i++) bytes[i] = static_cast<char>(value >> (8 * i));
+        stream.write(bytes, sizeof(bytes));
+    }
+
+    bool read_fixed(std::istream& stream, unsigned long long& value) {
+        unsigned char bytes[8];
+        if (!stream.read(reinterpret_cast<char*>(bytes), sizeof(bytes))) return false;
+
+        value = 0;
+        for (unsigned i{ 0 }; i < 8; i++) value |= static_cast<unsigned long long>(bytes[i]) << (8 * i);
+        return true;
+    }
+}
+
+/// <summary>
+/// Checkpoint constructor.
+/// </summary>
+/// <param name="processes">- Processes of the run. Running_Process::get_process_data() must point into this vector.</param>
+OS_Scheduler_Simulator::Engine::Checkpoint::Checkpoint(const std::vector<Process_Data>& processes)
+    : first_process(processes.data()), process_count(processes.size()), fingerprint(get_fingerprint(processes)), bytes(), position(0), valid(true) {}
+
+/// <summary>
+/// Drop the contents, to write a new checkpoint.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Checkpoint::clear() {
+    this->bytes.clear();
+    this->position = 0;
+    this->valid = true;
+}
+
+void OS_Scheduler_Simulator::Engine::Checkpoint::put(unsigned long long value) {
+    while (value >= 0x80) {
+        this->bytes.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+
+    this->bytes.push_back(static_cast<unsigned char>(value));
+}
+
+void OS_Scheduler_Simulator::Engine::Checkpoint::put_signed(long long value) {
+    // Zigzag, so small negative values stay small.
+    this->put((static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));
+}
+
+void OS_Scheduler_Simulator::Engine::Checkpoint::put_double(double value) {
+    this->put(std::bit_cast<unsigned long long>(value));
+}
+
+void OS_Scheduler_Simulator::Engine::Checkpoint::put_string(const std::string& value) {
+    this->put(value.size());
+    this->bytes.insert(this->bytes.end(), value.begin(), value.end());
+}
+
+void OS_Scheduler_Simulator::Engine::Checkpoint::put_process(const Running_Process& process) {
+    // 0 for no process, otherwise the index of the process plus one.
+    if (!process.is_valid()) {
+        this->put(0);
+        return;
+    }
+
+    this->put(this->index_of(process.get_process_data()) + 1);
+    this->put(static_cast<unsigned long long>(process.get_status()));
+    this->put(process.get_operation_index());
+    this->put(process.time_in_operation());
+    this->put(process.get_level());
+    this->put(process.get_switch_overhead());
+}
+
+void OS_Scheduler_Simulator::Engine::Checkpoint::put_processes(const std::list<Running_Process>& processes) {
+    this->put(processes.size());
+    for (const Running_Process& process : processes) this->put_process(process);
+}
+
+void OS_Scheduler_Simulator::Engine::Checkpoint::put_point(const Data_Point& data_point) {
+    this->put(data_point.get_time_since_start());
+    this->put_process(data_point.get_cpu_process());
+    this->put(data_point.has_ready_queue());
+
+    if (!data_point.has_ready_queue()) {
+        this->put(data_point.get_ready_count());
+        this->put(data_point.get_waiting_count());
+    }
+
+    else this->put(data_point.get_ready_levels().size());
+
+    for (const Data_Point::ready_level& level : data_point.get_ready_levels()) {
+        this->put(level.level);
+        this->put_processes(level.processes);
+    }
+
+    if (data_point.has_waiting_list()) this->put_processes(data_point.get_waiting_list());
+
+    // The changes of the ready queue, by index of the process; the dispatched one plus one, 0 for none.
+    const std::optional<Data_Point::ready_changes>& changes = data_point.get_ready_changes();
+    this->put(changes.has_value());
+
+    if (changes.has_value()) {
+        this->put(changes->enqueued.size());
+        for (const Process_Data* process : changes->enqueued) this->put(this->index_of(process));
+        this->put((changes->dispatched != nullptr) ? this->index_of(changes->dispatched) + 1 : 0);
+    }
+
+    // The changes of the waiting list, by index of the process.
+    const std::optional<Data_Point::waiting_changes>& io_changes = data_point.get_waiting_changes();
+    this->put(io_changes.has_value());
+    if (!io_changes.has_value()) return;
+
+    for (const std::vector<const Process_Data*>* processes : { &io_changes->completed, &io_changes->started }) {
+        this->put(processes->size());
+        for (const Process_Data* process : *processes) this->put(this->index_of(process));
+    }
+}
+
+/// <summary>
+/// Read the next value. Past the end, the checkpoint becomes invalid and 0 is returned.
+/// </summary>
+unsigned long long OS_Scheduler_Simulator::Engine::Checkpoint::get() {
+    unsigned long long value{ 0 };
+
+    for (unsigned shift{ 0 }; shift < 64; shift += 7) {
+        if (this->position >= this->bytes.size()) break;
+
+        const unsigned char byte = this->bytes.at(this->position++);
+        value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return value;
+    }
+
+    this->valid = false;
+    return 0;
+}
+
+long long OS_Scheduler_Simulator::Engine::Checkpoint::get_signed() {
+    const unsigned long long value = this->get();
+    return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+double OS_Scheduler_Simulator::Engine::Checkpoint::get_double() {
+    return std::bit_cast<double>(this->get());
+}
+
+std::string OS_Scheduler_Simulator::Engine::Checkpoint::get_string() {
+    const unsigned long long size = this->get();
+
+    if (size > this->bytes.size() - this->position) {
+        this->valid = false;
+        return std::string();
+    }
+
+    std::string value(this->bytes.begin() + this->position, this->bytes.begin() + this->position + size);
+    this->position += size;
+    return value;
+}
+
+OS_Scheduler_Simulator::Engine::Running_Process OS_Scheduler_Simulator::Engine::Checkpoint::get_process() {
+    const unsigned long long index = this->get();
+    if (index == 0) return Running_Process(nullptr);
+
+    const Process_Data* process = this->get_process_data(index - 1);
+    const unsigned long long status = this->get();
+    const unsigned long long operation = this->get();
+    const unsigned time_in_operation = static_cast<unsigned>(this->get());
+    const unsigned level = static_cast<unsigned>(this->get());
+    const unsigned switch_overhead = static_cast<unsigned>(this->get());
+
+    if (process == nullptr || status > Running_Process::status_type::done || operation >= process->get_operations_size()) {
+        this->valid = false;
+        return Running_Process(nullptr);
+    }
+
+    return Running_Process(process, static_cast<Running_Process::status_type>(status), operation, time_in_operation, level, switch_overhead);
+}
+
+std::list<OS_Scheduler_Simulator::Engine::Running_Process> OS_Scheduler_Simulator::Engine::Checkpoint::get_processes() {
+    std::list<Running_Process> processes;
+
+    for (unsigned long long count = this->get(); count > 0 && this->valid; count--) {
+        const Running_Process process = this->get_process();
+
+        if (!process.is_valid()) this->valid = false;
+        else processes.push_back(process);
+    }
+
+    return processes;
+}
+
+OS_Scheduler_Simulator::Engine::Data_Point OS_Scheduler_Simulator::Engine::Checkpoint::get_point() {
+    const unsigned time = static_cast<unsigned>(this->get());
+    const Running_Process running = this->get_process();
+    const bool queues_recorded = this->get() != 0;
+    const unsigned long long ready_count = (queues_recorded) ? 0 : this->get();
+    const unsigned long long waiting_count = (queues_recorded) ? 0 : this->get();
+    std::vector<Data_Point::ready_level> ready_levels;
+
+    // Every level takes at least two bytes, so a corrupted count cannot allocate more than the checkpoint holds.
+    for (unsigned long long levels = (queues_recorded) ? this->get() : 0; levels > 0 && this->valid; levels--) {
+        const unsigned level = static_cast<unsigned>(this->get());
+        ready_levels.push_back(Data_Point::ready_level{ .level = level, .processes = this->get_processes() });
+    }
+
+    Data_Point data_point = (queues_recorded) ? Data_Point(time, this->get_processes(), std::move(ready_levels), running)
+                                              : Data_Point(time, static_cast<size_t>(waiting_count), static_cast<size_t>(ready_count), running);
+
+    if (this->get() != 0) {
+        Data_Point::ready_changes changes{ .enqueued = {}, .dispatched = nullptr };
+
+        for (unsigned long long count = this->get(); count > 0 && this->valid; count--) {
+            const Process_Data* process = this->get_process_data(static_cast<size_t>(this->get()));
+
+            if (process == nullptr) this->valid = false;
+            else changes.enqueued.push_back(process);
+        }
+
+        const unsigned long long dispatched = this->get();
+        if (dispatched > 0) changes.dispatched = this->get_process_data(static_cast<size_t>(dispatched - 1));
+        if (dispatched > 0 && changes.dispatched == nullptr) this->valid = false;
+
+        data_point.set_ready_changes(std::move(changes));
+    }
+
+    if (this->get() == 0) return data_point;
+
+    Data_Point::waiting_changes io_changes{ .completed = {}, .started = {} };
+
+    for (std::vector<const Process_Data*>* processes : { &io_changes.completed, &io_changes.started })
+        for (unsigned long long count = this->get(); count > 0 && this->valid; count--) {
+            const Process_Data* process = this->get_process_data(static_cast<size_t>(this->get()));
+
+            if (process == nullptr) this->valid = false;
+            else processes->push_back(process);
+        }
+
+    data_point.set_waiting_changes(std::move(io_changes));
+    return data_point;
+}
+
+/// <summary>
+/// Write the checkpoint to a file, replacing the previous one only once the new one is complete.
+/// </summary>
+/// <returns>True if the file was written.</returns>
+bool OS_Scheduler_Simulator::Engine::Checkpoint::save(const std::string& path, std::string* error) const {
+    const std::string temporary = path + ".tmp";
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open()) {
+            if (error != nullptr) *error = "could not create \"" + temporary + "\"";
+            return false;
+        }
+
+        unsigned long long checksum = fnv_offset;
+        hash_bytes(checksum, this->bytes.data(), this->bytes.size());
+
+        file.write(magic, sizeof(magic));
+        write_fixed(file, this->fingerprint);
+        write_fixed(file, this->bytes.size());
+        file.write(reinterpret_cast<const char*>(this->bytes.data()), static_cast<std::streamsize>(this->bytes.size()));
+        write_fixed(file, checksum);
+        file.flush();
+
+        if (!file) {
+            if (error != nullptr) *error = "could not write \"" + temporary + "\"";
+            return false;
+        }
+    }
+
+    std::error_code code;
+    std::filesystem::rename(temporary, path, code);
+
+    if (code) {
+        if (error != nullptr) *error = "could not replace \"" + path + "\": " + code.message();
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Read a checkpoint written by save(). Values are then read from the start.
+/// </summary>
+/// <returns>True if the file is a complete checkpoint of the same workload.</returns>
+bool OS_Scheduler_Simulator::Engine::Checkpoint::load(const std::string& path, std::string* error) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        if (error != nullptr) *error = "could not open \"" + path + "\"";
+        return false;
+    }
+
+    char header[sizeof(magic)];
+    unsigned long long fingerprint{ 0 }, size{ 0 }, checksum{ 0 };
+
+    if (!file.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic) || !read_fixed(file, fingerprint) || !read_fixed(file, size)) {
+        if (error != nullptr) *error = "\"" + path + "\" is not a checkpoint";
+        return false;
+    }
+
+    if (fingerprint != this->fingerprint) {
+        if (error != nullptr) *error = "\"" + path + "\" was written for a different workload";
+        return false;
+    }
+
+    // The size is checked against the file before allocating anything.
+    const std::streamoff data_start = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff file_size = file.tellg();
+    file.seekg(data_start);
+
+    std::vector<unsigned char> contents;
+
+    if (file_size < data_start || size > static_cast<unsigned long long>(file_size - data_start)) file.setstate(std::ios::failbit);
+    else {
+        contents.resize(static_cast<size_t>(size));
+        file.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+    }
+
+    unsigned long long expected = fnv_offset;
+    hash_bytes(expected, contents.data(), contents.size());
+
+    if (!file || !read_fixed(file, checksum) || checksum != expected) {
+        if (error != nullptr) *error = "\"" + path + "\" is truncated or corrupted";
+        return false;
+    }
+
+    this->bytes = std::move(contents);
+    this->position = 0;
+    this->valid = true;
+    return true;
+}
+
+/// <summary>
+/// Hash everything that defines a workload: names, bursts, nice values, devices, groups, deadlines and periods.
+/// </summary>
+unsigned long long OS_Scheduler_Simulator::Engine::Checkpoint::get_fingerprint(const std::vector<Process_Data>& processes) {
+    unsigned long long hash = fnv_offset;
+    hash_value(hash, processes.size());
+
+    for (const Process_Data& process : processes) {
+        const std::string name = process.get_name();
+        hash_value(hash, name.size());
+        hash_bytes(hash, name.data(), name.size());
+
+        hash_value(hash, process.get_operations_size());
+        for (size_t i{ 0 }; i < process.get_operations_size(); i++) hash_value(hash, process.get_operation(i));
+
+        hash_value(hash, static_cast<unsigned long long>(static_cast<long long>(process.get_nice())));
+        hash_value(hash, process.get_period());
+
+        hash_value(hash, process.get_deadlines().size());
+        for (unsigned deadline : process.get_deadlines()) hash_value(hash, deadline);
+
+        const IO_Device* device = process.get_io_device().get();
+        hash_value(hash, (device != nullptr) ? device->get_channels() : 0);
+        if (device != nullptr) hash_bytes(hash, device->get_name().data(), device->get_name().size());
+
+        // The whole path of the group, from the process up.
+        for (const Process_Group* group = process.get_group().get(); group != nullptr; group = group->get_parent().get()) {
+            hash_value(hash, group->get_weight());
+            hash_value(hash, group->get_quota());
+            hash_value(hash, group->get_period());
+            hash_bytes(hash, group->get_name().data(), group->get_name().size());
+        }
+
+        // Only hashed when present, so the fingerprints of workloads without dependencies stay the same.
+        if (process.has_dependencies() || process.get_barrier() != 0) {
+            hash_value(hash, process.get_barrier());
+            hash_value(hash, process.get_predecessors().size());
+            for (unsigned predecessor : process.get_predecessors()) hash_value(hash, predecessor);
+            hash_value(hash, process.get_awaited_barriers().size());
+            for (unsigned barrier : process.get_awaited_barriers()) hash_value(hash, barrier);
+        }
+
+        if (process.get_arrival() > 0) hash_value(hash, process.get_arrival());
+    }
+
+    return hash;
+}
@@ -0,0 +1,67 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_CHECKPOINT_
+#define _OS_SCHEDULER_SIMULATOR_CHECKPOINT_
+
+#include "engine.h"
+
+#include <string>
+#include <list>
+#include <vector>
+
+/// <summary>
+/// In-flight state of a run, saved to a binary file so the run can be continued after the program stops (see
+/// Simulation::run_with_checkpoints and Simulation::resume_from_checkpoint).
+///
+/// A checkpoint is a flat sequence of values, written by every component in a fixed order: the run itself (algorithm, switch costs,
+/// points committed), then the Evaluator, then the algorithm. Each component reads its part back in the same order. Numbers are stored as
+/// variable-length integers and processes as their index in the vector of processes, so a checkpoint takes a few bytes per process.
+///
+/// The file starts with a fingerprint of the workload, so a checkpoint is never resumed against different processes, and ends with a
+/// checksum of its contents. It is written to a temporary file first and then renamed, so a run killed while saving keeps the previous
+/// checkpoint.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Checkpoint {
+public:
+	Checkpoint(const std::vector<Process_Data>& processes);
+
+	void clear();
+
+	void put(unsigned long long value);
+	void put_signed(long long value);
+	void put_double(double value);
+	void put_string(const std::string& value);
+	void put_process(const Running_Process& process);
+	void put_processes(const std::list<Running_Process>& processes);
+	void put_point(const Data_Point& data_point);
+
+	unsigned long long get();
+	long long get_signed();
+	double get_double();
+	std::string get_string();
+	Running_Process get_process();
+	std::list<Running_Process> get_processes();
+	Data_Point get_point();
+
+	/// <summary>Get the index of a process in the vector of processes of the checkpoint.</summary>
+	size_t index_of(const Process_Data* process) const { return process - this->first_process; }
+	const Process_Data* get_process_data(size_t index) const { return (index < this->process_count) ? this->first_process + index : nullptr; }
+
+	/// <summary>Check that every value read so far was in the checkpoint and referred to an existing process.</summary>
+	bool is_valid() const { return this->valid; }
+	bool at_end() const { return this->position == this->bytes.size(); }
+
+	bool save(const std::string& path, std::string* error = nullptr) const;
+	bool load(const std::string& path, std::string* error = nullptr);
+
+	static unsigned long long get_fingerprint(const std::vector<Process_Data>& processes);
+
+private:
+	const Process_Data* first_process;
+	size_t process_count;
+	unsigned long long fingerprint;
+
+	std::vector<unsigned char> bytes;
+	size_t position;                  // Next byte to read.
+	bool valid;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#include "context_switches.h"
+#include "checkpoint.h"
+
+#include <vector>
+#include <algorithm>
+
+/// <summary>
+/// Context_Switches constructor.
+/// </summary>
+/// <param name="processes">- Processes of the simulation. Running_Process::get_process_data() must point into this vector.</param>
+/// <param name="timeline">- Timeline being populated, holding the costs.</param>
+OS_Scheduler_Simulator::Engine::Context_Switches::Context_Switches(const std::vector<Process_Data>& processes, const Timeline& timeline)
+    : costs(timeline.get_switch_costs()), enabled(false), first_process(processes.data()), left_cpu_at(), has_run(), on_cpu(nullptr), last_on_cpu(nullptr) {
+    this->enabled = this->costs.switch_cost > 0 || this->costs.cache_penalty > 0;
+
+    if (this->enabled) {
+        this->left_cpu_at.assign(processes.size(), 0);
+        this->has_run.assign(processes.size(), false);
+    }
+}
+
+/// <summary>
+/// Charge the switch to the process on the CPU, if it was just dispatched. Free when no costs are set.
+/// </summary>
+/// <param name="running">- Process on the CPU in the point about to be committed (invalid if the CPU is idle).</param>
+/// <param name="time">- Time of the point.</param>
+void OS_Scheduler_Simulator::Engine::Context_Switches::charge(Running_Process& running, unsigned time) {
+    if (!this->enabled) return;
+
+    const Process_Data* dispatched = (running.is_valid()) ? running.get_process_data() : nullptr;
+    if (dispatched == this->on_cpu) return; // Still running, or still idle.
+
+    if (this->on_cpu != nullptr) this->left_cpu_at.at(this->on_cpu - this->first_process) = time;
+    this->on_cpu = dispatched;
+
+    // Nothing ran in between, so the process finds its state and its cache as it left them.
+    if (dispatched == nullptr || dispatched == this->last_on_cpu) return;
+
+    const size_t i = dispatched - this->first_process;
+    unsigned cache_cost = this->costs.cache_penalty;
+
+    if (this->has_run.at(i) && this->costs.cache_decay > 0) {
+        const unsigned long long off_cpu = std::min<unsigned long long>(time - this->left_cpu_at.at(i), this->costs.cache_decay);
+        cache_cost = static_cast<unsigned>((off_cpu * this->costs.cache_penalty + this->costs.cache_decay - 1) / this->costs.cache_decay);
+    }
+
+    running.add_switch_overhead(this->costs.switch_cost + cache_cost);
+    this->has_run.at(i) = true;
+    this->last_on_cpu = dispatched;
+}
+
+/// <summary>
+/// Save when every process last ran, for a run resumed with the same costs. Nothing is saved when switches are free.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Context_Switches::save_state(Checkpoint& checkpoint) const {
+    if (!this->enabled) return;
+
+    for (size_t i{ 0 }; i < this->left_cpu_at.size(); i++) {
+        checkpoint.put(this->left_cpu_at.at(i));
+        checkpoint.put(this->has_run.at(i));
+    }
+
+    // Index plus one, 0 for none.
+    checkpoint.put((this->on_cpu != nullptr) ? checkpoint.index_of(this->on_cpu) + 1 : 0);
+    checkpoint.put((this->last_on_cpu != nullptr) ? checkpoint.index_of(this->last_on_cpu) + 1 : 0);
+}
+
+void OS_Scheduler_Simulator::Engine::Context_Switches::load_state(Checkpoint& checkpoint) {
+    if (!this->enabled) return;
+
+    for (size_t i{ 0 }; i < this->left_cpu_at.size(); i++) {
+        this->left_cpu_at.at(i) = static_cast<unsigned>(checkpoint.get());
+        this->has_run.at(i) = checkpoint.get() != 0;
+    }
+
+    const unsigned long long on_cpu = checkpoint.get();
+    const unsigned long long last_on_cpu = checkpoint.get();
+
+    this->on_cpu = (on_cpu > 0) ? checkpoint.get_process_data(on_cpu - 1) : nullptr;
+    this->last_on_cpu = (last_on_cpu > 0) ? checkpoint.get_process_data(last_on_cpu - 1) : nullptr;
+}
@@ -0,0 +1,40 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_CONTEXT_SWITCHES_
+#define _OS_SCHEDULER_SIMULATOR_CONTEXT_SWITCHES_
+
+#include "engine.h"
+
+#include <vector>
+
+/// <summary>
+/// Charges the context switches of an algorithm, using the costs set on its timeline (Timeline::set_switch_costs).
+///
+/// A process dispatched after a different one pays the switch cost plus a cache penalty that grows linearly with the time it spent off
+/// the CPU, up to the full penalty once cache_decay has passed (and for its first run). A process that gets the CPU back with nothing
+/// else running in between pays nothing. The cost is added to the Running_Process as switch overhead: it keeps the CPU busy without
+/// progressing the burst, so the Data_Points, the events and the evaluation see it without any change, and the Evaluator reports it
+/// apart from useful work.
+///
+/// Algorithms call charge() with the process on the CPU right before committing every Data_Point. Processes only leave the CPU at those
+/// points, so that is enough to know when each process last ran.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Context_Switches {
+public:
+	Context_Switches(const std::vector<Process_Data>& processes, const Timeline& timeline);
+
+	void charge(Running_Process& running, unsigned time);
+
+	void save_state(Checkpoint& checkpoint) const;
+	void load_state(Checkpoint& checkpoint);
+
+private:
+	Timeline::switch_costs costs;
+	bool enabled;
+
+	const Process_Data* first_process;
+	std::vector<unsigned> left_cpu_at;  // Last time every process left the CPU.
+	std::vector<bool> has_run;
+	const Process_Data* on_cpu;         // Process on the CPU at the last commit, if any.
+	const Process_Data* last_on_cpu;    // Last process that was on the CPU, even if it is idle now.
+};
+
+#endif
@@ -0,0 +1,250 @@
+#include "dependency_graph.h"
+#include "checkpoint.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
+
+namespace {
+    constexpr size_t no_node = std::numeric_limits<size_t>::max();
+}
+
+/// <summary>
+/// Dependency_Graph constructor. Invalid dependencies (unknown processes, a process depending on itself, cycles) are left out or never
+/// released; see is_valid.
+/// </summary>
+/// <param name="processes">- Processes of the workload. Their predecessors are indices in this vector.</param>
+OS_Scheduler_Simulator::Engine::Dependency_Graph::Dependency_Graph(const std::vector<Process_Data>& processes)
+    : process_count(processes.size()), dependent_processes(0), first_successor(), successors(), predecessor_count(), remaining(), work(processes.size(), 0),
+    dependency_bound(0), cpu_bound(0), problem() {
+    // Barriers become nodes after the processes, in order of first appearance.
+    std::unordered_map<unsigned, size_t> barrier_nodes;
+
+    auto barrier_node = [this, &barrier_nodes](unsigned barrier) {
+        return barrier_nodes.emplace(barrier, this->process_count + barrier_nodes.size()).first->second;
+    };
+
+    for (const Process_Data& process : processes) {
+        if (process.get_barrier() != 0) barrier_node(process.get_barrier());
+        for (unsigned barrier : process.get_awaited_barriers()) if (barrier != 0) barrier_node(barrier);
+    }
+
+    const size_t nodes = this->process_count + barrier_nodes.size();
+
+    // Every edge is visited twice, to count the successors of every node and then to place them.
+    auto for_each_edge = [&](auto&& add) {
+        for (size_t i{ 0 }; i < this->process_count; i++) {
+            const Process_Data& process = processes.at(i);
+
+            for (unsigned predecessor : process.get_predecessors()) {
+                if (predecessor >= this->process_count || predecessor == i) {
+                    if (this->problem.empty()) this->problem = "process \"" + process.get_name() + "\" depends on " + ((predecessor == i) ? "itself" : "unknown process " + std::to_string(predecessor));
+                    continue;
+                }
+
+                add(predecessor, i);
+            }
+
+            for (unsigned barrier : process.get_awaited_barriers()) {
+                if (barrier == 0) {
+                    if (this->problem.empty()) this->problem = "process \"" + process.get_name() + "\" awaits barrier 0";
+                    continue;
+                }
+
+                add(barrier_nodes.at(barrier), i);
+            }
+
+            if (process.get_barrier() != 0) add(i, barrier_nodes.at(process.get_barrier()));
+        }
+    };
+
+    this->first_successor.assign(nodes + 1, 0);
+    this->predecessor_count.assign(nodes, 0);
+
+    for_each_edge([this](size_t from, size_t to) {
+        this->first_successor.at(from + 1)++;
+        this->predecessor_count.at(to)++;
+    });
+
+    for (size_t node{ 0 }; node < nodes; node++) this->first_successor.at(node + 1) += this->first_successor.at(node);
+
+    this->successors.assign(this->first_successor.back(), 0);
+    std::vector<size_t> cursor(this->first_successor.begin(), this->first_successor.end() - 1);
+
+    for_each_edge([this, &cursor](size_t from, size_t to) { this->successors.at(cursor.at(from)++) = to; });
+
+    for (size_t i{ 0 }; i < this->process_count; i++) {
+        const Process_Data& process = processes.at(i);
+        if (this->predecessor_count.at(i) > 0) this->dependent_processes++;
+
+        for (size_t operation{ 0 }; operation < process.get_operations_size(); operation++) {
+            this->work.at(i) += process.get_operation(operation);
+            if (operation % 2 == 0) this->cpu_bound += process.get_operation(operation);
+        }
+    }
+
+    // Longest chain, in topological order. Nodes left unvisited are on a cycle.
+    std::vector<unsigned> pending = this->predecessor_count;
+    std::vector<unsigned long long> start(nodes, 0);
+    std::vector<size_t> ready;
+    size_t visited{ 0 };
+
+    for (size_t node{ 0 }; node < nodes; node++) if (pending.at(node) == 0) ready.push_back(node);
+
+    while (!ready.empty()) {
+        const size_t node = ready.back();
+        ready.pop_back();
+        visited++;
+
+        const unsigned long long end = start.at(node) + ((node < this->process_count) ? this->work.at(node) : 0);
+        this->dependency_bound = std::max(this->dependency_bound, end);
+
+        for (size_t edge{ this->first_successor.at(node) }; edge < this->first_successor.at(node + 1); edge++) {
+            const size_t successor = this->successors.at(edge);
+            start.at(successor) = std::max(start.at(successor), end);
+            if (--pending.at(successor) == 0) ready.push_back(successor);
+        }
+    }
+
+    if (visited < nodes && this->problem.empty()) this->problem = "the dependencies have a cycle";
+
+    this->reset();
+}
+
+/// <summary>
+/// Check that every dependency refers to an existing process and that there are no cycles. Processes on a cycle are never released.
+/// </summary>
+/// <param name="error">- Optional description of the first problem found.</param>
+bool OS_Scheduler_Simulator::Engine::Dependency_Graph::is_valid(std::string* error) const {
+    if (!this->problem.empty() && error != nullptr) *error = this->problem;
+    return this->problem.empty();
+}
+
+/// <summary>
+/// Start a new run: nothing is done, so only the processes without dependencies (or only on barriers without members) are released.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Dependency_Graph::reset() {
+    this->remaining = this->predecessor_count;
+
+    std::vector<size_t> released;
+    for (size_t node{ this->process_count }; node < this->remaining.size(); node++)
+        if (this->remaining.at(node) == 0) this->propagate(node, released);
+}
+
+/// <summary>
+/// Mark a process as done.
+/// </summary>
+/// <param name="process">- Index of the process.</param>
+/// <param name="released">- Processes released by it are appended here, in index order.</param>
+void OS_Scheduler_Simulator::Engine::Dependency_Graph::finish(size_t process, std::vector<size_t>& released) {
+    const size_t first = released.size();
+    this->propagate(process, released);
+    std::sort(released.begin() + static_cast<std::ptrdiff_t>(first), released.end());
+}
+
+/// <summary>
+/// Save the dependencies still pending, for Policy_Runner::save_state.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Dependency_Graph::save_state(Checkpoint& checkpoint) const {
+    checkpoint.put(this->remaining.size());
+    for (unsigned count : this->remaining) checkpoint.put(count);
+}
+
+void OS_Scheduler_Simulator::Engine::Dependency_Graph::load_state(Checkpoint& checkpoint) {
+    const size_t count = static_cast<size_t>(checkpoint.get());
+
+    for (size_t node{ 0 }; node < count; node++) {
+        const unsigned value = static_cast<unsigned>(checkpoint.get());
+        if (node < this->remaining.size()) this->remaining.at(node) = value;
+    }
+}
+
+/// <summary>
+/// Split the makespan of a run over the chain of processes that ended last.
+/// </summary>
+/// <param name="evaluation">- Evaluation of every process of the run (Simulation::get_per_process_evaluation), in order.</param>
+/// <param name="makespan">- Execution time of the run.</param>
+OS_Scheduler_Simulator::Engine::Dependency_Graph::critical_path_report OS_Scheduler_Simulator::Engine::Dependency_Graph::get_critical_path(const std::vector<Evaluator::Process>& evaluation, unsigned makespan) const {
+    critical_path_report report{ .makespan = makespan, .dependency_bound = this->dependency_bound, .cpu_bound = this->cpu_bound, .critical_path = {}, .path_work = 0, .path_waiting = 0 };
+    if (evaluation.size() != this->process_count || this->process_count == 0) return report;
+
+    const size_t nodes = this->predecessor_count.size();
+    std::vector<unsigned> end(nodes, 0);
+    std::vector<unsigned> release(nodes, 0);
+    std::vector<size_t> binding(nodes, no_node);   // Predecessor that ended last.
+
+    // Turnaround times count from the arrival of the processes, which is also when the ones without predecessors are released.
+    for (size_t i{ 0 }; i < this->process_count; i++) {
+        const Process_Data* process = evaluation.at(i).get_process_addr();
+
+        release.at(i) = (process != nullptr) ? process->get_arrival() : 0;
+        end.at(i) = release.at(i) + evaluation.at(i).get_turnaround_time();
+    }
+
+    // Barriers only have processes as predecessors, so they are done once their last member is.
+    for (size_t i{ 0 }; i < this->process_count; i++)
+        for (size_t edge{ this->first_successor.at(i) }; edge < this->first_successor.at(i + 1); edge++) {
+            const size_t barrier = this->successors.at(edge);
+
+            if (barrier >= this->process_count && (binding.at(barrier) == no_node || end.at(i) > end.at(barrier))) {
+                end.at(barrier) = end.at(i);
+                binding.at(barrier) = i;
+            }
+        }
+
+    for (size_t node{ 0 }; node < nodes; node++)
+        for (size_t edge{ this->first_successor.at(node) }; edge < this->first_successor.at(node + 1); edge++) {
+            const size_t process = this->successors.at(edge);
+
+            // A process arriving after all its predecessors ended is released by its arrival.
+            if (process < this->process_count && ((binding.at(process) == no_node && end.at(node) >= release.at(process)) || end.at(node) > release.at(process))) {
+                release.at(process) = end.at(node);
+                binding.at(process) = node;
+            }
+        }
+
+    size_t current = static_cast<size_t>(std::max_element(end.begin(), end.begin() + static_cast<std::ptrdiff_t>(this->process_count)) - end.begin());
+
+    while (current != no_node && report.critical_path.size() < this->process_count) {
+        const unsigned long long span = end.at(current) - std::min(end.at(current), release.at(current));
+
+        report.critical_path.push_back(current);
+        report.path_work += this->work.at(current);
+        report.path_waiting += span - std::min(span, this->work.at(current));
+
+        current = binding.at(current);
+        if (current != no_node && current >= this->process_count) current = binding.at(current);
+    }
+
+    std::reverse(report.critical_path.begin(), report.critical_path.end());
+    return report;
+}
+
+/// <summary>
+/// Check if any process of a workload waits for another one or for a barrier, before building a graph.
+/// </summary>
+bool OS_Scheduler_Simulator::Engine::Dependency_Graph::has_dependencies(const std::vector<Process_Data>& processes) {
+    return std::any_of(processes.begin(), processes.end(), [](const Process_Data& process) { return process.has_dependencies(); });
+}
+
+/// <summary>
+/// Mark a node as done and release its successors, going through the barriers that are done in turn.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Dependency_Graph::propagate(size_t node, std::vector<size_t>& released) {
+    std::vector<size_t> done{ node };
+
+    while (!done.empty()) {
+        const size_t current = done.back();
+        done.pop_back();
+
+        for (size_t edge{ this->first_successor.at(current) }; edge < this->first_successor.at(current + 1); edge++) {
+            const size_t successor = this->successors.at(edge);
+            if (this->remaining.at(successor) == 0 || --this->remaining.at(successor) > 0) continue;
+
+            if (successor < this->process_count) released.push_back(successor);
+            else done.push_back(successor);
+        }
+    }
+}
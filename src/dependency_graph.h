@@ -0,0 +1,68 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_DEPENDENCY_GRAPH_
+#define _OS_SCHEDULER_SIMULATOR_DEPENDENCY_GRAPH_
+
+#include "engine.h"
+
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Dependencies between the processes of a workload (see Process_Data::set_predecessors and Process_Data::set_barrier): a process becomes
+/// ready only once all its predecessors and all the barriers it awaits are done. A barrier is done once all its members are; a barrier
+/// without members is done from the start.
+///
+/// Processes and barriers are the nodes of the graph, and its edges are stored as flat successor lists, so building the graph, releasing
+/// processes over a whole run and the analysis all take time linear in the processes and dependencies. The algorithms keep a graph for
+/// every run: processes that are not released yet are in none of the lists of the Data_Points, so they count as neither ready nor waiting.
+///
+/// After a run, get_critical_path follows the chain of processes that ended last back to the start, each process to the predecessor that
+/// released it. Over that chain the makespan splits exactly into the bursts of its processes, which the dependencies impose whatever the
+/// scheduler does, and the time they spent ready, queued for a device or switching after being released, which is down to the scheduler.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Dependency_Graph {
+public:
+	typedef struct {
+		unsigned makespan;
+		unsigned long long dependency_bound;     // Longest chain of dependencies, each process taking the sum of its bursts.
+		unsigned long long cpu_bound;            // Sum of the CPU bursts of every process.
+		std::vector<size_t> critical_path;       // Processes of the chain that ended last, from the start.
+		unsigned long long path_work;            // Bursts of the processes of the chain.
+		unsigned long long path_waiting;         // Time between release and end of the processes of the chain not spent on their bursts.
+	} critical_path_report;
+
+	Dependency_Graph(const std::vector<Process_Data>& processes);
+
+	bool is_valid(std::string* error = nullptr) const;
+
+	/// <summary>Check if any process waits for another one or for a barrier.</summary>
+	bool has_dependencies() const { return this->dependent_processes > 0; }
+
+	void reset();
+	void finish(size_t process, std::vector<size_t>& released);
+
+	/// <summary>Check if a process is released: everything it depends on is done.</summary>
+	bool is_released(size_t process) const { return this->remaining.at(process) == 0; }
+
+	void save_state(Checkpoint& checkpoint) const;
+	void load_state(Checkpoint& checkpoint);
+
+	critical_path_report get_critical_path(const std::vector<Evaluator::Process>& evaluation, unsigned makespan) const;
+
+	static bool has_dependencies(const std::vector<Process_Data>& processes);
+
+private:
+	void propagate(size_t node, std::vector<size_t>& released);
+
+	size_t process_count;                        // Nodes from process_count on are barriers.
+	size_t dependent_processes;
+	std::vector<size_t> first_successor;         // Successors of node i are successors[first_successor[i]] to successors[first_successor[i + 1] - 1].
+	std::vector<size_t> successors;
+	std::vector<unsigned> predecessor_count;
+	std::vector<unsigned> remaining;             // Predecessors of every node not done yet.
+	std::vector<unsigned long long> work;        // Sum of the bursts of every process.
+	unsigned long long dependency_bound;
+	unsigned long long cpu_bound;
+	std::string problem;
+};
+
+#endif
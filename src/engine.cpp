@@ -1,22 +1,40 @@
 #include "engine.h"
+#include "algorithms.h"
+#include "perf_counters.h"
+#include "io_device.h"
+#include "process_group.h"
+#include "context_switches.h"
+#include "timeline_spill.h"
+#include "checkpoint.h"
+#include "interval_index.h"
+#include "shared_prefix_runner.h"
+#include "burst_store.h"
+#include "dependency_graph.h"
 
 #include <string>
 #include <list>
 #include <vector>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <algorithm>
 
 #ifdef _DEBUG
 #include <iostream>
 #endif // _DEBUG
 
+const OS_Scheduler_Simulator::Engine::Process_Data::extra_settings OS_Scheduler_Simulator::Engine::Process_Data::no_extras{
+    .io_device = nullptr, .group = nullptr, .deadlines = {}, .period = 0, .barrier = 0, .predecessors = {}, .awaited_barriers = {}, .arrival = 0 };
+
 /// <summary>
 /// Process_Data constructor.
 /// </summary>
 /// <param name="name">- Name of the process.</param>
 /// <param name="operations_list">- List of unsigned numbers representing the CPU and I/O bursts.</param>
 OS_Scheduler_Simulator::Engine::Process_Data::Process_Data(std::string name, std::span<unsigned> operations_list) 
-    : name(name), operations(operations_list.size()) {
+    : name(name), operations(operations_list.size()), packed_operations(nullptr), packed_first(0), packed_size(0), nice(0), extras() {
     for (unsigned i{ 0 }; i < operations_list.size(); i++) this->operations.at(i) = operations_list[i];
 
 #ifdef _DEBUG
@@ -24,20 +42,104 @@ OS_Scheduler_Simulator::Engine::Process_Data::Process_Data(std::string name, std
 #endif // _DEBUG
 }
 
+/// <summary>
+/// Process_Data constructor for bursts kept in a Burst_Store. The process only keeps where its bursts are, so the store must outlive the
+/// process and all its copies.
+/// </summary>
+/// <param name="name">- Name of the process.</param>
+/// <param name="store">- Store holding the bursts.</param>
+/// <param name="first_operation">- Index in the store of the first burst, as returned by Burst_Store::append.</param>
+/// <param name="operations_size">- Number of CPU and I/O bursts.</param>
+OS_Scheduler_Simulator::Engine::Process_Data::Process_Data(std::string name, const Burst_Store* store, size_t first_operation, size_t operations_size)
+    : name(name), operations(), packed_operations(store), packed_first(first_operation), packed_size(static_cast<unsigned>(operations_size)), nice(0), extras() {
+#ifdef _DEBUG
+    if (operations_size % 2 == 0) std::cerr << "Critial error: Process_Data for process \"" << name << "\" was initialized with even size amount of operations." << std::endl;
+#endif // _DEBUG
+}
+
+OS_Scheduler_Simulator::Engine::Process_Data::Process_Data(const Process_Data& other)
+    : name(other.name), operations(other.operations), packed_operations(other.packed_operations), packed_first(other.packed_first), packed_size(other.packed_size), nice(other.nice),
+      extras((other.extras != nullptr) ? std::make_unique<extra_settings>(*other.extras) : nullptr) {}
+
+OS_Scheduler_Simulator::Engine::Process_Data& OS_Scheduler_Simulator::Engine::Process_Data::operator=(const Process_Data& other) {
+    if (this != &other) *this = Process_Data(other);
+    return *this;
+}
+
+/// <summary>
+/// Get the settings kept apart to change one, allocating them with their defaults the first time.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Process_Data::extra_settings& OS_Scheduler_Simulator::Engine::Process_Data::edit_extras() {
+    if (this->extras == nullptr) this->extras = std::make_unique<extra_settings>(no_extras);
+    return *this->extras;
+}
+
+/// <summary>
+/// Read a burst from the Burst_Store. Past the bursts of the process, fails as get_operation does with its own bursts.
+/// </summary>
+unsigned OS_Scheduler_Simulator::Engine::Process_Data::get_packed_operation(size_t i) const {
+    return this->packed_operations->get(this->packed_first + ((i < this->packed_size) ? i : this->packed_operations->size()));
+}
+
+/// <summary>
+/// Get the relative deadline of a CPU burst.
+/// </summary>
+/// <param name="operation">- Index of the CPU burst in the list of operations.</param>
+/// <returns>Time the burst has to complete after it becomes ready, or 0 if it has no deadline.</returns>
+unsigned OS_Scheduler_Simulator::Engine::Process_Data::get_deadline(size_t operation) const {
+    const std::vector<unsigned>& deadlines = this->get_extras().deadlines;
+
+    if (deadlines.empty()) return this->get_extras().period;
+    return deadlines.at(std::min(operation / 2, deadlines.size() - 1));
+}
+
+/// <summary>
+/// Check if any process arrives after the start (see set_arrival).
+/// </summary>
+bool OS_Scheduler_Simulator::Engine::Process_Data::has_arrivals(const std::vector<Process_Data>& processes) {
+    return std::any_of(processes.begin(), processes.end(), [](const Process_Data& process) { return process.get_arrival() > 0; });
+}
+
+/// <summary>
+/// Get a copy of the process with only its first operations, keeping every other setting.
+/// </summary>
+/// <param name="operations">- Number of operations kept. Odd, so the process still ends with a CPU burst.</param>
+OS_Scheduler_Simulator::Engine::Process_Data OS_Scheduler_Simulator::Engine::Process_Data::get_prefix(size_t operations) const {
+    Process_Data prefix = *this;
+    prefix.operations.resize(std::min(operations, this->operations.size()));
+    prefix.packed_size = static_cast<unsigned>(std::min<size_t>(operations, this->packed_size));
+    return prefix;
+}
+
 OS_Scheduler_Simulator::Engine::Running_Process::Running_Process(const OS_Scheduler_Simulator::Engine::Process_Data* process) 
     : process(process), status(OS_Scheduler_Simulator::Engine::Running_Process::status_type::ready), 
-    current_operation(0), time_in_current_operation(0) {}
+    current_operation(0), time_in_current_operation(0), level(0), switch_overhead(0) {}
+
+/// <summary>
+/// Rebuild a Running_Process from its state, as stored by the Timeline_Spill.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Running_Process::Running_Process(const Process_Data* process, status_type status, size_t operation, unsigned time_in_operation, unsigned level, unsigned switch_overhead)
+    : process(process), status(status), current_operation(operation), time_in_current_operation(time_in_operation), level(level), switch_overhead(switch_overhead) {}
 
 unsigned OS_Scheduler_Simulator::Engine::Running_Process::time_to_end_current_burst() const {
     unsigned time{ 0 };
     
     if (this->process != nullptr && this->current_operation < this->process->get_operations_size())
-        time = this->process->get_operation(this->current_operation) - time_in_current_operation;
+        time = this->process->get_operation(this->current_operation) - time_in_current_operation + this->switch_overhead;
 
     return time;
 }
 
 OS_Scheduler_Simulator::Engine::Running_Process OS_Scheduler_Simulator::Engine::Running_Process::get_next_process_state(unsigned time) const {
+    // The switch overhead is spent first; the burst only progresses after it.
+    if (this->switch_overhead > 0 && this->status == status_type::running) {
+        Running_Process switched = (*this);
+        const unsigned switching = std::min(time, this->switch_overhead);
+
+        switched.switch_overhead -= switching;
+        return (switching == time) ? switched : switched.get_next_process_state(time - switching);
+    }
+
     OS_Scheduler_Simulator::Engine::Running_Process new_process_data(this->process);
 
     if (this->time_to_end_current_burst() < time || this->status == status_type::done || this->status == status_type::ready) {
@@ -85,23 +187,84 @@ OS_Scheduler_Simulator::Engine::Running_Process OS_Scheduler_Simulator::Engine::
 }
 
 OS_Scheduler_Simulator::Engine::Data_Point::Data_Point(const std::list<Process_Data>& starting_list)
-    : ready_list(), waiting_list(),
-    running(OS_Scheduler_Simulator::Engine::Running_Process(nullptr)), time_since_start(0) {
+    : ready_levels(), waiting_list(),
+    running(OS_Scheduler_Simulator::Engine::Running_Process(nullptr)), time_since_start(0), ready_count(starting_list.size()), waiting_count(0), queues_recorded(true), changes(), io_changes() {
+    if (starting_list.empty()) return;
+
+    this->ready_levels.push_back(ready_level{ .level = 0, .processes = {} });
     for (const Process_Data& process : starting_list)
-        ready_list.push_back(Running_Process(&process));
+        this->ready_levels.front().processes.push_back(Running_Process(&process));
 }
 
 OS_Scheduler_Simulator::Engine::Data_Point::Data_Point(const std::vector<Process_Data>& starting_list)
-    : ready_list(), waiting_list(),
-    running(OS_Scheduler_Simulator::Engine::Running_Process(nullptr)), time_since_start(0) {
+    : ready_levels(), waiting_list(),
+    running(OS_Scheduler_Simulator::Engine::Running_Process(nullptr)), time_since_start(0), ready_count(starting_list.size()), waiting_count(0), queues_recorded(true), changes(), io_changes() {
+    if (starting_list.empty()) return;
+
+    this->ready_levels.push_back(ready_level{ .level = 0, .processes = {} });
     for (const Process_Data& process : starting_list)
-        ready_list.push_back(Running_Process(&process));
+        this->ready_levels.front().processes.push_back(Running_Process(&process));
 }
 
 OS_Scheduler_Simulator::Engine::Data_Point::Data_Point(unsigned time_since_start, const std::list<Running_Process>& waiting_list, const std::list<Running_Process>& ready_list, Running_Process running_process)
-    : time_since_start(time_since_start), waiting_list(waiting_list), ready_list(ready_list), running(running_process) {}
+    : time_since_start(time_since_start), waiting_list(waiting_list), ready_levels(), running(running_process), ready_count(ready_list.size()), waiting_count(waiting_list.size()), queues_recorded(true), changes(), io_changes() {
     // Note that if receiving a null pointer for the running process, it will call the Running_Process constructor with null pointer as argument.
     // If receiving an actual Running_Process for the running_process argument, then it will be called with the defaul copy constructor (not defined here).
+    if (!ready_list.empty()) this->ready_levels.push_back(ready_level{ .level = 0, .processes = ready_list });
+}
+
+/// <summary>
+/// Data_Point constructor for multi-level algorithms, taking over the ready queue of every level (see Scheduling_Policy::get_ready_levels).
+/// </summary>
+/// <param name="ready_levels">- Queues in the order they run. Empty ones are left out.</param>
+OS_Scheduler_Simulator::Engine::Data_Point::Data_Point(unsigned time_since_start, const std::list<Running_Process>& waiting_list, std::vector<ready_level>&& ready_levels, Running_Process running_process)
+    : time_since_start(time_since_start), waiting_list(waiting_list), ready_levels(std::move(ready_levels)), running(running_process), ready_count(0), waiting_count(waiting_list.size()), queues_recorded(true), changes(), io_changes() {
+    std::erase_if(this->ready_levels, [](const ready_level& level) { return level.processes.empty(); });
+    for (const ready_level& level : this->ready_levels) this->ready_count += level.processes.size();
+}
+
+/// <summary>
+/// Data_Point constructor for timelines that do not need the queues (see Timeline::needs_queues), so building the point does not depend on
+/// how many processes are ready or waiting for I/O.
+/// </summary>
+/// <param name="waiting_count">- Processes in the waiting list.</param>
+/// <param name="ready_count">- Processes in the ready queue.</param>
+OS_Scheduler_Simulator::Engine::Data_Point::Data_Point(unsigned time_since_start, size_t waiting_count, size_t ready_count, Running_Process running_process)
+    : time_since_start(time_since_start), waiting_list(), ready_levels(), running(running_process), ready_count(ready_count), waiting_count(waiting_count), queues_recorded(false), changes(), io_changes() {}
+
+/// <summary>
+/// Get the ready queue in the order the processes run, every level after the one before. Empty if the point does not hold it (see
+/// has_ready_queue).
+/// </summary>
+std::list<OS_Scheduler_Simulator::Engine::Running_Process> OS_Scheduler_Simulator::Engine::Data_Point::get_ready_list() const {
+    if (this->ready_levels.size() == 1) return this->ready_levels.front().processes;
+
+    std::list<Running_Process> ready_list;
+    for (const ready_level& level : this->ready_levels) ready_list.insert(ready_list.end(), level.processes.begin(), level.processes.end());
+    return ready_list;
+}
+
+/// <summary>
+/// Get the ready queue of one level of a multi-level algorithm (MLFQ, Priority). Their processes carry the level plus one
+/// (Running_Process::get_level).
+/// </summary>
+/// <param name="level">- Level, 0 running first.</param>
+std::list<OS_Scheduler_Simulator::Engine::Running_Process> OS_Scheduler_Simulator::Engine::Data_Point::get_ready_level(unsigned level) const {
+    auto it = std::lower_bound(this->ready_levels.begin(), this->ready_levels.end(), level, [](const ready_level& queue, unsigned value) { return queue.level < value; });
+    return (it != this->ready_levels.end() && it->level == level) ? it->processes : std::list<Running_Process>();
+}
+
+/// <summary>
+/// Estimate the memory taken by the point and its lists, in bytes.
+/// </summary>
+size_t OS_Scheduler_Simulator::Engine::Data_Point::get_memory_size() const {
+    size_t processes = this->waiting_list.size();
+    for (const ready_level& level : this->ready_levels) processes += level.processes.size();
+
+    size_t changes = (this->changes.has_value()) ? this->changes->enqueued.size() * sizeof(const Process_Data*) : 0;
+    if (this->io_changes.has_value()) changes += (this->io_changes->completed.size() + this->io_changes->started.size()) * sizeof(const Process_Data*);
+    return sizeof(Data_Point) + this->ready_levels.size() * sizeof(ready_level) + processes * (sizeof(Running_Process) + 2 * sizeof(void*)) + changes;
+}
 
 OS_Scheduler_Simulator::Engine::Data_Point::event OS_Scheduler_Simulator::Engine::Data_Point::get_next_event() {
     unsigned shortest_time{ 0 };
@@ -121,297 +284,1437 @@ OS_Scheduler_Simulator::Engine::Data_Point::event OS_Scheduler_Simulator::Engine
             ev = event_type::io;
         }
         
-        for (const Running_Process& process : this->waiting_list) {
+        // Requests queued for a device do not progress. The first request of the list is always in service.
+        IO_Device::for_each_request(this->waiting_list, [&shortest_time, &ev](const Running_Process& process, bool in_service) {
             const unsigned time = process.time_to_end_current_burst();
-            if (time < shortest_time) {
+            if (in_service && time < shortest_time) {
                 shortest_time = time;
                 ev = event_type::io;
             }
+        });
+
+    if (!this->running.is_valid() && this->waiting_list.size() == 0) ev = event_type::done;
+
+    return event{
+        .event_type = ev,
+        .time = shortest_time
+    };
+}
+
+/// <summary>
+/// Timeline constructor.
+/// </summary>
+/// <param name="keep_history">- Keep every committed point. If false, only the latest point is kept.</param>
+OS_Scheduler_Simulator::Engine::Timeline::Timeline(bool keep_history)
+    : prefix(), prefix_points(0), prefix_pages(0), points(), keep_history(keep_history), stop(false), committed_points(0), observer(), observer_reads_queues(true), costs(switch_costs{ .switch_cost = 0, .cache_penalty = 0, .cache_decay = 0 }),
+      memory_budget(0), first_process(nullptr), resident_bytes(0), peak_resident_bytes(0), spill(),
+      checkpoint_interval(0), checkpoint_writer(), state_saver(), checkpointable(false), resume_checkpoint(nullptr), resumed(false), restarted(false) {}
+
+OS_Scheduler_Simulator::Engine::Timeline::~Timeline() {
+    this->clear();
+}
+
+OS_Scheduler_Simulator::Engine::Timeline::Timeline(Timeline&& other) noexcept
+    : prefix(std::move(other.prefix)), prefix_points(other.prefix_points), prefix_pages(other.prefix_pages), points(std::move(other.points)), keep_history(other.keep_history), stop(other.stop), committed_points(other.committed_points), observer(std::move(other.observer)), observer_reads_queues(other.observer_reads_queues), costs(other.costs),
+      memory_budget(other.memory_budget), first_process(other.first_process), resident_bytes(other.resident_bytes), peak_resident_bytes(other.peak_resident_bytes),
+      spill(std::move(other.spill)), checkpoint_interval(other.checkpoint_interval), checkpoint_writer(std::move(other.checkpoint_writer)),
+      state_saver(std::move(other.state_saver)), checkpointable(other.checkpointable), resume_checkpoint(other.resume_checkpoint), resumed(other.resumed), restarted(other.restarted) {
+    other.prefix_points = 0;
+    other.prefix_pages = 0;
+    other.points.clear();
+    other.committed_points = 0;
+    other.resident_bytes = 0;
+}
+
+OS_Scheduler_Simulator::Engine::Timeline& OS_Scheduler_Simulator::Engine::Timeline::operator=(Timeline&& other) noexcept {
+    if (this != &other) {
+        this->clear();
+        this->prefix = std::move(other.prefix);
+        this->prefix_points = other.prefix_points;
+        this->prefix_pages = other.prefix_pages;
+        this->points = std::move(other.points);
+        this->keep_history = other.keep_history;
+        this->stop = other.stop;
+        this->committed_points = other.committed_points;
+        this->observer = std::move(other.observer);
+        this->observer_reads_queues = other.observer_reads_queues;
+        this->costs = other.costs;
+        this->memory_budget = other.memory_budget;
+        this->first_process = other.first_process;
+        this->resident_bytes = other.resident_bytes;
+        this->peak_resident_bytes = other.peak_resident_bytes;
+        this->spill = std::move(other.spill);
+        this->checkpoint_interval = other.checkpoint_interval;
+        this->checkpoint_writer = std::move(other.checkpoint_writer);
+        this->state_saver = std::move(other.state_saver);
+        this->checkpointable = other.checkpointable;
+        this->resume_checkpoint = other.resume_checkpoint;
+        this->resumed = other.resumed;
+        this->restarted = other.restarted;
+
+        other.prefix_points = 0;
+        other.prefix_pages = 0;
+        other.points.clear();
+        other.committed_points = 0;
+        other.resident_bytes = 0;
+    }
+
+    return *this;
+}
+
+/// <summary>
+/// Commit a point to the timeline, which takes ownership of it.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Timeline::push_back(Data_Point* data_point) {
+    this->points.push_back(data_point);
+    this->committed_points++;
+    this->resident_bytes += sizeof(Data_Point*) + data_point->get_memory_size();
+
+    // An algorithm that does not resume starts over from the beginning, so its points must not reach the observer.
+    if (this->resume_checkpoint != nullptr) {
+        this->resume_checkpoint = nullptr;
+        this->restarted = true;
+        this->stop = true;
+    }
+
+    if (this->observer && !this->restarted) this->observer(*data_point);
+
+    if (this->checkpoint_interval > 0 && this->state_saver && !this->restarted && this->committed_points % this->checkpoint_interval == 0)
+        this->checkpoint_writer(*this);
+
+    if (!this->keep_history)
+        while (this->points.size() > 1) {
+            this->resident_bytes -= sizeof(Data_Point*) + this->points.front()->get_memory_size();
+            delete this->points.front();
+            this->points.pop_front();
+        }
+
+    const size_t cached = (this->spill != nullptr) ? this->spill->get_cached_bytes() : 0;
+    this->peak_resident_bytes = std::max(this->peak_resident_bytes, this->resident_bytes + cached);
+
+    // Half of the budget is left for the segments paged back in.
+    if (this->memory_budget > 0 && this->resident_bytes > this->memory_budget - this->memory_budget / 2) this->spill_segments();
+}
+
+/// <summary>
+/// Delete every point kept, in memory or spilled.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Timeline::clear() {
+    for (Data_Point* data_point : this->points)
+        delete data_point;
+
+    this->points.clear();
+    this->committed_points = 0;
+    this->resident_bytes = 0;
+    this->spill.reset();
+
+    this->prefix.reset();
+    this->prefix_points = 0;
+    this->prefix_pages = 0;
+}
+
+/// <summary>
+/// Continue a timeline that will not change anymore. Its points become the first points of this one, shared with every other timeline
+/// continuing it, and the next points are committed after them. Only the points after the prefix count in the memory usage.
+/// </summary>
+/// <param name="prefix">- Timeline to continue, with at least one point. This timeline must be empty.</param>
+void OS_Scheduler_Simulator::Engine::Timeline::set_prefix(std::shared_ptr<const Timeline> prefix) {
+    this->clear();
+
+    this->prefix_points = prefix->size();
+    this->prefix_pages = prefix->get_page_keys();
+    this->committed_points = prefix->get_committed_points();
+    this->prefix = std::move(prefix);
+}
+
+void OS_Scheduler_Simulator::Engine::Timeline::set_state_saver(std::function<void(Checkpoint&)> saver) {
+    this->state_saver = saver;
+    this->checkpointable = this->checkpointable || static_cast<bool>(saver);
+}
+
+/// <summary>
+/// Make the algorithm filling this timeline continue from a checkpoint. The Evaluator and the run read their parts first, so the checkpoint
+/// is left at the state of the algorithm.
+/// </summary>
+/// <param name="checkpoint">- Checkpoint to resume from, kept alive by the caller until the algorithm returns.</param>
+/// <param name="committed_points">- Points committed before the checkpoint, so the next checkpoints are written at the same points.</param>
+void OS_Scheduler_Simulator::Engine::Timeline::set_resume_checkpoint(Checkpoint* checkpoint, size_t committed_points) {
+    this->resume_checkpoint = checkpoint;
+    this->committed_points = committed_points;
+}
+
+/// <summary>
+/// Start from the latest point of the resume checkpoint instead of committing a first point. The point was already seen by the observer
+/// before the checkpoint was written, so it is not passed to it again.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Timeline::resume(Data_Point* data_point) {
+    this->resume_checkpoint = nullptr;
+    this->resumed = true;
+
+    this->points.push_back(data_point);
+    this->resident_bytes += sizeof(Data_Point*) + data_point->get_memory_size();
+}
+
+/// <summary>
+/// Set the memory the points may take before the oldest segments are spilled to a temporary file. Only timelines keeping their history spill.
+/// </summary>
+/// <param name="bytes">- Budget, as estimated by Data_Point::get_memory_size. 0 keeps every point in memory.</param>
+/// <param name="first_process">- First element of the vector of processes the points refer to, so spilled points can store indexes.</param>
+void OS_Scheduler_Simulator::Engine::Timeline::set_memory_budget(size_t bytes, const Process_Data* first_process) {
+    this->memory_budget = (this->keep_history) ? bytes : 0;
+    this->first_process = first_process;
+}
+
+OS_Scheduler_Simulator::Engine::Timeline::memory_usage OS_Scheduler_Simulator::Engine::Timeline::get_memory_usage() const {
+    const size_t cached = (this->spill != nullptr) ? this->spill->get_cached_bytes() : 0;
+    const size_t peak_cached = (this->spill != nullptr) ? this->spill->get_peak_cached_bytes() : 0;
+
+    return memory_usage{
+        .resident_bytes = this->resident_bytes + cached,
+        .peak_resident_bytes = std::max(this->peak_resident_bytes, this->resident_bytes + peak_cached),
+        .spilled_bytes = (this->spill != nullptr) ? this->spill->get_file_bytes() : 0,
+        .spilled_points = (this->spill != nullptr) ? this->spill->get_spilled_points() : 0
+    };
+}
+
+/// <summary>
+/// Write the oldest points to the spill file, a segment at a time, until the points in memory fit in their half of the budget again. The
+/// segments take up to a quarter of the budget, so the other half holds at least two of them paged back in.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Timeline::spill_segments() {
+    const size_t points_budget = this->memory_budget - this->memory_budget / 2;
+    const size_t segment_bytes = this->memory_budget / 4;
+
+    if (this->spill == nullptr) this->spill = std::make_unique<Timeline_Spill>(this->first_process, this->memory_budget / 2);
+
+    // The latest point stays in memory.
+    while (this->resident_bytes > points_budget && this->points.size() > 1) {
+        size_t count{ 0 }, bytes{ 0 };
+
+        while (count + 1 < this->points.size()) {
+            const size_t point_bytes = sizeof(Data_Point*) + this->points.at(count)->get_memory_size();
+            if (count > 0 && bytes + point_bytes > segment_bytes) break;
+
+            bytes += point_bytes;
+            count++;
+        }
+
+        // Without a usable file the timeline simply keeps growing in memory.
+        if (!this->spill->write(this->points, count)) {
+            this->memory_budget = 0;
+            return;
+        }
+
+        for (size_t i{ 0 }; i < count; i++) {
+            delete this->points.front();
+            this->points.pop_front();
+        }
+
+        this->resident_bytes -= bytes;
+    }
+}
+
+size_t OS_Scheduler_Simulator::Engine::Timeline::get_spilled_points() const {
+    return (this->spill != nullptr) ? this->spill->get_spilled_points() : 0;
+}
+
+size_t OS_Scheduler_Simulator::Engine::Timeline::get_page_keys() const {
+    return this->prefix_pages + ((this->spill != nullptr) ? this->spill->get_segments() : 0);
+}
+
+/// <summary>
+/// Get a point, paging its segment back in if it was spilled.
+/// </summary>
+/// <param name="index">- Position of the point.</param>
+/// <param name="page">- Segment paged in by a previous call, reused if the point is in it, otherwise replaced.</param>
+/// <param name="page_segment">- Index of that segment.</param>
+/// <returns>The point, valid while the page is held, or nullptr if the spill file could not be read.</returns>
+const OS_Scheduler_Simulator::Engine::Data_Point* OS_Scheduler_Simulator::Engine::Timeline::get_point(size_t index, std::shared_ptr<const std::vector<Data_Point>>& page, size_t& page_segment) const {
+    if (index < this->prefix_points) return this->prefix->get_point(index, page, page_segment);
+
+    index -= this->prefix_points;
+
+    const size_t spilled = this->get_spilled_points();
+    if (index >= spilled) return this->points.at(index - spilled);
+
+    const size_t segment = this->spill->find_segment(index);
+
+    // Pages of the prefix keep their own keys, so a page held by an iterator is never mistaken for one of this timeline.
+    if (page == nullptr || page_segment != this->prefix_pages + segment) {
+        page = this->spill->read(segment);
+        page_segment = this->prefix_pages + segment;
+    }
+
+    return (page != nullptr) ? &page->at(index - this->spill->get_first_point(segment)) : nullptr;
+}
+
+/// <summary>
+/// Get the state at a given time: the last point at or before it, or the first point if the time is before it. Only the segment
+/// holding the answer is paged in.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Data_Point OS_Scheduler_Simulator::Engine::Timeline::get_data_at(unsigned time) const {
+    const size_t spilled = this->get_spilled_points();
+    const unsigned first_time = (spilled > 0) ? this->spill->get_first_time(0) : (!this->points.empty()) ? this->points.front()->get_time_since_start() : 0;
+
+    if (this->prefix != nullptr && (spilled + this->points.size() == 0 || time < first_time)) return this->prefix->get_data_at(time);
+
+    // The first point after the time; the answer is the one before.
+    if (spilled == 0 || this->points.front()->get_time_since_start() <= time) {
+        auto after = std::upper_bound(this->points.begin(), this->points.end(), time, [](unsigned time, const Data_Point* data_point) { return time < data_point->get_time_since_start(); });
+        return **((after == this->points.begin()) ? after : std::prev(after));
+    }
+
+    // The last segment starting at or before the time holds the answer.
+    std::shared_ptr<const std::vector<Data_Point>> page = this->spill->read(this->spill->find_segment_at(time));
+    if (page == nullptr) return *this->back(); // The spill file could not be read.
+
+    auto after = std::upper_bound(page->begin(), page->end(), time, [](unsigned time, const Data_Point& data_point) { return time < data_point.get_time_since_start(); });
+    return (after == page->begin()) ? *after : *std::prev(after);
+}
+
+const OS_Scheduler_Simulator::Engine::Data_Point* OS_Scheduler_Simulator::Engine::Timeline::const_iterator::operator*() const {
+    return this->timeline->get_point(this->index, this->page, this->page_segment);
+}
+
+OS_Scheduler_Simulator::Engine::Evaluator::Evaluator(std::list<Process_Data>& processes, Timeline* timeline)
+    : timeline(timeline), processes_data(processes.size()), total_results({ 0, 0, 0, 0, 0, 0, 0 }), devices(), device_index(), groups(), group_states(), group_index(), process_index(), credited_as(), process_group(),
+      track_deadlines(false),
+      deadlines(), cpu_completed_at(), queued_since_cpu(), previous_point(), current_point(), unused_cpu(0), switch_overhead(0),
+      follow_changes(false), ready_since(), ready_in_group(), device_queues() {
+    unsigned i{ 0 };
+    for (Process_Data& process : processes) {
+        this->processes_data.at(i).set_process_addr(&process);
+        i++;
+    }
+
+    this->index_processes();
+
+    this->run_evaluation();
+}
+
+OS_Scheduler_Simulator::Engine::Evaluator::Evaluator(std::vector<Process_Data>& processes, Timeline* timeline)
+    : timeline(timeline), processes_data(processes.size()), total_results({ 0, 0, 0, 0, 0, 0, 0 }), devices(), device_index(), groups(), group_states(), group_index(), process_index(), credited_as(), process_group(),
+      track_deadlines(false),
+      deadlines(), cpu_completed_at(), queued_since_cpu(), previous_point(), current_point(), unused_cpu(0), switch_overhead(0),
+      follow_changes(false), ready_since(), ready_in_group(), device_queues() {
+    for (unsigned i{ 0 }; i < processes.size(); i++)
+        this->processes_data.at(i).set_process_addr(&processes.at(i));
+
+    this->index_processes();
+
+    this->run_evaluation();
+}
+
+OS_Scheduler_Simulator::Engine::Evaluator::Process* find_process(std::vector<OS_Scheduler_Simulator::Engine::Evaluator::Process>& list_of_processes, std::string proc_name) {
+    OS_Scheduler_Simulator::Engine::Evaluator::Process* needle = nullptr;
+    
+    for (OS_Scheduler_Simulator::Engine::Evaluator::Process& process : list_of_processes) {
+        if (process.get_process_name() == proc_name) {
+            needle = &process;
+            break;
+        }
+    }
+
+    return needle;
+}
+
+/// <summary>
+/// List the I/O devices and the groups used by the processes, in the order they are first used, and check whether any process has deadlines.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Evaluator::index_processes() {
+
+    for (const Evaluator::Process& process : this->processes_data) {
+        const IO_Device* device = process.get_process_addr()->get_io_device().get();
+
+        if (device != nullptr && this->device_index.emplace(device, this->devices.size()).second)
+            this->devices.push_back(device_usage{ .name = device->get_name(), .channels = device->get_channels(), .busy_time = 0, .requests = 0, .queueing_delay = 0, .max_queue_length = 0, .utilization = 0 });
+
+        this->process_group.push_back(this->index_group(process.get_process_addr()->get_group().get()));
+        this->track_deadlines = this->track_deadlines || process.get_process_addr()->has_deadlines();
+    }
+
+    if (this->groups.empty()) this->process_group.clear();
+
+    // The processes are accounted without searching them by name at every block.
+    std::unordered_map<std::string, size_t> first_with_name;
+
+    for (size_t i{ 0 }; i < this->processes_data.size(); i++) {
+        this->process_index.emplace(this->processes_data.at(i).get_process_addr(), i);
+        this->credited_as.push_back(first_with_name.try_emplace(this->processes_data.at(i).get_process_name(), i).first->second);
+    }
+}
+
+/// <summary>
+/// Get the evaluation a process is credited to: the first process with its name.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Evaluator::Process* OS_Scheduler_Simulator::Engine::Evaluator::find_credited(const Running_Process& process) {
+    auto it = this->process_index.find(process.get_process_data());
+
+    // The timeline may run on copies of the processes evaluated.
+    if (it == this->process_index.end()) return find_process(this->processes_data, process.get_proc_name());
+    return &this->processes_data.at(this->credited_as.at(it->second));
+}
+
+/// <summary>
+/// Get the index of a group, adding it and its ancestors the first time.
+/// </summary>
+/// <returns>The index, or no_group for nullptr.</returns>
+size_t OS_Scheduler_Simulator::Engine::Evaluator::index_group(const Process_Group* group) {
+    if (group == nullptr) return no_group;
+
+    auto it = this->group_index.find(group);
+    if (it != this->group_index.end()) return it->second;
+
+    const size_t parent = this->index_group(group->get_parent().get());
+
+    this->groups.push_back(group_usage{ .name = group->get_name(), .parent = (parent != no_group) ? this->groups.at(parent).name : "", .weight = group->get_weight(),
+        .quota = group->get_quota(), .period = group->get_period(), .cpu_time = 0, .throttled_time = 0, .throttled_periods = 0, .utilization = 0 });
+    this->group_states.push_back(group_state{ .parent = parent, .period_index = 0, .used = 0, .throttled = false });
+
+    this->group_index.emplace(group, this->groups.size() - 1);
+    return this->groups.size() - 1;
+}
+
+void OS_Scheduler_Simulator::Engine::Evaluator::run_evaluation() {
+    // Clear evaluator data if any.
+    this->reset();
+
+    if (this->timeline != nullptr && this->timeline->size() > 0) {
+        Perf_Counters::Scope scope(Perf_Counters::phase::evaluation, this->timeline->size());
+
+        for (const Data_Point* data_point : *this->timeline) {
+            if (data_point == nullptr) break; // The spill file could not be read.
+            this->add_data_point(*data_point);
+        }
+
+        this->finish();
+    }
+}
+
+/// <summary>
+/// Clear the evaluator data to start a new incremental evaluation.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Evaluator::reset() {
+    for (auto& proc : this->processes_data) proc.reset();
+
+    for (device_usage& device : this->devices)
+        device = device_usage{ .name = device.name, .channels = device.channels, .busy_time = 0, .requests = 0, .queueing_delay = 0, .max_queue_length = 0, .utilization = 0 };
+
+    for (group_usage& group : this->groups) {
+        group.cpu_time = group.throttled_time = group.throttled_periods = 0;
+        group.utilization = 0;
+    }
+
+    for (group_state& state : this->group_states) state = group_state{ .parent = state.parent, .period_index = 0, .used = 0, .throttled = false };
+
+    this->deadlines = deadline_report{ .jobs = 0, .misses = 0, .worst_lateness = 0, .total_tardiness = 0, .max_tardiness = 0, .tardiness_histogram = {} };
+    this->cpu_completed_at.assign((this->track_deadlines) ? this->processes_data.size() : 0, 0);
+    this->queued_since_cpu.assign((this->track_deadlines) ? this->processes_data.size() : 0, 0);
+
+    this->previous_point.reset();
+    this->current_point.reset();
+    this->unused_cpu = 0;
+    this->switch_overhead = 0;
+
+    this->follow_changes = false;
+    this->ready_since.clear();
+    this->ready_in_group.assign(this->groups.size(), 0);
+    this->device_queues.assign(this->devices.size(), {});
+}
+
+/// <summary>
+/// Account the next point of the timeline. The block between two points is only evaluated once the point after them arrives, since the
+/// last block is handled differently (see finish()).
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Evaluator::add_data_point(const Data_Point& data_point) {
+    // Timelines either record the changes of the ready queue at every point or at none.
+    if (!this->current_point.has_value()) this->follow_changes = data_point.get_ready_changes().has_value();
+
+    if (this->previous_point.has_value()) {
+        // Time for the current block.
+        unsigned diff = this->current_point->get_time_since_start() - this->previous_point->get_time_since_start();
+
+        // Calculate the waiting times at every point adding them up.
+        if (this->follow_changes) this->apply_ready_changes(*this->previous_point);
+
+        else {
+            for (Running_Process& waiting_process : this->previous_point->get_ready_list()) {
+                Process* proc_to_update = this->find_credited(waiting_process);
+                if (proc_to_update != nullptr) proc_to_update->add_total_waiting_time(diff);
+            }
+        }
+
+        if (this->previous_point->is_cpu_busy()) {
+            this->switch_overhead += std::min(diff, this->previous_point->get_cpu_process().get_switch_overhead());
+
+            // Calculating response time, from the arrival of the process.
+            Process* running_proc = this->find_credited(this->previous_point->get_cpu_process());
+            const unsigned arrival = this->previous_point->get_cpu_process().get_process_data()->get_arrival();
+
+            if (running_proc->is_response_set() == false)
+                running_proc->set_response_time(this->previous_point->get_time_since_start() - arrival);
+
+            // Calculating turnaround time.
+            Running_Process::status_type p_next_status = this->previous_point->get_cpu_process().get_next_process_state(diff).get_status();
+            if (p_next_status == Running_Process::status_type::done)
+                running_proc->set_turnaround_time(this->current_point->get_time_since_start() - arrival);
+
+            if (this->track_deadlines && this->previous_point->get_cpu_process().time_to_end_current_burst() == diff)
+                this->add_completed_burst(this->previous_point->get_cpu_process(), this->current_point->get_time_since_start());
+        }
+
+        else { // Add time not being utilized.
+            this->unused_cpu += diff;
+        }
+
+        if (!this->devices.empty()) this->add_io_block(*this->previous_point, diff);
+        if (!this->groups.empty()) this->add_group_block(*this->previous_point, diff);
+    }
+
+    this->previous_point = std::move(this->current_point);
+    this->current_point.emplace(data_point);
+}
+
+/// <summary>
+/// Follow the changes of the ready queue at a point: the processes joining it are ready since the point, and the one dispatched is credited
+/// the time it waited. Each block adds up the same waiting times as walking the queue of its first point, in the time of its changes.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Evaluator::apply_ready_changes(const Data_Point& data_point) {
+    const std::optional<Data_Point::ready_changes>& changes = data_point.get_ready_changes();
+    if (!changes.has_value()) return;
+
+    const unsigned time = data_point.get_time_since_start();
+
+    for (const Process_Data* process : changes->enqueued) {
+        this->ready_since[process] = time;
+        if (!this->groups.empty()) this->mark_ready_groups(process, true);
+    }
+
+    auto dispatched = this->ready_since.find(changes->dispatched);
+    if (dispatched == this->ready_since.end()) return;
+
+    Process* proc_to_update = this->find_credited(Running_Process(dispatched->first));
+    if (proc_to_update != nullptr) proc_to_update->add_total_waiting_time(time - dispatched->second);
+
+    if (!this->groups.empty()) this->mark_ready_groups(dispatched->first, false);
+    this->ready_since.erase(dispatched);
+}
+
+/// <summary>
+/// Follow the changes of the waiting list at a point: a completed request leaves its device, the next request queued for the device is
+/// credited the time it waited, and the requests started are queued. Each block then adds up the same times as walking the waiting list of
+/// its first point.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Evaluator::apply_waiting_changes(const Data_Point& data_point) {
+    const std::optional<Data_Point::waiting_changes>& changes = data_point.get_waiting_changes();
+    if (!changes.has_value()) return;
+
+    const unsigned time = data_point.get_time_since_start();
+
+    for (const Process_Data* process : changes->completed) {
+        auto device = this->device_index.find(process->get_io_device().get());
+        if (device == this->device_index.end()) continue;
+
+        std::deque<std::pair<const Process_Data*, unsigned>>& queue = this->device_queues.at(device->second);
+        auto request = std::find_if(queue.begin(), queue.end(), [process](const std::pair<const Process_Data*, unsigned>& request) { return request.first == process; });
+        if (request == queue.end()) continue;
+
+        queue.erase(request);
+        this->devices.at(device->second).requests++;
+
+        // The first request queued behind the channels takes the one freed.
+        const size_t channels = this->devices.at(device->second).channels;
+        if (queue.size() < channels) continue;
+
+        const auto& [queued, since] = queue.at(channels - 1);
+        const size_t i = this->process_index.at(queued);
+
+        this->processes_data.at(this->credited_as.at(i)).add_io_queueing_time(time - since);
+        if (this->track_deadlines) this->queued_since_cpu.at(i) += time - since;
+    }
+
+    for (const Process_Data* process : changes->started) {
+        auto device = this->device_index.find(process->get_io_device().get());
+        if (device != this->device_index.end()) this->device_queues.at(device->second).emplace_back(process, time);
+    }
+}
+
+/// <summary>
+/// Count a process joining or leaving the ready queue in its group and all the groups above it.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Evaluator::mark_ready_groups(const Process_Data* process, bool ready) {
+    auto it = this->process_index.find(process);
+    if (it == this->process_index.end()) return;
+
+    for (size_t group = this->process_group.at(it->second); group != no_group; group = this->group_states.at(group).parent) {
+        if (ready) this->ready_in_group.at(group)++;
+        else this->ready_in_group.at(group)--;
+    }
+}
+
+/// <summary>
+/// Save the state of an incremental evaluation, to continue it with load_state.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Evaluator::save_state(Checkpoint& checkpoint) const {
+    for (const Evaluator::Process& process : this->processes_data) process.save_state(checkpoint);
+
+    for (const device_usage& device : this->devices) {
+        checkpoint.put(device.busy_time);
+        checkpoint.put(device.requests);
+        checkpoint.put(device.queueing_delay);
+        checkpoint.put(device.max_queue_length);
+    }
+
+    for (size_t i{ 0 }; i < this->groups.size(); i++) {
+        checkpoint.put(this->groups.at(i).cpu_time);
+        checkpoint.put(this->groups.at(i).throttled_time);
+        checkpoint.put(this->groups.at(i).throttled_periods);
+        checkpoint.put(this->group_states.at(i).period_index);
+        checkpoint.put(this->group_states.at(i).used);
+        checkpoint.put(this->group_states.at(i).throttled);
+    }
+
+    checkpoint.put(this->deadlines.jobs);
+    checkpoint.put(this->deadlines.misses);
+    checkpoint.put_signed(this->deadlines.worst_lateness);
+    checkpoint.put(this->deadlines.total_tardiness);
+    checkpoint.put(this->deadlines.max_tardiness);
+    checkpoint.put(this->deadlines.tardiness_histogram.size());
+    for (unsigned long long jobs : this->deadlines.tardiness_histogram) checkpoint.put(jobs);
+
+    for (unsigned time : this->cpu_completed_at) checkpoint.put(time);
+    for (unsigned time : this->queued_since_cpu) checkpoint.put(time);
+
+    for (const std::optional<Data_Point>* data_point : { &this->previous_point, &this->current_point }) {
+        checkpoint.put(data_point->has_value());
+        if (data_point->has_value()) checkpoint.put_point(**data_point);
+    }
+
+    checkpoint.put(this->unused_cpu);
+    checkpoint.put(this->switch_overhead);
+
+    checkpoint.put(this->follow_changes);
+    checkpoint.put(this->ready_since.size());
+
+    for (const auto& [process, since] : this->ready_since) {
+        checkpoint.put(this->process_index.at(process));
+        checkpoint.put(since);
+    }
+
+    for (const std::deque<std::pair<const Process_Data*, unsigned>>& queue : this->device_queues) {
+        checkpoint.put(queue.size());
+
+        for (const auto& [process, since] : queue) {
+            checkpoint.put(this->process_index.at(process));
+            checkpoint.put(since);
         }
+    }
+}
+
+/// <summary>
+/// Continue an incremental evaluation from the state saved by save_state, for the same processes.
+/// </summary>
+/// <returns>False if the checkpoint was invalid.</returns>
+bool OS_Scheduler_Simulator::Engine::Evaluator::load_state(Checkpoint& checkpoint) {
+    this->reset();
+
+    for (Evaluator::Process& process : this->processes_data) process.load_state(checkpoint);
+
+    for (device_usage& device : this->devices) {
+        device.busy_time = checkpoint.get();
+        device.requests = checkpoint.get();
+        device.queueing_delay = checkpoint.get();
+        device.max_queue_length = static_cast<size_t>(checkpoint.get());
+    }
+
+    for (size_t i{ 0 }; i < this->groups.size(); i++) {
+        this->groups.at(i).cpu_time = checkpoint.get();
+        this->groups.at(i).throttled_time = checkpoint.get();
+        this->groups.at(i).throttled_periods = checkpoint.get();
+        this->group_states.at(i).period_index = checkpoint.get();
+        this->group_states.at(i).used = checkpoint.get();
+        this->group_states.at(i).throttled = checkpoint.get() != 0;
+    }
+
+    this->deadlines.jobs = checkpoint.get();
+    this->deadlines.misses = checkpoint.get();
+    this->deadlines.worst_lateness = checkpoint.get_signed();
+    this->deadlines.total_tardiness = checkpoint.get();
+    this->deadlines.max_tardiness = static_cast<unsigned>(checkpoint.get());
+
+    // Each bucket is at least one byte, so a corrupted size cannot allocate more than the checkpoint holds.
+    for (unsigned long long buckets = checkpoint.get(); buckets > 0 && checkpoint.is_valid(); buckets--)
+        this->deadlines.tardiness_histogram.push_back(checkpoint.get());
+
+    for (unsigned& time : this->cpu_completed_at) time = static_cast<unsigned>(checkpoint.get());
+    for (unsigned& time : this->queued_since_cpu) time = static_cast<unsigned>(checkpoint.get());
+
+    for (std::optional<Data_Point>* data_point : { &this->previous_point, &this->current_point })
+        if (checkpoint.get() != 0) data_point->emplace(checkpoint.get_point());
+
+    this->unused_cpu = static_cast<unsigned>(checkpoint.get());
+    this->switch_overhead = checkpoint.get();
+
+    this->follow_changes = checkpoint.get() != 0;
+
+    for (unsigned long long count = checkpoint.get(); count > 0 && checkpoint.is_valid(); count--) {
+        const unsigned long long index = checkpoint.get();
+        const unsigned since = static_cast<unsigned>(checkpoint.get());
+
+        if (index >= this->processes_data.size()) return false;
+
+        const Process_Data* process = this->processes_data.at(static_cast<size_t>(index)).get_process_addr();
+        this->ready_since[process] = since;
+        if (!this->groups.empty()) this->mark_ready_groups(process, true);
+    }
+
+    for (std::deque<std::pair<const Process_Data*, unsigned>>& queue : this->device_queues)
+        for (unsigned long long count = checkpoint.get(); count > 0 && checkpoint.is_valid(); count--) {
+            const unsigned long long index = checkpoint.get();
+            const unsigned since = static_cast<unsigned>(checkpoint.get());
+
+            if (index >= this->processes_data.size()) return false;
+            queue.emplace_back(this->processes_data.at(static_cast<size_t>(index)).get_process_addr(), since);
+        }
+
+    return checkpoint.is_valid();
+}
+
+/// <summary>
+/// Account the I/O devices during a block: channels busy, requests queued and requests completed.
+/// </summary>
+/// <param name="data_point">- Point starting the block.</param>
+/// <param name="time">- Length of the block.</param>
+void OS_Scheduler_Simulator::Engine::Evaluator::add_io_block(const Data_Point& data_point, unsigned time) {
+    if (data_point.get_waiting_changes().has_value()) {
+        this->apply_waiting_changes(data_point);
+
+        for (size_t i{ 0 }; i < this->devices.size(); i++) {
+            device_usage& usage = this->devices.at(i);
+            const size_t requests = this->device_queues.at(i).size(), queued = requests - std::min<size_t>(requests, usage.channels);
+
+            usage.busy_time += static_cast<unsigned long long>(requests - queued) * time;
+            usage.queueing_delay += static_cast<unsigned long long>(queued) * time;
+            usage.max_queue_length = std::max(usage.max_queue_length, queued);
+        }
+
+        return;
+    }
+
+    const std::list<Running_Process> waiting_list = data_point.get_waiting_list();
+    std::vector<size_t> queued(this->devices.size(), 0);
+
+    IO_Device::for_each_request(waiting_list, [this, &queued, time](const Running_Process& request, bool in_service) {
+        auto device = this->device_index.find(request.get_process_data()->get_io_device().get());
+        if (device == this->device_index.end()) return;
+
+        device_usage& usage = this->devices.at(device->second);
+
+        if (in_service) {
+            usage.busy_time += time;
+            if (request.time_to_end_current_burst() == time) usage.requests++;
+        }
+
+        else {
+            usage.queueing_delay += time;
+            queued.at(device->second)++;
+
+            const size_t i = this->process_index.at(request.get_process_data());
+            this->processes_data.at(this->credited_as.at(i)).add_io_queueing_time(time);
+            if (this->track_deadlines) this->queued_since_cpu.at(i) += time;
+        }
+    });
+
+    for (size_t i{ 0 }; i < this->devices.size(); i++)
+        this->devices.at(i).max_queue_length = std::max(this->devices.at(i).max_queue_length, queued.at(i));
+}
+
+/// <summary>
+/// Account the groups during a block: the CPU time of the running process goes to its group and all the groups above it, and a group that
+/// used up its quota for the period is throttled while it has ready processes and none running. The Group algorithm steps at the period
+/// boundaries of the groups involved, so blocks fall within a period and this is exact; other algorithms do not enforce the quotas, and
+/// their blocks are accounted in the period they start in.
+/// </summary>
+/// <param name="data_point">- Point starting the block.</param>
+/// <param name="time">- Length of the block.</param>
+void OS_Scheduler_Simulator::Engine::Evaluator::add_group_block(const Data_Point& data_point, unsigned time) {
+    const unsigned start = data_point.get_time_since_start();
+    std::vector<bool> ready(this->groups.size(), false), running(this->groups.size(), false);
+
+    // Marks a group and its ancestors, stopping at the first one marked already.
+    auto mark = [this](std::vector<bool>& marks, const Running_Process& process) {
+        for (size_t group = this->process_group.at(this->process_index.at(process.get_process_data())); group != no_group && !marks.at(group); group = this->group_states.at(group).parent)
+            marks.at(group) = true;
+    };
+
+    if (this->follow_changes)
+        for (size_t group{ 0 }; group < this->groups.size(); group++) ready.at(group) = this->ready_in_group.at(group) > 0;
+
+    else
+        for (const Running_Process& process : data_point.get_ready_list()) mark(ready, process);
+
+    if (data_point.is_cpu_busy()) mark(running, data_point.get_cpu_process());
+
+    for (size_t group{ 0 }; group < this->groups.size(); group++) {
+        group_usage& usage = this->groups.at(group);
+        group_state& state = this->group_states.at(group);
+
+        if (usage.quota == 0) continue;
+
+        if (state.period_index != start / usage.period) {
+            state.period_index = start / usage.period;
+            state.used = 0;
+            state.throttled = false;
+        }
+
+        if (state.used >= usage.quota && ready.at(group) && !running.at(group)) {
+            const unsigned long long period_end = (state.period_index + 1) * usage.period;
+            usage.throttled_time += std::min<unsigned long long>(time, period_end - start);
+
+            if (!state.throttled) usage.throttled_periods++;
+            state.throttled = true;
+        }
+    }
+
+    if (!data_point.is_cpu_busy()) return;
+
+    const Running_Process process = data_point.get_cpu_process();
+    const unsigned on_burst = time - std::min(time, process.get_switch_overhead());
+
+    for (size_t group = this->process_group.at(this->process_index.at(process.get_process_data())); group != no_group; group = this->group_states.at(group).parent) {
+        this->groups.at(group).cpu_time += on_burst;
+        if (this->groups.at(group).quota > 0) this->group_states.at(group).used += on_burst;
+    }
+}
+
+/// <summary>
+/// Account a CPU burst that completed against its deadline. The burst became ready when the previous I/O burst ended, which is the end of
+/// the previous CPU burst plus the I/O burst and the time queued for its device (the arrival of the process for the first burst).
+/// </summary>
+/// <param name="process">- Process completing the burst, as it was on the CPU.</param>
+/// <param name="time">- Completion time.</param>
+void OS_Scheduler_Simulator::Engine::Evaluator::add_completed_burst(const Running_Process& process, unsigned time) {
+    const size_t i = this->process_index.at(process.get_process_data());
+    const size_t operation = process.get_operation_index();
+    const unsigned relative_deadline = process.get_process_data()->get_deadline(operation);
+
+    const unsigned long long released = (operation == 0) ? process.get_process_data()->get_arrival() : static_cast<unsigned long long>(this->cpu_completed_at.at(i)) + process.get_process_data()->get_operation(operation - 1) + this->queued_since_cpu.at(i);
+
+    this->cpu_completed_at.at(i) = time;
+    this->queued_since_cpu.at(i) = 0;
+
+    if (relative_deadline == 0) return;
+
+    const long long lateness = static_cast<long long>(time) - static_cast<long long>(released + relative_deadline);
+    const unsigned tardiness = (lateness > 0) ? static_cast<unsigned>(lateness) : 0;
+
+    this->deadlines.worst_lateness = (this->deadlines.jobs == 0) ? lateness : std::max(this->deadlines.worst_lateness, lateness);
+    this->deadlines.jobs++;
+    this->deadlines.total_tardiness += tardiness;
+    this->deadlines.max_tardiness = std::max(this->deadlines.max_tardiness, tardiness);
+
+    // Bucket 0 for jobs on time, then one bucket per power of two.
+    size_t bucket{ 0 };
+    for (unsigned rest{ tardiness }; rest > 0; rest >>= 1) bucket++;
+
+    if (this->deadlines.tardiness_histogram.size() <= bucket) this->deadlines.tardiness_histogram.resize(bucket + 1, 0);
+    this->deadlines.tardiness_histogram.at(bucket)++;
+
+    if (tardiness > 0) {
+        this->deadlines.misses++;
+        this->processes_data.at(this->credited_as.at(i)).add_deadline_miss();
+    }
+}
+
+/// <summary>
+/// Complete the incremental evaluation after the last point of the timeline.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Evaluator::finish() {
+    if (!this->previous_point.has_value()) return;
+
+    // Adding turnaround for the last process.
+    Process* last_proc = this->find_credited(this->previous_point->get_cpu_process());
+    last_proc->set_turnaround_time(this->current_point->get_time_since_start() - this->previous_point->get_cpu_process().get_process_data()->get_arrival());
+
+    const unsigned last_block = this->current_point->get_time_since_start() - this->previous_point->get_time_since_start();
+    if (this->track_deadlines && this->previous_point->is_cpu_busy() && this->previous_point->get_cpu_process().time_to_end_current_burst() == last_block)
+        this->add_completed_burst(this->previous_point->get_cpu_process(), this->current_point->get_time_since_start());
+
+    if (this->previous_point->is_cpu_busy())
+        this->switch_overhead += std::min(last_block, this->previous_point->get_cpu_process().get_switch_overhead());
+
+    if (this->follow_changes) this->apply_ready_changes(*this->previous_point);
+    if (!this->devices.empty()) this->apply_waiting_changes(*this->previous_point);
+    if (!this->groups.empty()) this->add_group_block(*this->previous_point, last_block);
+
+    // Processes still ready waited until the last block, which is not credited.
+    for (const auto& [process, since] : this->ready_since) {
+        Process* proc_to_update = this->find_credited(Running_Process(process));
+        if (proc_to_update != nullptr) proc_to_update->add_total_waiting_time(this->previous_point->get_time_since_start() - since);
+    }
+
+    // Calculate CPU utilization, and the part of it that went to the bursts rather than to switching.
+    this->total_results.cpu_utilization = static_cast<double>(this->current_point->get_time_since_start() - this->unused_cpu) / static_cast<double>(this->current_point->get_time_since_start());
+    this->total_results.switch_overhead = static_cast<double>(this->switch_overhead) / static_cast<double>(this->current_point->get_time_since_start());
+    this->total_results.effective_cpu_utilization = this->total_results.cpu_utilization - this->total_results.switch_overhead;
+
+    // Calculate averages.
+    this->total_results.avg_response_time = this->total_results.avg_turnaround_time = this->total_results.avg_waiting_time = 0;
+    this->total_results.avg_io_queueing_delay = 0;
+    
+    for (const Evaluator::Process& proc : this->processes_data) {
+        this->total_results.avg_response_time     += static_cast<double>(proc.get_response_time());
+        this->total_results.avg_turnaround_time   += static_cast<double>(proc.get_turnaround_time());
+        this->total_results.avg_waiting_time      += static_cast<double>(proc.get_total_waiting_time());
+        this->total_results.avg_io_queueing_delay += static_cast<double>(proc.get_io_queueing_time());
+    }
+
+    this->total_results.avg_response_time     /= this->processes_data.size();
+    this->total_results.avg_turnaround_time   /= this->processes_data.size();
+    this->total_results.avg_waiting_time      /= this->processes_data.size();
+    this->total_results.avg_io_queueing_delay /= this->processes_data.size();
+
+    for (device_usage& device : this->devices)
+        device.utilization = static_cast<double>(device.busy_time) / (static_cast<double>(device.channels) * this->current_point->get_time_since_start());
+
+    for (group_usage& group : this->groups)
+        group.utilization = static_cast<double>(group.cpu_time) / this->current_point->get_time_since_start();
+}
+
+OS_Scheduler_Simulator::Engine::Evaluator::Process::Process(OS_Scheduler_Simulator::Engine::Process_Data* process)
+    : process(process), total_waiting_time(0), io_queueing_time(0), deadline_misses(0), turnaround_time(0), response_time(0), response_time_set(false), turnaround_time_set(false) {}
+
+void OS_Scheduler_Simulator::Engine::Evaluator::Process::save_state(Checkpoint& checkpoint) const {
+    checkpoint.put(this->total_waiting_time);
+    checkpoint.put(this->io_queueing_time);
+    checkpoint.put(this->deadline_misses);
+    checkpoint.put(this->turnaround_time);
+    checkpoint.put(this->turnaround_time_set);
+    checkpoint.put(this->response_time);
+    checkpoint.put(this->response_time_set);
+}
+
+void OS_Scheduler_Simulator::Engine::Evaluator::Process::load_state(Checkpoint& checkpoint) {
+    this->total_waiting_time = static_cast<unsigned>(checkpoint.get());
+    this->io_queueing_time = static_cast<unsigned>(checkpoint.get());
+    this->deadline_misses = static_cast<unsigned>(checkpoint.get());
+    this->turnaround_time = static_cast<unsigned>(checkpoint.get());
+    this->turnaround_time_set = checkpoint.get() != 0;
+    this->response_time = static_cast<unsigned>(checkpoint.get());
+    this->response_time_set = checkpoint.get() != 0;
+}
+
+OS_Scheduler_Simulator::Engine::Simulation::Simulation(const std::span<const Process_Data>& processes)
+    : processes(std::make_shared<std::vector<Process_Data>>(processes.begin(), processes.end())), latest_results(nullptr), algorithms_mutex(), algorithms(), policies(),
+      switch_costs(Timeline::switch_costs{ .switch_cost = 0, .cache_penalty = 0, .cache_decay = 0 }), memory_budget(0) {
+    this->processes->shrink_to_fit();
+
+    // Registering default algorithms.
+    this->register_algorithm("FCFS", OS_SS_Algorithms::FCFS);
+    this->register_algorithm("SJF", OS_SS_Algorithms::SJF);
+    this->register_algorithm("MLFQ", OS_SS_Algorithms::MLFQ);
+    this->register_algorithm("CFS", OS_SS_Algorithms::CFS);
+    this->register_algorithm("SRTF", OS_SS_Algorithms::SRTF);
+    this->register_algorithm("ASJF", OS_SS_Algorithms::ASJF);
+    this->register_algorithm("EDF", OS_SS_Algorithms::EDF);
+    this->register_algorithm("RM", OS_SS_Algorithms::RM);
+    this->register_algorithm("Group", OS_SS_Algorithms::Group);
+    this->register_algorithm("RR", OS_SS_Algorithms::RR);
+    this->register_algorithm("Priority", OS_SS_Algorithms::Priority);
+
+    // The same algorithms as policies, for compare_algorithms. The names are taken, so the algorithms above stay registered.
+    this->register_policy("FCFS", []() { return std::make_unique<OS_SS_Algorithms::FCFS_Policy>(); });
+    this->register_policy("SJF", []() { return std::make_unique<OS_SS_Algorithms::SJF_Policy>(); });
+    this->register_policy("CFS", []() { return std::make_unique<OS_SS_Algorithms::CFS_Policy>(); });
+    this->register_policy("SRTF", []() { return std::make_unique<OS_SS_Algorithms::SRTF_Policy>(); });
+    this->register_policy("ASJF", []() { return std::make_unique<OS_SS_Algorithms::ASJF_Policy>(); });
+    this->register_policy("EDF", []() { return std::make_unique<OS_SS_Algorithms::EDF_Policy>(); });
+    this->register_policy("RM", []() { return std::make_unique<OS_SS_Algorithms::RM_Policy>(); });
+    this->register_policy("Group", []() { return std::make_unique<OS_SS_Algorithms::Group_Policy>(); });
+    this->register_policy("RR", []() { return std::make_unique<OS_SS_Algorithms::Round_Robin_Policy>(); });
+    this->register_policy("Priority", []() { return std::make_unique<OS_SS_Algorithms::Priority_Policy>(); });
+}
+
+void OS_Scheduler_Simulator::Engine::Simulation::register_algorithm(std::string name, std::function<void(const std::vector<Process_Data>&, Timeline&)> algorithm) {
+    std::lock_guard<std::mutex> lock(this->algorithms_mutex);
+    bool algorithm_exists = false;
+
+    for (const auto& [alg_name, func] : this->algorithms)
+        if (alg_name == name) {
+            algorithm_exists = true;
+            break;
+        }
+    
+    if (!algorithm_exists)
+        this->algorithms.push_back(std::pair(name, algorithm));
+
+    // NOTE: For future refactoring. Could the list be changed to vector, be sorted, and improve checking time?
+}
+
+void OS_Scheduler_Simulator::Engine::Simulation::register_algorithm(std::string name, std::function<void(const std::vector<Process_Data>&, std::list<Data_Point*>&)> algorithm) {
+    this->register_algorithm(name, [algorithm](const std::vector<Process_Data>& processes, Timeline& timeline) {
+        std::list<Data_Point*> points;
+        algorithm(processes, points);
+
+        // The timeline takes ownership of the points.
+        for (Data_Point* data_point : points) timeline.push_back(data_point);
+    });
+}
+
+void OS_Scheduler_Simulator::Engine::Simulation::register_policy(std::string name, std::function<std::unique_ptr<Scheduling_Policy>()> factory) {
+    this->register_algorithm(name, [factory](const std::vector<Process_Data>& processes, Timeline& timeline) {
+        std::unique_ptr<Scheduling_Policy> policy = factory();
+        Policy_Runner(processes, *policy).run(timeline);
+    });
+
+    std::lock_guard<std::mutex> lock(this->algorithms_mutex);
+
+    for (const auto& [policy_name, func] : this->policies)
+        if (policy_name == name)
+            return;
+
+    this->policies.push_back(std::pair(name, factory));
+}
+
+std::function<std::unique_ptr<OS_Scheduler_Simulator::Engine::Scheduling_Policy>()> OS_Scheduler_Simulator::Engine::Simulation::get_policy(std::string name_identifier) const {
+    std::lock_guard<std::mutex> lock(this->algorithms_mutex);
+
+    for (const auto& [policy_name, func] : this->policies)
+        if (policy_name == name_identifier)
+            return func;
+
+    return nullptr;
+}
+
+/// <summary>
+/// Get a registered algorithm.
+/// </summary>
+/// <returns>The algorithm, or an empty function if there is none with that name.</returns>
+std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> OS_Scheduler_Simulator::Engine::Simulation::get_algorithm(std::string name_identifier) const {
+    std::lock_guard<std::mutex> lock(this->algorithms_mutex);
 
-    if (!this->running.is_valid() && this->waiting_list.size() == 0) ev = event_type::done;
+    for (const auto& [alg_name, func] : this->algorithms)
+        if (alg_name == name_identifier)
+            return func;
 
-    return event{
-        .event_type = ev,
-        .time = shortest_time
-    };
+    return nullptr;
 }
 
-OS_Scheduler_Simulator::Engine::Evaluator::Evaluator(std::list<Process_Data>& processes, std::list<Data_Point*>* timeline)
-    : timeline(timeline), processes_data(processes.size()), total_results({0, 0, 0, 0}) {
-    unsigned i{ 0 };
-    for (Process_Data& process : processes) {
-        this->processes_data.at(i).set_process_addr(&process);
-        i++;
+void OS_Scheduler_Simulator::Engine::Simulation::set_switch_costs(Timeline::switch_costs costs) {
+    std::lock_guard<std::mutex> lock(this->algorithms_mutex);
+    this->switch_costs = costs;
+}
+
+OS_Scheduler_Simulator::Engine::Timeline::switch_costs OS_Scheduler_Simulator::Engine::Simulation::get_switch_costs() const {
+    std::lock_guard<std::mutex> lock(this->algorithms_mutex);
+    return this->switch_costs;
+}
+
+void OS_Scheduler_Simulator::Engine::Simulation::set_memory_budget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(this->algorithms_mutex);
+    this->memory_budget = bytes;
+}
+
+size_t OS_Scheduler_Simulator::Engine::Simulation::get_memory_budget() const {
+    std::lock_guard<std::mutex> lock(this->algorithms_mutex);
+    return this->memory_budget;
+}
+
+/// <summary>
+/// Run an algorithm and publish its results. The new timeline is built and evaluated privately, then swapped in atomically, so readers of
+/// the previous snapshot are never affected.
+/// </summary>
+/// <param name="name_identifier">- Name the algorithm was registered with.</param>
+/// <returns>Evaluation totals of the run, or all zeros if the algorithm does not exist (the previous results are kept in that case).</returns>
+OS_Scheduler_Simulator::Engine::Evaluator::results_table OS_Scheduler_Simulator::Engine::Simulation::execute_algorithm(std::string name_identifier) {
+    std::function<void(const std::vector<Process_Data>&, Timeline&)> algorithm = this->get_algorithm(name_identifier);
+    if (!algorithm) return Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+
+    Timeline timeline;
+    timeline.set_switch_costs(this->get_switch_costs());
+    timeline.set_memory_budget(this->get_memory_budget(), this->processes->data());
+
+    {
+        Perf_Counters::Scope scope(Perf_Counters::phase::algorithm);
+        algorithm(*this->processes, timeline);
+        scope.set_events(timeline.get_committed_points());
     }
 
-    this->run_evaluation();
+    std::shared_ptr<const Result_Snapshot> results = std::make_shared<const Result_Snapshot>(name_identifier, this->processes, std::move(timeline));
+    this->latest_results.store(results);
+
+    return results->get_total_results();
 }
 
-OS_Scheduler_Simulator::Engine::Evaluator::Evaluator(std::vector<Process_Data>& processes, std::list<Data_Point*>* timeline)
-    : timeline(timeline), processes_data(processes.size()), total_results({ 0, 0, 0, 0 }) {
-    for (unsigned i{ 0 }; i < processes.size(); i++)
-        this->processes_data.at(i).set_process_addr(&processes.at(i));
+/// <summary>
+/// Run an algorithm without keeping its timeline: every point is passed to the observer and evaluated as it is produced, then discarded.
+/// Memory stays constant however long the run is. No snapshot is published, so the getters keep returning the previous results.
+///
+/// Without an observer, the points of the algorithms built on a Scheduling_Policy only hold the size and the changes of the ready queue, so
+/// every step costs the same however many processes are ready.
+/// </summary>
+/// <param name="name_identifier">- Name the algorithm was registered with.</param>
+/// <param name="observer">- Called with every point of the timeline, in order. May be nullptr.</param>
+/// <returns>Evaluation totals of the run, or all zeros if the algorithm does not exist.</returns>
+OS_Scheduler_Simulator::Engine::Evaluator::results_table OS_Scheduler_Simulator::Engine::Simulation::stream_algorithm(std::string name_identifier, std::function<void(const Data_Point&)> observer) {
+    std::function<void(const std::vector<Process_Data>&, Timeline&)> algorithm = this->get_algorithm(name_identifier);
+    if (!algorithm) return Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+
+    Evaluator evaluator(*this->processes, nullptr);
+    Timeline timeline(false);
+    timeline.set_switch_costs(this->get_switch_costs());
+
+    timeline.set_observer([&evaluator, &observer](const Data_Point& data_point) {
+        evaluator.add_data_point(data_point);
+        if (observer) observer(data_point);
+    }, static_cast<bool>(observer));
+
+    algorithm(*this->processes, timeline);
+    evaluator.finish();
+
+    return evaluator.get_overall_totals();
+}
 
-    this->run_evaluation();
+/// <summary>
+/// Run an algorithm like stream_algorithm, writing a checkpoint every "interval" points, so the run can be continued with
+/// resume_from_checkpoint if the program stops. Only the built-in algorithms, and the ones built on a Scheduling_Policy that supports it,
+/// can be checkpointed.
+///
+/// The results are published as a snapshot, like execute_algorithm, but the timeline of a checkpointed run is not kept: the snapshot only
+/// holds its latest point.
+/// </summary>
+/// <param name="name_identifier">- Name the algorithm was registered with. Resuming looks the algorithm up by this name.</param>
+/// <param name="path">- Checkpoint file, replaced by every new checkpoint. It is left in place when the run completes.</param>
+/// <param name="interval">- Points committed between two checkpoints.</param>
+/// <param name="error">- Optional description of the problem if the algorithm does not exist, cannot be checkpointed or a checkpoint could
+/// not be written. In the last two cases the run still completes and the results are valid.</param>
+/// <returns>Evaluation totals of the run, or all zeros if the algorithm does not exist.</returns>
+OS_Scheduler_Simulator::Engine::Evaluator::results_table OS_Scheduler_Simulator::Engine::Simulation::run_with_checkpoints(std::string name_identifier, std::string path, size_t interval, std::string* error) {
+    return this->run_checkpointed(name_identifier, nullptr, path, (interval > 0) ? interval : 1, this->get_switch_costs(), error);
 }
 
-OS_Scheduler_Simulator::Engine::Evaluator::Process* find_process(std::vector<OS_Scheduler_Simulator::Engine::Evaluator::Process>& list_of_processes, std::string proc_name) {
-    OS_Scheduler_Simulator::Engine::Evaluator::Process* needle = nullptr;
-    
-    for (OS_Scheduler_Simulator::Engine::Evaluator::Process& process : list_of_processes) {
-        if (process.get_process_name() == proc_name) {
-            needle = &process;
-            break;
-        }
+/// <summary>
+/// Continue a run from the checkpoint written by run_with_checkpoints. The results are the same as those of the uninterrupted run, and new
+/// checkpoints keep being written to the same file at the same interval. The switch costs of the original run are used.
+/// </summary>
+/// <param name="path">- Checkpoint file.</param>
+/// <param name="error">- Optional description of the problem if the checkpoint cannot be resumed, or a new one could not be written.</param>
+/// <returns>Evaluation totals of the complete run, or all zeros if the checkpoint cannot be resumed.</returns>
+OS_Scheduler_Simulator::Engine::Evaluator::results_table OS_Scheduler_Simulator::Engine::Simulation::resume_from_checkpoint(std::string path, std::string* error) {
+    Checkpoint checkpoint(*this->processes);
+    if (!checkpoint.load(path, error)) return Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+
+    // Header written by run_checkpointed.
+    const std::string name_identifier = checkpoint.get_string();
+
+    Timeline::switch_costs costs{ .switch_cost = 0, .cache_penalty = 0, .cache_decay = 0 };
+    costs.switch_cost = static_cast<unsigned>(checkpoint.get());
+    costs.cache_penalty = static_cast<unsigned>(checkpoint.get());
+    costs.cache_decay = static_cast<unsigned>(checkpoint.get());
+
+    const size_t interval = static_cast<size_t>(checkpoint.get());
+
+    if (!checkpoint.is_valid() || interval == 0) {
+        if (error != nullptr) *error = "\"" + path + "\" is corrupted";
+        return Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
     }
 
-    return needle;
+    return this->run_checkpointed(name_identifier, &checkpoint, path, interval, costs, error);
 }
 
-void OS_Scheduler_Simulator::Engine::Evaluator::run_evaluation() {
-    // Clear evaluator data if any.
-    for (auto& proc : this->processes_data) proc.reset();
+/// <summary>
+/// Run several algorithms on the processes and evaluate each of them, like execute_algorithm, sharing the work they have in common.
+///
+/// The algorithms registered as policies (all the built-in ones but MLFQ) run together through a Shared_Prefix_Runner: their schedules are
+/// simulated once for as long as they are the same, and their timelines share those points instead of copying them
+/// (Timeline::get_shared_points). The results are the same as running every algorithm on its own. Other algorithms run on their own, and so
+/// do all of them for workloads with dependencies, where processes are not all submitted at the start.
+/// </summary>
+/// <param name="names">- Names the algorithms were registered with.</param>
+/// <returns>The snapshot of every algorithm, in the same order, or nullptr for the names that are not registered. They are not published,
+/// so the getters keep returning the previous results.</returns>
+std::vector<std::shared_ptr<const OS_Scheduler_Simulator::Engine::Result_Snapshot>> OS_Scheduler_Simulator::Engine::Simulation::compare_algorithms(const std::vector<std::string>& names) {
+    std::vector<std::shared_ptr<const Result_Snapshot>> results(names.size(), nullptr);
+    std::vector<Timeline> timelines(names.size());
+
+    for (Timeline& timeline : timelines) {
+        timeline.set_switch_costs(this->get_switch_costs());
+        timeline.set_memory_budget(this->get_memory_budget(), this->processes->data());
+    }
 
-    if (this->timeline != nullptr && this->timeline->size() > 0) {
-        // Setup.
-        std::list<Data_Point*>::iterator previous_point = this->timeline->begin();
-        std::list<Data_Point*>::iterator current_point = std::next(previous_point);
-        std::list<Data_Point*>::iterator last_point = std::prev(this->timeline->end());
+    std::vector<std::unique_ptr<Scheduling_Policy>> policies;
+    std::vector<Scheduling_Policy*> shared_policies;
+    std::vector<Timeline*> shared_timelines;
 
-        unsigned unused_cpu{ 0 };
+    {
+        Perf_Counters::Scope scope(Perf_Counters::phase::algorithm);
 
-        while (current_point != last_point) {
-            // Time for the current block.
-            unsigned diff = (* current_point)->get_time_since_start() - (* previous_point)->get_time_since_start();
-            
-            // Calculate the waiting times at every point adding them up.
-            for (Running_Process& waiting_process : (* previous_point)->get_ready_list()) {
-                Process* proc_to_update = find_process(this->processes_data, waiting_process.get_proc_name());
-                if (proc_to_update != nullptr) proc_to_update->add_total_waiting_time(diff);
+        for (size_t i{ 0 }; i < names.size(); i++) {
+            if (std::function<std::unique_ptr<Scheduling_Policy>()> factory = this->get_policy(names.at(i))) {
+                policies.push_back(factory());
+                shared_policies.push_back(policies.back().get());
+                shared_timelines.push_back(&timelines.at(i));
             }
 
-            if ((*previous_point)->is_cpu_busy()) {
-                // Calculating response time.
-                Process* running_proc = find_process(this->processes_data, (*previous_point)->get_cpu_process().get_proc_name());
-                if (running_proc->is_response_set() == false)
-                    running_proc->set_response_time((*previous_point)->get_time_since_start());
-
-                // Calculating turnaround time.
-                // This model assumes all processes are submitted at start.
-                Running_Process::status_type p_next_status = (*previous_point)->get_cpu_process().get_next_process_state(diff).get_status();
-                if (p_next_status == Running_Process::status_type::done)
-                    running_proc->set_turnaround_time((*current_point)->get_time_since_start());
-            }
-            
-            else { // Add time not being utilized.
-                unused_cpu += diff;
-            }
-            
-            // The i++
-            previous_point = current_point;
-            current_point = std::next(current_point);
+            else if (std::function<void(const std::vector<Process_Data>&, Timeline&)> algorithm = this->get_algorithm(names.at(i)))
+                algorithm(*this->processes, timelines.at(i));
         }
 
-        // Adding turnaround for the last process.
-        Process* last_proc = find_process(this->processes_data, (*previous_point)->get_cpu_process().get_proc_name());
-        last_proc->set_turnaround_time((*current_point)->get_time_since_start());
-
-        // Calculate CPU utilization.
-        this->total_results.cpu_utilization = static_cast<double>((*last_point)->get_time_since_start() - unused_cpu) / static_cast<double>((*last_point)->get_time_since_start());
+        // The Shared_Prefix_Runner submits every process at the start, so with dependencies or later arrivals every policy runs on its own.
+        if (Dependency_Graph::has_dependencies(*this->processes) || Process_Data::has_arrivals(*this->processes))
+            for (size_t i{ 0 }; i < shared_policies.size(); i++) Policy_Runner(*this->processes, *shared_policies.at(i)).run(*shared_timelines.at(i));
 
-        // Calculate averages.
-        this->total_results.avg_response_time = this->total_results.avg_turnaround_time = this->total_results.avg_waiting_time = 0;
-        
-        for (const Evaluator::Process& proc : this->processes_data) {
-            this->total_results.avg_response_time   += static_cast<double>(proc.get_response_time());
-            this->total_results.avg_turnaround_time += static_cast<double>(proc.get_turnaround_time());
-            this->total_results.avg_waiting_time    += static_cast<double>(proc.get_total_waiting_time());
-        }
+        else Shared_Prefix_Runner(*this->processes, shared_policies).run(shared_timelines);
 
-        this->total_results.avg_response_time   /= this->processes_data.size();
-        this->total_results.avg_turnaround_time /= this->processes_data.size();
-        this->total_results.avg_waiting_time    /= this->processes_data.size();
+        // Every timeline counts the points it shares with the others, as if the algorithms had run on their own.
+        unsigned long long events{ 0 };
+        for (const Timeline& timeline : timelines) events += timeline.get_committed_points();
+        scope.set_events(events);
     }
+
+    for (size_t i{ 0 }; i < names.size(); i++)
+        if (!timelines.at(i).empty())
+            results.at(i) = std::make_shared<const Result_Snapshot>(names.at(i), this->processes, std::move(timelines.at(i)));
+
+    return results;
 }
 
-OS_Scheduler_Simulator::Engine::Evaluator::Process::Process(OS_Scheduler_Simulator::Engine::Process_Data* process)
-    : process(process), total_waiting_time(0), turnaround_time(0), response_time(0), response_time_set(false), turnaround_time_set(false) {}
+OS_Scheduler_Simulator::Engine::Evaluator::results_table OS_Scheduler_Simulator::Engine::Simulation::run_checkpointed(std::string name_identifier, Checkpoint* resume, std::string path, size_t interval, Timeline::switch_costs costs, std::string* error) {
+    std::function<void(const std::vector<Process_Data>&, Timeline&)> algorithm = this->get_algorithm(name_identifier);
 
-OS_Scheduler_Simulator::Engine::Simulation::Simulation(const std::span<Process_Data>& processes)
-    : processes(), evaluator(nullptr) {
-    for (unsigned i{ 0 }; i < processes.size(); i++)
-        this->processes.push_back(processes[i]);
+    if (!algorithm) {
+        if (error != nullptr) *error = "unknown algorithm \"" + name_identifier + "\"";
+        return Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+    }
 
-    this->processes.shrink_to_fit();
-    this->evaluator = new Evaluator(this->processes, &this->timeline);
+    Evaluator evaluator(*this->processes, nullptr);
+    Timeline timeline(false);
+    timeline.set_switch_costs(costs);
+    timeline.set_observer([&evaluator](const Data_Point& data_point) { evaluator.add_data_point(data_point); }, false);
 
-    // Registering default algorithms.
-    this->register_algorithm("FCFS", OS_SS_Algorithms::FCFS);
-    this->register_algorithm("SJF", OS_SS_Algorithms::SJF);
-    this->register_algorithm("MLFQ", OS_SS_Algorithms::MLFQ);
-}
+    if (resume != nullptr) {
+        const size_t committed_points = static_cast<size_t>(resume->get());
 
-OS_Scheduler_Simulator::Engine::Simulation::~Simulation() {
-    delete this->evaluator;
+        if (!evaluator.load_state(*resume)) {
+            if (error != nullptr) *error = "\"" + path + "\" is corrupted";
+            return Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+        }
 
-    for (Data_Point* data_point : this->timeline)
-        delete data_point;
-}
+        timeline.set_resume_checkpoint(resume, committed_points);
+    }
 
-void OS_Scheduler_Simulator::Engine::Simulation::register_algorithm(std::string name, std::function<void(const std::vector<Process_Data>&, std::list<Data_Point*>&)> algorithm) {
-    bool algorithm_exists = false;
+    // Header, then the evaluation, then the algorithm; resume_from_checkpoint reads them back in that order.
+    Checkpoint checkpoint(*this->processes);
+    std::string write_error;
+
+    timeline.set_checkpoints(interval, [&](const Timeline& current) {
+        checkpoint.clear();
+        checkpoint.put_string(name_identifier);
+        checkpoint.put(costs.switch_cost);
+        checkpoint.put(costs.cache_penalty);
+        checkpoint.put(costs.cache_decay);
+        checkpoint.put(interval);
+        checkpoint.put(current.get_committed_points());
+
+        evaluator.save_state(checkpoint);
+        current.save_state(checkpoint);
+
+        std::string save_error;
+        if (!checkpoint.save(path, &save_error) && write_error.empty()) write_error = save_error;
+    });
+
+    {
+        Perf_Counters::Scope scope(Perf_Counters::phase::algorithm);
+        algorithm(*this->processes, timeline);
+        scope.set_events(timeline.get_committed_points());
+    }
 
-    for (const auto& [alg_name, func] : this->algorithms)
-        if (alg_name == name) {
-            algorithm_exists = true;
-            break;
-        }
-    
-    if (!algorithm_exists)
-        this->algorithms.push_back(std::pair(name, algorithm));
+    if (resume != nullptr && (!timeline.was_resumed() || !resume->is_valid())) {
+        if (error != nullptr) *error = (!resume->is_valid()) ? "\"" + path + "\" is corrupted" : "algorithm \"" + name_identifier + "\" cannot resume from a checkpoint";
+        return Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+    }
 
-    // NOTE: For future refactoring. Could the list be changed to vector, be sorted, and improve checking time?
+    if (error != nullptr) {
+        if (!timeline.can_checkpoint()) *error = "algorithm \"" + name_identifier + "\" cannot be checkpointed";
+        else if (!write_error.empty()) *error = write_error;
+    }
+
+    evaluator.finish();
+
+    // Both refer to this frame.
+    timeline.set_observer(nullptr);
+    timeline.set_checkpoints(0, nullptr);
+
+    std::shared_ptr<const Result_Snapshot> results = std::make_shared<const Result_Snapshot>(name_identifier, this->processes, std::move(timeline), evaluator);
+    this->latest_results.store(results);
+
+    return results->get_total_results();
 }
 
-OS_Scheduler_Simulator::Engine::Evaluator::results_table OS_Scheduler_Simulator::Engine::Simulation::execute_algorithm(std::string name_identifier) {
-    // Clear the timeline before doing anything else.
-    for (Data_Point* data_point : this->timeline)
-        delete data_point;
+OS_Scheduler_Simulator::Engine::Data_Point OS_Scheduler_Simulator::Engine::Simulation::get_latest_data_point() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_latest_data_point() : Data_Point(*this->processes);
+}
 
-    this->timeline.clear();
+unsigned OS_Scheduler_Simulator::Engine::Simulation::get_execution_time() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_execution_time() : 0;
+}
 
-    // Run function if it exists.
-    for (const auto& [alg_name, func] : this->algorithms)
-        if (alg_name == name_identifier) {
-            func(this->processes, this->timeline);
-            this->evaluator->run_evaluation();
-        }
+OS_Scheduler_Simulator::Engine::Evaluator::results_table OS_Scheduler_Simulator::Engine::Simulation::get_total_results() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_total_results() : Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+}
 
-    return this->evaluator->get_overall_totals();
+std::vector<OS_Scheduler_Simulator::Engine::Evaluator::Process> OS_Scheduler_Simulator::Engine::Simulation::get_per_process_evaluation() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_per_process_evaluation() : std::vector<Evaluator::Process>();
 }
 
-OS_Scheduler_Simulator::Engine::Data_Point OS_Scheduler_Simulator::Engine::Simulation::get_data_at(unsigned time) {
-    for (std::list<Data_Point*>::iterator it{ this->timeline.begin() }; it != this->timeline.end(); it = std::next(it)) {
-        if ((*it)->get_time_since_start() > time) {
-            return *(* std::prev(it));
-            break;
-        }
-    }
-    
-    // if (time == this->timeline.back()->get_time_since_start()) 
-    return *(this->timeline.back());
+std::vector<OS_Scheduler_Simulator::Engine::Evaluator::device_usage> OS_Scheduler_Simulator::Engine::Simulation::get_device_usage() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_device_usage() : std::vector<Evaluator::device_usage>();
 }
 
 /// <summary>
-/// First Come, First Serve scheduling algorithm.
+/// Get the memory taken by the timeline of the latest run, in memory and spilled (see set_memory_budget).
 /// </summary>
-/// <param name="processes">- List of processes for this algorithm.</param>
-/// <param name="timeline">- Blank timeline to populate.</param>
-void OS_SS_Algorithms::FCFS(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, std::list<OS_Scheduler_Simulator::Engine::Data_Point*>& timeline) {
-    OS_Scheduler_Simulator::Engine::Data_Point* current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(processes);
+OS_Scheduler_Simulator::Engine::Timeline::memory_usage OS_Scheduler_Simulator::Engine::Simulation::get_memory_usage() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_timeline().get_memory_usage() : Timeline::memory_usage{ .resident_bytes = 0, .peak_resident_bytes = 0, .spilled_bytes = 0, .spilled_points = 0 };
+}
 
-    // Sending the first process to the CPU before commiting to the timeline.
-    std::list<OS_Scheduler_Simulator::Engine::Running_Process> waiting_list = current_data_point->get_waiting_list();
-    std::list<OS_Scheduler_Simulator::Engine::Running_Process> ready_list = current_data_point->get_ready_list();
-    OS_Scheduler_Simulator::Engine::Running_Process running = ready_list.front();
-    
-    running.send_to_cpu();
-    ready_list.pop_front();
+std::vector<OS_Scheduler_Simulator::Engine::Evaluator::group_usage> OS_Scheduler_Simulator::Engine::Simulation::get_group_usage() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_group_usage() : std::vector<Evaluator::group_usage>();
+}
 
-    delete current_data_point;
-    current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(0, waiting_list, ready_list, running);
-    timeline.push_back(current_data_point);
+OS_Scheduler_Simulator::Engine::Evaluator::deadline_report OS_Scheduler_Simulator::Engine::Simulation::get_deadline_report() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_deadline_report() : Evaluator::deadline_report{ .jobs = 0, .misses = 0, .worst_lateness = 0, .total_tardiness = 0, .max_tardiness = 0, .tardiness_histogram = {} };
+}
 
-    while (!current_data_point->is_done()) {
-        ready_list = current_data_point->get_ready_list();
-        waiting_list = current_data_point->get_waiting_list();
-        running = current_data_point->get_cpu_process();
+OS_Scheduler_Simulator::Engine::Data_Point OS_Scheduler_Simulator::Engine::Simulation::get_data_at(unsigned time) const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    return (results != nullptr) ? results->get_data_at(time) : Data_Point(*this->processes);
+}
 
-        OS_Scheduler_Simulator::Engine::Data_Point::event next_event = current_data_point->get_next_event();
+std::shared_ptr<const OS_Scheduler_Simulator::Engine::Interval_Index> OS_Scheduler_Simulator::Engine::Simulation::get_interval_index() const {
+    std::shared_ptr<const Result_Snapshot> results = this->get_results();
+    if (results == nullptr) return nullptr;
 
-        // Running events.
-        if (running.is_valid()) running = running.get_next_process_state(next_event.time);
-        for (OS_Scheduler_Simulator::Engine::Running_Process& process : waiting_list) process = process.get_next_process_state(next_event.time);
+    // Shares ownership of the snapshot, which owns the index.
+    return std::shared_ptr<const Interval_Index>(results, &results->get_interval_index());
+}
 
-        // Removing process from CPU if completed.
-        if (next_event.event_type == OS_Scheduler_Simulator::Engine::Data_Point::event_type::cpu) {
-            if (running.get_status() == OS_Scheduler_Simulator::Engine::Running_Process::status_type::waiting)
-                waiting_list.push_back(running); // It will be performing some IO operations now.
+/// <summary>
+/// Result_Snapshot constructor. Takes ownership of the timeline and evaluates it.
+/// </summary>
+/// <param name="algorithm_name">- Name of the algorithm that produced the timeline.</param>
+/// <param name="processes">- Processes the timeline points into. Kept alive by the snapshot.</param>
+/// <param name="timeline">- Complete timeline of the run.</param>
+OS_Scheduler_Simulator::Engine::Result_Snapshot::Result_Snapshot(std::string algorithm_name, std::shared_ptr<std::vector<Process_Data>> processes, Timeline&& timeline)
+    : algorithm_name(algorithm_name), processes(processes), timeline(std::move(timeline)), total_results({ 0, 0, 0, 0, 0, 0, 0 }), per_process(), devices(), groups(), deadlines(),
+      interval_index_built(), interval_index() {
+    Evaluator evaluator(*this->processes, &this->timeline);
+    this->total_results = evaluator.get_overall_totals();
+    this->per_process = evaluator.get_all_processes_data();
+    this->devices = evaluator.get_device_usage();
+    this->groups = evaluator.get_group_usage();
+    this->deadlines = evaluator.get_deadline_report();
+}
 
-            running = OS_Scheduler_Simulator::Engine::Running_Process(nullptr); // CPU open.
-        }
+/// <summary>
+/// Result_Snapshot constructor for runs evaluated as they went (see Simulation::run_with_checkpoints). Takes ownership of what is left of
+/// the timeline.
+/// </summary>
+/// <param name="evaluator">- Evaluator that saw every point of the run, finished.</param>
+OS_Scheduler_Simulator::Engine::Result_Snapshot::Result_Snapshot(std::string algorithm_name, std::shared_ptr<std::vector<Process_Data>> processes, Timeline&& timeline, Evaluator& evaluator)
+    : algorithm_name(algorithm_name), processes(processes), timeline(std::move(timeline)), total_results(evaluator.get_overall_totals()), per_process(evaluator.get_all_processes_data()),
+      devices(evaluator.get_device_usage()), groups(evaluator.get_group_usage()), deadlines(evaluator.get_deadline_report()), interval_index_built(), interval_index() {}
 
-        // Regardless of previous case, check if any I/O operations is completed.
-        for (std::list<OS_Scheduler_Simulator::Engine::Running_Process>::iterator it{ waiting_list.begin() }; it != waiting_list.end(); ) {
-            if ((*it).get_status() == OS_Scheduler_Simulator::Engine::Running_Process::status_type::ready) {
-                ready_list.push_back((*it));
-                it = waiting_list.erase(it);
-            }
+OS_Scheduler_Simulator::Engine::Result_Snapshot::~Result_Snapshot() = default;
 
-            else it = std::next(it);
-        }
+/// <summary>
+/// Get the state of the simulation at a given time (the last data point at or before it).
+/// </summary>
+OS_Scheduler_Simulator::Engine::Data_Point OS_Scheduler_Simulator::Engine::Result_Snapshot::get_data_at(unsigned time) const {
+    Perf_Counters::Scope scope(Perf_Counters::phase::data_lookup, 1);
+    return this->timeline.get_data_at(time);
+}
 
-        if (!running.is_valid() && ready_list.size() > 0) {
-            running = ready_list.front();
-            ready_list.pop_front();
-            running.send_to_cpu();
-        }
+/// <summary>
+/// Get the interval index of the timeline. The first call builds it in one pass over the timeline; concurrent callers wait for it.
+/// </summary>
+const OS_Scheduler_Simulator::Engine::Interval_Index& OS_Scheduler_Simulator::Engine::Result_Snapshot::get_interval_index() const {
+    std::call_once(this->interval_index_built, [this]() {
+        this->interval_index = std::make_unique<Interval_Index>(this->timeline, *this->processes);
+    });
 
-        // Adding data point.
-        current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(current_data_point->get_time_since_start() + next_event.time, waiting_list, ready_list, running);
-        timeline.push_back(current_data_point);
-    }
+    return *this->interval_index;
 }
 
 /// <summary>
-/// Shortest Job First algorithm. Note: This algorithm could not be implemented in real life because the scheduler would need to know the CPU bursts beforehand; however, the ASJF is a real world implementation of this algorithm.
+/// First Come, First Serve scheduling algorithm.
 /// </summary>
 /// <param name="processes">- List of processes for this algorithm.</param>
 /// <param name="timeline">- Blank timeline to populate.</param>
-void OS_SS_Algorithms::SJF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, std::list<OS_Scheduler_Simulator::Engine::Data_Point*>& timeline) {
+void OS_SS_Algorithms::FCFS(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    // The policy gives the same timelines, and releases the processes with dependencies or arriving later.
+    if (OS_Scheduler_Simulator::Engine::Dependency_Graph::has_dependencies(processes) || OS_Scheduler_Simulator::Engine::Process_Data::has_arrivals(processes)) {
+        FCFS_Policy policy;
+        OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+        return;
+    }
+
     OS_Scheduler_Simulator::Engine::Data_Point* current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(processes);
+    OS_Scheduler_Simulator::Engine::Context_Switches switches(processes, timeline);
 
-    // Sending the shortest process first to the CPU before commiting to the timeline.
+    // Sending the first process to the CPU before commiting to the timeline.
     std::list<OS_Scheduler_Simulator::Engine::Running_Process> waiting_list = current_data_point->get_waiting_list();
     std::list<OS_Scheduler_Simulator::Engine::Running_Process> ready_list = current_data_point->get_ready_list();
+    OS_Scheduler_Simulator::Engine::Running_Process running = ready_list.front();
+    
+    running.send_to_cpu();
+    ready_list.pop_front();
 
-    // Get the shortest job in the ready list.
-    auto shortest = [&ready_list]() -> std::list<OS_Scheduler_Simulator::Engine::Running_Process>::const_iterator {
-        std::list<OS_Scheduler_Simulator::Engine::Running_Process>::const_iterator shortest_job = ready_list.begin();
+    delete current_data_point;
 
-        for (auto it{ ready_list.begin() }; it != ready_list.end(); it = std::next(it))
-            if (it->time_to_end_current_burst() < shortest_job->time_to_end_current_burst())
-                shortest_job = it;
+    // The latest point holds the whole state, apart from the context switches.
+    timeline.set_state_saver([&timeline, &switches](OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+        checkpoint.put_point(*timeline.back());
+        switches.save_state(checkpoint);
+    });
 
-        return shortest_job;
-    };
+    if (OS_Scheduler_Simulator::Engine::Checkpoint* checkpoint = timeline.get_resume_checkpoint()) {
+        current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(checkpoint->get_point());
+        switches.load_state(*checkpoint);
 
-    // Send the shortest job to the CPU.
-    std::list<OS_Scheduler_Simulator::Engine::Running_Process>::const_iterator temp = shortest();
-    OS_Scheduler_Simulator::Engine::Running_Process running = *temp;
-    ready_list.erase(temp);
+        if (!checkpoint->is_valid()) {
+            delete current_data_point;
+            timeline.set_state_saver(nullptr);
+            return;
+        }
 
-    running.send_to_cpu();
+        timeline.resume(current_data_point);
+    }
 
-    // Commit to timeline.
-    delete current_data_point;
-    current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(0, waiting_list, ready_list, running);
-    timeline.push_back(current_data_point);
+    else {
+        switches.charge(running, 0);
+        current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(0, waiting_list, ready_list, running);
+        timeline.push_back(current_data_point);
+    }
 
-    // Start loop for the timeline.
-    while (!current_data_point->is_done()) {
-        // Update lists.
+    while (!current_data_point->is_done() && !timeline.stop_requested()) {
         ready_list = current_data_point->get_ready_list();
         waiting_list = current_data_point->get_waiting_list();
         running = current_data_point->get_cpu_process();
 
-        // Get next event.
         OS_Scheduler_Simulator::Engine::Data_Point::event next_event = current_data_point->get_next_event();
 
-        // Running processes.
+        // Running events.
         if (running.is_valid()) running = running.get_next_process_state(next_event.time);
-        for (OS_Scheduler_Simulator::Engine::Running_Process& process : waiting_list) process = process.get_next_process_state(next_event.time);
+        OS_Scheduler_Simulator::Engine::IO_Device::advance_waiting_list(waiting_list, next_event.time);
 
         // Removing process from CPU if completed.
         if (next_event.event_type == OS_Scheduler_Simulator::Engine::Data_Point::event_type::cpu) {
@@ -432,63 +1735,89 @@ void OS_SS_Algorithms::SJF(const std::vector<OS_Scheduler_Simulator::Engine::Pro
         }
 
         if (!running.is_valid() && ready_list.size() > 0) {
-            // Getting the next shortest job first if CPU is open.
-            temp = shortest();
-            running = *temp;
-            ready_list.erase(temp);
-
+            running = ready_list.front();
+            ready_list.pop_front();
             running.send_to_cpu();
         }
 
         // Adding data point.
+        switches.charge(running, current_data_point->get_time_since_start() + next_event.time);
         current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(current_data_point->get_time_since_start() + next_event.time, waiting_list, ready_list, running);
         timeline.push_back(current_data_point);
     }
+
+    timeline.set_state_saver(nullptr);
 }
 
 /// <summary>
-/// This Implementation of MLFQ has three levels.
-/// 
-/// - First level uses Round Robin with time quantum = 5.
-/// - Second level uses Round Robin with time quantum = 10.
-/// - Third level uses Round Robin with time quantum = 10.
+/// Shortest Job First algorithm. Note: This algorithm could not be implemented in real life because the scheduler would need to know the CPU bursts beforehand; however, the ASJF is a real world implementation of this algorithm.
 /// </summary>
 /// <param name="processes">- List of processes for this algorithm.</param>
 /// <param name="timeline">- Blank timeline to populate.</param>
-void OS_SS_Algorithms::MLFQ(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, std::list<OS_Scheduler_Simulator::Engine::Data_Point*>& timeline) {
-    // All the ready queues.
-    std::list<OS_Scheduler_Simulator::Engine::Running_Process> round_robin_1;
-    std::list<OS_Scheduler_Simulator::Engine::Running_Process> round_robin_2;
-    std::list<OS_Scheduler_Simulator::Engine::Running_Process> FCFS;
-    
+void OS_SS_Algorithms::SJF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    // The ready queue is a heap keyed on the current burst, so getting the shortest job does not scan the whole ready list.
+    SJF_Policy policy;
+    OS_Scheduler_Simulator::Engine::Policy_Runner(processes, policy).run(timeline);
+}
+
+/// <summary>
+/// MLFQ with the given quanta and boost period (see make_MLFQ).
+/// </summary>
+static void run_MLFQ(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline, unsigned quantum_1, unsigned quantum_2,
+    unsigned boost_period) {
+    // All the ready queues: the round robins are levels 0 and 1, FCFS is level 2.
+    OS_SS_Algorithms::Level_Queues queues;
+    queues.reset(processes, 3);
+
     std::list<OS_Scheduler_Simulator::Engine::Running_Process> IO_list; // waiting_list in other algorithms here.
     OS_Scheduler_Simulator::Engine::Running_Process running(nullptr);
+    OS_Scheduler_Simulator::Engine::Context_Switches switches(processes, timeline);
+
+    // Processes with dependencies join level 1 once they are released, like the ones returning from I/O.
+    std::optional<OS_Scheduler_Simulator::Engine::Dependency_Graph> dependencies;
+    std::vector<size_t> released;
+    if (OS_Scheduler_Simulator::Engine::Dependency_Graph::has_dependencies(processes)) dependencies.emplace(processes);
+
+    // Processes arriving after the start join level 1 when they arrive, in that order, once they are released too.
+    std::vector<size_t> arrivals;
+    size_t next_arrival{ 0 };
+
+    for (size_t i{ 0 }; i < processes.size(); i++)
+        if (processes.at(i).get_arrival() > 0) arrivals.push_back(i);
+
+    std::stable_sort(arrivals.begin(), arrivals.end(), [&processes](size_t a, size_t b) { return processes.at(a).get_arrival() < processes.at(b).get_arrival(); });
 
     // Preparing the first commit.
-    for (const auto& proc : processes) { // Initially adding all of them to the level 1.
-        OS_Scheduler_Simulator::Engine::Running_Process process(&proc);
+    for (size_t i{ 0 }; i < processes.size(); i++) { // Initially adding all of them to the level 1.
+        if (processes.at(i).get_arrival() > 0 || (dependencies.has_value() && !dependencies->is_released(i))) continue;
+
+        OS_Scheduler_Simulator::Engine::Running_Process process(&processes.at(i));
         process.set_level(1);
-        round_robin_1.push_back(process);
+        queues.push_back(0, process);
     }
     
+    // Time the running process had spent on its burst when it was dispatched; its time slice counts from there.
+    unsigned slice_start{ 0 };
+
     // Send the first process to CPU.
-    running = round_robin_1.front();
-    round_robin_1.pop_front();
-    running.send_to_cpu();
+    if (!queues.empty()) {
+        running = queues.pop_front(0);
+        running.send_to_cpu();
+    }
 
     // What level is running?
     enum levels { level_1, level_2, level_3 };
     levels level_running = levels::level_1;
 
-    auto get_time_quantum = [](levels level) -> unsigned {
+    auto get_time_quantum = [quantum_1, quantum_2](levels level) -> unsigned {
         unsigned time;
         switch (level)
         {
         case levels::level_1:
-            time = 5;
+            time = quantum_1;
             break;
         case levels::level_2:
-            time = 10;
+            time = quantum_2;
             break;
         case levels::level_3: // FCFS has no time quantum.
         default:
@@ -499,65 +1828,112 @@ void OS_SS_Algorithms::MLFQ(const std::vector<OS_Scheduler_Simulator::Engine::Pr
         return time;
     };
 
-    // Function to combine all queues to one for easy commit.
-    // This could be improved by changing the architecture of a Data_Point to hold multiple ready_queues (optimization for MLFQ).
-    auto prepare_ready_queue = [](
-            const std::list<OS_Scheduler_Simulator::Engine::Running_Process>& round_robin_1, 
-            const std::list<OS_Scheduler_Simulator::Engine::Running_Process>& round_robin_2,
-            const std::list<OS_Scheduler_Simulator::Engine::Running_Process>& FCFS
-        ) -> std::list<OS_Scheduler_Simulator::Engine::Running_Process> {
-        std::list<OS_Scheduler_Simulator::Engine::Running_Process> ready_queue;
-        ready_queue.insert(ready_queue.end(), round_robin_1.begin(), round_robin_1.end());
-        ready_queue.insert(ready_queue.end(), round_robin_2.begin(), round_robin_2.end());
-        ready_queue.insert(ready_queue.end(), FCFS.begin(),    FCFS.end());
-        return ready_queue;
-    };
+    // The queues are saved apart, as the Data_Points hold them (Data_Point::get_ready_levels).
+    timeline.set_state_saver([&](OS_Scheduler_Simulator::Engine::Checkpoint& checkpoint) {
+        checkpoint.put(timeline.back()->get_time_since_start());
+        for (unsigned level{ 0 }; level < 3; level++) checkpoint.put_processes(queues.get_list(level));
+        checkpoint.put_processes(IO_list);
+        checkpoint.put_process(running);
+        checkpoint.put(static_cast<unsigned long long>(level_running));
+        checkpoint.put(slice_start);
+        switches.save_state(checkpoint);
+        if (dependencies.has_value()) dependencies->save_state(checkpoint);
+    });
+
+    OS_Scheduler_Simulator::Engine::Data_Point* current_data_point;
+
+    if (OS_Scheduler_Simulator::Engine::Checkpoint* checkpoint = timeline.get_resume_checkpoint()) {
+        const unsigned time = static_cast<unsigned>(checkpoint->get());
+        queues.reset(processes, 3); // The saved queues replace the initial one.
+
+        for (unsigned level{ 0 }; level < 3; level++)
+            for (const OS_Scheduler_Simulator::Engine::Running_Process& process : checkpoint->get_processes()) queues.push_back(level, process);
+
+        IO_list = checkpoint->get_processes();
+        running = checkpoint->get_process();
+
+        const unsigned long long level = checkpoint->get();
+        level_running = (level <= levels::level_3) ? static_cast<levels>(level) : levels::level_1;
+        slice_start = static_cast<unsigned>(checkpoint->get());
+        switches.load_state(*checkpoint);
+        if (dependencies.has_value()) dependencies->load_state(*checkpoint);
+
+        if (!checkpoint->is_valid() || level > levels::level_3) {
+            timeline.set_state_saver(nullptr);
+            return;
+        }
+
+        while (next_arrival < arrivals.size() && processes.at(arrivals.at(next_arrival)).get_arrival() <= time) next_arrival++;
+
+        current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(time, IO_list, queues.get_ready_levels(), running);
+        timeline.resume(current_data_point);
+    }
 
     // First commit to the timeline.
-    OS_Scheduler_Simulator::Engine::Data_Point* current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(0, IO_list, prepare_ready_queue(round_robin_1, round_robin_2, FCFS), running);
-    timeline.push_back(current_data_point);
+    else {
+        switches.charge(running, 0);
+        current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(0, IO_list, queues.get_ready_levels(), running);
+        timeline.push_back(current_data_point);
+    }
 
     // The loop.
-    while (!current_data_point->is_done()) {
+    while ((!current_data_point->is_done() || next_arrival < arrivals.size()) && !timeline.stop_requested()) {
         // All lists should stay the same as in the previous iteration.
 
-        // Get the next event.
+        // Get the next event. The next arrival ends the step like the end of an I/O burst.
         OS_Scheduler_Simulator::Engine::Data_Point::event next_event = current_data_point->get_next_event();
         unsigned current_time_quantum{ 0 };
 
-        // Check if interrupted by time quantum.
-        current_time_quantum = get_time_quantum(level_running);
-        
-        if (current_data_point->is_cpu_busy() && level_running == levels::level_1 && current_time_quantum < running.time_in_operation() + next_event.time) {
-            next_event.event_type = OS_Scheduler_Simulator::Engine::Data_Point::event_type::cpu;
-            next_event.time = current_time_quantum - running.time_in_operation();
+        if (next_arrival < arrivals.size()) {
+            const unsigned arrival = processes.at(arrivals.at(next_arrival)).get_arrival() - current_data_point->get_time_since_start();
+
+            if (next_event.event_type == OS_Scheduler_Simulator::Engine::Data_Point::event_type::done || arrival < next_event.time)
+                next_event = OS_Scheduler_Simulator::Engine::Data_Point::event{ .event_type = OS_Scheduler_Simulator::Engine::Data_Point::event_type::io, .time = arrival };
+        }
+
+        // So does the next boost.
+        if (boost_period > 0) {
+            const unsigned boost = boost_period - current_data_point->get_time_since_start() % boost_period;
+
+            if (next_event.event_type == OS_Scheduler_Simulator::Engine::Data_Point::event_type::done || boost < next_event.time)
+                next_event = OS_Scheduler_Simulator::Engine::Data_Point::event{ .event_type = OS_Scheduler_Simulator::Engine::Data_Point::event_type::io, .time = boost };
         }
 
-        else if (current_data_point->is_cpu_busy() && level_running == levels::level_2 && current_time_quantum < (running.time_in_operation() - get_time_quantum(levels::level_1)) + next_event.time) {
+        // Check if interrupted by time quantum. The quanta only count time spent on the burst, after the switch overhead.
+        current_time_quantum = get_time_quantum(level_running);
+        const unsigned switching = (current_data_point->is_cpu_busy()) ? running.get_switch_overhead() : 0;
+        const unsigned on_burst = next_event.time - std::min(next_event.time, switching);
+        const unsigned in_slice = (current_data_point->is_cpu_busy()) ? running.time_in_operation() - slice_start : 0;
+
+        if (current_data_point->is_cpu_busy() && level_running != levels::level_3 && current_time_quantum < in_slice + on_burst) {
             next_event.event_type = OS_Scheduler_Simulator::Engine::Data_Point::event_type::cpu;
-            next_event.time = current_time_quantum - (running.time_in_operation() - get_time_quantum(levels::level_1));
+            next_event.time = switching + current_time_quantum - in_slice;
         }
         
         // Running processes.
         if (running.is_valid()) running = running.get_next_process_state(next_event.time);
-        for (OS_Scheduler_Simulator::Engine::Running_Process& process : IO_list) process = process.get_next_process_state(next_event.time);
+        OS_Scheduler_Simulator::Engine::IO_Device::advance_waiting_list(IO_list, next_event.time);
 
         // Removing process from CPU if completed or time quantum interrupted.
         if (next_event.event_type == OS_Scheduler_Simulator::Engine::Data_Point::event_type::cpu) {
             if (running.get_status() == OS_Scheduler_Simulator::Engine::Running_Process::status_type::waiting)
                 IO_list.push_back(running); // It will be performing some IO operations now.
 
+            else if (running.get_status() == OS_Scheduler_Simulator::Engine::Running_Process::status_type::done) {
+                if (dependencies.has_value()) dependencies->finish(static_cast<size_t>(running.get_process_data() - processes.data()), released);
+            }
+
             // If an even in CPU was not caused by burst completion, it must have been a quantum interruption.
-            else if (running.get_status() != OS_Scheduler_Simulator::Engine::Running_Process::status_type::done) {
+            else {
                 switch (level_running)
                 {
                 case levels::level_1:
                     running.set_level(2);
-                    round_robin_2.push_back(running);
+                    queues.push_back(1, running);
                     break;
                 case levels::level_2:
                     running.set_level(3);
-                    FCFS.push_back(running);
+                    queues.push_back(2, running);
                     break;
                 }
             }
@@ -570,38 +1946,91 @@ void OS_SS_Algorithms::MLFQ(const std::vector<OS_Scheduler_Simulator::Engine::Pr
         for (std::list<OS_Scheduler_Simulator::Engine::Running_Process>::iterator it{ IO_list.begin() }; it != IO_list.end(); ) {
             if ((*it).get_status() == OS_Scheduler_Simulator::Engine::Running_Process::status_type::ready) {
                 (*it).set_level(1);
-                round_robin_1.push_back((*it)); // Send to level 1 if done.
+                queues.push_back(0, *it); // Send to level 1 if done.
                 it = IO_list.erase(it);
             }
 
             else it = std::next(it);
         }
 
-        // Put something in the CPU if empty.
-        if (!running.is_valid() && (round_robin_1.size() > 0 || round_robin_2.size() > 0 || FCFS.size() > 0)) {
-            if (round_robin_1.size() > 0) {
-                running = round_robin_1.front();
-                round_robin_1.pop_front();
+        const unsigned now = current_data_point->get_time_since_start() + next_event.time;
+
+        for (; next_arrival < arrivals.size() && processes.at(arrivals.at(next_arrival)).get_arrival() <= now; next_arrival++) {
+            if (dependencies.has_value() && !dependencies->is_released(arrivals.at(next_arrival))) continue;
+
+            OS_Scheduler_Simulator::Engine::Running_Process process(&processes.at(arrivals.at(next_arrival)));
+            process.set_level(1);
+            queues.push_back(0, process);
+        }
+
+        for (size_t index : released) {
+            if (processes.at(index).get_arrival() > now) continue; // Joins when it arrives.
+
+            OS_Scheduler_Simulator::Engine::Running_Process process(&processes.at(index));
+            process.set_level(1);
+            queues.push_back(0, process);
+        }
+
+        released.clear();
+
+        // The boost moves the lower levels, in order, behind the first one. A boosted running process starts a slice of the first level.
+        if (boost_period > 0 && now % boost_period == 0) {
+            for (unsigned level{ 1 }; level < 3; level++)
+                while (!queues.empty(level)) {
+                    OS_Scheduler_Simulator::Engine::Running_Process process = queues.pop_front(level);
+                    process.set_level(1);
+                    queues.push_back(0, process);
+                }
+
+            if (running.is_valid() && level_running != levels::level_1) {
+                running.set_level(1);
                 level_running = levels::level_1;
+                slice_start = running.time_in_operation();
             }
+        }
 
-            else if (round_robin_2.size() > 0) {
-                running = round_robin_2.front();
-                round_robin_2.pop_front();
-                level_running = levels::level_2;
-            }
+        // Put something in the CPU if empty.
+        if (!running.is_valid() && !queues.empty()) {
+            const unsigned level = queues.first_level();
 
-            else {
-                running = FCFS.front();
-                FCFS.pop_front();
-                level_running = levels::level_3;
-            }
-            
+            running = queues.pop_front(level);
+            level_running = static_cast<levels>(level);
             running.send_to_cpu();
+            slice_start = running.time_in_operation();
         }
 
         // Commit to timeline.
-        current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(current_data_point->get_time_since_start() + next_event.time, IO_list, prepare_ready_queue(round_robin_1, round_robin_2, FCFS), running);
+        switches.charge(running, current_data_point->get_time_since_start() + next_event.time);
+        current_data_point = new OS_Scheduler_Simulator::Engine::Data_Point(current_data_point->get_time_since_start() + next_event.time, IO_list, queues.get_ready_levels(), running);
         timeline.push_back(current_data_point);
     }
-}
\ No newline at end of file
+
+    timeline.set_state_saver(nullptr);
+}
+
+/// <summary>
+/// This Implementation of MLFQ has three levels.
+/// 
+/// - First level uses Round Robin with time quantum = 5.
+/// - Second level uses Round Robin with time quantum = 10.
+/// - Third level uses FCFS.
+/// </summary>
+/// <param name="processes">- List of processes for this algorithm.</param>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_SS_Algorithms::MLFQ(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+    run_MLFQ(processes, timeline, 5, 10, 0);
+}
+
+/// <summary>
+/// Build an MLFQ with custom quanta for its two round robin levels and a priority boost, ready to be registered with
+/// Simulation::register_algorithm.
+/// </summary>
+/// <param name="quantum_1">- Time quantum of the first level.</param>
+/// <param name="quantum_2">- Time quantum of the second level.</param>
+/// <param name="boost_period">- Every boost_period time units, every process in the lower levels moves back to the first one, so CPU-bound
+/// processes do not starve. 0 turns the boost off.</param>
+std::function<void(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>&, OS_Scheduler_Simulator::Engine::Timeline&)> OS_SS_Algorithms::make_MLFQ(unsigned quantum_1, unsigned quantum_2, unsigned boost_period) {
+    return [quantum_1, quantum_2, boost_period](const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline) {
+        run_MLFQ(processes, timeline, quantum_1, quantum_2, boost_period);
+    };
+}
@@ -3,9 +3,18 @@
 
 #include <string>
 #include <list>
+#include <deque>
 #include <vector>
+#include <optional>
 #include <functional>
 #include <span>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <iterator>
+#include <utility>
+#include <cstddef>
 
 /// <summary>
 /// Representation of the whole system. FIXME: This class must be further developed for integration with the web interface.
@@ -13,6 +22,11 @@
 class OS_Scheduler_Simulator {
 public:
 	class Engine;
+	class Work_Stealing_Pool;
+	class Batch_Runner;
+	class Parameter_Optimizer;
+	class Simulation_Daemon;
+	class Daemon_Client;
 };
 
 /// <summary>
@@ -23,8 +37,29 @@ public:
 	class Process_Data;
 	class Running_Process;
 	class Data_Point;
+	class Timeline;
 	class Simulation;
 	class Evaluator;
+	class Result_Snapshot;
+	class Trace_Importer;
+	class Trace_Exporter;
+	class Cycle_Detector;
+	class Perf_Counters;
+	class Scheduling_Policy;
+	class Policy_Runner;
+	class Workload_File;
+	class IO_Device;
+	class IO_Queues;
+	class Context_Switches;
+	class Timeline_Spill;
+	class Checkpoint;
+	class Interval_Index;
+	class Shared_Prefix_Runner;
+	class Process_Group;
+	class Calibration;
+	class Lockstep_Batch;
+	class Burst_Store;
+	class Dependency_Graph;
 };
 
 /// <summary>
@@ -33,6 +68,11 @@ public:
 class OS_Scheduler_Simulator::Engine::Process_Data {
 public:
 	Process_Data(std::string name, std::span<unsigned> operations_list);
+	Process_Data(std::string name, const Burst_Store* store, size_t first_operation, size_t operations_size);
+	Process_Data(const Process_Data& other);
+	Process_Data(Process_Data&& other) noexcept = default;
+	Process_Data& operator=(const Process_Data& other);
+	Process_Data& operator=(Process_Data&& other) noexcept = default;
 	
 	/// <summary>Get the name of the process.</summary>
 	/// <returns>Name of the process.</returns>
@@ -40,16 +80,90 @@ public:
 	
 	/// <summary>Get the total number of operation registered for this process.</summary>
 	/// <returns>Total number CPU and I/O bursts.</returns>
-	size_t get_operations_size() const { return this->operations.size(); }
+	size_t get_operations_size() const { return (this->packed_operations == nullptr) ? this->operations.size() : this->packed_size; }
 	
 	/// <summary>Get the total time of an operation given an index.</summary>
 	/// <param name="i">- The operation to retrieve. Odd if it is a CPU burst, or even if it is an I/O burst.</param>
 	/// <returns>The duration of the burst.</returns>
-	unsigned get_operation(size_t i) const { return this->operations.at(i); }
+	unsigned get_operation(size_t i) const { return (this->packed_operations == nullptr) ? this->operations.at(i) : this->get_packed_operation(i); }
+
+	/// <summary>Set the nice value of the process (-20 to 19, as in Linux). Only used by weighted algorithms such as CFS.</summary>
+	/// <param name="nice">- Nice value. Lower values get a larger share of the CPU.</param>
+	void set_nice(int nice) { this->nice = (nice < -20) ? -20 : (nice > 19) ? 19 : nice; }
+	int get_nice() const { return this->nice; }
+
+	/// <summary>Set the device serving the I/O bursts of the process. Without one, its I/O runs in parallel with everything else.</summary>
+	void set_io_device(std::shared_ptr<const IO_Device> device) { this->edit_extras().io_device = device; }
+	const std::shared_ptr<const IO_Device>& get_io_device() const { return this->get_extras().io_device; }
+
+	/// <summary>Set the group of the process. Without one, the process hangs from the root of the group hierarchy.</summary>
+	void set_group(std::shared_ptr<const Process_Group> group) { this->edit_extras().group = group; }
+	const std::shared_ptr<const Process_Group>& get_group() const { return this->get_extras().group; }
+
+	/// <summary>Set the relative deadline of the CPU bursts: each must complete within this time of becoming ready. 0 removes them.</summary>
+	void set_deadline(unsigned deadline) { this->edit_extras().deadlines.assign((deadline > 0) ? 1 : 0, deadline); }
+	
+	/// <summary>Set one relative deadline per CPU burst, in order (0 for none). Bursts past the end of the list use the last one.</summary>
+	void set_deadlines(const std::vector<unsigned>& deadlines) { this->edit_extras().deadlines = deadlines; }
+	const std::vector<unsigned>& get_deadlines() const { return this->get_extras().deadlines; }
+
+	/// <summary>Set the period of the process, its priority for rate-monotonic scheduling. Bursts without a deadline must complete within a period.</summary>
+	void set_period(unsigned period) { this->edit_extras().period = period; }
+	unsigned get_period() const { return this->get_extras().period; }
+
+	unsigned get_deadline(size_t operation) const;
+	bool has_deadlines() const { return this->get_period() > 0 || !this->get_deadlines().empty(); }
+
+	/// <summary>Set the processes that must be done before this one becomes ready, by their index in the workload (see Dependency_Graph).</summary>
+	void set_predecessors(const std::vector<unsigned>& predecessors) { this->edit_extras().predecessors = predecessors; }
+	const std::vector<unsigned>& get_predecessors() const { return this->get_extras().predecessors; }
+
+	/// <summary>Make the process a member of a barrier, which is done once all its members are. 0 for none.</summary>
+	void set_barrier(unsigned barrier) { this->edit_extras().barrier = barrier; }
+	unsigned get_barrier() const { return this->get_extras().barrier; }
+
+	/// <summary>Set the barriers that must be done before the process becomes ready.</summary>
+	void set_awaited_barriers(const std::vector<unsigned>& barriers) { this->edit_extras().awaited_barriers = barriers; }
+	const std::vector<unsigned>& get_awaited_barriers() const { return this->get_extras().awaited_barriers; }
+
+	bool has_dependencies() const { return !this->get_predecessors().empty() || !this->get_awaited_barriers().empty(); }
+
+	/// <summary>Set the time the process is submitted. Until then it is in no queue; with dependencies, it becomes ready once it arrived and
+	/// was released. Its response and turnaround times count from its arrival.</summary>
+	void set_arrival(unsigned arrival) { this->edit_extras().arrival = arrival; }
+	unsigned get_arrival() const { return this->get_extras().arrival; }
+
+	static bool has_arrivals(const std::vector<Process_Data>& processes);
+
+	Process_Data get_prefix(size_t operations) const;
 
 private:
+	/// <summary>Settings most processes leave unset. They are kept apart, and only allocated once one is set, so that large workloads
+	/// only pay for the name and the bursts of every process.</summary>
+	typedef struct {
+		std::shared_ptr<const IO_Device> io_device;
+		std::shared_ptr<const Process_Group> group;
+		std::vector<unsigned> deadlines;
+		unsigned period;
+		unsigned barrier;
+		std::vector<unsigned> predecessors;
+		std::vector<unsigned> awaited_barriers;
+		unsigned arrival;
+	} extra_settings;
+
+	static const extra_settings no_extras;
+
+	unsigned get_packed_operation(size_t i) const;
+	const extra_settings& get_extras() const { return (this->extras != nullptr) ? *this->extras : no_extras; }
+	extra_settings& edit_extras();
+
 	std::string name;
-	std::vector<unsigned> operations;
+	std::vector<unsigned> operations;                         // Empty when the bursts are in a Burst_Store.
+	const Burst_Store* packed_operations;                     // Owned by whoever built the process; it must outlive its copies.
+	size_t packed_first;                                      // Index of the first burst in the store.
+	unsigned packed_size;
+	int nice;
+	std::unique_ptr<extra_settings> extras;                   // nullptr while every setting has its default.
 };
 
 class OS_Scheduler_Simulator::Engine::Running_Process {
@@ -57,19 +171,26 @@ public:
 	typedef enum { running, waiting, ready, done } status_type;
 
 	Running_Process(const Process_Data* process);
+	Running_Process(const Process_Data* process, status_type status, size_t operation, unsigned time_in_operation, unsigned level, unsigned switch_overhead);
 	
 	Running_Process get_next_process_state(unsigned time) const;
 	unsigned time_to_end_current_burst() const;
 	unsigned time_in_operation() const { return this->time_in_current_operation; };
+	size_t get_operation_index() const { return this->current_operation; }
 	
 	status_type get_status() const { return this->status; }
-	void send_to_ready() { this->status = status_type::ready; }
+	void send_to_ready() { this->status = status_type::ready; this->switch_overhead = 0; }
 	void send_to_cpu() { this->status = status_type::running; }
 	bool is_valid() const { return (this->process != nullptr) ? true : false; }
 	std::string get_proc_name() const { return this->process->get_name(); }
+	const Process_Data* get_process_data() const { return this->process; }
 
 	void set_level(unsigned level) { this->level = level; }
 	unsigned get_level() const { return this->level; }
+
+	/// <summary>Make the process spend some CPU time switching in before its burst progresses (see Context_Switches).</summary>
+	void add_switch_overhead(unsigned time) { this->switch_overhead += time; }
+	unsigned get_switch_overhead() const { return this->switch_overhead; }
 	
 private:
 	const Process_Data* process;
@@ -78,6 +199,7 @@ private:
 	unsigned time_in_current_operation;
 	
 	unsigned level;
+	unsigned switch_overhead; // Switching time left before the burst runs again.
 };
 
 class OS_Scheduler_Simulator::Engine::Data_Point {
@@ -89,24 +211,233 @@ public:
 		unsigned time;
 	} event;
 
+	/// <summary>Ready queue of one level of a multi-level algorithm. Level 0 runs first; algorithms without levels only use level 0.</summary>
+	typedef struct {
+		unsigned level;
+		std::list<Running_Process> processes;
+	} ready_level;
+
+	/// <summary>How the ready queue changed at a point: the processes that joined it, in order, then the one that left it for the CPU.</summary>
+	typedef struct {
+		std::vector<const Process_Data*> enqueued;
+		const Process_Data* dispatched;  // nullptr if no process was dispatched.
+	} ready_changes;
+
+	/// <summary>How the waiting list changed at a point: the processes whose I/O burst completed, then the ones that started one, in the
+	/// order they joined the end of the list.</summary>
+	typedef struct {
+		std::vector<const Process_Data*> completed;
+		std::vector<const Process_Data*> started;
+	} waiting_changes;
+
 	Data_Point(const std::list<Process_Data>& starting_list);
 	Data_Point(const std::vector<Process_Data>& starting_list);
 	Data_Point(unsigned time_since_start, const std::list<Running_Process>& waiting_list, const std::list<Running_Process>& ready_list, Running_Process running_process = nullptr);
+	Data_Point(unsigned time_since_start, const std::list<Running_Process>& waiting_list, std::vector<ready_level>&& ready_levels, Running_Process running_process = nullptr);
+	Data_Point(unsigned time_since_start, size_t waiting_count, size_t ready_count, Running_Process running_process = nullptr);
 
 	event get_next_event();
 	bool is_cpu_busy() const { return this->running.is_valid(); }
 	
 	Running_Process get_cpu_process() const { return this->running; }
 	std::list<Running_Process> get_waiting_list() const { return this->waiting_list; }
-	std::list<Running_Process> get_ready_list() const { return this->ready_list; }
+	std::list<Running_Process> get_ready_list() const;
+	std::list<Running_Process> get_ready_level(unsigned level) const;
+
+	/// <summary>Get the levels with ready processes, in the order they run.</summary>
+	const std::vector<ready_level>& get_ready_levels() const { return this->ready_levels; }
+
+	/// <summary>Check if the point holds its ready queue. Points of timelines that do not need it (see Timeline::needs_queues) only
+	/// have its size and, for the algorithms that record them, its changes.</summary>
+	bool has_ready_queue() const { return this->queues_recorded; }
+	size_t get_ready_count() const { return this->ready_count; }
+
+	/// <summary>Check if the point holds its waiting list. Points that do not hold their ready queue do not hold it either.</summary>
+	bool has_waiting_list() const { return this->queues_recorded; }
+	size_t get_waiting_count() const { return this->waiting_count; }
+
+	/// <summary>Get the changes of the ready queue at this point, if the algorithm recorded them. Algorithms built on a Scheduling_Policy do.</summary>
+	const std::optional<ready_changes>& get_ready_changes() const { return this->changes; }
+	void set_ready_changes(ready_changes changes) { this->changes = std::move(changes); }
+
+	/// <summary>Get the changes of the waiting list at this point, if the algorithm recorded them. Algorithms built on a Scheduling_Policy do.</summary>
+	const std::optional<waiting_changes>& get_waiting_changes() const { return this->io_changes; }
+	void set_waiting_changes(waiting_changes changes) { this->io_changes = std::move(changes); }
+
 	unsigned get_time_since_start() const { return this->time_since_start; }
-	bool is_done() { return (this->ready_list.size() == 0 && this->waiting_list.size() == 0 && !this->running.is_valid()); }
+	bool is_done() { return (this->ready_count == 0 && this->waiting_count == 0 && !this->running.is_valid()); }
+
+	size_t get_memory_size() const;
 
 private:
-	std::list<Running_Process> ready_list;
+	std::vector<ready_level> ready_levels; // Only the levels with processes, in the order they run.
 	std::list<Running_Process> waiting_list;
 	Running_Process running;
 	unsigned time_since_start;
+	size_t ready_count;
+	size_t waiting_count;
+	bool queues_recorded;
+	std::optional<ready_changes> changes;
+	std::optional<waiting_changes> io_changes;
+};
+
+/// <summary>
+/// Sequence of Data_Points produced by an algorithm, in time order. The timeline owns its points.
+///
+/// An observer can be attached to see every point as it is committed. Without history, only the latest point is kept (algorithms only
+/// need the latest one to continue), so long runs can be streamed to the observer in constant memory.
+///
+/// With a memory budget, half of it holds the latest points and half the segments paged back in. Once the points in memory go over their
+/// half, the oldest ones are written to a temporary file (see Timeline_Spill) in segments of up to a quarter of the budget, and paged back in
+/// when iterating or looking up a time. Only the latest point always stays in memory, so back() is never paged; the points in memory and
+/// the pages cached stay within the budget plus the point being committed. Pages still held by readers after leaving the cache are not
+/// counted, and budgets smaller than a couple of points cannot be met.
+///
+/// Runs can also be checkpointed (see Checkpoint). Algorithms that support it register a state saver, called with the latest point committed
+/// when a checkpoint is due, and start from the resume checkpoint instead of the beginning when the timeline has one.
+///
+/// A timeline can continue another one (see set_prefix): the points of the prefix come first and are shared, not copied, so runs that
+/// forked from a common prefix only store what they did after it.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Timeline {
+public:
+	/// <summary>Cost of dispatching a process, charged by the algorithms through Context_Switches. All zero by default.</summary>
+	typedef struct {
+		unsigned switch_cost;   // Fixed cost of every switch to a different process.
+		unsigned cache_penalty; // Extra cost of a process whose cache is completely cold.
+		unsigned cache_decay;   // Time off the CPU after which the cache of a process is completely cold (0: always cold).
+	} switch_costs;
+
+	/// <summary>Memory taken by the points, estimated from their contents (Data_Point::get_memory_size).</summary>
+	typedef struct {
+		size_t resident_bytes;       // Points in memory, including spilled segments paged back in.
+		size_t peak_resident_bytes;
+		size_t spilled_bytes;        // Size of the spill file.
+		size_t spilled_points;
+	} memory_usage;
+
+	/// <summary>
+	/// Iterator over the points, in order. Dereferencing gives a pointer to the point, which stays valid while the iterator is on its segment.
+	/// </summary>
+	class const_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef const Data_Point* value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Data_Point* const* pointer;
+		typedef const Data_Point* reference;
+
+		const_iterator() : timeline(nullptr), index(0), page(), page_segment(0) {}
+		const_iterator(const Timeline* timeline, size_t index) : timeline(timeline), index(index), page(), page_segment(0) {}
+
+		const Data_Point* operator*() const;
+		const_iterator& operator++() { this->index++; return *this; }
+		const_iterator operator++(int) { const_iterator previous = *this; this->index++; return previous; }
+		bool operator==(const const_iterator& other) const { return this->index == other.index; }
+
+	private:
+		const Timeline* timeline;
+		size_t index;
+		mutable std::shared_ptr<const std::vector<Data_Point>> page; // Spilled segment being read.
+		mutable size_t page_segment;
+	};
+
+	typedef const_iterator iterator;
+
+	Timeline(bool keep_history = true);
+	~Timeline();
+
+	Timeline(Timeline&& other) noexcept;
+	Timeline& operator=(Timeline&& other) noexcept;
+	Timeline(const Timeline&) = delete;
+	Timeline& operator=(const Timeline&) = delete;
+
+	void push_back(Data_Point* data_point);
+	void clear();
+
+	/// <summary>Set a function called with every Data_Point right after it is committed.</summary>
+	/// <param name="reads_queues">- False if the observer only needs the sizes and the changes of the ready queue and the waiting list
+	/// (see needs_queues).</param>
+	void set_observer(std::function<void(const Data_Point&)> observer, bool reads_queues = true) { this->observer = observer; this->observer_reads_queues = reads_queues; }
+
+	/// <summary>Check if the points committed need their whole ready queue and waiting list: they are kept, or the observer reads them.
+	/// Otherwise algorithms may only give their sizes and changes, so every point costs the same however many processes are ready or
+	/// waiting for I/O.</summary>
+	bool needs_queues() const { return this->keep_history || (this->observer && this->observer_reads_queues); }
+
+	Data_Point* back() const { return (this->points.empty() && this->prefix != nullptr) ? this->prefix->back() : this->points.back(); }
+	size_t size() const { return this->prefix_points + this->get_spilled_points() + this->points.size(); }
+	bool empty() const { return this->size() == 0; }
+
+	void set_prefix(std::shared_ptr<const Timeline> prefix);
+
+	/// <summary>Get the number of points shared with the timeline this one continues.</summary>
+	size_t get_shared_points() const { return this->prefix_points; }
+
+	/// <summary>Ask the algorithm filling the timeline to stop early. The built-in algorithms check it before every step.</summary>
+	void request_stop() { this->stop = true; }
+	bool stop_requested() const { return this->stop; }
+
+	/// <summary>Get the number of points committed, including the ones discarded when history is not kept.</summary>
+	size_t get_committed_points() const { return this->committed_points; }
+
+	void set_memory_budget(size_t bytes, const Process_Data* first_process);
+	size_t get_memory_budget() const { return this->memory_budget; }
+	memory_usage get_memory_usage() const;
+
+	Data_Point get_data_at(unsigned time) const;
+
+	void set_switch_costs(switch_costs costs) { this->costs = costs; }
+	switch_costs get_switch_costs() const { return this->costs; }
+
+	/// <summary>Call the writer every "interval" committed points, right after the observer, if the algorithm registered a state saver. 0 for never.</summary>
+	void set_checkpoints(size_t interval, std::function<void(const Timeline&)> writer) { this->checkpoint_interval = interval; this->checkpoint_writer = writer; }
+
+	/// <summary>Set how the algorithm filling the timeline saves the state it needs to continue after the latest point. Algorithms clear it when they return.</summary>
+	void set_state_saver(std::function<void(Checkpoint&)> saver);
+	void save_state(Checkpoint& checkpoint) const { if (this->state_saver) this->state_saver(checkpoint); }
+
+	/// <summary>Check if the algorithm that filled the timeline registered a state saver at some point.</summary>
+	bool can_checkpoint() const { return this->checkpointable; }
+
+	void set_resume_checkpoint(Checkpoint* checkpoint, size_t committed_points);
+	Checkpoint* get_resume_checkpoint() const { return this->resume_checkpoint; }
+	void resume(Data_Point* data_point);
+	bool was_resumed() const { return this->resumed; }
+
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, this->size()); }
+
+private:
+	const Data_Point* get_point(size_t index, std::shared_ptr<const std::vector<Data_Point>>& page, size_t& page_segment) const;
+	size_t get_spilled_points() const;
+	size_t get_page_keys() const;
+	void spill_segments();
+
+	std::shared_ptr<const Timeline> prefix; // Frozen timeline this one continues, if any.
+	size_t prefix_points;
+	size_t prefix_pages;            // Page keys used by the prefix; the segments of this timeline are keyed after them.
+	std::deque<Data_Point*> points; // Points after the prefix and the spilled ones.
+	bool keep_history;
+	bool stop;
+	size_t committed_points;
+	std::function<void(const Data_Point&)> observer;
+	bool observer_reads_queues;
+	switch_costs costs;
+
+	size_t memory_budget;           // 0 for no budget.
+	const Process_Data* first_process;
+	size_t resident_bytes;
+	size_t peak_resident_bytes;
+	std::unique_ptr<Timeline_Spill> spill;
+
+	size_t checkpoint_interval;     // 0 for no checkpoints.
+	std::function<void(const Timeline&)> checkpoint_writer;
+	std::function<void(Checkpoint&)> state_saver;
+	bool checkpointable;
+	Checkpoint* resume_checkpoint;  // Until the algorithm resumes from it.
+	bool resumed;
+	bool restarted;                 // The algorithm ignored the resume checkpoint; its points are not observed.
 };
 
 class OS_Scheduler_Simulator::Engine::Evaluator {
@@ -116,46 +447,187 @@ public:
 		double avg_waiting_time;
 		double avg_turnaround_time;
 		double avg_response_time;
+		double avg_io_queueing_delay;   // Time spent queued for an I/O device, per process.
+		double effective_cpu_utilization; // CPU time spent on the bursts, without the switching overhead.
+		double switch_overhead;         // Fraction of the time spent switching between processes.
 	} results_table;
+
+	typedef struct {
+		std::string name;
+		unsigned channels;
+		unsigned long long busy_time;   // Channel time spent serving requests.
+		unsigned long long requests;    // Requests completed.
+		unsigned long long queueing_delay; // Time requests spent queued, in total.
+		size_t max_queue_length;
+		double utilization;             // Busy time over the time all channels were available.
+	} device_usage;
+
+	typedef struct {
+		std::string name;
+		std::string parent;             // Empty for the groups under the root.
+		unsigned weight;
+		unsigned quota;                 // 0 if the group is not limited.
+		unsigned period;
+		unsigned long long cpu_time;    // CPU time of the group and its descendants, without the switching overhead.
+		unsigned long long throttled_time; // Time it had ready processes and none running after using up its quota for the period.
+		unsigned long long throttled_periods; // Periods with any throttled time.
+		double utilization;             // CPU time over the execution time.
+	} group_usage;
+
+	typedef struct {
+		unsigned long long jobs;        // CPU bursts with a deadline that completed.
+		unsigned long long misses;
+		long long worst_lateness;       // Largest completion time minus deadline; negative if every job finished early.
+		unsigned long long total_tardiness;
+		unsigned max_tardiness;
+		std::vector<unsigned long long> tardiness_histogram; // [0]: jobs on time; [b]: jobs late by 2^(b-1) to 2^b - 1.
+	} deadline_report;
 	
 	class Process;
 
-	Evaluator(std::list<Process_Data>& processes, std::list<Data_Point*>* timeline = nullptr); // Used mostly during testing.
-	Evaluator(std::vector<Process_Data>& processes, std::list<Data_Point*>* timeline = nullptr);
+	Evaluator(std::list<Process_Data>& processes, Timeline* timeline = nullptr); // Used mostly during testing.
+	Evaluator(std::vector<Process_Data>& processes, Timeline* timeline = nullptr);
 
     void run_evaluation();
+
+	// Incremental evaluation, for timelines that are streamed instead of stored: reset(), then every point in order, then finish().
+	void reset();
+	void add_data_point(const Data_Point& data_point);
+	void finish();
+
+	void save_state(Checkpoint& checkpoint) const;
+	bool load_state(Checkpoint& checkpoint);
 	
 	results_table get_overall_totals() { return this->total_results; }
 	std::vector<Evaluator::Process> get_all_processes_data() { return this->processes_data; }
+	unsigned get_unused_cpu_time() const { return this->unused_cpu; }
+	unsigned long long get_switch_overhead_time() const { return this->switch_overhead; }
+	std::vector<device_usage> get_device_usage() const { return this->devices; }
+	std::vector<group_usage> get_group_usage() const { return this->groups; }
+	deadline_report get_deadline_report() const { return this->deadlines; }
 
 private:
-	std::list<Data_Point*>* timeline;
+	typedef struct {
+		size_t parent;                  // Index of the parent group, or no_group.
+		unsigned long long period_index; // Period the used time belongs to.
+		unsigned long long used;
+		bool throttled;                 // Some throttled time in the period.
+	} group_state;
+
+	static constexpr size_t no_group = static_cast<size_t>(-1);
+
+	void index_processes();
+	size_t index_group(const Process_Group* group);
+	void add_io_block(const Data_Point& data_point, unsigned time);
+	void add_group_block(const Data_Point& data_point, unsigned time);
+	void add_completed_burst(const Running_Process& process, unsigned time);
+	void apply_ready_changes(const Data_Point& data_point);
+	void apply_waiting_changes(const Data_Point& data_point);
+	void mark_ready_groups(const Process_Data* process, bool ready);
+	Evaluator::Process* find_credited(const Running_Process& process);
+
+	Timeline* timeline;
 	std::vector<Evaluator::Process> processes_data;
 	results_table total_results;
+
+	std::vector<device_usage> devices;
+	std::unordered_map<const IO_Device*, size_t> device_index;
+
+	// Groups, parents first, and the quota periods they are in.
+	std::vector<group_usage> groups;
+	std::vector<group_state> group_states;
+	std::unordered_map<const Process_Group*, size_t> group_index;
+
+	std::unordered_map<const Process_Data*, size_t> process_index;
+	std::vector<size_t> credited_as;     // First process with the same name, as find_process credits it.
+	std::vector<size_t> process_group;   // Group of every process, or no_group.
+
+	bool track_deadlines;
+	deadline_report deadlines;
+	std::vector<unsigned> cpu_completed_at;  // End of the last CPU burst of every process.
+	std::vector<unsigned> queued_since_cpu;  // Time queued for a device since then.
+
+	// State of the incremental evaluation. The last pair of points is handled by finish(), so two points are kept.
+	std::optional<Data_Point> previous_point;
+	std::optional<Data_Point> current_point;
+	unsigned unused_cpu;
+	unsigned long long switch_overhead;
+
+	// With points recording the changes of their ready queue, the waiting time is credited when a process leaves it, and the queue is
+	// never walked (see apply_ready_changes).
+	bool follow_changes;
+	std::unordered_map<const Process_Data*, unsigned> ready_since;
+	std::vector<size_t> ready_in_group;      // Ready processes in every group and its descendants.
+
+	// With points recording the changes of their waiting list, the requests of every device in arrival order, with the time they were
+	// queued since; the first ones, up to the channels of the device, are in service (see apply_waiting_changes).
+	std::vector<std::deque<std::pair<const Process_Data*, unsigned>>> device_queues;
 };
 
+/// <summary>
+/// A Simulation runs algorithms over a fixed set of processes. Every completed run is published as an immutable Result_Snapshot, so any
+/// number of threads can query the latest results (or keep an older snapshot alive) while another thread executes a new algorithm.
+/// </summary>
 class OS_Scheduler_Simulator::Engine::Simulation {
 public:
-	Simulation(const std::span<Process_Data>& processes);
-	~Simulation(); // Destructor needed to deallocate the timeline.
+	Simulation(const std::span<const Process_Data>& processes);
 
+	void register_algorithm(std::string name, std::function<void(const std::vector<Process_Data>&, Timeline&)> algorithm);
+
+	/// <summary>Register an algorithm written for the list of points that came before Timeline. The list is committed to the timeline once
+	/// the algorithm returns, so the algorithm runs as before, but cannot be checkpointed and holds all its points until it returns.</summary>
 	void register_algorithm(std::string name, std::function<void(const std::vector<Process_Data>&, std::list<Data_Point*>&)> algorithm);
+
+	/// <summary>Register an algorithm built on a Scheduling_Policy, given as a function creating a new policy for every run. It runs like any
+	/// other algorithm, and can also share its work with other policies in compare_algorithms.</summary>
+	void register_policy(std::string name, std::function<std::unique_ptr<Scheduling_Policy>()> factory);
+
+	/// <summary>Set the cost of the context switches of the next runs. The built-in algorithms charge them; the default is free switches.</summary>
+	void set_switch_costs(Timeline::switch_costs costs);
+	Timeline::switch_costs get_switch_costs() const;
+
+	/// <summary>Limit the memory taken by the timelines of the next runs. Beyond it, older points are spilled to a temporary file. 0 for no limit.</summary>
+	void set_memory_budget(size_t bytes);
+	size_t get_memory_budget() const;
 	Evaluator::results_table execute_algorithm(std::string name);
+	Evaluator::results_table stream_algorithm(std::string name, std::function<void(const Data_Point&)> observer);
+	Evaluator::results_table run_with_checkpoints(std::string name, std::string path, size_t interval, std::string* error = nullptr);
+	Evaluator::results_table resume_from_checkpoint(std::string path, std::string* error = nullptr);
+	std::vector<std::shared_ptr<const Result_Snapshot>> compare_algorithms(const std::vector<std::string>& names);
+	std::function<void(const std::vector<Process_Data>&, Timeline&)> get_algorithm(std::string name) const;
 
-	Data_Point get_latest_data_point() { return *this->timeline.back(); }
-	unsigned get_execution_time() { return (*this->timeline.back()).get_time_since_start(); }
+	/// <summary>Get the results of the latest completed run. The snapshot stays valid for as long as it is held, even after newer runs.</summary>
+	/// <returns>The latest snapshot, or nullptr if no algorithm was executed yet.</returns>
+	std::shared_ptr<const Result_Snapshot> get_results() const { return this->latest_results.load(); }
 
-	Evaluator::results_table get_total_results() { return this->evaluator->get_overall_totals(); }
-	std::vector<Evaluator::Process> get_per_process_evaluation() { return this->evaluator->get_all_processes_data(); }
+	Data_Point get_latest_data_point() const;
+	unsigned get_execution_time() const;
 
-	Data_Point get_data_at(unsigned time);
+	Evaluator::results_table get_total_results() const;
+	std::vector<Evaluator::Process> get_per_process_evaluation() const;
+	std::vector<Evaluator::device_usage> get_device_usage() const;
+	std::vector<Evaluator::group_usage> get_group_usage() const;
+	Evaluator::deadline_report get_deadline_report() const;
+	Timeline::memory_usage get_memory_usage() const;
+
+	Data_Point get_data_at(unsigned time) const;
+
+	/// <summary>Get the interval index of the latest completed run. It keeps the run's snapshot alive while held.</summary>
+	/// <returns>The index, or nullptr if no algorithm was executed yet.</returns>
+	std::shared_ptr<const Interval_Index> get_interval_index() const;
 
 private:
-	std::vector<Process_Data> processes;
-	std::list<Data_Point*> timeline;
-	Evaluator* evaluator;
+	Evaluator::results_table run_checkpointed(std::string name, Checkpoint* resume, std::string path, size_t interval, Timeline::switch_costs costs, std::string* error);
+	std::function<std::unique_ptr<Scheduling_Policy>()> get_policy(std::string name) const;
+
+	std::shared_ptr<std::vector<Process_Data>> processes; // Shared with the snapshots, which point into it.
+	std::atomic<std::shared_ptr<const Result_Snapshot>> latest_results;
 
-	std::list<std::pair<std::string, std::function<void(const std::vector<Process_Data>&, std::list<Data_Point*>&)>>> algorithms;
+	mutable std::mutex algorithms_mutex;
+	std::list<std::pair<std::string, std::function<void(const std::vector<Process_Data>&, Timeline&)>>> algorithms;
+	std::list<std::pair<std::string, std::function<std::unique_ptr<Scheduling_Policy>()>>> policies;
+	Timeline::switch_costs switch_costs; // Guarded by algorithms_mutex.
+	size_t memory_budget;                // Guarded by algorithms_mutex.
 };
 
 class OS_Scheduler_Simulator::Engine::Evaluator::Process {
@@ -169,6 +641,12 @@ public:
 	void add_total_waiting_time(unsigned val) { this->total_waiting_time += val; }
 	unsigned get_total_waiting_time() const { return this->total_waiting_time; }
 
+	void add_io_queueing_time(unsigned val) { this->io_queueing_time += val; }
+	unsigned get_io_queueing_time() const { return this->io_queueing_time; }
+
+	void add_deadline_miss() { this->deadline_misses++; }
+	unsigned get_deadline_misses() const { return this->deadline_misses; }
+
 	void set_turnaround_time(unsigned val) {
 		if (!this->turnaround_time_set) {
 			this->turnaround_time = val;
@@ -188,8 +666,14 @@ public:
 	unsigned get_response_time() const { return this->response_time; }
 
 	bool is_response_set() { return this->response_time_set; }
+
+	void save_state(Checkpoint& checkpoint) const;
+	void load_state(Checkpoint& checkpoint);
+
 	void reset() {
 		this->total_waiting_time = 0;
+		this->io_queueing_time = 0;
+		this->deadline_misses = 0;
 		this->turnaround_time = 0;
 		this->response_time = 0;
 
@@ -200,6 +684,8 @@ public:
 private:
 	OS_Scheduler_Simulator::Engine::Process_Data* process;
 	unsigned total_waiting_time;
+	unsigned io_queueing_time;
+	unsigned deadline_misses;
 	
 	unsigned turnaround_time;
 	bool turnaround_time_set;
@@ -208,12 +694,66 @@ private:
 	bool response_time_set;
 };
 
+/// <summary>
+/// Immutable result of executing one algorithm: the timeline and its evaluation. Snapshots are shared through std::shared_ptr and never
+/// modified after construction, so they can be read from many threads without locking.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Result_Snapshot {
+public:
+	Result_Snapshot(std::string algorithm_name, std::shared_ptr<std::vector<Process_Data>> processes, Timeline&& timeline);
+	Result_Snapshot(std::string algorithm_name, std::shared_ptr<std::vector<Process_Data>> processes, Timeline&& timeline, Evaluator& evaluator);
+
+	~Result_Snapshot();
+
+	Result_Snapshot(const Result_Snapshot&) = delete;
+	Result_Snapshot& operator=(const Result_Snapshot&) = delete;
+
+	const std::string& get_algorithm_name() const { return this->algorithm_name; }
+	const Timeline& get_timeline() const { return this->timeline; }
+
+	const Data_Point& get_latest_data_point() const { return *this->timeline.back(); }
+	unsigned get_execution_time() const { return this->timeline.back()->get_time_since_start(); }
+
+	Evaluator::results_table get_total_results() const { return this->total_results; }
+	const std::vector<Evaluator::Process>& get_per_process_evaluation() const { return this->per_process; }
+	const std::vector<Evaluator::device_usage>& get_device_usage() const { return this->devices; }
+	const std::vector<Evaluator::group_usage>& get_group_usage() const { return this->groups; }
+	const Evaluator::deadline_report& get_deadline_report() const { return this->deadlines; }
+
+	Data_Point get_data_at(unsigned time) const;
+
+	/// <summary>Get the interval index of the timeline, built on the first call.</summary>
+	const Interval_Index& get_interval_index() const;
+
+private:
+	std::string algorithm_name;
+	std::shared_ptr<std::vector<Process_Data>> processes;
+	Timeline timeline;
+
+	Evaluator::results_table total_results;
+	std::vector<Evaluator::Process> per_process;
+	std::vector<Evaluator::device_usage> devices;
+	std::vector<Evaluator::group_usage> groups;
+	Evaluator::deadline_report deadlines;
+
+	mutable std::once_flag interval_index_built;
+	mutable std::unique_ptr<Interval_Index> interval_index;
+};
+
 // Algorithms.
 // This algorithms come with the engine, but others can be created and plugged into the engine.
 namespace OS_SS_Algorithms {
-	void FCFS(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, std::list<OS_Scheduler_Simulator::Engine::Data_Point*>& timeline);
-	void SJF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, std::list<OS_Scheduler_Simulator::Engine::Data_Point*>& timeline);
-	void MLFQ(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, std::list<OS_Scheduler_Simulator::Engine::Data_Point*>& timeline);
+	void FCFS(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void SJF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void MLFQ(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void CFS(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void SRTF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void ASJF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void EDF(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void RM(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void Group(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void RR(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
+	void Priority(const std::vector<OS_Scheduler_Simulator::Engine::Process_Data>& processes, OS_Scheduler_Simulator::Engine::Timeline& timeline);
 }
 
 #endif
@@ -0,0 +1,227 @@
+#include "interval_index.h"
+#include "io_device.h"
+
+#include <vector>
+#include <array>
+#include <list>
+#include <utility>
+#include <algorithm>
+
+/// <summary>
+/// Interval_Index constructor. Reads the timeline once.
+/// </summary>
+/// <param name="timeline">- Complete timeline of a run.</param>
+/// <param name="processes">- Processes of the run. Running_Process::get_process_data() must point into this vector.</param>
+OS_Scheduler_Simulator::Engine::Interval_Index::Interval_Index(const Timeline& timeline, const std::vector<Process_Data>& processes)
+    : processes(processes.size()), end_time(0) {
+    const Process_Data* first_process = processes.data();
+
+    // State of every process listed in the previous point, closed when the next point arrives. Points are not kept, since a spilled point
+    // is only valid while the iterator is on its segment.
+    std::vector<std::pair<size_t, state_type>> open;
+    bool has_previous{ false };
+    unsigned previous_time{ 0 };
+
+    auto open_process = [&open, first_process, &processes](const Running_Process& process, state_type state) {
+        const size_t i = process.get_process_data() - first_process;
+        if (i < processes.size()) open.push_back(std::pair(i, state));
+    };
+
+    for (const Data_Point* data_point : timeline) {
+        if (data_point == nullptr) break; // The spill file could not be read.
+
+        const unsigned time = data_point->get_time_since_start();
+
+        if (has_previous && time > previous_time)
+            for (const auto& [i, state] : open)
+                this->add_block(i, previous_time, time, state);
+
+        open.clear();
+
+        if (data_point->is_cpu_busy()) open_process(data_point->get_cpu_process(), state_type::running);
+
+        for (const Running_Process& process : data_point->get_ready_list())
+            open_process(process, state_type::ready);
+
+        const std::list<Running_Process> waiting_list = data_point->get_waiting_list();
+
+        IO_Device::for_each_request(waiting_list, [&open_process](const Running_Process& process, bool in_service) {
+            open_process(process, (in_service) ? state_type::io : state_type::io_queued);
+        });
+
+        has_previous = true;
+        previous_time = time;
+    }
+
+    this->end_time = previous_time;
+
+    for (process_index& index : this->processes) {
+        totals before{};
+
+        for (const interval& block : index.intervals) {
+            index.time_before.push_back(before);
+            before.at(block.state) += block.end - block.start;
+        }
+
+        this->build_pyramid(index);
+    }
+}
+
+/// <summary>
+/// Get the intervals of a process overlapping a range, clipped to it.
+/// </summary>
+/// <param name="process">- Index of the process.</param>
+/// <param name="from">- Start of the range.</param>
+/// <param name="to">- End of the range, excluded.</param>
+std::vector<OS_Scheduler_Simulator::Engine::Interval_Index::interval> OS_Scheduler_Simulator::Engine::Interval_Index::get_intervals(size_t process, unsigned from, unsigned to) const {
+    std::vector<interval> found;
+    if (process >= this->processes.size() || to <= from) return found;
+
+    const std::vector<interval>& intervals = this->processes.at(process).intervals;
+
+    // Intervals do not overlap, so they are sorted by their end as well.
+    auto it = std::partition_point(intervals.begin(), intervals.end(), [from](const interval& block) { return block.end <= from; });
+
+    for (; it != intervals.end() && it->start < to; it++)
+        found.push_back(interval{ .start = std::max(it->start, from), .end = std::min(it->end, to), .state = it->state });
+
+    return found;
+}
+
+/// <summary>
+/// Get the exact time a process spent in every state over a range.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Interval_Index::occupancy OS_Scheduler_Simulator::Engine::Interval_Index::get_occupancy(size_t process, unsigned from, unsigned to) const {
+    occupancy result{};
+    if (process >= this->processes.size() || to <= from) return result;
+
+    const totals until_to = this->get_time_until(this->processes.at(process), to);
+    const totals until_from = this->get_time_until(this->processes.at(process), from);
+
+    for (size_t state{ 0 }; state < state_count; state++)
+        result.at(state) = static_cast<double>(until_to.at(state) - until_from.at(state));
+
+    return result;
+}
+
+/// <summary>
+/// Get the time a process spent in every state in each of a number of columns splitting a range, as needed to draw it at that resolution.
+///
+/// Columns read the pyramid level with buckets at most a quarter of a column wide, and the buckets cut by the edge of a column are split in
+/// proportion, so the values can be off by a fraction of a bucket at the edges while their sum over the range is exact. Columns narrower
+/// than the smallest buckets are computed exactly from the intervals.
+/// </summary>
+/// <param name="process">- Index of the process.</param>
+/// <param name="from">- Start of the range.</param>
+/// <param name="to">- End of the range, excluded.</param>
+/// <param name="columns">- Number of columns.</param>
+std::vector<OS_Scheduler_Simulator::Engine::Interval_Index::occupancy> OS_Scheduler_Simulator::Engine::Interval_Index::get_overview(size_t process, unsigned from, unsigned to, unsigned columns) const {
+    std::vector<occupancy> result(columns, occupancy{});
+    if (process >= this->processes.size() || to <= from || columns == 0) return result;
+
+    const process_index& index = this->processes.at(process);
+    if (index.levels.empty()) return result;
+
+    const unsigned long long span = to - from;
+    const double column_width = static_cast<double>(span) / columns;
+
+    auto column_start = [from, span, columns](unsigned long long column) { return from + span * column / columns; };
+
+    if (column_width < 4.0 * index.bucket_width) {
+        for (unsigned column{ 0 }; column < columns; column++)
+            result.at(column) = this->get_occupancy(process, static_cast<unsigned>(column_start(column)), static_cast<unsigned>(column_start(column + 1)));
+
+        return result;
+    }
+
+    size_t level{ 0 };
+    unsigned long long width = index.bucket_width;
+
+    while (level + 1 < index.levels.size() && 8.0 * width <= column_width) {
+        level++;
+        width *= 2;
+    }
+
+    const std::vector<totals>& buckets = index.levels.at(level);
+
+    for (unsigned column{ 0 }; column < columns; column++) {
+        const unsigned long long start = column_start(column), end = column_start(column + 1);
+
+        for (unsigned long long bucket = start / width; bucket < buckets.size() && bucket * width < end; bucket++) {
+            // The last bucket stops at the end of the timeline.
+            const unsigned long long bucket_start = bucket * width, bucket_end = std::min<unsigned long long>((bucket + 1) * width, this->end_time);
+            if (start >= bucket_end) break;
+
+            const unsigned long long covered = std::min(end, bucket_end) - std::max(start, bucket_start);
+            const double fraction = static_cast<double>(covered) / static_cast<double>(bucket_end - bucket_start);
+
+            for (size_t state{ 0 }; state < state_count; state++)
+                result.at(column).at(state) += fraction * static_cast<double>(buckets.at(bucket).at(state));
+        }
+    }
+
+    return result;
+}
+
+/// <summary>
+/// Add a block to the intervals of a process, extending the last interval if it continues it.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Interval_Index::add_block(size_t process, unsigned start, unsigned end, state_type state) {
+    std::vector<interval>& intervals = this->processes.at(process).intervals;
+
+    if (!intervals.empty() && intervals.back().end == start && intervals.back().state == state) intervals.back().end = end;
+    else intervals.push_back(interval{ .start = start, .end = end, .state = state });
+}
+
+/// <summary>
+/// Build the occupancy pyramid of a process. The bottom buckets are the smallest power of two that needs no more buckets than there are
+/// intervals, so an interval touches a couple of buckets on average.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Interval_Index::build_pyramid(process_index& index) {
+    index.bucket_width = 1;
+    index.levels.clear();
+
+    if (index.intervals.empty() || this->end_time == 0) return;
+
+    while (index.bucket_width * index.intervals.size() < this->end_time) index.bucket_width *= 2;
+
+    const unsigned long long width = index.bucket_width;
+    std::vector<totals> bottom((this->end_time + width - 1) / width, totals{});
+
+    for (const interval& block : index.intervals)
+        for (unsigned long long time = block.start; time < block.end; ) {
+            const unsigned long long bucket = time / width;
+            const unsigned long long next = std::min<unsigned long long>(block.end, (bucket + 1) * width);
+
+            bottom.at(bucket).at(block.state) += next - time;
+            time = next;
+        }
+
+    index.levels.push_back(std::move(bottom));
+
+    while (index.levels.back().size() > 1) {
+        const std::vector<totals>& below = index.levels.back();
+        std::vector<totals> above((below.size() + 1) / 2, totals{});
+
+        for (size_t i{ 0 }; i < below.size(); i++)
+            for (size_t state{ 0 }; state < state_count; state++)
+                above.at(i / 2).at(state) += below.at(i).at(state);
+
+        index.levels.push_back(std::move(above));
+    }
+}
+
+/// <summary>
+/// Get the time a process spent in every state before a given time.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Interval_Index::totals OS_Scheduler_Simulator::Engine::Interval_Index::get_time_until(const process_index& index, unsigned time) const {
+    auto after = std::upper_bound(index.intervals.begin(), index.intervals.end(), time, [](unsigned t, const interval& block) { return t < block.start; });
+    if (after == index.intervals.begin()) return totals{};
+
+    const size_t i = std::prev(after) - index.intervals.begin();
+    const interval& block = index.intervals.at(i);
+
+    totals result = index.time_before.at(i);
+    result.at(block.state) += std::min(time, block.end) - block.start;
+    return result;
+}
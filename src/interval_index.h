@@ -0,0 +1,61 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_INTERVAL_INDEX_
+#define _OS_SCHEDULER_SIMULATOR_INTERVAL_INDEX_
+
+#include "engine.h"
+
+#include <vector>
+#include <array>
+
+/// <summary>
+/// Index of what every process was doing over a timeline, for range queries such as drawing a Gantt chart, without copying the lists of a
+/// Data_Point for every time asked.
+///
+/// Every process gets its sorted list of intervals (running, ready, in I/O or queued for an I/O device), with the time spent in every state
+/// before each interval, so the intervals in a range are found by binary search and the time spent in every state over any range takes two
+/// searches. On top of it, every process gets a pyramid of its occupancy: buckets of a power-of-two width at the bottom, each level summing
+/// pairs of the level below. The bottom buckets are about as many as the intervals of the process, so the pyramid takes about as much
+/// memory as the intervals. An overview at a given number of columns reads the level whose buckets are just narrower than a column, so it
+/// costs a few buckets per column however long the timeline is.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Interval_Index {
+public:
+	typedef enum { running, ready, io, io_queued } state_type;
+	static constexpr size_t state_count = 4;
+
+	typedef struct {
+		unsigned start;
+		unsigned end;                    // Excluded.
+		state_type state;
+	} interval;
+
+	/// <summary>Time spent in every state, indexed by state_type.</summary>
+	typedef std::array<double, state_count> occupancy;
+
+	Interval_Index(const Timeline& timeline, const std::vector<Process_Data>& processes);
+
+	size_t get_process_count() const { return this->processes.size(); }
+	unsigned get_end_time() const { return this->end_time; }
+
+	std::vector<interval> get_intervals(size_t process, unsigned from, unsigned to) const;
+	occupancy get_occupancy(size_t process, unsigned from, unsigned to) const;
+	std::vector<occupancy> get_overview(size_t process, unsigned from, unsigned to, unsigned columns) const;
+
+private:
+	typedef std::array<unsigned long long, state_count> totals;
+
+	typedef struct {
+		std::vector<interval> intervals;
+		std::vector<totals> time_before;   // Time in every state before each interval.
+		unsigned long long bucket_width;   // Width of the buckets of level 0.
+		std::vector<std::vector<totals>> levels;
+	} process_index;
+
+	void add_block(size_t process, unsigned start, unsigned end, state_type state);
+	void build_pyramid(process_index& index);
+	totals get_time_until(const process_index& index, unsigned time) const;
+
+	std::vector<process_index> processes;
+	unsigned end_time;
+};
+
+#endif
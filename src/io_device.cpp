@@ -0,0 +1,128 @@
+#include "io_device.h"
+
+#include <string>
+#include <list>
+#include <vector>
+
+/// <summary>
+/// IO_Device constructor.
+/// </summary>
+/// <param name="name">- Name of the device, used in the reports.</param>
+/// <param name="channels">- Requests served at the same time. At least 1.</param>
+OS_Scheduler_Simulator::Engine::IO_Device::IO_Device(std::string name, unsigned channels)
+    : name(name), channels((channels > 0) ? channels : 1) {}
+
+/// <summary>
+/// Advance the I/O operations of a waiting list. Only the requests in service progress; queued ones keep waiting for a channel.
+/// </summary>
+/// <param name="waiting_list">- Waiting list in arrival order.</param>
+/// <param name="time">- Time elapsed.</param>
+void OS_Scheduler_Simulator::Engine::IO_Device::advance_waiting_list(std::list<Running_Process>& waiting_list, unsigned time) {
+    IO_Device::for_each_request(waiting_list, [time](Running_Process& process, bool in_service) {
+        if (in_service) process = process.get_next_process_state(time);
+    });
+}
+
+/// <summary>
+/// IO_Queues constructor, without requests.
+/// </summary>
+OS_Scheduler_Simulator::Engine::IO_Queues::IO_Queues()
+    : requests(), devices(), completions(), next_id(0) {}
+
+/// <summary>
+/// Add a request behind the ones already outstanding. It enters service right away unless its device has no channel free.
+/// </summary>
+/// <param name="process">- Process starting an I/O burst, or in the middle of one (when resuming a run).</param>
+/// <param name="time">- Current time.</param>
+void OS_Scheduler_Simulator::Engine::IO_Queues::add(const Running_Process& process, unsigned time) {
+    const unsigned long long id = this->next_id++;
+    const IO_Device* device = process.get_process_data()->get_io_device().get();
+
+    this->requests.emplace(id, request{ .process = process, .since = time, .in_service = false });
+
+    if (device != nullptr) {
+        device_queue& queue = this->devices.try_emplace(device, device_queue{ .free_channels = device->get_channels(), .queued = {} }).first->second;
+
+        if (queue.free_channels == 0) {
+            queue.queued.push_back(id);
+            return;
+        }
+
+        queue.free_channels--;
+    }
+
+    this->serve(id, time);
+}
+
+/// <summary>
+/// Complete the requests that end by a time. The channels they free go to the next requests of their devices, which start at that time.
+/// </summary>
+/// <param name="time">- Current time. Steps must not go past the next completion (see get_next_event).</param>
+/// <param name="completed">- Receives the processes that completed their burst, ready, in arrival order.</param>
+void OS_Scheduler_Simulator::Engine::IO_Queues::advance(unsigned time, std::vector<Running_Process>& completed) {
+    std::vector<const IO_Device*> freed;
+
+    while (!this->completions.empty() && this->completions.top().first <= time) {
+        auto it = this->requests.find(this->completions.top().second);
+        this->completions.pop();
+
+        completed.push_back(it->second.process.get_next_process_state(time - it->second.since));
+
+        const IO_Device* device = it->second.process.get_process_data()->get_io_device().get();
+        if (device != nullptr) freed.push_back(device);
+
+        this->requests.erase(it);
+    }
+
+    // The queued requests only start once all the ones completing left, as they would in a list.
+    for (const IO_Device* device : freed) {
+        device_queue& queue = this->devices.at(device);
+
+        if (queue.queued.empty()) queue.free_channels++;
+
+        else {
+            this->serve(queue.queued.front(), time);
+            queue.queued.pop_front();
+        }
+    }
+}
+
+void OS_Scheduler_Simulator::Engine::IO_Queues::serve(unsigned long long id, unsigned time) {
+    request& served = this->requests.at(id);
+
+    served.in_service = true;
+    served.since = time;
+    this->completions.push(completion(static_cast<unsigned long long>(time) + served.process.time_to_end_current_burst(), id));
+}
+
+/// <summary>
+/// Get the next event of a run: the end of the CPU burst, the next request completing, or done if nothing is left.
+/// </summary>
+/// <param name="running">- Process on the CPU, if any.</param>
+/// <param name="time">- Current time.</param>
+OS_Scheduler_Simulator::Engine::Data_Point::event OS_Scheduler_Simulator::Engine::IO_Queues::get_next_event(const Running_Process& running, unsigned time) const {
+    Data_Point::event next{ .event_type = Data_Point::event_type::unresolved, .time = 0 };
+
+    if (running.is_valid()) next = Data_Point::event{ .event_type = Data_Point::event_type::cpu, .time = running.time_to_end_current_burst() };
+
+    if (!this->completions.empty()) {
+        const unsigned io_time = static_cast<unsigned>(this->completions.top().first - time);
+        if (!running.is_valid() || io_time < next.time) next = Data_Point::event{ .event_type = Data_Point::event_type::io, .time = io_time };
+    }
+
+    if (!running.is_valid() && this->requests.empty()) next.event_type = Data_Point::event_type::done;
+
+    return next;
+}
+
+/// <summary>
+/// Build the waiting list at a time: every request in arrival order, the ones in service progressed up to it.
+/// </summary>
+std::list<OS_Scheduler_Simulator::Engine::Running_Process> OS_Scheduler_Simulator::Engine::IO_Queues::get_waiting_list(unsigned time) const {
+    std::list<Running_Process> waiting_list;
+
+    for (const auto& [id, outstanding] : this->requests)
+        waiting_list.push_back((outstanding.in_service) ? outstanding.process.get_next_process_state(time - outstanding.since) : outstanding.process);
+
+    return waiting_list;
+}
@@ -0,0 +1,101 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_IO_DEVICE_
+#define _OS_SCHEDULER_SIMULATOR_IO_DEVICE_
+
+#include "engine.h"
+
+#include <string>
+#include <list>
+#include <vector>
+#include <deque>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <functional>
+
+/// <summary>
+/// An I/O device serving requests in arrival order with a fixed number of parallel channels (1 for a plain FIFO device). The I/O bursts of
+/// a process assigned to a device (Process_Data::set_io_device) queue behind the requests already on it; processes without a device keep
+/// the infinitely parallel I/O of the engine.
+///
+/// The waiting lists of the Data_Points are kept in arrival order, so the requests in service on a device are the first "channels" entries of
+/// the list that use it and the others are queued behind them, in order. Snapshots and the cycle detector therefore see the state of every
+/// device without any extra field, and finding it costs one pass over the waiting list. The algorithms built on a Scheduling_Policy keep
+/// the queues explicitly instead (see IO_Queues), so their steps do not depend on how many requests are outstanding.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::IO_Device {
+public:
+	IO_Device(std::string name, unsigned channels = 1);
+
+	const std::string& get_name() const { return this->name; }
+	unsigned get_channels() const { return this->channels; }
+
+	/// <summary>Call function(request, in_service) for every request of a waiting list, in order.</summary>
+	template <typename List, typename Function>
+	static void for_each_request(List& waiting_list, Function function);
+
+	static void advance_waiting_list(std::list<Running_Process>& waiting_list, unsigned time);
+
+private:
+	std::string name;
+	unsigned channels;
+};
+
+template <typename List, typename Function>
+void OS_Scheduler_Simulator::Engine::IO_Device::for_each_request(List& waiting_list, Function function) {
+	// Requests met so far on every device. Nothing is allocated while no request uses a device.
+	std::unordered_map<const IO_Device*, unsigned> requests;
+
+	for (auto& process : waiting_list) {
+		const IO_Device* device = process.get_process_data()->get_io_device().get();
+		const bool in_service = device == nullptr || ++requests[device] <= device->channels;
+
+		function(process, in_service);
+	}
+}
+
+/// <summary>
+/// The I/O requests outstanding in a run, with an explicit queue per device. Every device has a FIFO of the requests waiting for a channel,
+/// and the requests in service, on a device or not, are in one min-heap by the time they complete. Advancing the run only touches the
+/// requests that complete and the heads of their devices, however many requests are outstanding.
+///
+/// Requests in service are not progressed at every step: each keeps its state from when it entered service, and is brought up to date when
+/// it completes or when the waiting list is built (get_waiting_list), which is the same list, in the same order, the algorithms built on
+/// lists keep.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::IO_Queues {
+public:
+	IO_Queues();
+
+	void add(const Running_Process& process, unsigned time);
+	void advance(unsigned time, std::vector<Running_Process>& completed);
+
+	Data_Point::event get_next_event(const Running_Process& running, unsigned time) const;
+	std::list<Running_Process> get_waiting_list(unsigned time) const;
+
+	bool empty() const { return this->requests.empty(); }
+	size_t size() const { return this->requests.size(); }
+
+private:
+	typedef struct {
+		Running_Process process;               // State when it entered service, or when it was added while queued.
+		unsigned since;                        // Time it entered service.
+		bool in_service;
+	} request;
+
+	typedef struct {
+		unsigned free_channels;
+		std::deque<unsigned long long> queued; // Requests waiting for a channel, in arrival order.
+	} device_queue;
+
+	typedef std::pair<unsigned long long, unsigned long long> completion; // Time and request.
+
+	void serve(unsigned long long id, unsigned time);
+
+	std::map<unsigned long long, request> requests; // By arrival.
+	std::unordered_map<const IO_Device*, device_queue> devices;
+	std::priority_queue<completion, std::vector<completion>, std::greater<completion>> completions;
+	unsigned long long next_id;
+};
+
+#endif
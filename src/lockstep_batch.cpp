@@ -0,0 +1,353 @@
+#include "lockstep_batch.h"
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr unsigned infinite = std::numeric_limits<unsigned>::max();
+    constexpr size_t no_workload = std::numeric_limits<size_t>::max();
+
+    // Status of a process slot. Slots past the processes of a workload are absent. Bursts in progress come last, so that testing for them
+    // takes a single comparison.
+    enum : unsigned { absent, ready, done, running, in_io };
+}
+
+/// <summary>
+/// State of "lanes" workloads, one per lane. Every array is indexed [process slot][lane], so the loops over lanes are contiguous.
+/// </summary>
+struct OS_Scheduler_Simulator::Engine::Lockstep_Batch::lane_block {
+    static constexpr size_t L = Lockstep_Batch::lanes;
+    static constexpr size_t P = Lockstep_Batch::max_processes;
+    static constexpr unsigned idle = static_cast<unsigned>(P);
+
+    const Lockstep_Batch& batch;
+
+    // Per process slot.
+    alignas(64) std::array<std::array<unsigned, L>, P> left;         // Time left in the current burst.
+    alignas(64) std::array<std::array<unsigned, L>, P> status;
+    std::array<std::array<unsigned, L>, P> operation;
+    std::array<std::array<unsigned, L>, P> queued_at;                 // When the process became ready.
+    std::array<std::array<unsigned, L>, P> sequence;                  // Order in which the processes started their I/O.
+    std::array<std::array<unsigned, L>, P> waiting_time;
+    std::array<std::array<unsigned, L>, P> response_time;
+    std::array<std::array<unsigned, L>, P> turnaround_time;
+    std::array<std::array<unsigned char, L>, P> ready_queue;          // Ring of process slots, from head.
+    std::array<std::array<const unsigned*, L>, P> bursts;             // First burst of the process.
+    std::array<std::array<unsigned, L>, P> burst_count;
+
+    // Per lane.
+    alignas(64) std::array<unsigned, L> now;
+    alignas(64) std::array<unsigned, L> slice_left;                   // Infinite without a running process or a quantum.
+    alignas(64) std::array<unsigned, L> unused_cpu;
+    alignas(64) std::array<unsigned, L> on_cpu;                       // Slot of the running process, or idle.
+    std::array<unsigned, L> process_count;
+    std::array<unsigned, L> finished;
+    std::array<unsigned, L> head;
+    std::array<unsigned, L> queued;
+    std::array<unsigned, L> next_sequence;
+    std::array<unsigned, L> last_dispatch;                            // Slot dispatched last, and when.
+    std::array<unsigned, L> dispatched_at;
+    std::array<size_t, L> workload;
+    unsigned slots;                                                   // Largest process count of the lanes.
+
+    lane_block(const Lockstep_Batch& batch) : batch(batch), slots(0) {
+        for (size_t lane{ 0 }; lane < L; lane++) {
+            this->workload[lane] = no_workload;
+            this->on_cpu[lane] = idle;
+            this->slice_left[lane] = infinite;
+            for (size_t slot{ 0 }; slot < P; slot++) this->status[slot][lane] = absent;
+        }
+    }
+
+    unsigned burst(size_t slot, size_t lane) const {
+        return this->bursts[slot][lane][this->operation[slot][lane]];
+    }
+
+    void enqueue(size_t slot, size_t lane) {
+        this->ready_queue[(this->head[lane] + this->queued[lane]) % P][lane] = static_cast<unsigned char>(slot);
+        this->queued[lane]++;
+        this->queued_at[slot][lane] = this->now[lane];
+        this->status[slot][lane] = ready;
+    }
+
+    void dispatch_if_idle(size_t lane) {
+        if (this->on_cpu[lane] != idle || this->queued[lane] == 0) return;
+
+        const unsigned slot = this->ready_queue[this->head[lane]][lane];
+        this->head[lane] = (this->head[lane] + 1) % P;
+        this->queued[lane]--;
+
+        this->waiting_time[slot][lane] += this->now[lane] - this->queued_at[slot][lane];
+        if (this->response_time[slot][lane] == infinite) this->response_time[slot][lane] = this->now[lane];
+
+        this->status[slot][lane] = running;
+        this->on_cpu[lane] = slot;
+        this->last_dispatch[lane] = slot;
+        this->dispatched_at[lane] = this->now[lane];
+        this->slice_left[lane] = (this->batch.quantum > 0) ? this->batch.quantum : infinite;
+    }
+
+    // Start a workload in a lane. All processes are submitted at start, in order.
+    void load(size_t lane, size_t index) {
+        this->workload[lane] = index;
+        this->process_count[lane] = this->batch.workloads.at(index).process_count;
+        this->now[lane] = this->unused_cpu[lane] = this->finished[lane] = this->head[lane] = this->queued[lane] = this->next_sequence[lane] = 0;
+        this->on_cpu[lane] = idle;
+        this->slice_left[lane] = infinite;
+
+        for (size_t slot{ 0 }; slot < P; slot++) {
+            this->status[slot][lane] = absent;
+            if (slot >= this->process_count[lane]) continue;
+
+            const Lockstep_Batch::process& data = this->batch.processes.at(this->batch.workloads.at(index).first_process + slot);
+            this->bursts[slot][lane] = this->batch.bursts.data() + data.first_burst;
+            this->burst_count[slot][lane] = data.burst_count;
+            this->operation[slot][lane] = 0;
+            this->left[slot][lane] = this->burst(slot, lane);
+            this->waiting_time[slot][lane] = 0;
+            this->response_time[slot][lane] = infinite;
+            this->turnaround_time[slot][lane] = 0;
+            this->enqueue(slot, lane);
+        }
+
+        this->dispatch_if_idle(lane);
+    }
+
+    // Results of a finished lane, as the Evaluator computes them.
+    void store(size_t lane, std::vector<Lockstep_Batch::result>& results) const {
+        Lockstep_Batch::result& stored = results.at(this->workload[lane]);
+        const unsigned end = this->now[lane];
+        const double count = static_cast<double>(this->process_count[lane]);
+
+        stored.execution_time = end;
+        stored.totals = Evaluator::results_table{ 0, 0, 0, 0, 0, 0, 0 };
+        stored.totals.cpu_utilization = static_cast<double>(end - this->unused_cpu[lane]) / static_cast<double>(end);
+        stored.totals.effective_cpu_utilization = stored.totals.cpu_utilization;
+
+        // The Evaluator only records a response time before the last block of the timeline: a process first dispatched there has none.
+        const unsigned last = this->last_dispatch[lane];
+        const bool last_responds = this->response_time[last][lane] != this->dispatched_at[lane];
+
+        for (size_t slot{ 0 }; slot < this->process_count[lane]; slot++) {
+            if (slot != last || last_responds) stored.totals.avg_response_time += static_cast<double>(this->response_time[slot][lane]);
+            stored.totals.avg_turnaround_time += static_cast<double>(this->turnaround_time[slot][lane]);
+            stored.totals.avg_waiting_time += static_cast<double>(this->waiting_time[slot][lane]);
+        }
+
+        stored.totals.avg_response_time /= count;
+        stored.totals.avg_turnaround_time /= count;
+        stored.totals.avg_waiting_time /= count;
+    }
+
+    void update_slots() {
+        this->slots = 0;
+        for (size_t lane{ 0 }; lane < L; lane++)
+            if (this->workload[lane] != no_workload) this->slots = std::max(this->slots, this->process_count[lane]);
+    }
+
+    // Advance every lane to its next event. Returns false once no lane has a workload left.
+    bool step(size_t& next_workload, std::vector<Lockstep_Batch::result>& results) {
+        alignas(64) std::array<unsigned, L> advance;
+        alignas(64) std::array<unsigned, L> events{};
+
+        // Next event of every lane: the end of the running burst, of its slice, or of an I/O burst. Lanes without a workload do not move.
+        for (size_t lane{ 0 }; lane < L; lane++) advance[lane] = this->slice_left[lane];
+
+        const unsigned slots = this->slots;
+
+        // The masks are all ones for the bursts in progress and 0 otherwise, so the loops have no branches.
+        for (size_t slot{ 0 }; slot < slots; slot++)
+            for (size_t lane{ 0 }; lane < L; lane++) {
+                const unsigned active = 0u - static_cast<unsigned>(this->status[slot][lane] >= running);
+                advance[lane] = std::min(advance[lane], this->left[slot][lane] | ~active);
+            }
+
+        for (size_t lane{ 0 }; lane < L; lane++) advance[lane] &= 0u - static_cast<unsigned>(advance[lane] != infinite);
+
+        // Masked updates of every burst in progress; the bursts that end are marked in the event mask of their lane.
+        for (size_t slot{ 0 }; slot < slots; slot++)
+            for (size_t lane{ 0 }; lane < L; lane++) {
+                const unsigned active = 0u - static_cast<unsigned>(this->status[slot][lane] >= running);
+                this->left[slot][lane] -= advance[lane] & active;
+                events[lane] |= (0u - static_cast<unsigned>(this->left[slot][lane] == 0)) & active & (1u << slot);
+            }
+
+        for (size_t lane{ 0 }; lane < L; lane++) {
+            this->now[lane] += advance[lane];
+            this->unused_cpu[lane] += (this->on_cpu[lane] == idle) ? advance[lane] : 0;
+            this->slice_left[lane] -= (this->slice_left[lane] != infinite) ? advance[lane] : 0;
+        }
+
+        bool any_left{ false };
+
+        for (size_t lane{ 0 }; lane < L; lane++) {
+            if (this->workload[lane] == no_workload) continue;
+
+            unsigned mask = events[lane];
+            const unsigned current = this->on_cpu[lane];
+
+            // The running process leaves the CPU for I/O, ends, or goes back to the ready queue.
+            if (current != idle && ((mask >> current) & 1) != 0) {
+                mask &= ~(1u << current);
+                this->operation[current][lane]++;
+                this->on_cpu[lane] = idle;
+                this->slice_left[lane] = infinite;
+
+                if (this->operation[current][lane] < this->burst_count[current][lane]) {
+                    this->status[current][lane] = in_io;
+                    this->left[current][lane] = this->burst(current, lane);
+                    this->sequence[current][lane] = this->next_sequence[lane]++;
+                }
+
+                else {
+                    this->status[current][lane] = done;
+                    this->turnaround_time[current][lane] = this->now[lane];
+                    this->finished[lane]++;
+                }
+            }
+
+            else if (current != idle && this->slice_left[lane] == 0) {
+                this->on_cpu[lane] = idle;
+                this->slice_left[lane] = infinite;
+                this->enqueue(current, lane);
+            }
+
+            // Completed I/O, in the order it started.
+            while (mask != 0) {
+                unsigned first = static_cast<unsigned>(std::countr_zero(mask));
+
+                for (unsigned rest = mask & (mask - 1); rest != 0; rest &= rest - 1) {
+                    const unsigned slot = static_cast<unsigned>(std::countr_zero(rest));
+                    if (this->sequence[slot][lane] < this->sequence[first][lane]) first = slot;
+                }
+
+                mask &= ~(1u << first);
+                this->operation[first][lane]++;
+                this->left[first][lane] = this->burst(first, lane);
+                this->enqueue(first, lane);
+            }
+
+            this->dispatch_if_idle(lane);
+
+            if (this->finished[lane] == this->process_count[lane]) {
+                this->store(lane, results);
+                this->workload[lane] = no_workload;
+
+                if (next_workload < this->batch.workloads.size()) this->load(lane, next_workload++);
+                this->update_slots();
+            }
+
+            any_left = any_left || this->workload[lane] != no_workload;
+        }
+
+        return any_left;
+    }
+};
+
+/// <summary>
+/// Lockstep_Batch constructor.
+/// </summary>
+/// <param name="quantum">- Time slice of round robin. 0 runs FCFS.</param>
+OS_Scheduler_Simulator::Engine::Lockstep_Batch::Lockstep_Batch(unsigned quantum)
+    : quantum(quantum), bursts(), processes(), workloads(), results() {}
+
+/// <summary>
+/// Add a workload. Only the bursts are used; nice values, groups and deadlines do not matter to FCFS or round robin.
+/// </summary>
+/// <param name="error">- Optional description of the problem if the workload cannot be run.</param>
+/// <returns>True if the workload was added.</returns>
+bool OS_Scheduler_Simulator::Engine::Lockstep_Batch::add_workload(const std::vector<Process_Data>& processes, std::string* error) {
+    std::vector<unsigned> counts;
+    std::vector<unsigned> all_bursts;
+
+    for (const Process_Data& process : processes) {
+        if (process.get_io_device() != nullptr) {
+            if (error != nullptr) *error = "process \"" + process.get_name() + "\" uses an I/O device";
+            return false;
+        }
+
+        if (process.has_dependencies()) {
+            if (error != nullptr) *error = "process \"" + process.get_name() + "\" has dependencies";
+            return false;
+        }
+
+        if (process.get_arrival() > 0) {
+            if (error != nullptr) *error = "process \"" + process.get_name() + "\" arrives after the start";
+            return false;
+        }
+
+        counts.push_back(static_cast<unsigned>(process.get_operations_size()));
+        for (size_t i{ 0 }; i < process.get_operations_size(); i++) all_bursts.push_back(process.get_operation(i));
+    }
+
+    return this->add_workload(counts, all_bursts, error);
+}
+
+/// <summary>
+/// Add a workload given as flat arrays: process i has burst_counts[i] bursts, stored one process after the other in bursts.
+/// </summary>
+/// <param name="error">- Optional description of the problem if the workload cannot be run.</param>
+/// <returns>True if the workload was added.</returns>
+bool OS_Scheduler_Simulator::Engine::Lockstep_Batch::add_workload(std::span<const unsigned> burst_counts, std::span<const unsigned> bursts, std::string* error) {
+    std::string problem;
+    size_t total{ 0 };
+
+    if (burst_counts.empty()) problem = "the workload has no processes";
+    else if (burst_counts.size() > max_processes) problem = "the workload has more than " + std::to_string(max_processes) + " processes";
+
+    for (size_t i{ 0 }; i < burst_counts.size() && problem.empty(); i++) {
+        if (burst_counts[i] % 2 == 0) problem = "process " + std::to_string(i) + " does not end with a CPU burst";
+        total += burst_counts[i];
+    }
+
+    if (problem.empty() && total != bursts.size()) problem = "the burst counts do not match the number of bursts";
+    if (problem.empty() && std::find(bursts.begin(), bursts.end(), 0u) != bursts.end()) problem = "bursts must last at least 1 unit";
+
+    if (!problem.empty()) {
+        if (error != nullptr) *error = problem;
+        return false;
+    }
+
+    this->workloads.push_back(workload{ .first_process = this->processes.size(), .process_count = static_cast<unsigned>(burst_counts.size()) });
+
+    for (unsigned count : burst_counts) {
+        this->processes.push_back(process{ .first_burst = this->bursts.size(), .burst_count = count });
+        this->bursts.insert(this->bursts.end(), bursts.begin(), bursts.begin() + count);
+        bursts = bursts.subspan(count);
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Remove every workload and result.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Lockstep_Batch::clear() {
+    this->bursts.clear();
+    this->processes.clear();
+    this->workloads.clear();
+    this->results.clear();
+}
+
+/// <summary>
+/// Run every workload.
+/// </summary>
+/// <returns>One result per workload, in the order they were added.</returns>
+const std::vector<OS_Scheduler_Simulator::Engine::Lockstep_Batch::result>& OS_Scheduler_Simulator::Engine::Lockstep_Batch::run() {
+    this->results.assign(this->workloads.size(), result{ .totals = { 0, 0, 0, 0, 0, 0, 0 }, .execution_time = 0 });
+    if (this->workloads.empty()) return this->results;
+
+    // About 40 KB of state, too much for the stack of some threads.
+    std::unique_ptr<lane_block> block = std::make_unique<lane_block>(*this);
+    size_t next_workload{ 0 };
+
+    for (size_t lane{ 0 }; lane < lanes && next_workload < this->workloads.size(); lane++) block->load(lane, next_workload++);
+    block->update_slots();
+
+    while (block->step(next_workload, this->results));
+    return this->results;
+}
@@ -0,0 +1,68 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_LOCKSTEP_BATCH_
+#define _OS_SCHEDULER_SIMULATOR_LOCKSTEP_BATCH_
+
+#include "engine.h"
+
+#include <string>
+#include <vector>
+#include <span>
+
+/// <summary>
+/// Runs many small independent workloads under FCFS or round robin at once, for Monte Carlo studies where the setup of a Simulation (timeline,
+/// lists of Running_Process, std::function) costs more than the run itself.
+///
+/// Workloads are laid out side by side in "lanes": every field of the state (time left in the burst, status, operation, waiting time...) is an
+/// array with one entry per process slot and lane. All lanes advance in lockstep. Finding the next event and advancing every burst by it are
+/// branch-free loops over the lanes with masked updates, which compilers turn into SIMD instructions without any intrinsics. The events
+/// themselves (a burst ends, a slice expires, a process is dispatched) are rare and handled lane by lane. A lane whose workload is done is
+/// refilled with the next one, so long and short workloads do not hold each other back.
+///
+/// The results are the same as Simulation::execute_algorithm("FCFS"), or a FCFS queue with a time slice for round robin: the step follows
+/// the Policy_Runner's, and simultaneous I/O completions are queued in the order the processes started their I/O. Workloads must have at most
+/// max_processes processes, each ending with a CPU burst, bursts of at least 1 unit and no I/O devices; switch costs are not modelled.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Lockstep_Batch {
+public:
+	typedef struct {
+		Evaluator::results_table totals;
+		unsigned execution_time;
+	} result;
+
+	static constexpr size_t lanes = 8;
+	static constexpr size_t max_processes = 32;
+
+	Lockstep_Batch(unsigned quantum = 0);
+
+	bool add_workload(const std::vector<Process_Data>& processes, std::string* error = nullptr);
+	bool add_workload(std::span<const unsigned> burst_counts, std::span<const unsigned> bursts, std::string* error = nullptr);
+	void clear();
+
+	/// <summary>Get the number of workloads added.</summary>
+	size_t size() const { return this->workloads.size(); }
+
+	const std::vector<result>& run();
+
+	/// <summary>Get the results of the last run, in the order the workloads were added.</summary>
+	const std::vector<result>& get_results() const { return this->results; }
+
+private:
+	typedef struct {
+		size_t first_process;
+		unsigned process_count;
+	} workload;
+
+	typedef struct {
+		size_t first_burst;
+		unsigned burst_count;
+	} process;
+
+	struct lane_block;
+
+	unsigned quantum;                          // Time slice of round robin; 0 for FCFS.
+	std::vector<unsigned> bursts;
+	std::vector<process> processes;
+	std::vector<workload> workloads;
+	std::vector<result> results;
+};
+
+#endif
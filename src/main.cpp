@@ -2,7 +2,31 @@
 #include <list>
 #include <iterator>
 #include <array>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <csignal>
+#include <random>
 #include "engine.h"
+#include "trace_import.h"
+#include "algorithms.h"
+#include "batch_runner.h"
+#include "optimizer.h"
+#include "workload_file.h"
+#include "perf_counters.h"
+#include "trace_export.h"
+#include "steady_state.h"
+#include "io_device.h"
+#include "interval_index.h"
+#include "process_group.h"
+#include "simulation_daemon.h"
+#include "calibration.h"
+#include "lockstep_batch.h"
+#include "burst_store.h"
+#include "dependency_graph.h"
 
 #if defined (_REPORT_MODE) // This is the main function used for the report (FAU OS class assignment).
 
@@ -123,6 +147,28 @@ void test_data_points();
 void test_simulator();
 void testing_mlfq();
 void testing_mlfq2();
+void test_trace_import();
+void testing_cfs();
+void testing_shortest_first();
+void testing_trace_export();
+void testing_fast_forward();
+void testing_optimizer();
+void testing_perf_counters();
+void testing_io_devices();
+void testing_deadlines();
+void testing_context_switches();
+void testing_memory_budget();
+void testing_checkpoints();
+void testing_interval_index();
+void testing_shared_prefix();
+void testing_process_groups();
+void testing_simulation_daemon();
+void testing_calibration();
+void testing_lockstep_batch();
+void testing_burst_store();
+void testing_dependency_graph();
+void testing_round_robin();
+void testing_streaming_io();
 
 void print_data_point(const OS_Scheduler_Simulator::Engine::Data_Point& data_point, unsigned time, bool print_level = false);
 
@@ -133,6 +179,28 @@ int main(void) {
     // test_simulator();
     // testing_mlfq();
     testing_mlfq2();
+    // test_trace_import();
+    // testing_cfs();
+    // testing_shortest_first();
+    // testing_trace_export();
+    // testing_fast_forward();
+    // testing_optimizer();
+    // testing_perf_counters();
+    // testing_io_devices();
+    // testing_deadlines();
+    // testing_context_switches();
+    // testing_memory_budget();
+    // testing_checkpoints();
+    // testing_interval_index();
+    // testing_shared_prefix();
+    // testing_process_groups();
+    // testing_simulation_daemon();
+    // testing_calibration();
+    // testing_lockstep_batch();
+    // testing_burst_store();
+    // testing_dependency_graph();
+    // testing_round_robin();
+    // testing_streaming_io();
 
     return 0;
 }
@@ -209,7 +277,7 @@ void test_data_points() {
     // Breakpoint 1: Check if initial Data_Point is correct (everything is in the waiting_list).
 
     // Demonstration of a First Come First Serve algorithm.
-    std::list<OS_Scheduler_Simulator::Engine::Data_Point*> timeline;
+    OS_Scheduler_Simulator::Engine::Timeline timeline;
 
     std::list<OS_Scheduler_Simulator::Engine::Running_Process> waiting_list = current_data_point->get_waiting_list();
     std::list<OS_Scheduler_Simulator::Engine::Running_Process> ready_list = current_data_point->get_ready_list();
@@ -284,9 +352,6 @@ void test_data_points() {
     std::cout << "\tAvg turnaround time: " << eval.get_overall_totals().avg_turnaround_time << std::endl;
 
     std::cout << "\nTotal CPU utilization: " << eval.get_overall_totals().cpu_utilization * 100 << "%" << std::endl;
-
-    // Delete all data points.
-    for (auto data_point : timeline) delete data_point;
 }
 
 void print_results(OS_Scheduler_Simulator::Engine::Simulation& simulator);
@@ -397,6 +462,649 @@ void testing_mlfq2() {
     print_data_point(sim.get_data_at(66), 66, true);
 }
 
+void test_trace_import() {
+    // Sample traces are relative to the project directory (the default working directory in Visual Studio).
+    OS_Scheduler_Simulator::Engine::Trace_Importer ftrace_importer;
+    ftrace_importer.import_file("../samples/traces/ftrace_sched.txt");
+
+    OS_Scheduler_Simulator::Engine::Trace_Importer perf_importer;
+    perf_importer.import_file("../samples/traces/perf_sched.txt");
+
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes = ftrace_importer.get_processes();
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> perf_processes = perf_importer.get_processes();
+
+    // Both dumps describe the same schedule, so they must produce the same workload.
+    bool same_workload = processes.size() == perf_processes.size();
+    for (size_t i{ 0 }; same_workload && i < processes.size(); i++) {
+        same_workload = processes.at(i).get_name() == perf_processes.at(i).get_name() && processes.at(i).get_operations_size() == perf_processes.at(i).get_operations_size();
+        for (size_t j{ 0 }; same_workload && j < processes.at(i).get_operations_size(); j++)
+            same_workload = processes.at(i).get_operation(j) == perf_processes.at(i).get_operation(j);
+    }
+
+    std::cout << "Imported " << processes.size() << " processes from " << ftrace_importer.get_events_read() << " events." << std::endl;
+    std::cout << "ftrace and perf workloads match: " << (same_workload ? "yes" : "no") << std::endl;
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+    std::cout << "Running FCFS algorithm on the imported trace." << std::endl;
+    sim.execute_algorithm("FCFS");
+    print_results(sim);
+}
+
+void testing_cfs() {
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+
+    std::vector<unsigned> bursts = { 30, 5, 30 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts));
+
+    bursts = { 30, 5, 30 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts));
+    processes.back().set_nice(-5); // Roughly three times the share of P1.
+
+    bursts = { 2, 3, 2, 3, 2, 3, 2 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P3", bursts));
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    sim.register_algorithm("CFS (low latency)", OS_SS_Algorithms::make_CFS(8, 2, 1));
+
+    std::cout << "Running CFS algorithm." << std::endl;
+    sim.execute_algorithm("CFS");
+    print_results(sim);
+
+    print_data_point(sim.get_data_at(10), 10);
+
+    std::cout << "Running CFS algorithm with low latency." << std::endl;
+    sim.execute_algorithm("CFS (low latency)");
+    print_results(sim);
+}
+
+void testing_shortest_first() {
+    // A long job and a short interactive one: SRTF lets the short job preempt, ASJF has to learn its burst lengths first.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+
+    std::vector<unsigned> bursts = { 20, 2, 20 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts));
+
+    bursts = { 1, 3, 3, 3, 3 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts));
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    sim.register_algorithm("ASJF (alpha = 0.8)", OS_SS_Algorithms::make_ASJF(0.8, 5));
+
+    for (std::string algorithm : { "SJF", "SRTF", "ASJF", "ASJF (alpha = 0.8)" }) {
+        std::cout << "Running " << algorithm << " algorithm." << std::endl;
+        sim.execute_algorithm(algorithm);
+        print_results(sim);
+    }
+}
+
+void testing_trace_export() {
+    // The schedule is streamed to the exporter and evaluated on the fly; no timeline is kept.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+
+    std::vector<unsigned> bursts = { 5, 8, 3 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts));
+
+    bursts = { 4, 3, 5 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts));
+
+    bursts = { 8, 1, 2 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P3", bursts));
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+    std::ofstream file("schedule_trace.json");
+    OS_Scheduler_Simulator::Engine::Trace_Exporter exporter(file);
+
+    OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = sim.stream_algorithm("FCFS", [&exporter](const OS_Scheduler_Simulator::Engine::Data_Point& data_point) {
+        exporter.add_data_point(data_point);
+    });
+    exporter.finish();
+
+    std::cout << "Wrote " << exporter.get_events_written() << " events to schedule_trace.json (open it in chrome://tracing or ui.perfetto.dev)." << std::endl;
+    std::cout << "Avg waiting time: " << totals.avg_waiting_time << ", CPU utilization: " << totals.cpu_utilization * 100 << "%" << std::endl;
+}
+
+void testing_fast_forward() {
+    // Two processes repeating the same pattern many times: the schedule repeats once both are in step.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::vector<unsigned> bursts;
+
+    for (unsigned i{ 0 }; i < 10000; i++) bursts.insert(bursts.end(), { 4, 6 });
+    bursts.push_back(4);
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts));
+
+    bursts.clear();
+    for (unsigned i{ 0 }; i < 5000; i++) bursts.insert(bursts.end(), { 7, 3, 2, 9 });
+    bursts.push_back(7);
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts));
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+    for (std::string algorithm : { "FCFS", "MLFQ" }) {
+        OS_Scheduler_Simulator::Engine::Cycle_Detector::result fast = OS_Scheduler_Simulator::Engine::Cycle_Detector::fast_forward(sim.get_algorithm(algorithm), processes);
+        OS_Scheduler_Simulator::Engine::Evaluator::results_table full = sim.execute_algorithm(algorithm);
+
+        std::cout << algorithm << ": cycle of " << fast.detected.length << " starting at " << fast.detected.start_time << ", skipped " << fast.detected.repetitions
+                  << " times; simulated " << fast.simulated_points << " points instead of " << sim.get_results()->get_timeline().size() << "." << std::endl;
+        std::cout << "\tAvg waiting time: " << fast.totals.avg_waiting_time << " (full run: " << full.avg_waiting_time << ")" << std::endl;
+        std::cout << "\tCPU utilization: " << fast.totals.cpu_utilization * 100 << "% (full run: " << full.cpu_utilization * 100 << "%)" << std::endl;
+    }
+}
+
+void testing_optimizer() {
+    // Tune CFS for the tail of the response times of a mix of interactive and CPU-bound processes.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+
+    for (unsigned i{ 0 }; i < 12; i++) {
+        std::vector<unsigned> bursts;
+        for (unsigned j{ 0 }; j < 40; j++) bursts.insert(bursts.end(), { (i % 3 == 0) ? 30u : 2u + i % 4, 5u + i });
+        bursts.push_back(3);
+
+        processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P" + std::to_string(i + 1), bursts));
+    }
+
+    OS_Scheduler_Simulator::Parameter_Optimizer optimizer("CFS", processes, OS_Scheduler_Simulator::Parameter_Optimizer::objective::p99_response_time);
+    optimizer.add_range("target_latency", 4, 64, true);
+    optimizer.add_range("min_granularity", 1, 8, true);
+    optimizer.add_values("wakeup_granularity", { 0, 1, 2, 4, 8 });
+
+    OS_Scheduler_Simulator::Parameter_Optimizer::result best;
+    optimizer.optimize(best);
+
+    for (const auto& round : best.rounds)
+        std::cout << round.candidates << " candidates on " << round.horizon * 100 << "% of the bursts: best p99 response time " << round.best_score << std::endl;
+
+    std::cout << "Best configuration after " << best.simulations << " simulations:";
+    for (const auto& [name, value] : best.parameters) std::cout << " " << name << "=" << value;
+    std::cout << std::endl;
+}
+
+void testing_perf_counters() {
+    // Counters stay "unavailable" where the PMU cannot be accessed (containers, perf_event_paranoid); wall time is always measured.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+
+    for (unsigned i{ 0 }; i < 200; i++) {
+        std::vector<unsigned> bursts;
+        for (unsigned j{ 0 }; j < 20; j++) bursts.insert(bursts.end(), { 1 + (i * 7 + j) % 13, 2 + (i + j * 3) % 17 });
+        bursts.push_back(1 + i % 5);
+
+        processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P" + std::to_string(i + 1), bursts));
+    }
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    OS_Scheduler_Simulator::Engine::Perf_Counters::reset();
+    OS_Scheduler_Simulator::Engine::Perf_Counters::set_enabled(true);
+
+    for (std::string algorithm : { "FCFS", "CFS" }) {
+        sim.execute_algorithm(algorithm);
+
+        for (unsigned time{ 0 }; time < sim.get_execution_time(); time += 97)
+            sim.get_data_at(time);
+    }
+
+    OS_Scheduler_Simulator::Engine::Perf_Counters::set_enabled(false);
+    OS_Scheduler_Simulator::Engine::Perf_Counters::print_report(std::cout);
+}
+
+void testing_io_devices() {
+    // Four I/O-heavy processes sharing a single disk, and one using the network with two channels.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::IO_Device> disk = std::make_shared<const OS_Scheduler_Simulator::Engine::IO_Device>("disk", 1);
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::IO_Device> network = std::make_shared<const OS_Scheduler_Simulator::Engine::IO_Device>("network", 2);
+
+    std::vector<unsigned> bursts = { 2, 10, 2, 10, 2 };
+    for (std::string name : { "P1", "P2", "P3", "P4" }) {
+        processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data(name, bursts));
+        processes.back().set_io_device(disk);
+    }
+
+    bursts = { 3, 8, 3 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P5", bursts));
+    processes.back().set_io_device(network);
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = sim.execute_algorithm("FCFS");
+
+    std::cout << "FCFS: avg waiting time " << totals.avg_waiting_time << ", avg I/O queueing delay " << totals.avg_io_queueing_delay << ", execution time " << sim.get_execution_time() << std::endl;
+
+    for (const OS_Scheduler_Simulator::Engine::Evaluator::device_usage& device : sim.get_device_usage())
+        std::cout << "\t" << device.name << " (" << device.channels << " channels): " << device.utilization * 100 << "% busy, " << device.requests << " requests, "
+                  << device.queueing_delay << " queued, longest queue " << device.max_queue_length << std::endl;
+
+    for (const OS_Scheduler_Simulator::Engine::Evaluator::Process& process : sim.get_per_process_evaluation())
+        std::cout << "\t" << process.get_process_name() << ": turnaround " << process.get_turnaround_time() << ", queued for I/O " << process.get_io_queueing_time() << std::endl;
+}
+
+void testing_deadlines() {
+    // Two periodic tasks and one with a deadline per burst, run by a scheduler that ignores deadlines and by the two real-time ones.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+
+    std::vector<unsigned> bursts = { 2, 8, 2, 8, 2 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts));
+    processes.back().set_period(10);
+
+    bursts = { 4, 11, 4, 11, 4 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts));
+    processes.back().set_period(15);
+
+    bursts = { 9, 5, 3 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P3", bursts));
+    processes.back().set_deadlines({ 12, 6 });
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+    for (std::string algorithm : { "FCFS", "EDF", "RM" }) {
+        sim.execute_algorithm(algorithm);
+        const OS_Scheduler_Simulator::Engine::Evaluator::deadline_report report = sim.get_deadline_report();
+
+        std::cout << algorithm << ": " << report.misses << " of " << report.jobs << " jobs missed their deadline, worst lateness " << report.worst_lateness
+                  << ", total tardiness " << report.total_tardiness << std::endl;
+
+        for (const OS_Scheduler_Simulator::Engine::Evaluator::Process& process : sim.get_per_process_evaluation())
+            std::cout << "\t" << process.get_process_name() << ": " << process.get_deadline_misses() << " misses, turnaround " << process.get_turnaround_time() << std::endl;
+    }
+}
+
+void testing_context_switches() {
+    // CPU-bound processes: the shorter the time slices, the more CPU time goes to switching between them.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::vector<unsigned> bursts = { 60, 5, 40 };
+
+    for (std::string name : { "P1", "P2", "P3", "P4" })
+        processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data(name, bursts));
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+    for (unsigned switch_cost : { 0, 1, 3 }) {
+        sim.set_switch_costs(OS_Scheduler_Simulator::Engine::Timeline::switch_costs{ .switch_cost = switch_cost, .cache_penalty = 2 * switch_cost, .cache_decay = 30 });
+
+        for (std::string algorithm : { "FCFS", "MLFQ", "CFS" }) {
+            OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = sim.execute_algorithm(algorithm);
+
+            std::cout << algorithm << " with switch cost " << switch_cost << ": execution time " << sim.get_execution_time() << ", CPU utilization " << totals.cpu_utilization
+                      << " (effective " << totals.effective_cpu_utilization << ", switching " << totals.switch_overhead << ")" << std::endl;
+        }
+    }
+}
+
+void testing_memory_budget() {
+    // Many short bursts, so the timeline is long.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::vector<unsigned> bursts;
+
+    for (unsigned i{ 0 }; i < 2001; i++)
+        bursts.push_back(1 + i % 7);
+
+    for (std::string name : { "P1", "P2", "P3", "P4", "P5", "P6" })
+        processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data(name, bursts));
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    size_t largest_point{ 0 };
+
+    for (size_t budget : { 0, 200000, 20000 }) {
+        sim.set_memory_budget(budget);
+
+        OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = sim.execute_algorithm("MLFQ");
+        OS_Scheduler_Simulator::Engine::Timeline::memory_usage usage = sim.get_memory_usage();
+
+        std::cout << "Budget " << budget << ": average waiting time " << totals.avg_waiting_time << ", peak memory " << usage.peak_resident_bytes
+                  << " bytes, spilled " << usage.spilled_points << " points in " << usage.spilled_bytes << " bytes" << std::endl;
+        print_data_point(sim.get_data_at(5000), 5000);
+
+        if (budget == 0)
+            for (const OS_Scheduler_Simulator::Engine::Data_Point* data_point : sim.get_results()->get_timeline())
+                largest_point = std::max(largest_point, sizeof(data_point) + data_point->get_memory_size());
+
+        // The points in memory and the segments read back may only go over the budget by the point being committed.
+        else if (usage.peak_resident_bytes > budget + largest_point)
+            std::cerr << "Budget " << budget << " exceeded: peak memory " << usage.peak_resident_bytes << " bytes." << std::endl;
+    }
+}
+
+void testing_checkpoints() {
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::vector<unsigned> bursts_1 = { 5, 27, 3, 31, 5, 43, 4 };
+    std::vector<unsigned> bursts_2 = { 8, 33, 12, 41, 18, 65, 14 };
+    std::vector<unsigned> bursts_3 = { 16, 24, 17, 21, 5 };
+
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts_1));
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts_2));
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P3", bursts_3));
+
+    const std::string path = "testing_checkpoints.bin";
+
+    for (std::string algorithm : { "FCFS", "MLFQ", "CFS" }) {
+        OS_Scheduler_Simulator::Engine::Simulation complete(processes);
+        OS_Scheduler_Simulator::Engine::Evaluator::results_table uninterrupted = complete.execute_algorithm(algorithm);
+
+        // The last checkpoint is left in the file, as if the run had stopped there.
+        OS_Scheduler_Simulator::Engine::Simulation checkpointed(processes);
+        checkpointed.run_with_checkpoints(algorithm, path, 4);
+
+        std::string error;
+        OS_Scheduler_Simulator::Engine::Simulation resumed(processes);
+        OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = resumed.resume_from_checkpoint(path, &error);
+
+        std::cout << algorithm << ": average waiting time " << uninterrupted.avg_waiting_time << " uninterrupted, " << totals.avg_waiting_time << " resumed"
+                  << ((error.empty()) ? "" : " (" + error + ")") << std::endl;
+    }
+
+    std::remove(path.c_str());
+}
+
+void testing_interval_index() {
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::vector<unsigned> bursts_1 = { 5, 27, 3, 31, 5, 43, 4 };
+    std::vector<unsigned> bursts_2 = { 8, 33, 12, 41, 18, 65, 14 };
+    std::vector<unsigned> bursts_3 = { 16, 24, 17, 21, 5 };
+
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts_1));
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts_2));
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P3", bursts_3));
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    sim.execute_algorithm("MLFQ");
+
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::Interval_Index> index = sim.get_interval_index();
+    const unsigned columns = 60;
+
+    // One character per column, for the state the process spent most of the column in.
+    for (size_t i{ 0 }; i < index->get_process_count(); i++) {
+        std::string chart;
+
+        for (const OS_Scheduler_Simulator::Engine::Interval_Index::occupancy& column : index->get_overview(i, 0, index->get_end_time(), columns)) {
+            const auto most = std::max_element(column.begin(), column.end());
+            chart += (*most == 0) ? ' ' : "#.~~"[most - column.begin()];
+        }
+
+        std::cout << processes.at(i).get_name() << " |" << chart << "|" << std::endl;
+    }
+
+    std::cout << "P2 before 40:" << std::endl;
+
+    for (const OS_Scheduler_Simulator::Engine::Interval_Index::interval& interval : index->get_intervals(1, 0, 40))
+        std::cout << "    " << interval.start << "-" << interval.end << ": state " << interval.state << std::endl;
+}
+
+void testing_shared_prefix() {
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::vector<unsigned> bursts_1 = { 5, 27, 3, 31, 5, 43, 4 };
+    std::vector<unsigned> bursts_2 = { 8, 33, 12, 41, 18, 65, 14 };
+    std::vector<unsigned> bursts_3 = { 16, 24, 17, 21, 5 };
+
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts_1));
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts_2));
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P3", bursts_3));
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    const std::vector<std::string> names = { "FCFS", "SJF", "SRTF", "EDF", "RM", "CFS", "MLFQ" };
+    std::vector<std::shared_ptr<const OS_Scheduler_Simulator::Engine::Result_Snapshot>> results = sim.compare_algorithms(names);
+
+    for (size_t i{ 0 }; i < names.size(); i++) {
+        const OS_Scheduler_Simulator::Engine::Timeline& timeline = results.at(i)->get_timeline();
+
+        std::cout << names.at(i) << ": average waiting time " << results.at(i)->get_total_results().avg_waiting_time << ", " << timeline.get_shared_points()
+                  << " of " << timeline.size() << " points shared" << std::endl;
+    }
+}
+
+void testing_process_groups() {
+    // Two containers: "web" with twice the weight of "batch", and "batch" capped at 25% of the CPU. One of its jobs is capped again below it.
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::Process_Group> web = std::make_shared<const OS_Scheduler_Simulator::Engine::Process_Group>("web", nullptr, 2048);
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::Process_Group> batch = std::make_shared<const OS_Scheduler_Simulator::Engine::Process_Group>("batch", nullptr, 1024, 25, 100);
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::Process_Group> report = std::make_shared<const OS_Scheduler_Simulator::Engine::Process_Group>("report", batch, 1024, 5, 50);
+
+    std::vector<unsigned> bursts = { 20, 4, 20, 4, 20 };
+    for (std::string name : { "W1", "W2" }) {
+        processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data(name, bursts));
+        processes.back().set_group(web);
+    }
+
+    bursts = { 60 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("B1", bursts));
+    processes.back().set_group(batch);
+
+    bursts = { 30 };
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("R1", bursts));
+    processes.back().set_group(report);
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+    for (std::string algorithm : { "CFS", "Group" }) {
+        OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = sim.execute_algorithm(algorithm);
+
+        std::cout << algorithm << ": execution time " << sim.get_execution_time() << ", avg waiting time " << totals.avg_waiting_time << std::endl;
+
+        for (const OS_Scheduler_Simulator::Engine::Evaluator::group_usage& group : sim.get_group_usage())
+            std::cout << "\t" << group.name << ((group.parent.empty()) ? "" : " (in " + group.parent + ")") << ": " << group.cpu_time << " CPU time, " << group.utilization * 100
+                      << "% of the run, throttled for " << group.throttled_time << " in " << group.throttled_periods << " periods" << std::endl;
+    }
+}
+
+void testing_simulation_daemon() {
+    const std::string socket_path = "simulator_demo.sock";
+    std::string error;
+
+    OS_Scheduler_Simulator::Simulation_Daemon daemon;
+    if (!daemon.start(socket_path, &error)) {
+        std::cout << "Daemon not started: " << error << std::endl;
+        return;
+    }
+
+    OS_Scheduler_Simulator::Daemon_Client client;
+    unsigned long long workload{ 0 };
+    size_t processes{ 0 };
+
+    if (!client.connect(socket_path, &error) || !client.put_workload("P1 5 27 3 31 5\nP2 8 33 12 41 18\nP3 16 24 17 21 5\n", workload, &processes, &error)) {
+        std::cout << "Client failed: " << error << std::endl;
+        return;
+    }
+
+    OS_Scheduler_Simulator::Batch_Runner::scenario_result result;
+    if (client.run(workload, "CFS", { { "target_latency", 12 } }, result, &error))
+        std::cout << "CFS on " << processes << " processes: execution time " << result.execution_time << ", avg waiting time " << result.totals.avg_waiting_time << std::endl;
+
+    // Pipelined: the requests go out together and come back in batches.
+    const unsigned runs{ 10000 };
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (unsigned i{ 0 }; i < runs; i++) client.send_run(workload, (i % 2 == 0) ? "FCFS" : "SJF", {});
+
+    OS_Scheduler_Simulator::Daemon_Client::response answer;
+    for (unsigned i{ 0 }; i < runs && client.receive(answer, &error); i++) {}
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << runs << " runs in " << seconds << " s (" << runs / seconds << " per second), " << daemon.get_batches() << " batches" << std::endl;
+
+    daemon.stop();
+}
+
+void testing_calibration() {
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::vector<unsigned> bursts_1 = { 20, 5, 20 };
+    std::vector<unsigned> bursts_2 = { 4, 10, 4, 10, 4 };
+    std::vector<unsigned> bursts_3 = { 30 };
+
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P1", bursts_1));
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P2", bursts_2));
+    processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P3", bursts_3));
+
+    OS_Scheduler_Simulator::Engine::Calibration calibration(processes, 1000);
+    std::string error;
+
+    if (!calibration.measure(&error)) {
+        std::cout << "Calibration failed: " << error << std::endl;
+        return;
+    }
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+    // The same measurement is compared with every algorithm.
+    for (std::string algorithm : { "FCFS", "SRTF", "CFS" }) {
+        const OS_Scheduler_Simulator::Engine::Calibration::report report = calibration.compare(sim, algorithm);
+
+        std::cout << algorithm << (report.pinned ? "" : " (threads not pinned)") << ": avg waiting time " << report.simulated.avg_waiting_time << " simulated, "
+                  << report.measured.avg_waiting_time << " measured; avg response time " << report.simulated.avg_response_time << " simulated, "
+                  << report.measured.avg_response_time << " measured" << std::endl;
+    }
+}
+
+void testing_lockstep_batch() {
+    std::mt19937 generator(7);
+    std::vector<std::vector<OS_Scheduler_Simulator::Engine::Process_Data>> workloads;
+
+    // Random workloads of 5 to 20 processes, each with 1 to 3 CPU bursts.
+    for (unsigned i{ 0 }; i < 1000; i++) {
+        std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+        const unsigned count = 5 + generator() % 16;
+
+        for (unsigned p{ 0 }; p < count; p++) {
+            std::vector<unsigned> bursts;
+            const unsigned operations = 1 + 2 * (generator() % 3);
+            for (unsigned o{ 0 }; o < operations; o++) bursts.push_back(1 + generator() % 20);
+            processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P" + std::to_string(p + 1), bursts));
+        }
+
+        workloads.push_back(processes);
+    }
+
+    OS_Scheduler_Simulator::Engine::Lockstep_Batch batch;
+    for (const auto& processes : workloads) batch.add_workload(processes);
+
+    const std::vector<OS_Scheduler_Simulator::Engine::Lockstep_Batch::result>& results = batch.run();
+
+    // Every workload should give the same results as a Simulation.
+    unsigned mismatches{ 0 };
+    for (size_t i{ 0 }; i < workloads.size(); i++) {
+        OS_Scheduler_Simulator::Engine::Simulation sim(workloads.at(i));
+        const OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = sim.execute_algorithm("FCFS");
+
+        if (totals.avg_waiting_time != results.at(i).totals.avg_waiting_time || totals.avg_turnaround_time != results.at(i).totals.avg_turnaround_time ||
+            totals.avg_response_time != results.at(i).totals.avg_response_time || sim.get_execution_time() != results.at(i).execution_time)
+            mismatches++;
+    }
+
+    std::cout << "Lockstep batch: " << results.size() << " workloads, " << mismatches << " different from the simulation" << std::endl;
+}
+
+void testing_burst_store() {
+    std::mt19937 generator(11);
+    std::shared_ptr<OS_Scheduler_Simulator::Engine::Burst_Store> store = std::make_shared<OS_Scheduler_Simulator::Engine::Burst_Store>();
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> unpacked;
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> packed;
+
+    for (unsigned p{ 0 }; p < 50; p++) {
+        std::vector<unsigned> bursts(1 + 2 * (generator() % 10));
+        for (unsigned& burst : bursts) burst = 1 + generator() % 300;
+
+        unpacked.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P" + std::to_string(p + 1), bursts));
+        packed.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P" + std::to_string(p + 1), store.get(), store->append(bursts), bursts.size()));
+    }
+
+    store->shrink_to_fit();
+
+    // Both workloads should give the same schedule.
+    OS_Scheduler_Simulator::Engine::Simulation unpacked_sim(unpacked);
+    OS_Scheduler_Simulator::Engine::Simulation packed_sim(packed);
+
+    for (std::string algorithm : { "FCFS", "SRTF", "CFS" })
+        std::cout << algorithm << ": avg waiting time " << unpacked_sim.execute_algorithm(algorithm).avg_waiting_time << " unpacked, "
+                  << packed_sim.execute_algorithm(algorithm).avg_waiting_time << " packed" << std::endl;
+
+    std::cout << store->size() << " bursts in " << store->get_memory_usage() << " bytes, against " << store->size() * sizeof(unsigned) << " unpacked" << std::endl;
+}
+
+void testing_dependency_graph() {
+    // A layered graph: every process waits for two processes of the layer before, and the last layer waits for a barrier.
+    std::mt19937 generator(5);
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    const unsigned layers{ 20 }, width{ 10 };
+
+    for (unsigned layer{ 0 }; layer < layers; layer++) {
+        for (unsigned column{ 0 }; column < width; column++) {
+            std::vector<unsigned> bursts = { 1 + static_cast<unsigned>(generator() % 6), 1 + static_cast<unsigned>(generator() % 8), 1 + static_cast<unsigned>(generator() % 6) };
+            processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("L" + std::to_string(layer) + "_" + std::to_string(column), bursts));
+
+            if (layer > 0) processes.back().set_predecessors({ (layer - 1) * width + column, (layer - 1) * width + (column + 1) % width });
+            if (layer == layers - 2) processes.back().set_barrier(1);
+            if (layer == layers - 1) processes.back().set_awaited_barriers({ 1 });
+        }
+    }
+
+    const OS_Scheduler_Simulator::Engine::Dependency_Graph graph(processes);
+    std::string error;
+    if (!graph.is_valid(&error)) std::cout << "Invalid graph: " << error << std::endl;
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+    for (std::string algorithm : { "FCFS", "SJF", "MLFQ", "CFS" }) {
+        sim.execute_algorithm(algorithm);
+        const OS_Scheduler_Simulator::Engine::Dependency_Graph::critical_path_report report = graph.get_critical_path(sim.get_per_process_evaluation(), sim.get_execution_time());
+
+        // The work and the waiting on the critical path add up to the makespan.
+        std::cout << algorithm << ": makespan " << report.makespan << " (dependency bound " << report.dependency_bound << ", CPU bound " << report.cpu_bound << "), "
+                  << report.critical_path.size() << " processes on the critical path, " << report.path_work << " working and " << report.path_waiting << " waiting" << std::endl;
+    }
+}
+
+void testing_round_robin() {
+    // Two high priority processes keep the CPU busy, and the low priority one only runs early with aging.
+    std::vector<unsigned> high = { 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10 };
+    std::vector<unsigned> low = { 5 };
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes = { OS_Scheduler_Simulator::Engine::Process_Data("H1", high),
+        OS_Scheduler_Simulator::Engine::Process_Data("H2", high), OS_Scheduler_Simulator::Engine::Process_Data("L", low) };
+    processes.at(0).set_nice(-10);
+    processes.at(1).set_nice(-10);
+    processes.at(2).set_nice(10);
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    sim.register_algorithm("Priority without aging", OS_SS_Algorithms::make_Priority(4, 0));
+    sim.register_algorithm("Priority with aging", OS_SS_Algorithms::make_Priority(4, 5));
+
+    for (std::string algorithm : { "RR", "Priority without aging", "Priority with aging" }) {
+        sim.execute_algorithm(algorithm);
+        const std::vector<OS_Scheduler_Simulator::Engine::Evaluator::Process> evaluation = sim.get_per_process_evaluation();
+        std::cout << algorithm << ": L responds at " << evaluation.at(2).get_response_time() << ", makespan " << sim.get_execution_time() << std::endl;
+    }
+
+    // The ready queue of every level at time 10, as recorded in the data point.
+    const OS_Scheduler_Simulator::Engine::Data_Point data_point = sim.get_data_at(10);
+
+    for (const OS_Scheduler_Simulator::Engine::Data_Point::ready_level& level : data_point.get_ready_levels())
+        for (const auto& process : level.processes)
+            std::cout << "\tLevel " << level.level << ": " << process.get_proc_name() << std::endl;
+}
+
+void testing_streaming_io() {
+    // I/O-heavy processes all sharing one disk, so most of them are queued for it at any time. Streamed runs only record how the ready
+    // queue and the waiting list change, so a step costs the same however many requests are outstanding.
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::IO_Device> disk = std::make_shared<const OS_Scheduler_Simulator::Engine::IO_Device>("disk", 4);
+    std::vector<unsigned> bursts = { 2, 50, 2, 50, 2 };
+
+    for (size_t count : { 1000, 10000, 100000 }) {
+        std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+        processes.reserve(count);
+
+        for (size_t i{ 0 }; i < count; i++) {
+            processes.push_back(OS_Scheduler_Simulator::Engine::Process_Data("P" + std::to_string(i + 1), bursts));
+            processes.back().set_io_device(disk);
+        }
+
+        OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+
+        for (std::string algorithm : { "CFS", "SRTF", "SJF", "ASJF" }) {
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            OS_Scheduler_Simulator::Engine::Evaluator::results_table totals = sim.stream_algorithm(algorithm, nullptr);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << algorithm << " streamed over " << count << " processes in " << seconds << " s: avg waiting time " << totals.avg_waiting_time
+                      << ", avg I/O queueing delay " << totals.avg_io_queueing_delay << std::endl;
+        }
+    }
+}
+
 void print_data_point(const OS_Scheduler_Simulator::Engine::Data_Point& data_point, unsigned time, bool print_level) {
     std::cout << "Information of processes at time " << time << ":" << std::endl;
 
@@ -417,4 +1125,430 @@ void print_data_point(const OS_Scheduler_Simulator::Engine::Data_Point& data_poi
     std::cout << "\n" << std::endl;
 }
 
+#else // Command-line driver: runs a manifest of scenarios on all the cores of the machine.
+
+void print_usage(const char* program);
+int run_optimizer(int argc, char* argv[]);
+int run_daemon(int argc, char* argv[]);
+int run_client(int argc, char* argv[]);
+int run_calibration(int argc, char* argv[]);
+int run_critical_path(int argc, char* argv[]);
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--optimize") return run_optimizer(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--daemon") return run_daemon(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--client") return run_client(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--calibrate") return run_calibration(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--critical-path") return run_critical_path(argc, argv);
+
+    std::string manifest;
+    std::string output_path;
+    unsigned threads{ 0 };
+    bool count_events{ false };
+    OS_Scheduler_Simulator::Batch_Runner::output_format format = OS_Scheduler_Simulator::Batch_Runner::output_format::csv;
+
+    for (int i{ 1 }; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if ((argument == "-j" || argument == "--threads") && i + 1 < argc) threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if ((argument == "-o" || argument == "--output") && i + 1 < argc) output_path = argv[++i];
+        else if (argument == "--perf") count_events = true;
+        else if (argument == "--format" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name == "json") format = OS_Scheduler_Simulator::Batch_Runner::output_format::json;
+            else if (name != "csv") {
+                print_usage(argv[0]);
+                return 2;
+            }
+        }
+
+        else if (manifest.empty() && !argument.empty() && argument.front() != '-') manifest = argument;
+        else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (manifest.empty()) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    OS_Scheduler_Simulator::Batch_Runner runner(threads);
+    std::string error;
+
+    if (!runner.load_manifest(manifest, &error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    std::ofstream output_file;
+    if (!output_path.empty()) {
+        output_file.open(output_path);
+        if (!output_file.is_open()) {
+            std::cerr << "Error: could not open \"" << output_path << "\" for writing." << std::endl;
+            return 1;
+        }
+    }
+
+    OS_Scheduler_Simulator::Engine::Perf_Counters::set_enabled(count_events);
+
+    const size_t failures = runner.run((output_path.empty()) ? std::cout : output_file, format);
+    if (failures > 0) std::cerr << failures << " of " << runner.get_scenarios().size() << " scenarios failed." << std::endl;
+
+    if (count_events) OS_Scheduler_Simulator::Engine::Perf_Counters::print_report(std::cerr);
+
+    return (failures > 0) ? 1 : 0;
+}
+
+// Parameter search: --optimize <workload> <algorithm> [options] parameter=min:max | parameter=min..max | parameter=v1,v2,...
+int run_optimizer(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    std::vector<std::string> parameters;
+    OS_Scheduler_Simulator::Parameter_Optimizer::objective goal = OS_Scheduler_Simulator::Parameter_Optimizer::objective::avg_waiting_time;
+    OS_Scheduler_Simulator::Parameter_Optimizer::settings search{ .candidates = 27, .eta = 3, .seed = 1 };
+    unsigned threads{ 0 };
+
+    for (int i{ 2 }; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if ((argument == "-j" || argument == "--threads") && i + 1 < argc) threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (argument == "--candidates" && i + 1 < argc) search.candidates = std::stoul(argv[++i]);
+        else if (argument == "--eta" && i + 1 < argc) search.eta = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (argument == "--seed" && i + 1 < argc) search.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (argument == "--objective" && i + 1 < argc) {
+            if (!OS_Scheduler_Simulator::Parameter_Optimizer::parse_objective(argv[++i], goal)) {
+                std::cerr << "Error: unknown objective \"" << argv[i] << "\"." << std::endl;
+                return 2;
+            }
+        }
+
+        else if (argument.find('=') != std::string::npos) parameters.push_back(argument);
+        else if (!argument.empty() && argument.front() != '-') positional.push_back(argument);
+        else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (positional.size() != 2) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::Burst_Store> bursts;
+    std::string error;
+
+    if (!OS_Scheduler_Simulator::Engine::Workload_File::load(positional.at(0), processes, &error, &bursts)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    OS_Scheduler_Simulator::Parameter_Optimizer optimizer(positional.at(1), processes, goal, threads);
+
+    for (const std::string& parameter : parameters) {
+        const std::string name = parameter.substr(0, parameter.find('='));
+        const std::string space = parameter.substr(parameter.find('=') + 1);
+
+        try {
+            if (space.find("..") != std::string::npos)
+                optimizer.add_range(name, std::stod(space.substr(0, space.find(".."))), std::stod(space.substr(space.find("..") + 2)), true);
+            else if (space.find(':') != std::string::npos)
+                optimizer.add_range(name, std::stod(space.substr(0, space.find(':'))), std::stod(space.substr(space.find(':') + 1)), false);
+            else {
+                std::vector<double> values;
+                for (size_t start{ 0 }; start <= space.size(); start = space.find(',', start) + 1) {
+                    values.push_back(std::stod(space.substr(start)));
+                    if (space.find(',', start) == std::string::npos) break;
+                }
+
+                optimizer.add_values(name, values);
+            }
+        }
+
+        catch (...) {
+            std::cerr << "Error: invalid search space \"" << parameter << "\"." << std::endl;
+            return 2;
+        }
+    }
+
+    OS_Scheduler_Simulator::Parameter_Optimizer::result best;
+
+    if (!optimizer.optimize(best, search, &error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    for (const OS_Scheduler_Simulator::Parameter_Optimizer::round& current : best.rounds)
+        std::cout << "Round: " << current.candidates << " candidates on " << current.horizon * 100 << "% of the bursts, best score " << current.best_score << std::endl;
+
+    std::cout << "Best configuration (" << best.simulations << " simulations):";
+    for (const auto& [name, value] : best.parameters) std::cout << " " << name << "=" << value;
+    std::cout << "\nScore: " << best.score << std::endl;
+
+    return 0;
+}
+
+namespace {
+    volatile std::sig_atomic_t stop_daemon{ 0 };
+}
+
+// Simulation daemon: --daemon <socket> [-j threads]. Serves until interrupted.
+int run_daemon(int argc, char* argv[]) {
+    std::string socket_path;
+    unsigned threads{ 0 };
+
+    for (int i{ 2 }; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if ((argument == "-j" || argument == "--threads") && i + 1 < argc) threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (socket_path.empty() && !argument.empty() && argument.front() != '-') socket_path = argument;
+        else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (socket_path.empty()) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    OS_Scheduler_Simulator::Simulation_Daemon daemon(threads);
+    std::string error;
+
+    std::signal(SIGINT, [](int) { stop_daemon = 1; });
+    std::signal(SIGTERM, [](int) { stop_daemon = 1; });
+
+    if (!daemon.start(socket_path, &error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Listening on " << socket_path << std::endl;
+    while (stop_daemon == 0) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    daemon.stop();
+    std::cerr << daemon.get_requests() << " requests in " << daemon.get_batches() << " batches." << std::endl;
+    return 0;
+}
+
+// Stub client of the daemon: --client <socket> <workload> <algorithm> [--repeat n] [parameter=value ...]. Runs the scenario n times,
+// pipelined, and prints the result and the throughput.
+int run_client(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    std::map<std::string, double> parameters;
+    unsigned long long repeat{ 1 };
+
+    for (int i{ 2 }; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--repeat" && i + 1 < argc) repeat = std::max(std::stoull(argv[++i]), 1ull);
+        else if (argument.find('=') != std::string::npos) {
+            try {
+                parameters[argument.substr(0, argument.find('='))] = std::stod(argument.substr(argument.find('=') + 1));
+            }
+
+            catch (...) {
+                std::cerr << "Error: invalid parameter \"" << argument << "\"." << std::endl;
+                return 2;
+            }
+        }
+
+        else if (!argument.empty() && argument.front() != '-') positional.push_back(argument);
+        else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (positional.size() != 3) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    OS_Scheduler_Simulator::Daemon_Client client;
+    unsigned long long workload{ 0 };
+    std::string error;
+
+    if (!client.connect(positional.at(0), &error) || !client.load_workload(positional.at(1), workload, nullptr, &error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (unsigned long long i{ 0 }; i < repeat; i++) client.send_run(workload, positional.at(2), parameters);
+
+    OS_Scheduler_Simulator::Daemon_Client::response answer;
+    size_t failures{ 0 };
+
+    for (unsigned long long i{ 0 }; i < repeat; i++) {
+        if (!client.receive(answer, &error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+
+        if (!answer.ok) failures++;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!answer.ok) std::cerr << "Error: " << answer.error << std::endl;
+    else {
+        const OS_Scheduler_Simulator::Engine::Evaluator::results_table& totals = answer.result.totals;
+        std::cout << "execution_time=" << answer.result.execution_time << " cpu_utilization=" << totals.cpu_utilization << " avg_waiting_time=" << totals.avg_waiting_time
+            << " avg_turnaround_time=" << totals.avg_turnaround_time << " avg_response_time=" << totals.avg_response_time << std::endl;
+    }
+
+    std::cerr << repeat << " runs in " << seconds << " s (" << static_cast<double>(repeat) / std::max(seconds, 1e-9) << " per second)." << std::endl;
+    return (failures > 0) ? 1 : 0;
+}
+
+// Calibration: --calibrate <workload> <algorithm> [--unit microseconds] [parameter=value ...]. Replays the workload on real threads and
+// prints the measured results next to the simulated ones.
+int run_calibration(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    std::map<std::string, double> parameters;
+    unsigned time_unit_us{ 1000 };
+
+    for (int i{ 2 }; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--unit" && i + 1 < argc) time_unit_us = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (argument.find('=') != std::string::npos) {
+            try {
+                parameters[argument.substr(0, argument.find('='))] = std::stod(argument.substr(argument.find('=') + 1));
+            }
+
+            catch (...) {
+                std::cerr << "Error: invalid parameter \"" << argument << "\"." << std::endl;
+                return 2;
+            }
+        }
+
+        else if (!argument.empty() && argument.front() != '-') positional.push_back(argument);
+        else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (positional.size() != 2) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::Burst_Store> bursts;
+    std::string error;
+
+    if (!OS_Scheduler_Simulator::Engine::Workload_File::load(positional.at(0), processes, &error, &bursts)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    auto algorithm = OS_SS_Algorithms::create_algorithm(positional.at(1), parameters, &error);
+    if (!algorithm) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    OS_Scheduler_Simulator::Engine::Calibration calibration(processes, time_unit_us);
+    if (!calibration.measure(&error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    sim.register_algorithm(positional.at(1), algorithm);
+
+    const OS_Scheduler_Simulator::Engine::Calibration::report report = calibration.compare(sim, positional.at(1));
+
+    std::cout << "1 unit = " << time_unit_us << " us, " << ((report.pinned) ? "all threads on one CPU" : "threads not pinned") << "\n" << std::endl;
+    std::cout << "metric,simulated,measured" << std::endl;
+    std::cout << "execution_time," << report.simulated_execution_time << "," << report.measured_execution_time << std::endl;
+    std::cout << "cpu_utilization," << report.simulated.cpu_utilization << "," << report.measured.cpu_utilization << std::endl;
+    std::cout << "avg_waiting_time," << report.simulated.avg_waiting_time << "," << report.measured.avg_waiting_time << std::endl;
+    std::cout << "avg_turnaround_time," << report.simulated.avg_turnaround_time << "," << report.measured.avg_turnaround_time << std::endl;
+    std::cout << "avg_response_time," << report.simulated.avg_response_time << "," << report.measured.avg_response_time << std::endl;
+    std::cout << "avg_io_queueing_delay," << report.simulated.avg_io_queueing_delay << "," << report.measured.avg_io_queueing_delay << "\n" << std::endl;
+
+    std::cout << "process,simulated_waiting,measured_waiting,simulated_turnaround,measured_turnaround,simulated_response,measured_response" << std::endl;
+    for (const OS_Scheduler_Simulator::Engine::Calibration::process_comparison& process : report.processes)
+        std::cout << process.name << "," << process.simulated.waiting_time << "," << process.measured.waiting_time << "," << process.simulated.turnaround_time << ","
+                  << process.measured.turnaround_time << "," << process.simulated.response_time << "," << process.measured.response_time << std::endl;
+
+    return 0;
+}
+
+// Critical path: --critical-path <workload> [algorithm ...]. Runs the algorithms (all the built-in ones but EDF, RM and Group by default) and
+// splits the makespan of each over the chain of dependencies that ended last.
+int run_critical_path(int argc, char* argv[]) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<OS_Scheduler_Simulator::Engine::Process_Data> processes;
+    std::shared_ptr<const OS_Scheduler_Simulator::Engine::Burst_Store> bursts;
+    std::string error;
+
+    if (!OS_Scheduler_Simulator::Engine::Workload_File::load(argv[2], processes, &error, &bursts)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    const OS_Scheduler_Simulator::Engine::Dependency_Graph graph(processes);
+    if (!graph.is_valid(&error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> names(argv + 3, argv + argc);
+    if (names.empty()) names = { "FCFS", "SJF", "SRTF", "ASJF", "MLFQ", "CFS" };
+
+    OS_Scheduler_Simulator::Engine::Simulation sim(processes);
+    const std::vector<std::shared_ptr<const OS_Scheduler_Simulator::Engine::Result_Snapshot>> snapshots = sim.compare_algorithms(names);
+
+    for (size_t i{ 0 }; i < names.size(); i++) {
+        if (snapshots.at(i) == nullptr) {
+            std::cerr << "Error: unknown algorithm \"" << names.at(i) << "\"." << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "algorithm,makespan,dependency_bound,cpu_bound,path_work,path_waiting,critical_path" << std::endl;
+
+    for (size_t i{ 0 }; i < names.size(); i++) {
+        const OS_Scheduler_Simulator::Engine::Dependency_Graph::critical_path_report report =
+            graph.get_critical_path(snapshots.at(i)->get_per_process_evaluation(), snapshots.at(i)->get_execution_time());
+
+        std::cout << names.at(i) << "," << report.makespan << "," << report.dependency_bound << "," << report.cpu_bound << "," << report.path_work << ","
+                  << report.path_waiting << ",";
+
+        for (size_t j{ 0 }; j < report.critical_path.size(); j++)
+            std::cout << ((j > 0) ? " " : "") << processes.at(report.critical_path.at(j)).get_name();
+
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " <manifest> [-j threads] [--format csv|json] [-o output] [--perf]" << std::endl;
+    std::cerr << "       " << program << " --optimize <workload> <algorithm> [-j threads] [--objective name] [--candidates n] [--eta n] [--seed n] parameter=space ..." << std::endl;
+    std::cerr << "       " << program << " --calibrate <workload> <algorithm> [--unit microseconds] [parameter=value ...]" << std::endl;
+    std::cerr << "       " << program << " --critical-path <workload> [algorithm ...]" << std::endl;
+    std::cerr << "       " << program << " --daemon <socket> [-j threads]" << std::endl;
+    std::cerr << "       " << program << " --client <socket> <workload> <algorithm> [--repeat n] [parameter=value ...]" << std::endl;
+    std::cerr << "\nEach manifest line is a scenario: <workload file> <algorithm> [parameter=value ...]" << std::endl;
+    std::cerr << "Algorithms: FCFS, SJF, SRTF, ASJF (alpha, initial_prediction), MLFQ (quantum_1, quantum_2, boost_period)," << std::endl;
+    std::cerr << "CFS (target_latency, min_granularity, wakeup_granularity), RR (quantum), Priority (quantum, aging)." << std::endl;
+    std::cerr << "Search spaces: min:max (real), min..max (integer) or v1,v2,... Objectives: avg_waiting_time, avg_turnaround_time, avg_response_time," << std::endl;
+    std::cerr << "p99_response_time, p99_turnaround_time." << std::endl;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "optimizer.h"
+#include "thread_pool.h"
+#include "algorithms.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+/// <summary>
+/// Parameter_Optimizer constructor.
+/// </summary>
+/// <param name="algorithm">- Name of the algorithm, as create_algorithm knows it.</param>
+/// <param name="workload">- Complete workload. The candidates that survive every round are scored on it.</param>
+/// <param name="goal">- Objective to minimize.</param>
+/// <param name="threads">- Number of worker threads. 0 uses one per hardware thread.</param>
+OS_Scheduler_Simulator::Parameter_Optimizer::Parameter_Optimizer(const std::string& algorithm, const std::vector<Engine::Process_Data>& workload, objective goal, unsigned threads)
+    : algorithm(algorithm), workload(workload), goal(goal), threads(threads), dimensions() {}
+
+/// <summary>
+/// Search a parameter over an interval.
+/// </summary>
+/// <param name="integer">- Only try whole numbers.</param>
+void OS_Scheduler_Simulator::Parameter_Optimizer::add_range(const std::string& parameter, double min, double max, bool integer) {
+    this->dimensions.push_back(dimension{ .name = parameter, .values = {}, .min = min, .max = max, .integer = integer });
+}
+
+/// <summary>
+/// Search a parameter over a list of values.
+/// </summary>
+void OS_Scheduler_Simulator::Parameter_Optimizer::add_values(const std::string& parameter, const std::vector<double>& values) {
+    this->dimensions.push_back(dimension{ .name = parameter, .values = values, .min = 0, .max = 0, .integer = false });
+}
+
+/// <summary>
+/// Get an objective from its name (the name of the enumerator).
+/// </summary>
+/// <returns>False if there is no objective with that name.</returns>
+bool OS_Scheduler_Simulator::Parameter_Optimizer::parse_objective(const std::string& name, objective& goal) {
+    static const std::map<std::string, objective> names = {
+        { "avg_waiting_time", objective::avg_waiting_time },
+        { "avg_turnaround_time", objective::avg_turnaround_time },
+        { "avg_response_time", objective::avg_response_time },
+        { "p99_response_time", objective::p99_response_time },
+        { "p99_turnaround_time", objective::p99_turnaround_time }
+    };
+
+    auto it = names.find(name);
+    if (it == names.end()) return false;
+
+    goal = it->second;
+    return true;
+}
+
+/// <summary>
+/// Run the search.
+/// </summary>
+/// <param name="best">- Receives the best configuration and a summary of every round.</param>
+/// <param name="search">- Size of the first round, reduction factor and seed.</param>
+/// <param name="error">- Optional description of the problem if the search could not run.</param>
+/// <returns>False if the algorithm, a parameter or the settings are invalid.</returns>
+bool OS_Scheduler_Simulator::Parameter_Optimizer::optimize(result& best, settings search, std::string* error) {
+    if (search.eta < 2 || search.candidates == 0) {
+        if (error != nullptr) *error = "eta must be at least 2 and there must be at least one candidate";
+        return false;
+    }
+
+    if (this->workload.empty()) {
+        if (error != nullptr) *error = "the workload has no processes";
+        return false;
+    }
+
+    for (const dimension& current : this->dimensions)
+        if ((current.values.empty() && current.min > current.max) || (current.values.empty() && current.integer && std::ceil(current.min) > std::floor(current.max))) {
+            if (error != nullptr) *error = "parameter \"" + current.name + "\" has an empty range";
+            return false;
+        }
+
+    std::vector<candidate> candidates = this->sample_candidates(search);
+
+    // Checks the algorithm, the names and the value of every candidate, so no simulation runs with an invalid parameter.
+    for (const candidate& current : candidates)
+        if (!OS_SS_Algorithms::create_algorithm(this->algorithm, current.parameters, error)) return false;
+
+    // Number of rounds so the last one has at most eta candidates.
+    size_t rounds{ 1 };
+    for (size_t remaining{ candidates.size() }; remaining > search.eta; remaining = (remaining + search.eta - 1) / search.eta)
+        rounds++;
+
+    best.rounds.clear();
+    best.simulations = 0;
+
+    Work_Stealing_Pool pool(this->threads);
+
+    for (size_t r{ 0 }; r < rounds; r++) {
+        const double horizon = std::pow(static_cast<double>(search.eta), static_cast<double>(r) - static_cast<double>(rounds - 1));
+        const std::vector<Engine::Process_Data> workload = this->get_horizon(horizon);
+
+        for (candidate& current : candidates)
+            pool.submit([this, &current, &workload]() { current.score = this->evaluate(current.parameters, workload); });
+
+        if (pool.wait() > 0) {
+            if (error != nullptr) *error = "the simulation of a candidate failed";
+            return false;
+        }
+
+        best.simulations += candidates.size();
+
+        // Stable, so ties keep the sampling order and the search is deterministic.
+        std::stable_sort(candidates.begin(), candidates.end(), [](const candidate& a, const candidate& b) { return a.score < b.score; });
+        best.rounds.push_back(round{ .horizon = horizon, .candidates = candidates.size(), .best_score = candidates.front().score });
+
+        if (r + 1 < rounds) candidates.resize((candidates.size() + search.eta - 1) / search.eta);
+    }
+
+    best.parameters = candidates.front().parameters;
+    best.score = candidates.front().score;
+    return true;
+}
+
+/// <summary>
+/// Get the candidates of the first round: the whole grid if the parameters are lists of values and the grid is small enough, a random
+/// sample otherwise.
+/// </summary>
+std::vector<OS_Scheduler_Simulator::Parameter_Optimizer::candidate> OS_Scheduler_Simulator::Parameter_Optimizer::sample_candidates(const settings& search) const {
+    std::vector<candidate> candidates;
+
+    size_t grid_size{ 1 };
+    for (const dimension& current : this->dimensions)
+        grid_size = (current.values.empty() || grid_size > search.candidates) ? search.candidates + 1 : grid_size * current.values.size();
+
+    if (grid_size <= search.candidates) {
+        std::vector<size_t> position(this->dimensions.size(), 0);
+
+        for (size_t n{ 0 }; n < grid_size; n++) {
+            candidate current{ .parameters = {}, .score = 0 };
+
+            for (size_t d{ 0 }; d < this->dimensions.size(); d++)
+                current.parameters[this->dimensions.at(d).name] = this->dimensions.at(d).values.at(position.at(d));
+
+            candidates.push_back(current);
+
+            // Next grid position, like an odometer.
+            for (size_t d{ 0 }; d < this->dimensions.size(); d++) {
+                if (++position.at(d) < this->dimensions.at(d).values.size()) break;
+                position.at(d) = 0;
+            }
+        }
+
+        return candidates;
+    }
+
+    std::mt19937 generator(search.seed);
+    std::set<std::map<std::string, double>> seen;
+
+    // Small spaces may have fewer distinct configurations than requested.
+    for (size_t attempt{ 0 }; candidates.size() < search.candidates && attempt < search.candidates * 16; attempt++) {
+        candidate current{ .parameters = {}, .score = 0 };
+
+        for (const dimension& current_dimension : this->dimensions) {
+            double value;
+
+            if (!current_dimension.values.empty())
+                value = current_dimension.values.at(std::uniform_int_distribution<size_t>(0, current_dimension.values.size() - 1)(generator));
+            else if (current_dimension.integer)
+                value = static_cast<double>(std::uniform_int_distribution<long long>(static_cast<long long>(std::ceil(current_dimension.min)), static_cast<long long>(std::floor(current_dimension.max)))(generator));
+            else
+                value = std::uniform_real_distribution<double>(current_dimension.min, current_dimension.max)(generator);
+
+            current.parameters[current_dimension.name] = value;
+        }
+
+        if (seen.insert(current.parameters).second) candidates.push_back(current);
+    }
+
+    return candidates;
+}
+
+/// <summary>
+/// Get the workload cut to a fraction of every burst list. Processes keep an odd number of bursts so they still end with a CPU burst.
+/// </summary>
+std::vector<OS_Scheduler_Simulator::Engine::Process_Data> OS_Scheduler_Simulator::Parameter_Optimizer::get_horizon(double fraction) const {
+    if (fraction >= 1) return this->workload;
+
+    std::vector<Engine::Process_Data> shortened;
+    shortened.reserve(this->workload.size());
+
+    for (const Engine::Process_Data& process : this->workload) {
+        size_t kept = static_cast<size_t>(std::ceil(fraction * process.get_operations_size()));
+        if (kept % 2 == 0) kept++;
+
+        shortened.push_back(process.get_prefix(kept));
+    }
+
+    return shortened;
+}
+
+/// <summary>
+/// Score a configuration on a workload.
+/// </summary>
+/// <returns>Value of the objective (lower is better).</returns>
+double OS_Scheduler_Simulator::Parameter_Optimizer::evaluate(const std::map<std::string, double>& parameters, const std::vector<Engine::Process_Data>& workload) const {
+    Engine::Simulation sim(workload);
+    sim.register_algorithm("Candidate", OS_SS_Algorithms::create_algorithm(this->algorithm, parameters));
+
+    const Engine::Evaluator::results_table totals = sim.execute_algorithm("Candidate");
+
+    switch (this->goal) {
+    case objective::avg_waiting_time:    return totals.avg_waiting_time;
+    case objective::avg_turnaround_time: return totals.avg_turnaround_time;
+    case objective::avg_response_time:   return totals.avg_response_time;
+    default: break;
+    }
+
+    // Percentiles use the nearest rank.
+    std::vector<unsigned> values;
+
+    for (const Engine::Evaluator::Process& process : sim.get_per_process_evaluation())
+        values.push_back((this->goal == objective::p99_response_time) ? process.get_response_time() : process.get_turnaround_time());
+
+    const size_t rank = static_cast<size_t>(std::ceil(0.99 * values.size()));
+    std::nth_element(values.begin(), values.begin() + (rank - 1), values.end());
+
+    return static_cast<double>(values.at(rank - 1));
+}
@@ -0,0 +1,75 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_OPTIMIZER_
+#define _OS_SCHEDULER_SIMULATOR_OPTIMIZER_
+
+#include "engine.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+/// <summary>
+/// Successive-halving search over the parameters of an algorithm (the ones create_algorithm accepts).
+///
+/// All candidates are first evaluated on a short horizon: every process keeps only the first bursts of its list. The best 1/eta of them
+/// move on to a horizon eta times longer, and so on until the survivors run the whole workload. Most of the simulation time is therefore
+/// spent on the promising configurations. The candidates of each round run in parallel on a Work_Stealing_Pool.
+/// </summary>
+class OS_Scheduler_Simulator::Parameter_Optimizer {
+public:
+	typedef enum { avg_waiting_time, avg_turnaround_time, avg_response_time, p99_response_time, p99_turnaround_time } objective;
+
+	typedef struct {
+		size_t candidates;                   // Configurations in the first round. A grid smaller than this is searched entirely.
+		unsigned eta;                        // Reduction factor between rounds.
+		unsigned seed;                       // Seed of the random sampling of candidates.
+	} settings;
+
+	typedef struct {
+		double horizon;                      // Fraction of every burst list simulated.
+		size_t candidates;
+		double best_score;
+	} round;
+
+	typedef struct {
+		std::map<std::string, double> parameters;
+		double score;                        // Value of the objective on the whole workload (lower is better).
+		size_t simulations;
+		std::vector<round> rounds;
+	} result;
+
+	Parameter_Optimizer(const std::string& algorithm, const std::vector<Engine::Process_Data>& workload, objective goal, unsigned threads = 0);
+
+	void add_range(const std::string& parameter, double min, double max, bool integer);
+	void add_values(const std::string& parameter, const std::vector<double>& values);
+
+	bool optimize(result& best, settings search = settings{ .candidates = 27, .eta = 3, .seed = 1 }, std::string* error = nullptr);
+
+	static bool parse_objective(const std::string& name, objective& goal);
+
+private:
+	typedef struct {
+		std::string name;
+		std::vector<double> values;          // Empty for a range.
+		double min;
+		double max;
+		bool integer;
+	} dimension;
+
+	typedef struct {
+		std::map<std::string, double> parameters;
+		double score;
+	} candidate;
+
+	std::vector<candidate> sample_candidates(const settings& search) const;
+	std::vector<Engine::Process_Data> get_horizon(double fraction) const;
+	double evaluate(const std::map<std::string, double>& parameters, const std::vector<Engine::Process_Data>& workload) const;
+
+	std::string algorithm;
+	std::vector<Engine::Process_Data> workload;
+	objective goal;
+	unsigned threads;
+
+	std::vector<dimension> dimensions;
+};
+
+#endif
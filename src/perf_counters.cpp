@@ -0,0 +1,189 @@
+#include "perf_counters.h"
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif // __linux__
+
+std::atomic<bool> OS_Scheduler_Simulator::Engine::Perf_Counters::enabled{ false };
+std::mutex OS_Scheduler_Simulator::Engine::Perf_Counters::totals_mutex;
+std::array<OS_Scheduler_Simulator::Engine::Perf_Counters::phase_totals, OS_Scheduler_Simulator::Engine::Perf_Counters::phase_count> OS_Scheduler_Simulator::Engine::Perf_Counters::totals{};
+
+namespace {
+    /// <summary>
+    /// Counters of the current thread, opened on first use and closed when the thread ends.
+    /// </summary>
+    struct thread_counters {
+        std::array<int, OS_Scheduler_Simulator::Engine::Perf_Counters::counter_count> descriptors;
+
+        thread_counters() {
+            this->descriptors.fill(-1);
+
+#ifdef __linux__
+            const std::array<unsigned long long, OS_Scheduler_Simulator::Engine::Perf_Counters::counter_count> configs = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+            };
+
+            for (size_t i{ 0 }; i < configs.size(); i++) {
+                perf_event_attr attributes{};
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.size = sizeof(attributes);
+                attributes.config = configs.at(i);
+                attributes.exclude_kernel = 1; // Allowed with the default perf_event_paranoid.
+                attributes.exclude_hv = 1;
+
+                // This thread, any CPU, no group. Failures (EACCES, ENOENT, ENOSYS...) leave the counter unavailable.
+                this->descriptors.at(i) = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+            }
+#endif // __linux__
+        }
+
+        ~thread_counters() {
+#ifdef __linux__
+            for (int descriptor : this->descriptors)
+                if (descriptor >= 0) close(descriptor);
+#endif // __linux__
+        }
+    };
+
+    thread_counters& get_thread_counters() {
+        static thread_local thread_counters counters;
+        return counters;
+    }
+}
+
+/// <summary>
+/// Start measuring a phase, if counting is enabled.
+/// </summary>
+/// <param name="measured">- Phase being measured.</param>
+/// <param name="events">- Number of events of the phase, if already known.</param>
+OS_Scheduler_Simulator::Engine::Perf_Counters::Scope::Scope(phase measured, unsigned long long events)
+    : active(Perf_Counters::is_enabled()), measured(measured), events(events), start(), started(), start_time() {
+    if (!this->active) return;
+
+    this->start_time = std::chrono::steady_clock::now();
+    Perf_Counters::read_counters(this->start, this->started);
+}
+
+OS_Scheduler_Simulator::Engine::Perf_Counters::Scope::~Scope() {
+    if (!this->active) return;
+
+    std::array<unsigned long long, counter_count> end{};
+    std::array<bool, counter_count> ended{};
+    Perf_Counters::read_counters(end, ended);
+
+    phase_totals sample{};
+    sample.wall_ns = static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start_time).count());
+    sample.calls = 1;
+    sample.events = this->events;
+
+    for (size_t i{ 0 }; i < counter_count; i++) {
+        sample.available.at(i) = this->started.at(i) && ended.at(i);
+        sample.values.at(i) = (sample.available.at(i)) ? end.at(i) - this->start.at(i) : 0;
+    }
+
+    Perf_Counters::add(this->measured, sample);
+}
+
+/// <summary>
+/// Check whether a counter can be read on the calling thread.
+/// </summary>
+bool OS_Scheduler_Simulator::Engine::Perf_Counters::is_available(counter measured) {
+    return get_thread_counters().descriptors.at(measured) >= 0;
+}
+
+/// <summary>
+/// Get the totals of a phase since the last reset.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Perf_Counters::phase_totals OS_Scheduler_Simulator::Engine::Perf_Counters::get_totals(phase measured) {
+    std::lock_guard<std::mutex> lock(Perf_Counters::totals_mutex);
+    return Perf_Counters::totals.at(measured);
+}
+
+/// <summary>
+/// Clear the totals of every phase.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Perf_Counters::reset() {
+    std::lock_guard<std::mutex> lock(Perf_Counters::totals_mutex);
+    Perf_Counters::totals.fill(phase_totals{});
+}
+
+/// <summary>
+/// Print a table with the totals of every phase and their value per event.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Perf_Counters::print_report(std::ostream& output) {
+    static const std::array<const char*, phase_count> phase_names = { "algorithm", "evaluation", "get_data_at" };
+    static const std::array<const char*, counter_count> counter_names = { "cycles", "instructions", "cache misses", "branch misses" };
+
+    const std::ios_base::fmtflags flags = output.flags();
+    const std::streamsize precision = output.precision();
+    output << std::fixed << std::setprecision(2);
+
+    for (size_t p{ 0 }; p < phase_count; p++) {
+        const phase_totals current = Perf_Counters::get_totals(static_cast<phase>(p));
+        if (current.calls == 0) continue;
+
+        output << phase_names.at(p) << ": " << current.calls << " calls, " << current.events << " events, " << current.wall_ns / 1e6 << " ms";
+        if (current.events > 0) output << " (" << static_cast<double>(current.wall_ns) / current.events << " ns/event)";
+        output << std::endl;
+
+        for (size_t c{ 0 }; c < counter_count; c++) {
+            output << "\t" << std::setw(14) << std::left << counter_names.at(c) << std::right;
+
+            if (!current.available.at(c)) {
+                output << "unavailable" << std::endl;
+                continue;
+            }
+
+            output << std::setw(16) << current.values.at(c);
+            if (current.events > 0) output << "  " << std::setw(12) << static_cast<double>(current.values.at(c)) / current.events << " /event";
+            output << std::endl;
+        }
+    }
+
+    output.flags(flags);
+    output.precision(precision);
+}
+
+bool OS_Scheduler_Simulator::Engine::Perf_Counters::read_counters(std::array<unsigned long long, counter_count>& values, std::array<bool, counter_count>& valid) {
+    const thread_counters& counters = get_thread_counters();
+    bool any{ false };
+
+    for (size_t i{ 0 }; i < counter_count; i++) {
+        valid.at(i) = false;
+        values.at(i) = 0;
+
+#ifdef __linux__
+        if (counters.descriptors.at(i) >= 0)
+            valid.at(i) = read(counters.descriptors.at(i), &values.at(i), sizeof(values.at(i))) == sizeof(values.at(i));
+#endif // __linux__
+
+        any = any || valid.at(i);
+    }
+
+    return any;
+}
+
+void OS_Scheduler_Simulator::Engine::Perf_Counters::add(phase measured, const phase_totals& sample) {
+    std::lock_guard<std::mutex> lock(Perf_Counters::totals_mutex);
+    phase_totals& current = Perf_Counters::totals.at(measured);
+
+    // A counter is available for the phase if it was read in every call.
+    for (size_t i{ 0 }; i < counter_count; i++) {
+        current.available.at(i) = (current.calls == 0) ? sample.available.at(i) : current.available.at(i) && sample.available.at(i);
+        current.values.at(i) += sample.values.at(i);
+    }
+
+    current.wall_ns += sample.wall_ns;
+    current.calls += sample.calls;
+    current.events += sample.events;
+}
@@ -0,0 +1,73 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_PERF_COUNTERS_
+#define _OS_SCHEDULER_SIMULATOR_PERF_COUNTERS_
+
+#include "engine.h"
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+/// <summary>
+/// Optional hardware counters (Linux perf_event_open) around the phases of the engine: the algorithm loop, the evaluation of a timeline and
+/// the lookups of get_data_at. Every phase reports cycles, instructions, cache misses and branch misses, in total and per simulated event.
+///
+/// Counting is off until set_enabled(true), and then costs a few system calls per phase. Counters are opened per thread (user space only),
+/// so parallel runs are counted correctly. When a counter cannot be opened (no PMU access in a container, perf_event_paranoid, other
+/// operating systems), it is reported as unavailable and only the wall time is measured.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Perf_Counters {
+public:
+	typedef enum { cycles, instructions, cache_misses, branch_misses, counter_count } counter;
+	typedef enum { algorithm, evaluation, data_lookup, phase_count } phase;
+
+	typedef struct {
+		std::array<unsigned long long, counter_count> values;
+		std::array<bool, counter_count> available; // True if the counter was read in every call.
+		unsigned long long wall_ns;
+		unsigned long long calls;
+		unsigned long long events;            // Data points produced, evaluated or looked up.
+	} phase_totals;
+
+	/// <summary>
+	/// Measures one phase from construction to destruction.
+	/// </summary>
+	class Scope {
+	public:
+		Scope(phase measured, unsigned long long events = 0);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		/// <summary>Set the number of events of the phase, when it is only known at the end.</summary>
+		void set_events(unsigned long long events) { this->events = events; }
+
+	private:
+		bool active;
+		phase measured;
+		unsigned long long events;
+		std::array<unsigned long long, counter_count> start;
+		std::array<bool, counter_count> started;
+		std::chrono::steady_clock::time_point start_time;
+	};
+
+	static void set_enabled(bool enabled) { Perf_Counters::enabled.store(enabled, std::memory_order_relaxed); }
+	static bool is_enabled() { return Perf_Counters::enabled.load(std::memory_order_relaxed); }
+
+	static bool is_available(counter measured);
+	static phase_totals get_totals(phase measured);
+	static void reset();
+	static void print_report(std::ostream& output);
+
+private:
+	static bool read_counters(std::array<unsigned long long, counter_count>& values, std::array<bool, counter_count>& valid);
+	static void add(phase measured, const phase_totals& sample);
+
+	static std::atomic<bool> enabled;
+	static std::mutex totals_mutex;
+	static std::array<phase_totals, phase_count> totals;
+};
+
+#endif
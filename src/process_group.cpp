@@ -0,0 +1,15 @@
+#include "process_group.h"
+
+#include <string>
+#include <memory>
+
+/// <summary>
+/// Process_Group constructor.
+/// </summary>
+/// <param name="name">- Name of the group, used in the reports.</param>
+/// <param name="parent">- Group containing this one, or nullptr for the root.</param>
+/// <param name="weight">- Share of the CPU against its siblings. At least 1.</param>
+/// <param name="quota">- CPU time per period, or 0 for no limit.</param>
+/// <param name="period">- Length of the quota periods. Ignored without a quota; at least the quota otherwise.</param>
+OS_Scheduler_Simulator::Engine::Process_Group::Process_Group(std::string name, std::shared_ptr<const Process_Group> parent, unsigned weight, unsigned quota, unsigned period)
+    : name(name), parent(parent), weight((weight > 0) ? weight : 1), quota(quota), period((quota == 0) ? 0 : (period > quota) ? period : quota) {}
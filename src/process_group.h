@@ -0,0 +1,39 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_PROCESS_GROUP_
+#define _OS_SCHEDULER_SIMULATOR_PROCESS_GROUP_
+
+#include "engine.h"
+
+#include <string>
+#include <memory>
+
+/// <summary>
+/// A group of processes in the style of a Linux control group, set with Process_Data::set_group. Groups nest: a group without a parent
+/// hangs from the root, as do the processes without a group.
+///
+/// The weight shares the CPU between sibling groups and processes (like cpu.shares; 1024 is a nice 0 process). The quota limits the CPU
+/// time the group and all its descendants get in every period (like cpu.max): once it is used up, the group is throttled until the period
+/// ends. Periods start at time 0. Only the Group algorithm enforces weights and quotas; the Evaluator reports the usage of every group
+/// whatever the algorithm.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Process_Group {
+public:
+	Process_Group(std::string name, std::shared_ptr<const Process_Group> parent = nullptr, unsigned weight = 1024, unsigned quota = 0, unsigned period = 0);
+
+	const std::string& get_name() const { return this->name; }
+	const std::shared_ptr<const Process_Group>& get_parent() const { return this->parent; }
+	unsigned get_weight() const { return this->weight; }
+
+	/// <summary>Get the CPU time the group may use per period, or 0 if it is not limited.</summary>
+	unsigned get_quota() const { return this->quota; }
+	unsigned get_period() const { return this->period; }
+	bool has_quota() const { return this->quota > 0; }
+
+private:
+	std::string name;
+	std::shared_ptr<const Process_Group> parent;
+	unsigned weight;
+	unsigned quota;
+	unsigned period;
+};
+
+#endif
@@ -0,0 +1,307 @@
+#include "scheduling_policy.h"
+#include "io_device.h"
+#include "checkpoint.h"
+
+#include <list>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+std::vector<OS_Scheduler_Simulator::Engine::Data_Point::ready_level> OS_Scheduler_Simulator::Engine::Scheduling_Policy::get_ready_levels() const {
+    std::vector<Data_Point::ready_level> levels(1);
+    levels.front().processes = this->get_ready_list();
+
+    if (levels.front().processes.empty()) levels.clear(); // Data_Points only hold the levels with processes.
+    return levels;
+}
+
+/// <summary>
+/// Policy_Runner constructor.
+/// </summary>
+/// <param name="processes">- List of processes for the simulation.</param>
+/// <param name="policy">- Policy deciding the order of the ready queue.</param>
+OS_Scheduler_Simulator::Engine::Policy_Runner::Policy_Runner(const std::vector<Process_Data>& processes, Scheduling_Policy& policy)
+    : processes(processes), policy(policy), time(0), time_in_slice(0), running(nullptr), io(), ready_count(0), changes(), io_changes(), switches(), dependencies(), arrivals(), next_arrival(0) {}
+
+/// <summary>
+/// Run the policy until all processes are done.
+/// </summary>
+/// <param name="timeline">- Blank timeline to populate.</param>
+void OS_Scheduler_Simulator::Engine::Policy_Runner::run(Timeline& timeline) {
+    if (this->policy.can_checkpoint())
+        timeline.set_state_saver([this](Checkpoint& checkpoint) { this->save_state(checkpoint); });
+
+    Checkpoint* checkpoint = timeline.get_resume_checkpoint();
+
+    if (checkpoint != nullptr && this->policy.can_checkpoint()) {
+        if (!this->resume(timeline, *checkpoint)) {
+            timeline.set_state_saver(nullptr);
+            return;
+        }
+    }
+
+    else this->start(timeline);
+
+    while (!timeline.stop_requested() && this->step(timeline));
+    timeline.set_state_saver(nullptr);
+}
+
+void OS_Scheduler_Simulator::Engine::Policy_Runner::start(Timeline& timeline) {
+    this->time = 0;
+    this->time_in_slice = 0;
+    this->running = Running_Process(nullptr);
+    this->io = IO_Queues();
+    this->ready_count = 0;
+    this->changes = Data_Point::ready_changes{ .enqueued = {}, .dispatched = nullptr };
+    this->io_changes = Data_Point::waiting_changes{ .completed = {}, .started = {} };
+    this->switches.emplace(this->processes, timeline);
+
+    this->policy.setup(this->processes);
+    if (Dependency_Graph::has_dependencies(this->processes)) this->dependencies.emplace(this->processes);
+
+    // Processes are submitted at start unless they arrive later, and the ones with dependencies wait to be released.
+    this->schedule_arrivals();
+
+    for (size_t i{ 0 }; i < this->processes.size(); i++)
+        if (this->processes.at(i).get_arrival() == 0 && (!this->dependencies.has_value() || this->dependencies->is_released(i)))
+            this->enqueue(Running_Process(&this->processes.at(i)), false);
+
+    this->dispatch_if_idle();
+    this->switches->charge(this->running, 0);
+    timeline.push_back(this->make_data_point(timeline));
+}
+
+/// <summary>
+/// Continue from the state saved by save_state instead of starting over.
+/// </summary>
+/// <returns>False if the checkpoint was invalid.</returns>
+bool OS_Scheduler_Simulator::Engine::Policy_Runner::resume(Timeline& timeline, Checkpoint& checkpoint) {
+    this->time = static_cast<unsigned>(checkpoint.get());
+    this->time_in_slice = static_cast<unsigned>(checkpoint.get());
+    this->running = checkpoint.get_process();
+    this->io = IO_Queues();
+
+    // The requests are added back in arrival order, so the same ones are in service.
+    for (const Running_Process& request : checkpoint.get_processes()) this->io.add(request, this->time);
+
+    this->ready_count = static_cast<size_t>(checkpoint.get());
+    this->changes = Data_Point::ready_changes{ .enqueued = {}, .dispatched = nullptr };
+    this->io_changes = Data_Point::waiting_changes{ .completed = {}, .started = {} };
+
+    this->switches.emplace(this->processes, timeline);
+    this->switches->load_state(checkpoint);
+
+    this->policy.setup(this->processes);
+    this->policy.load_state(checkpoint);
+
+    if (Dependency_Graph::has_dependencies(this->processes)) {
+        this->dependencies.emplace(this->processes);
+        this->dependencies->load_state(checkpoint);
+    }
+
+    this->schedule_arrivals();
+
+    if (!checkpoint.is_valid()) return false;
+
+    timeline.resume(this->make_data_point(timeline));
+    return true;
+}
+
+/// <summary>
+/// Save the state of the run after the latest point: the event loop, the context switches and the policy.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Policy_Runner::save_state(Checkpoint& checkpoint) const {
+    checkpoint.put(this->time);
+    checkpoint.put(this->time_in_slice);
+    checkpoint.put_process(this->running);
+    checkpoint.put_processes(this->io.get_waiting_list(this->time));
+    checkpoint.put(this->ready_count);
+
+    this->switches->save_state(checkpoint);
+    this->policy.save_state(checkpoint);
+    if (this->dependencies.has_value()) this->dependencies->save_state(checkpoint);
+}
+
+/// <summary>
+/// Advance the simulation to the next event and commit it to the timeline.
+/// </summary>
+/// <returns>False if all processes were done already.</returns>
+bool OS_Scheduler_Simulator::Engine::Policy_Runner::step(Timeline& timeline) {
+    if (!this->running.is_valid() && this->ready_count == 0 && this->io.empty() && this->next_arrival == this->arrivals.size()) return false;
+
+    Data_Point::event next_event = this->io.get_next_event(this->running, this->time);
+
+    // The next arrival ends the step like the end of an I/O burst.
+    if (this->next_arrival < this->arrivals.size()) {
+        const unsigned arrival = this->processes.at(this->arrivals.at(this->next_arrival)).get_arrival() - this->time;
+
+        if (next_event.event_type == Data_Point::event_type::done || arrival < next_event.time)
+            next_event = Data_Point::event{ .event_type = Data_Point::event_type::io, .time = arrival };
+    }
+    bool slice_expired = false;
+
+    // The policy may cut the CPU burst short. Slices only count time spent on the burst, after the switch overhead.
+    const unsigned switching = (this->running.is_valid()) ? this->running.get_switch_overhead() : 0;
+
+    if (this->running.is_valid()) {
+        const unsigned slice = this->policy.get_time_slice(this->running);
+
+        if (slice > 0 && (this->time_in_slice >= slice || switching + slice - this->time_in_slice <= next_event.time)) {
+            next_event.time = (this->time_in_slice >= slice) ? 0 : switching + slice - this->time_in_slice;
+            slice_expired = true;
+        }
+    }
+
+    // A timer of the policy ends the step earlier; the CPU may be idle with processes ready that are not allowed to run yet.
+    const unsigned timer = this->policy.get_timer(this->running, this->time);
+
+    if (timer > 0 && (next_event.event_type == Data_Point::event_type::done || timer < next_event.time)) {
+        next_event.time = timer;
+        slice_expired = false;
+    }
+
+    // Running processes.
+    if (this->running.is_valid()) {
+        const unsigned on_burst = next_event.time - std::min(next_event.time, switching);
+
+        this->running = this->running.get_next_process_state(next_event.time);
+        this->policy.on_cpu_time(this->running, on_burst);
+        this->time_in_slice += on_burst;
+    }
+
+    this->time += next_event.time;
+    this->policy.on_time(this->time);
+
+    std::vector<Running_Process> completed;
+    this->io.advance(this->time, completed);
+
+    // Removing process from CPU if its burst is completed or its time slice expired.
+    Running_Process finished(nullptr);
+
+    if (this->running.is_valid()) {
+        if (this->running.get_status() == Running_Process::status_type::waiting) {
+            this->io.add(this->running, this->time); // It will be performing some IO operations now.
+            this->io_changes.started.push_back(this->running.get_process_data());
+            this->running = Running_Process(nullptr);
+        }
+
+        else if (this->running.get_status() == Running_Process::status_type::done) {
+            finished = this->running;
+            this->running = Running_Process(nullptr);
+        }
+
+        else if (slice_expired) {
+            this->running.send_to_ready();
+            this->enqueue(this->running, true);
+            this->running = Running_Process(nullptr);
+        }
+    }
+
+    // Processes whose I/O operations completed, in the order they started them.
+    bool process_woke = !completed.empty();
+    for (const Running_Process& process : completed) {
+        this->io_changes.completed.push_back(process.get_process_data());
+        this->enqueue(process, false);
+    }
+
+    if (this->admit_arrivals()) process_woke = true;
+    if (finished.is_valid() && this->release_successors(finished)) process_woke = true;
+
+    if (process_woke && this->running.is_valid() && this->policy.should_preempt(this->running, this->time_in_slice)) {
+        this->running.send_to_ready();
+        this->enqueue(this->running, true);
+        this->running = Running_Process(nullptr);
+    }
+
+    this->dispatch_if_idle();
+    this->switches->charge(this->running, this->time);
+
+    // Commit to timeline.
+    timeline.push_back(this->make_data_point(timeline));
+    return true;
+}
+
+void OS_Scheduler_Simulator::Engine::Policy_Runner::enqueue(const Running_Process& process, bool preempted) {
+    this->policy.enqueue(process, this->time, preempted);
+    this->changes.enqueued.push_back(process.get_process_data());
+    this->ready_count++;
+}
+
+void OS_Scheduler_Simulator::Engine::Policy_Runner::dispatch_if_idle() {
+    if (!this->running.is_valid() && this->policy.has_ready()) {
+        this->running = this->policy.dispatch(this->time);
+        this->running.send_to_cpu();
+        this->time_in_slice = 0;
+
+        this->changes.dispatched = this->running.get_process_data();
+        this->ready_count--;
+    }
+}
+
+/// <summary>
+/// Enqueue the processes released by a process that is done.
+/// </summary>
+/// <returns>True if any process was enqueued.</returns>
+bool OS_Scheduler_Simulator::Engine::Policy_Runner::release_successors(const Running_Process& process) {
+    if (!this->dependencies.has_value()) return false;
+
+    std::vector<size_t> released;
+    this->dependencies->finish(static_cast<size_t>(process.get_process_data() - this->processes.data()), released);
+
+    // The ones that did not arrive yet are enqueued when they do.
+    bool enqueued = false;
+
+    for (size_t index : released)
+        if (this->processes.at(index).get_arrival() <= this->time) {
+            this->enqueue(Running_Process(&this->processes.at(index)), false);
+            enqueued = true;
+        }
+
+    return enqueued;
+}
+
+/// <summary>
+/// List the processes that arrive after the current time, in the order they arrive.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Policy_Runner::schedule_arrivals() {
+    this->arrivals.clear();
+    this->next_arrival = 0;
+
+    for (size_t i{ 0 }; i < this->processes.size(); i++)
+        if (this->processes.at(i).get_arrival() > this->time) this->arrivals.push_back(i);
+
+    std::stable_sort(this->arrivals.begin(), this->arrivals.end(), [this](size_t a, size_t b) { return this->processes.at(a).get_arrival() < this->processes.at(b).get_arrival(); });
+}
+
+/// <summary>
+/// Enqueue the processes arriving by the current time, unless they still wait to be released.
+/// </summary>
+/// <returns>True if any process was enqueued.</returns>
+bool OS_Scheduler_Simulator::Engine::Policy_Runner::admit_arrivals() {
+    bool enqueued = false;
+
+    for (; this->next_arrival < this->arrivals.size() && this->processes.at(this->arrivals.at(this->next_arrival)).get_arrival() <= this->time; this->next_arrival++) {
+        const size_t index = this->arrivals.at(this->next_arrival);
+        if (this->dependencies.has_value() && !this->dependencies->is_released(index)) continue;
+
+        this->enqueue(Running_Process(&this->processes.at(index)), false);
+        enqueued = true;
+    }
+
+    return enqueued;
+}
+
+/// <summary>
+/// Build the point of the current state, with the changes of the ready queue and the waiting list since the previous one.
+/// </summary>
+OS_Scheduler_Simulator::Engine::Data_Point* OS_Scheduler_Simulator::Engine::Policy_Runner::make_data_point(const Timeline& timeline) {
+    Data_Point* data_point = (timeline.needs_queues()) ? new Data_Point(this->time, this->io.get_waiting_list(this->time), this->policy.get_ready_levels(), this->running)
+                                                       : new Data_Point(this->time, this->io.size(), this->ready_count, this->running);
+
+    data_point->set_ready_changes(std::move(this->changes));
+    data_point->set_waiting_changes(std::move(this->io_changes));
+    this->changes = Data_Point::ready_changes{ .enqueued = {}, .dispatched = nullptr };
+    this->io_changes = Data_Point::waiting_changes{ .completed = {}, .started = {} };
+
+    return data_point;
+}
@@ -0,0 +1,122 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_SCHEDULING_POLICY_
+#define _OS_SCHEDULER_SIMULATOR_SCHEDULING_POLICY_
+
+#include "engine.h"
+#include "context_switches.h"
+#include "io_device.h"
+#include "dependency_graph.h"
+
+#include <list>
+#include <vector>
+#include <optional>
+
+/// <summary>
+/// A Scheduling_Policy only decides which ready process runs next and for how long. Everything else (advancing the running process and the
+/// I/O operations, building the Data_Points) is done by the Policy_Runner, so new algorithms only need to implement their ready queue.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Scheduling_Policy {
+public:
+	virtual ~Scheduling_Policy() = default;
+
+	/// <summary>Called once before the simulation starts.</summary>
+	/// <param name="processes">- All processes of the simulation. Running_Process::get_process_data() points into this vector.</param>
+	virtual void setup(const std::vector<Process_Data>& /*processes*/) {}
+
+	/// <summary>Add a process to the ready queue.</summary>
+	/// <param name="process">- Process with status ready.</param>
+	/// <param name="time">- Current time.</param>
+	/// <param name="preempted">- True if the process was removed from the CPU before completing its burst; false if it is new or returns from I/O.</param>
+	virtual void enqueue(const Running_Process& process, unsigned time, bool preempted) = 0;
+
+	/// <summary>Remove the next process to run from the ready queue. Only called if has_ready() is true.</summary>
+	virtual Running_Process dispatch(unsigned time) = 0;
+
+	virtual bool has_ready() const = 0;
+
+	/// <summary>Get the ready queue in the order the policy would run it, used to build the Data_Points.</summary>
+	virtual std::list<Running_Process> get_ready_list() const = 0;
+
+	/// <summary>Get the ready queue split in the levels of the policy, for the Data_Points. Policies with a single queue keep the default,
+	/// which puts get_ready_list() in level 0.</summary>
+	virtual std::vector<Data_Point::ready_level> get_ready_levels() const;
+
+	/// <summary>Check if get_ready_list() always holds the processes as they were enqueued, in that order, without the ones dispatched. Policies
+	/// that do and dispatch the same processes have the same ready lists, so the Shared_Prefix_Runner does not compare them.</summary>
+	virtual bool keeps_arrival_order() const { return false; }
+
+	/// <summary>Maximum time the running process may keep the CPU before being preempted.</summary>
+	/// <returns>The time slice, or 0 if the process runs until the end of its burst.</returns>
+	virtual unsigned get_time_slice(const Running_Process& /*running*/) const { return 0; }
+
+	/// <summary>Charge CPU time to the running process. Called after every event, before the process leaves the CPU.</summary>
+	virtual void on_cpu_time(const Running_Process& /*running*/, unsigned /*time*/) {}
+
+	/// <summary>Called every time the clock advances, after on_cpu_time and before any process is enqueued or dispatched.</summary>
+	virtual void on_time(unsigned /*time*/) {}
+
+	/// <summary>Get the time until the policy needs to decide again even if no process event happens, e.g. when throttled processes may run again.</summary>
+	/// <param name="running">- Process on the CPU, or an invalid process if the CPU is idle.</param>
+	/// <param name="time">- Current time.</param>
+	/// <returns>The time from now, or 0 if there is no timer.</returns>
+	virtual unsigned get_timer(const Running_Process& /*running*/, unsigned /*time*/) const { return 0; }
+
+	/// <summary>Decide if a process returning from I/O should take the CPU from the running one.</summary>
+	/// <param name="time_in_slice">- Time the running process has been on the CPU since it was dispatched.</param>
+	virtual bool should_preempt(const Running_Process& /*running*/, unsigned /*time_in_slice*/) const { return false; }
+
+	/// <summary>Check if the policy can save its state in a checkpoint. Runs of policies that cannot are not checkpointed.</summary>
+	virtual bool can_checkpoint() const { return false; }
+
+	/// <summary>Save the ready queue and everything else the policy needs to continue.</summary>
+	virtual void save_state(Checkpoint& /*checkpoint*/) const {}
+
+	/// <summary>Restore the state saved by save_state. Called after setup(), instead of enqueuing the processes.</summary>
+	virtual void load_state(Checkpoint& /*checkpoint*/) {}
+};
+
+/// <summary>
+/// Generic event loop that runs a Scheduling_Policy over a set of processes and populates a timeline. Processes arriving after the start
+/// (see Process_Data::set_arrival) and processes with dependencies (see Dependency_Graph) are enqueued when they arrive and are released, as
+/// if they were new, after the processes returning from I/O.
+///
+/// Outstanding I/O is kept in an IO_Queues, so a step only touches the requests that complete, and only those are enqueued.
+///
+/// Every Data_Point records the changes of the ready queue and the waiting list. The whole queues are only copied into the points when the
+/// timeline needs them (Timeline::needs_queues), since that takes time proportional to the processes ready or waiting at every event;
+/// otherwise a step only costs what the policy takes to decide and the I/O requests that complete.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Policy_Runner {
+public:
+	Policy_Runner(const std::vector<Process_Data>& processes, Scheduling_Policy& policy);
+
+	void run(Timeline& timeline);
+
+private:
+	void start(Timeline& timeline);
+	bool resume(Timeline& timeline, Checkpoint& checkpoint);
+	void save_state(Checkpoint& checkpoint) const;
+	bool step(Timeline& timeline);
+	void enqueue(const Running_Process& process, bool preempted);
+	void dispatch_if_idle();
+	bool release_successors(const Running_Process& process);
+	void schedule_arrivals();
+	bool admit_arrivals();
+	Data_Point* make_data_point(const Timeline& timeline);
+
+	const std::vector<Process_Data>& processes;
+	Scheduling_Policy& policy;
+
+	unsigned time;
+	unsigned time_in_slice;
+	Running_Process running;
+	IO_Queues io;
+	size_t ready_count;
+	Data_Point::ready_changes changes; // Since the last point.
+	Data_Point::waiting_changes io_changes; // Since the last point.
+	std::optional<Context_Switches> switches; // Built for every run, from the costs of its timeline.
+	std::optional<Dependency_Graph> dependencies; // Only for workloads with dependencies.
+	std::vector<size_t> arrivals;   // Processes arriving after the current time, by arrival.
+	size_t next_arrival;            // First of them still to arrive.
+};
+
+#endif
@@ -0,0 +1,287 @@
+#include "shared_prefix_runner.h"
+#include "io_device.h"
+
+#include <list>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+namespace {
+    bool same_process(const OS_Scheduler_Simulator::Engine::Running_Process& a, const OS_Scheduler_Simulator::Engine::Running_Process& b) {
+        return a.get_process_data() == b.get_process_data() && a.get_status() == b.get_status() && a.get_operation_index() == b.get_operation_index()
+            && a.time_in_operation() == b.time_in_operation() && a.get_level() == b.get_level() && a.get_switch_overhead() == b.get_switch_overhead();
+    }
+
+    bool same_list(const std::list<OS_Scheduler_Simulator::Engine::Running_Process>& a, const std::list<OS_Scheduler_Simulator::Engine::Running_Process>& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), same_process);
+    }
+
+    bool same_levels(const std::vector<OS_Scheduler_Simulator::Engine::Data_Point::ready_level>& a, const std::vector<OS_Scheduler_Simulator::Engine::Data_Point::ready_level>& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const auto& x, const auto& y) { return x.level == y.level && same_list(x.processes, y.processes); });
+    }
+}
+
+/// <summary>
+/// Shared_Prefix_Runner constructor.
+/// </summary>
+/// <param name="processes">- List of processes for the simulation.</param>
+/// <param name="policies">- Policies to run, each with its own state. They are set up by run().</param>
+OS_Scheduler_Simulator::Engine::Shared_Prefix_Runner::Shared_Prefix_Runner(const std::vector<Process_Data>& processes, std::vector<Scheduling_Policy*> policies)
+    : processes(processes), policies(policies), timelines(), forks(0) {}
+
+/// <summary>
+/// Run every policy until all processes are done.
+/// </summary>
+/// <param name="timelines">- Blank timeline of every policy, in the same order. All must have the same switch costs; the first one's memory
+/// budget also applies to the shared prefixes.</param>
+void OS_Scheduler_Simulator::Engine::Shared_Prefix_Runner::run(std::vector<Timeline*> timelines) {
+    this->timelines = timelines;
+    this->forks = 0;
+
+    if (this->policies.empty() || this->timelines.size() != this->policies.size()) return;
+
+    group root{
+        .members = std::vector<size_t>(),
+        .shared = nullptr,
+        .timeline = this->timelines.front(),
+        .time = 0,
+        .time_in_slice = 0,
+        .running = Running_Process(nullptr),
+        .io = IO_Queues(),
+        .switches = std::nullopt,
+        .next_event = Data_Point::event{ .event_type = Data_Point::event_type::unresolved, .time = 0 },
+        .slice_expired = false,
+        .process_woke = false,
+        .dispatched = std::vector<Running_Process>()
+    };
+
+    for (size_t i{ 0 }; i < this->policies.size(); i++) root.members.push_back(i);
+
+    if (root.members.size() > 1) {
+        root.shared = this->make_shared_timeline(nullptr);
+        root.timeline = root.shared.get();
+    }
+
+    root.switches.emplace(this->processes, *root.timeline);
+
+    // All processes are submitted at start.
+    for (Scheduling_Policy* policy : this->policies) {
+        policy->setup(this->processes);
+
+        for (const Process_Data& process : this->processes)
+            policy->enqueue(Running_Process(&process), 0, false);
+    }
+
+    this->run_group(root, phase_type::dispatch);
+}
+
+/// <summary>
+/// Continue the event loop of a group from a phase of the current step, until all processes are done or the group forks.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Shared_Prefix_Runner::run_group(group& current, phase_type phase) {
+    for (; ; phase = phase_type::slice) {
+        if (phase == phase_type::slice) {
+            if (current.timeline->back()->is_done() || current.timeline->stop_requested()) break;
+
+            current.next_event = current.io.get_next_event(current.running, current.time);
+            current.slice_expired = false;
+            current.process_woke = false;
+            current.dispatched.clear();
+        }
+
+        // The policies may cut the CPU burst short. Slices only count time spent on the burst, after the switch overhead.
+        const unsigned switching = (current.running.is_valid()) ? current.running.get_switch_overhead() : 0;
+
+        if (phase == phase_type::slice && current.running.is_valid()) {
+            std::vector<unsigned> slices;
+            for (size_t member : current.members) slices.push_back(this->policies.at(member)->get_time_slice(current.running));
+
+            if (!this->agree(current, phase, [&slices](size_t a, size_t b) { return slices.at(a) == slices.at(b); })) return;
+
+            const unsigned slice = slices.front();
+
+            if (slice > 0 && (current.time_in_slice >= slice || switching + slice - current.time_in_slice <= current.next_event.time)) {
+                current.next_event.time = (current.time_in_slice >= slice) ? 0 : switching + slice - current.time_in_slice;
+                current.slice_expired = true;
+            }
+        }
+
+        if (phase == phase_type::slice) {
+            std::vector<unsigned> timers;
+            for (size_t member : current.members) timers.push_back(this->policies.at(member)->get_timer(current.running, current.time));
+
+            if (!this->agree(current, phase, [&timers](size_t a, size_t b) { return timers.at(a) == timers.at(b); })) return;
+
+            const unsigned timer = timers.front();
+
+            if (timer > 0 && (current.next_event.event_type == Data_Point::event_type::done || timer < current.next_event.time)) {
+                current.next_event.time = timer;
+                current.slice_expired = false;
+            }
+        }
+
+        if (phase <= phase_type::advance) {
+            // Running processes.
+            if (current.running.is_valid()) {
+                const unsigned on_burst = current.next_event.time - std::min(current.next_event.time, switching);
+
+                current.running = current.running.get_next_process_state(current.next_event.time);
+                for (size_t member : current.members) this->policies.at(member)->on_cpu_time(current.running, on_burst);
+                current.time_in_slice += on_burst;
+            }
+
+            current.time += current.next_event.time;
+            for (size_t member : current.members) this->policies.at(member)->on_time(current.time);
+
+            std::vector<Running_Process> completed;
+            current.io.advance(current.time, completed);
+
+            // Removing process from CPU if its burst is completed or its time slice expired.
+            if (current.running.is_valid()) {
+                if (current.running.get_status() == Running_Process::status_type::waiting) {
+                    current.io.add(current.running, current.time);
+                    current.running = Running_Process(nullptr);
+                }
+
+                else if (current.running.get_status() == Running_Process::status_type::done) {
+                    current.running = Running_Process(nullptr);
+                }
+
+                else if (current.slice_expired) {
+                    current.running.send_to_ready();
+                    for (size_t member : current.members) this->policies.at(member)->enqueue(current.running, current.time, true);
+                    current.running = Running_Process(nullptr);
+                }
+            }
+
+            // Processes whose I/O operations completed, in the order they started them.
+            for (const Running_Process& process : completed)
+                for (size_t member : current.members) this->policies.at(member)->enqueue(process, current.time, false);
+
+            current.process_woke = !completed.empty();
+        }
+
+        if (phase <= phase_type::preempt && current.process_woke && current.running.is_valid()) {
+            std::vector<bool> preempt;
+            for (size_t member : current.members) preempt.push_back(this->policies.at(member)->should_preempt(current.running, current.time_in_slice));
+
+            if (!this->agree(current, phase_type::preempt, [&preempt](size_t a, size_t b) { return preempt.at(a) == preempt.at(b); })) return;
+
+            if (preempt.front()) {
+                current.running.send_to_ready();
+                for (size_t member : current.members) this->policies.at(member)->enqueue(current.running, current.time, true);
+                current.running = Running_Process(nullptr);
+            }
+        }
+
+        if (phase <= phase_type::dispatch && !current.running.is_valid()) {
+            // Dispatching removes the process from the ready queue, so it is done once and kept if the group forks.
+            if (current.dispatched.empty())
+                for (size_t member : current.members) {
+                    Scheduling_Policy* policy = this->policies.at(member);
+                    current.dispatched.push_back((policy->has_ready()) ? policy->dispatch(current.time) : Running_Process(nullptr));
+                }
+
+            if (!this->agree(current, phase_type::dispatch, [&current](size_t a, size_t b) { return same_process(current.dispatched.at(a), current.dispatched.at(b)); })) return;
+
+            if (current.dispatched.front().is_valid()) {
+                current.running = current.dispatched.front();
+                current.running.send_to_cpu();
+                current.time_in_slice = 0;
+            }
+        }
+
+        // Commit to timeline. The ready queues must be in the same order too, or the points would differ; they are only compared if a member
+        // may order them otherwise than by arrival.
+        std::vector<std::vector<Data_Point::ready_level>> ready_levels;
+        ready_levels.push_back(this->policies.at(current.members.front())->get_ready_levels());
+
+        const bool arrival_order = std::all_of(current.members.begin(), current.members.end(), [this](size_t member) { return this->policies.at(member)->keeps_arrival_order(); });
+
+        if (!arrival_order) {
+            for (size_t position{ 1 }; position < current.members.size(); position++) ready_levels.push_back(this->policies.at(current.members.at(position))->get_ready_levels());
+            if (!this->agree(current, phase_type::commit, [&ready_levels](size_t a, size_t b) { return same_levels(ready_levels.at(a), ready_levels.at(b)); })) return;
+        }
+
+        current.switches->charge(current.running, current.time);
+        current.timeline->push_back(new Data_Point(current.time, current.io.get_waiting_list(current.time), std::move(ready_levels.front()), current.running));
+    }
+
+    // The members never disagreed after the last fork: the whole timeline of the group is theirs.
+    if (current.shared != nullptr)
+        for (size_t member : current.members) this->timelines.at(member)->set_prefix(current.shared);
+}
+
+/// <summary>
+/// Check that every member of a group takes the same decision. If not, fork the group: one subgroup per decision, each continuing from the
+/// same phase with a copy of the loop state and the timeline so far as its prefix.
+/// </summary>
+/// <param name="same">- Compares the decisions of two members, given their positions in the group.</param>
+/// <returns>True if all members agree; false if the group forked and ran its subgroups to the end.</returns>
+bool OS_Scheduler_Simulator::Engine::Shared_Prefix_Runner::agree(group& current, phase_type phase, std::function<bool(size_t, size_t)> same) {
+    if (current.members.size() <= 1) return true;
+
+    // Positions of the members, by decision, in the order the decisions are first met.
+    std::vector<std::vector<size_t>> decisions;
+
+    for (size_t position{ 0 }; position < current.members.size(); position++) {
+        auto it = std::find_if(decisions.begin(), decisions.end(), [&same, position](const std::vector<size_t>& decision) { return same(decision.front(), position); });
+
+        if (it != decisions.end()) it->push_back(position);
+        else decisions.push_back({ position });
+    }
+
+    if (decisions.size() <= 1) return true;
+
+    this->forks++;
+
+    // Nothing was committed yet if the members disagree on the first dispatch.
+    std::shared_ptr<const Timeline> prefix = (current.shared != nullptr && !current.shared->empty()) ? current.shared : nullptr;
+
+    for (const std::vector<size_t>& positions : decisions) {
+        group next{
+            .members = std::vector<size_t>(),
+            .shared = nullptr,
+            .timeline = nullptr,
+            .time = current.time,
+            .time_in_slice = current.time_in_slice,
+            .running = current.running,
+            .io = current.io,
+            .switches = current.switches,
+            .next_event = current.next_event,
+            .slice_expired = current.slice_expired,
+            .process_woke = current.process_woke,
+            .dispatched = std::vector<Running_Process>()
+        };
+
+        for (size_t position : positions) {
+            next.members.push_back(current.members.at(position));
+            if (!current.dispatched.empty()) next.dispatched.push_back(current.dispatched.at(position));
+        }
+
+        if (next.members.size() > 1) {
+            next.shared = this->make_shared_timeline(prefix);
+            next.timeline = next.shared.get();
+        }
+
+        else {
+            next.timeline = this->timelines.at(next.members.front());
+            if (prefix != nullptr) next.timeline->set_prefix(prefix);
+        }
+
+        this->run_group(next, phase);
+    }
+
+    return false;
+}
+
+std::shared_ptr<OS_Scheduler_Simulator::Engine::Timeline> OS_Scheduler_Simulator::Engine::Shared_Prefix_Runner::make_shared_timeline(std::shared_ptr<const Timeline> prefix) const {
+    std::shared_ptr<Timeline> timeline = std::make_shared<Timeline>();
+    timeline->set_switch_costs(this->timelines.front()->get_switch_costs());
+    timeline->set_memory_budget(this->timelines.front()->get_memory_budget(), this->processes.data());
+
+    if (prefix != nullptr) timeline->set_prefix(prefix);
+    return timeline;
+}
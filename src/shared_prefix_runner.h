@@ -0,0 +1,65 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_SHARED_PREFIX_RUNNER_
+#define _OS_SCHEDULER_SIMULATOR_SHARED_PREFIX_RUNNER_
+
+#include "engine.h"
+#include "scheduling_policy.h"
+#include "context_switches.h"
+#include "io_device.h"
+
+#include <list>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <functional>
+
+/// <summary>
+/// Runs several Scheduling_Policies over the same processes at once, doing the work only once while their schedules are the same (see
+/// Simulation::compare_algorithms).
+///
+/// The policies are driven by a single event loop, the same as the Policy_Runner's, and all of them see the same events. At every decision
+/// (time slice, timer, preemption, process dispatched, order of the ready queue) their answers are compared, and while they agree a single
+/// Data_Point is committed for all of them. At the first decision they disagree on, the group forks: its timeline is frozen and becomes
+/// the shared prefix (Timeline::set_prefix) of one subgroup per answer, and every subgroup continues from a copy of the loop state with its
+/// own policies. Subgroups fork again when their policies disagree, so every policy ends up with the timeline it would get on its own.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Shared_Prefix_Runner {
+public:
+	Shared_Prefix_Runner(const std::vector<Process_Data>& processes, std::vector<Scheduling_Policy*> policies);
+
+	void run(std::vector<Timeline*> timelines);
+
+	/// <summary>Get the number of times a group of policies forked in the last run.</summary>
+	size_t get_forks() const { return this->forks; }
+
+private:
+	typedef enum { slice, advance, preempt, dispatch, commit } phase_type;
+
+	typedef struct {
+		std::vector<size_t> members;             // Policies of the group.
+		std::shared_ptr<Timeline> shared;        // Timeline of the group while it has several members.
+		Timeline* timeline;                      // Where the group commits: the shared timeline, or the one of its only member.
+
+		unsigned time;
+		unsigned time_in_slice;
+		Running_Process running;
+		IO_Queues io;
+		std::optional<Context_Switches> switches;
+
+		// Step in progress.
+		Data_Point::event next_event;
+		bool slice_expired;
+		bool process_woke;
+		std::vector<Running_Process> dispatched; // What every member dispatched in this step, once it did.
+	} group;
+
+	void run_group(group& current, phase_type phase);
+	bool agree(group& current, phase_type phase, std::function<bool(size_t, size_t)> same);
+	std::shared_ptr<Timeline> make_shared_timeline(std::shared_ptr<const Timeline> prefix) const;
+
+	const std::vector<Process_Data>& processes;
+	std::vector<Scheduling_Policy*> policies;
+	std::vector<Timeline*> timelines;
+	size_t forks;
+};
+
+#endif
@@ -0,0 +1,911 @@
+#include "simulation_daemon.h"
+#include "thread_pool.h"
+#include "workload_file.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <exception>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+namespace {
+    // Larger frames are taken as garbage and close the connection.
+    constexpr unsigned long long max_frame = 64ull << 20;
+
+    // Clients with more responses than this waiting to be written are not reading them, and are dropped.
+    constexpr size_t max_output_backlog = 64ull << 20;
+
+    void put_varint(std::vector<unsigned char>& buffer, unsigned long long value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+
+        buffer.push_back(static_cast<unsigned char>(value));
+    }
+
+    void put_signed(std::vector<unsigned char>& buffer, long long value) {
+        put_varint(buffer, (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));
+    }
+
+    void put_double(std::vector<unsigned char>& buffer, double value) {
+        const unsigned long long bits = std::bit_cast<unsigned long long>(value);
+        for (unsigned shift{ 0 }; shift < 64; shift += 8) buffer.push_back(static_cast<unsigned char>(bits >> shift));
+    }
+
+    void put_string(std::vector<unsigned char>& buffer, const std::string& value) {
+        put_varint(buffer, value.size());
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    // Prefix a payload with its size.
+    void put_frame(std::vector<unsigned char>& buffer, const std::vector<unsigned char>& payload) {
+        put_varint(buffer, payload.size());
+        buffer.insert(buffer.end(), payload.begin(), payload.end());
+    }
+
+    // Bounds-checked reading of a payload. Reading past the end sets failed and returns zeros.
+    class reader {
+    public:
+        reader(const unsigned char* data, size_t size) : position(data), end(data + size), failed(false) {}
+
+        unsigned long long get_varint() {
+            unsigned long long value{ 0 };
+
+            for (unsigned shift{ 0 }; shift < 64; shift += 7) {
+                if (this->position == this->end) break;
+
+                const unsigned char byte = *this->position++;
+                value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) return value;
+            }
+
+            this->failed = true;
+            return 0;
+        }
+
+        long long get_signed() {
+            const unsigned long long value = this->get_varint();
+            return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+        }
+
+        unsigned char get_byte() {
+            if (this->position == this->end) {
+                this->failed = true;
+                return 0;
+            }
+
+            return *this->position++;
+        }
+
+        double get_double() {
+            unsigned long long bits{ 0 };
+            for (unsigned shift{ 0 }; shift < 64; shift += 8) bits |= static_cast<unsigned long long>(this->get_byte()) << shift;
+            return std::bit_cast<double>(bits);
+        }
+
+        std::string get_string() {
+            const unsigned long long size = this->get_varint();
+
+            if (size > static_cast<unsigned long long>(this->end - this->position)) {
+                this->failed = true;
+                return std::string();
+            }
+
+            std::string value(reinterpret_cast<const char*>(this->position), static_cast<size_t>(size));
+            this->position += size;
+            return value;
+        }
+
+        bool is_valid() const { return !this->failed; }
+
+    private:
+        const unsigned char* position;
+        const unsigned char* end;
+        bool failed;
+    };
+
+    // Find the frame starting at an offset of a buffer. Returns 1 if it is complete, 0 if more bytes are needed and -1 if it is malformed.
+    int next_frame(const std::vector<unsigned char>& buffer, size_t offset, size_t& start, size_t& size) {
+        unsigned long long length{ 0 };
+        size_t position{ offset };
+
+        for (unsigned shift{ 0 }; ; shift += 7) {
+            if (shift >= 64) return -1;
+            if (position == buffer.size()) return 0;
+
+            const unsigned char byte = buffer.at(position++);
+            length |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) break;
+        }
+
+        if (length > max_frame) return -1;
+        if (buffer.size() - position < length) return 0;
+
+        start = position;
+        size = static_cast<size_t>(length);
+        return 1;
+    }
+
+    // Take every complete frame from the front of a buffer. Returns false if a frame is malformed.
+    bool take_frames(std::vector<unsigned char>& buffer, std::vector<std::vector<unsigned char>>& frames) {
+        size_t offset{ 0 };
+        size_t start{ 0 };
+        size_t size{ 0 };
+        int found{ 0 };
+
+        while ((found = next_frame(buffer, offset, start, size)) > 0) {
+            frames.emplace_back(buffer.begin() + start, buffer.begin() + start + size);
+            offset = start + size;
+        }
+
+        buffer.erase(buffer.begin(), buffer.begin() + offset);
+        return found == 0;
+    }
+
+    void put_result(std::vector<unsigned char>& buffer, const OS_Scheduler_Simulator::Batch_Runner::scenario_result& result) {
+        put_varint(buffer, result.execution_time);
+
+        for (double value : { result.totals.cpu_utilization, result.totals.avg_waiting_time, result.totals.avg_turnaround_time, result.totals.avg_response_time,
+            result.totals.avg_io_queueing_delay, result.totals.effective_cpu_utilization, result.totals.switch_overhead })
+            put_double(buffer, value);
+
+        put_varint(buffer, result.deadlines.jobs);
+        put_varint(buffer, result.deadlines.misses);
+        put_signed(buffer, result.deadlines.worst_lateness);
+        put_varint(buffer, result.deadlines.total_tardiness);
+        put_varint(buffer, result.deadlines.max_tardiness);
+        put_varint(buffer, result.deadlines.tardiness_histogram.size());
+        for (unsigned long long count : result.deadlines.tardiness_histogram) put_varint(buffer, count);
+    }
+
+    void get_result(reader& input, OS_Scheduler_Simulator::Batch_Runner::scenario_result& result) {
+        result.execution_time = input.get_varint();
+
+        for (double* value : { &result.totals.cpu_utilization, &result.totals.avg_waiting_time, &result.totals.avg_turnaround_time, &result.totals.avg_response_time,
+            &result.totals.avg_io_queueing_delay, &result.totals.effective_cpu_utilization, &result.totals.switch_overhead })
+            *value = input.get_double();
+
+        result.deadlines.jobs = input.get_varint();
+        result.deadlines.misses = input.get_varint();
+        result.deadlines.worst_lateness = input.get_signed();
+        result.deadlines.total_tardiness = input.get_varint();
+        result.deadlines.max_tardiness = static_cast<unsigned>(input.get_varint());
+
+        result.deadlines.tardiness_histogram.clear();
+        for (unsigned long long buckets = input.get_varint(); buckets > 0 && input.is_valid(); buckets--)
+            result.deadlines.tardiness_histogram.push_back(input.get_varint());
+    }
+
+    void close_socket(int descriptor) {
+#if !defined(_WIN32)
+        if (descriptor >= 0) ::close(descriptor);
+#endif
+    }
+
+    // Write a whole buffer, retrying partial writes. Fails if the peer went away.
+    bool send_all(int descriptor, const unsigned char* data, size_t size) {
+#if defined(_WIN32)
+        return false;
+#else
+#ifdef MSG_NOSIGNAL
+        constexpr int flags = MSG_NOSIGNAL;
+#else
+        constexpr int flags = 0;
+#endif
+
+        while (size > 0) {
+            const ssize_t written = ::send(descriptor, data, size, flags);
+
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+
+        return true;
+#endif
+    }
+
+    // Write what the socket takes without blocking. Returns the number of bytes written, or a negative value if the peer went away.
+    long long send_some(int descriptor, const unsigned char* data, size_t size) {
+#if defined(_WIN32)
+        return -1;
+#else
+#ifdef MSG_NOSIGNAL
+        constexpr int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+#else
+        constexpr int flags = MSG_DONTWAIT;
+#endif
+
+        size_t total{ 0 };
+
+        while (total < size) {
+            const ssize_t written = ::send(descriptor, data + total, size - total, flags);
+
+            if (written < 0 && errno == EINTR) continue;
+            if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (written <= 0) return -1;
+
+            total += static_cast<size_t>(written);
+        }
+
+        return static_cast<long long>(total);
+#endif
+    }
+
+    // Read what is available, up to the size of the buffer. Returns 0 at the end of the stream and a negative value on errors.
+    long long receive_some(int descriptor, unsigned char* data, size_t size) {
+#if defined(_WIN32)
+        return -1;
+#else
+        for (; ; ) {
+            const ssize_t received = ::recv(descriptor, data, size, 0);
+            if (received < 0 && errno == EINTR) continue;
+            return received;
+        }
+#endif
+    }
+}
+
+/// <summary>
+/// A client connected to the daemon. The I/O thread owns its input. Its socket is non-blocking: workers queue responses in the output
+/// under the write mutex and write what the socket takes, and the I/O thread writes the rest once the socket is writable again. The socket
+/// closes once the I/O thread dropped the connection and the last task holding it finished.
+/// </summary>
+struct OS_Scheduler_Simulator::Simulation_Daemon::connection {
+    int socket;
+    std::mutex write_mutex;
+    std::vector<unsigned char> input;
+    std::vector<unsigned char> output;               // Responses not written yet.
+    bool failed;                                     // The peer went away or stopped reading; the I/O thread drops the connection.
+
+    connection(int socket) : socket(socket), write_mutex(), input(), output(), failed(false) {}
+    ~connection() { close_socket(this->socket); }
+
+    /// <summary>Write as much of the output as the socket takes. The write mutex must be held.</summary>
+    void flush() {
+        const long long written = (this->failed) ? 0 : send_some(this->socket, this->output.data(), this->output.size());
+
+        if (written < 0 || this->output.size() - static_cast<size_t>(written) > max_output_backlog) this->failed = true;
+
+        if (this->failed) this->output.clear();
+        else this->output.erase(this->output.begin(), this->output.begin() + static_cast<std::ptrdiff_t>(written));
+    }
+};
+
+/// <summary>
+/// Simulation_Daemon constructor. Nothing runs before start().
+/// </summary>
+/// <param name="threads">- Number of workers running the simulations; 0 uses the number of hardware threads.</param>
+OS_Scheduler_Simulator::Simulation_Daemon::Simulation_Daemon(unsigned threads)
+    : threads(threads), pool(nullptr), io_thread(), socket_path(), listener(-1), wake_pipe{ -1, -1 }, stopping(false), cache_mutex(), cache_keys(),
+    workloads(), requests(0), batches(0) {}
+
+OS_Scheduler_Simulator::Simulation_Daemon::~Simulation_Daemon() {
+    this->stop();
+}
+
+/// <summary>
+/// Listen on a Unix domain socket and start serving requests in the background. A stale socket file left by a daemon that is not running
+/// anymore is replaced; a live one is not.
+/// </summary>
+/// <param name="socket_path">- Path of the socket file.</param>
+/// <param name="error">- Optional description of the problem if the daemon could not start.</param>
+/// <returns>True if the daemon is running.</returns>
+bool OS_Scheduler_Simulator::Simulation_Daemon::start(const std::string& socket_path, std::string* error) {
+    std::string problem;
+
+#if defined(_WIN32)
+    problem = "the simulation daemon needs Unix domain sockets, which are not supported on this platform";
+#else
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    struct stat existing {};
+
+    if (this->io_thread.joinable()) problem = "the daemon is already running";
+
+    else if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) problem = "invalid socket path \"" + socket_path + "\"";
+
+    else if (::stat(socket_path.c_str(), &existing) == 0) {
+        std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+        if (!S_ISSOCK(existing.st_mode)) problem = "\"" + socket_path + "\" exists and is not a socket";
+
+        // Nobody answers on a stale socket.
+        else {
+            const int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            const bool live = probe >= 0 && ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+            close_socket(probe);
+
+            if (live) problem = "another daemon is listening on \"" + socket_path + "\"";
+            else ::unlink(socket_path.c_str());
+        }
+    }
+
+    if (problem.empty()) {
+        std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+        this->listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (this->listener < 0 || ::bind(this->listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(this->listener, SOMAXCONN) != 0)
+            problem = "cannot listen on \"" + socket_path + "\": " + std::strerror(errno);
+
+        // Non-blocking, so workers never wait on a full pipe: the I/O thread is going to wake up anyway.
+        else if (::pipe(this->wake_pipe) != 0 || ::fcntl(this->wake_pipe[0], F_SETFL, O_NONBLOCK) != 0 || ::fcntl(this->wake_pipe[1], F_SETFL, O_NONBLOCK) != 0)
+            problem = std::string("cannot create the wake-up pipe: ") + std::strerror(errno);
+    }
+
+    if (!problem.empty()) {
+        if (this->listener >= 0 && this->socket_path.empty()) ::unlink(socket_path.c_str());
+
+        close_socket(this->listener);
+        this->listener = -1;
+    }
+
+    else {
+        this->socket_path = socket_path;
+        this->stopping = false;
+        this->pool = std::make_unique<Work_Stealing_Pool>(this->threads);
+        this->io_thread = std::thread(&Simulation_Daemon::io_loop, this);
+    }
+#endif
+
+    if (!problem.empty() && error != nullptr) *error = problem;
+    return problem.empty();
+}
+
+/// <summary>
+/// Stop accepting requests, finish the ones already dispatched and remove the socket file. Responses the socket does not take right away
+/// are discarded. The workload cache is kept, so the daemon can be started again.
+/// </summary>
+void OS_Scheduler_Simulator::Simulation_Daemon::stop() {
+#if !defined(_WIN32)
+    if (!this->io_thread.joinable()) return;
+
+    this->stopping = true;
+    this->wake_io();
+
+    this->io_thread.join();
+    this->pool->wait();
+    this->pool.reset();
+
+    close_socket(this->listener);
+    close_socket(this->wake_pipe[0]);
+    close_socket(this->wake_pipe[1]);
+    this->listener = this->wake_pipe[0] = this->wake_pipe[1] = -1;
+
+    ::unlink(this->socket_path.c_str());
+    this->socket_path.clear();
+#endif
+}
+
+/// <summary>
+/// Wake the I/O thread up, to stop or to wait for a client's socket to take the rest of its output.
+/// </summary>
+void OS_Scheduler_Simulator::Simulation_Daemon::wake_io() {
+#if !defined(_WIN32)
+    const unsigned char wake{ 0 };
+    while (::write(this->wake_pipe[1], &wake, 1) < 0 && errno == EINTR) {}
+#endif
+}
+
+/// <summary>
+/// Body of the I/O thread: accept clients, read their frames, dispatch the requests of every poll round as one batch, and write the
+/// output the workers could not write. Clients that went away or fell too far behind are dropped.
+/// </summary>
+void OS_Scheduler_Simulator::Simulation_Daemon::io_loop() {
+#if !defined(_WIN32)
+    std::vector<std::shared_ptr<connection>> clients;
+    std::vector<pollfd> descriptors;
+    std::vector<unsigned char> buffer(1 << 16);
+    std::vector<std::vector<unsigned char>> frames;
+
+    for (; ; ) {
+        descriptors.clear();
+        descriptors.push_back(pollfd{ .fd = this->wake_pipe[0], .events = POLLIN, .revents = 0 });
+        descriptors.push_back(pollfd{ .fd = this->listener, .events = POLLIN, .revents = 0 });
+
+        for (size_t index{ clients.size() }; index-- > 0; ) {
+            std::lock_guard<std::mutex> lock(clients.at(index)->write_mutex);
+
+            // The peer sees the end of the stream now, even though workers may still hold the connection.
+            if (clients.at(index)->failed) {
+                ::shutdown(clients.at(index)->socket, SHUT_RDWR);
+                clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(index));
+            }
+        }
+
+        for (const std::shared_ptr<connection>& client : clients) {
+            std::lock_guard<std::mutex> lock(client->write_mutex);
+            descriptors.push_back(pollfd{ .fd = client->socket, .events = static_cast<short>(POLLIN | (client->output.empty() ? 0 : POLLOUT)), .revents = 0 });
+        }
+
+        if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (descriptors.front().revents != 0) {
+            while (::read(this->wake_pipe[0], buffer.data(), buffer.size()) > 0) {}
+            if (this->stopping) break;
+        }
+
+        std::vector<request> batch;
+
+        // Backwards, so dropping a client does not move the ones left to check.
+        for (size_t index{ clients.size() }; index-- > 0; ) {
+            std::shared_ptr<connection>& client = clients.at(index);
+
+            if ((descriptors.at(index + 2).revents & POLLOUT) != 0) {
+                std::lock_guard<std::mutex> lock(client->write_mutex);
+                client->flush();
+            }
+
+            if ((descriptors.at(index + 2).revents & (POLLIN | POLLHUP | POLLERR)) == 0) continue;
+
+            const long long received = receive_some(client->socket, buffer.data(), buffer.size());
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+
+            frames.clear();
+            if (received > 0) client->input.insert(client->input.end(), buffer.begin(), buffer.begin() + static_cast<size_t>(received));
+
+            if (received <= 0 || !take_frames(client->input, frames)) {
+                clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(index));
+                continue;
+            }
+
+            for (std::vector<unsigned char>& frame : frames) batch.push_back(request{ .client = client, .payload = std::move(frame) });
+        }
+
+        if ((descriptors.at(1).revents & POLLIN) != 0) {
+            const int accepted = ::accept(this->listener, nullptr, nullptr);
+
+            if (accepted >= 0 && ::fcntl(accepted, F_SETFL, O_NONBLOCK) == 0) clients.push_back(std::make_shared<connection>(accepted));
+            else close_socket(accepted);
+        }
+
+        if (!batch.empty()) this->dispatch(batch);
+    }
+#endif
+}
+
+/// <summary>
+/// Split a batch into a few tasks per worker. Every task answers a contiguous range of requests, which keeps the requests of a client
+/// together, and queues the responses of each client at once. Workers never wait for a client: what its socket does not take is left to
+/// the I/O thread.
+/// </summary>
+void OS_Scheduler_Simulator::Simulation_Daemon::dispatch(std::vector<request>& batch) {
+    this->batches.fetch_add(1, std::memory_order_relaxed);
+
+    std::shared_ptr<std::vector<request>> shared = std::make_shared<std::vector<request>>(std::move(batch));
+
+    const size_t tasks = std::min<size_t>(shared->size(), static_cast<size_t>(this->pool->get_thread_count()) * 4);
+    const size_t chunk = (shared->size() + tasks - 1) / tasks;
+
+    for (size_t first{ 0 }; first < shared->size(); first += chunk) {
+        const size_t last = std::min(first + chunk, shared->size());
+
+        this->pool->submit([this, shared, first, last]() {
+            std::vector<unsigned char> output;
+
+            for (size_t index{ first }; index < last; index++) {
+                const request& current = shared->at(index);
+                this->answer(current, output);
+
+                if (index + 1 == last || shared->at(index + 1).client != current.client) {
+                    bool wake{ false };
+
+                    {
+                        std::lock_guard<std::mutex> lock(current.client->write_mutex);
+
+                        if (!current.client->failed) {
+                            // With output already queued, the I/O thread is waiting for the socket and writes this after it.
+                            const bool queued = !current.client->output.empty();
+                            current.client->output.insert(current.client->output.end(), output.begin(), output.end());
+
+                            if (!queued) current.client->flush();
+                            wake = !queued && (current.client->failed || !current.client->output.empty());
+                        }
+                    }
+
+                    if (wake) this->wake_io();
+                    output.clear();
+                }
+            }
+        });
+    }
+}
+
+/// <summary>
+/// Answer a request, appending the response frame to an output buffer.
+/// </summary>
+void OS_Scheduler_Simulator::Simulation_Daemon::answer(const request& message, std::vector<unsigned char>& output) {
+    reader input(message.payload.data(), message.payload.size());
+
+    const unsigned long long id = input.get_varint();
+    const unsigned char type = input.get_byte();
+
+    std::string error;
+    std::vector<unsigned char> payload;
+
+    if (!input.is_valid()) error = "malformed request";
+
+    else if (type == load_workload || type == put_workload) {
+        const std::string source = input.get_string();
+        const bool from_file = type == load_workload;
+
+        if (!input.is_valid()) error = "malformed request";
+
+        else {
+            const unsigned long long workload = this->find_workload((from_file ? "file:" : "text:") + source, source, from_file);
+            std::shared_ptr<workload_entry> entry = this->get_workload(workload);
+
+            if (!entry->valid) error = entry->error;
+
+            else {
+                put_varint(payload, workload);
+                put_varint(payload, entry->processes.size());
+            }
+        }
+    }
+
+    else if (type == run) {
+        const unsigned long long workload = input.get_varint();
+        const std::string algorithm = input.get_string();
+
+        std::map<std::string, double> parameters;
+        for (unsigned long long count = input.get_varint(); count > 0 && input.is_valid(); count--) {
+            const std::string name = input.get_string();
+            parameters[name] = input.get_double();
+        }
+
+        std::shared_ptr<workload_entry> entry = (input.is_valid()) ? this->get_workload(workload) : nullptr;
+        Batch_Runner::scenario_result result;
+
+        if (!input.is_valid()) error = "malformed request";
+        else if (entry == nullptr || !entry->valid) error = "unknown workload " + std::to_string(workload);
+        else {
+            // The client gets an error instead of no answer, and the worker goes on with the other requests.
+            try {
+                if (Batch_Runner::simulate(entry->processes, algorithm, parameters, result, &error)) put_result(payload, result);
+            }
+            catch (const std::exception& exception) {
+                error = std::string("exception: ") + exception.what();
+            }
+            catch (...) {
+                error = "unknown exception";
+            }
+        }
+    }
+
+    else error = "unknown request type " + std::to_string(type);
+
+    std::vector<unsigned char> response;
+    put_varint(response, id);
+    response.push_back(error.empty() ? 0 : 1);
+
+    if (error.empty()) response.insert(response.end(), payload.begin(), payload.end());
+    else put_string(response, error);
+
+    put_frame(output, response);
+    this->requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Get the id of a workload, adding it to the cache if it is new. It is loaded by get_workload.
+/// </summary>
+/// <param name="key">- Identifies the workload: its kind and path or text.</param>
+unsigned long long OS_Scheduler_Simulator::Simulation_Daemon::find_workload(const std::string& key, const std::string& source, bool from_file) {
+    std::lock_guard<std::mutex> lock(this->cache_mutex);
+
+    auto [it, inserted] = this->cache_keys.try_emplace(key, this->workloads.size());
+
+    if (inserted) {
+        this->workloads.push_back(std::make_shared<workload_entry>());
+        this->workloads.back()->source = source;
+        this->workloads.back()->from_file = from_file;
+    }
+
+    return it->second;
+}
+
+/// <summary>
+/// Get a workload of the cache, loading it the first time. Concurrent requests for the same workload wait for a single load. A workload
+/// that fails to load is dropped from the keys, so loading it again retries.
+/// </summary>
+/// <returns>The workload, or nullptr if the id is unknown.</returns>
+std::shared_ptr<OS_Scheduler_Simulator::Simulation_Daemon::workload_entry> OS_Scheduler_Simulator::Simulation_Daemon::get_workload(unsigned long long id) {
+    std::shared_ptr<workload_entry> entry;
+
+    {
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        if (id < this->workloads.size()) entry = this->workloads.at(static_cast<size_t>(id));
+    }
+
+    if (entry == nullptr) return nullptr;
+
+    std::call_once(entry->loaded, [this, &entry, id]() {
+        if (entry->from_file) entry->valid = Engine::Workload_File::load(entry->source, entry->processes, &entry->error, &entry->bursts);
+
+        else {
+            std::istringstream stream(entry->source);
+            entry->valid = Engine::Workload_File::parse(stream, entry->processes, &entry->error);
+        }
+
+        if (entry->valid && entry->processes.empty()) {
+            entry->valid = false;
+            entry->error = "workload has no processes";
+        }
+
+        std::lock_guard<std::mutex> lock(this->cache_mutex);
+        if (!entry->valid) this->cache_keys.erase((entry->from_file ? "file:" : "text:") + entry->source);
+
+        entry->source.clear();
+        entry->source.shrink_to_fit();
+    });
+
+    return entry;
+}
+
+/// <summary>
+/// Daemon_Client constructor. Call connect() before anything else.
+/// </summary>
+OS_Scheduler_Simulator::Daemon_Client::Daemon_Client() : server(-1), next_request(0), output(), input(), pending() {}
+
+OS_Scheduler_Simulator::Daemon_Client::~Daemon_Client() {
+    this->disconnect();
+}
+
+/// <summary>
+/// Connect to a running daemon.
+/// </summary>
+/// <param name="socket_path">- Path of the socket the daemon listens on.</param>
+/// <param name="error">- Optional description of the problem if the connection failed.</param>
+/// <returns>True if connected.</returns>
+bool OS_Scheduler_Simulator::Daemon_Client::connect(const std::string& socket_path, std::string* error) {
+    this->disconnect();
+
+    std::string problem;
+
+#if defined(_WIN32)
+    problem = "the simulation daemon needs Unix domain sockets, which are not supported on this platform";
+#else
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) problem = "invalid socket path \"" + socket_path + "\"";
+
+    else {
+        std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+        this->server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (this->server < 0 || ::connect(this->server, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            problem = "cannot connect to \"" + socket_path + "\": " + std::strerror(errno);
+            this->disconnect();
+        }
+    }
+#endif
+
+    if (!problem.empty() && error != nullptr) *error = problem;
+    return problem.empty();
+}
+
+/// <summary>
+/// Close the connection. Requests not sent yet and responses not received yet are dropped.
+/// </summary>
+void OS_Scheduler_Simulator::Daemon_Client::disconnect() {
+    close_socket(this->server);
+
+    this->server = -1;
+    this->output.clear();
+    this->input.clear();
+    this->pending.clear();
+}
+
+/// <summary>
+/// Load a workload file on the daemon. The path is resolved by the daemon, from its working directory.
+/// </summary>
+/// <param name="workload">- Id of the workload, for run and send_run.</param>
+/// <param name="processes">- Optional number of processes of the workload.</param>
+/// <returns>True if the workload was loaded.</returns>
+bool OS_Scheduler_Simulator::Daemon_Client::load_workload(const std::string& path, unsigned long long& workload, size_t* processes, std::string* error) {
+    return this->request_workload(Simulation_Daemon::load_workload, path, workload, processes, error);
+}
+
+/// <summary>
+/// Send a workload to the daemon, in the Workload_File format.
+/// </summary>
+/// <param name="workload">- Id of the workload, for run and send_run.</param>
+/// <param name="processes">- Optional number of processes of the workload.</param>
+/// <returns>True if the workload was loaded.</returns>
+bool OS_Scheduler_Simulator::Daemon_Client::put_workload(const std::string& text, unsigned long long& workload, size_t* processes, std::string* error) {
+    return this->request_workload(Simulation_Daemon::put_workload, text, workload, processes, error);
+}
+
+/// <summary>
+/// Run one scenario and wait for its result.
+/// </summary>
+/// <returns>True if the scenario ran.</returns>
+bool OS_Scheduler_Simulator::Daemon_Client::run(unsigned long long workload, const std::string& algorithm, const std::map<std::string, double>& parameters,
+    Batch_Runner::scenario_result& result, std::string* error) {
+    std::vector<unsigned char> payload;
+    if (!this->wait_for(this->send_run(workload, algorithm, parameters), payload, error)) return false;
+
+    reader input(payload.data(), payload.size());
+    input.get_varint();
+
+    if (input.get_byte() != 0) {
+        if (error != nullptr) *error = input.get_string();
+        return false;
+    }
+
+    get_result(input, result);
+    return true;
+}
+
+/// <summary>
+/// Queue a run without waiting for it. Queued requests are sent by flush or receive, and their responses read with receive.
+/// </summary>
+/// <returns>Id of the request, found in its response.</returns>
+unsigned long long OS_Scheduler_Simulator::Daemon_Client::send_run(unsigned long long workload, const std::string& algorithm, const std::map<std::string, double>& parameters) {
+    const unsigned long long id = this->next_request++;
+
+    std::vector<unsigned char> payload;
+    put_varint(payload, id);
+    payload.push_back(Simulation_Daemon::run);
+    put_varint(payload, workload);
+    put_string(payload, algorithm);
+    put_varint(payload, parameters.size());
+
+    for (const auto& [name, value] : parameters) {
+        put_string(payload, name);
+        put_double(payload, value);
+    }
+
+    put_frame(this->output, payload);
+    return id;
+}
+
+/// <summary>
+/// Send the queued requests.
+/// </summary>
+/// <returns>True if they were sent.</returns>
+bool OS_Scheduler_Simulator::Daemon_Client::flush(std::string* error) {
+    if (this->output.empty()) return true;
+
+    const bool sent = send_all(this->server, this->output.data(), this->output.size());
+    this->output.clear();
+
+    if (!sent && error != nullptr) *error = "the connection to the daemon is closed";
+    return sent;
+}
+
+/// <summary>
+/// Send the queued requests and wait for the next response of a run, in the order they come back.
+/// </summary>
+/// <returns>True if a response was received; false if the connection failed.</returns>
+bool OS_Scheduler_Simulator::Daemon_Client::receive(response& next, std::string* error) {
+    std::vector<unsigned char> payload;
+
+    if (!this->pending.empty()) {
+        payload = std::move(this->pending.front().second);
+        this->pending.pop_front();
+    }
+
+    else if (!this->flush(error) || !this->read_response(payload, error)) return false;
+
+    reader input(payload.data(), payload.size());
+    next.request = input.get_varint();
+    next.ok = input.get_byte() == 0;
+    next.error.clear();
+    next.result = Batch_Runner::scenario_result{ .totals = { 0, 0, 0, 0, 0, 0, 0 },
+        .deadlines = { .jobs = 0, .misses = 0, .worst_lateness = 0, .total_tardiness = 0, .max_tardiness = 0, .tardiness_histogram = {} }, .execution_time = 0 };
+
+    if (next.ok) get_result(input, next.result);
+    else next.error = input.get_string();
+
+    return true;
+}
+
+bool OS_Scheduler_Simulator::Daemon_Client::request_workload(Simulation_Daemon::request_type type, const std::string& source, unsigned long long& workload, size_t* processes,
+    std::string* error) {
+    const unsigned long long id = this->next_request++;
+
+    std::vector<unsigned char> payload;
+    put_varint(payload, id);
+    payload.push_back(type);
+    put_string(payload, source);
+    put_frame(this->output, payload);
+
+    if (!this->wait_for(id, payload, error)) return false;
+
+    reader input(payload.data(), payload.size());
+    input.get_varint();
+
+    if (input.get_byte() != 0) {
+        if (error != nullptr) *error = input.get_string();
+        return false;
+    }
+
+    workload = input.get_varint();
+    if (processes != nullptr) *processes = static_cast<size_t>(input.get_varint());
+    return true;
+}
+
+/// <summary>
+/// Read the next response frame from the connection.
+/// </summary>
+bool OS_Scheduler_Simulator::Daemon_Client::read_response(std::vector<unsigned char>& payload, std::string* error) {
+    unsigned char buffer[1 << 14];
+
+    for (; ; ) {
+        size_t start{ 0 };
+        size_t size{ 0 };
+        const int found = next_frame(this->input, 0, start, size);
+
+        if (found > 0) {
+            payload.assign(this->input.begin() + start, this->input.begin() + start + size);
+            this->input.erase(this->input.begin(), this->input.begin() + start + size);
+            return true;
+        }
+
+        if (found < 0) {
+            if (error != nullptr) *error = "malformed response from the daemon";
+            return false;
+        }
+
+        const long long received = receive_some(this->server, buffer, sizeof(buffer));
+
+        if (received <= 0) {
+            if (error != nullptr) *error = "the connection to the daemon is closed";
+            return false;
+        }
+
+        this->input.insert(this->input.end(), buffer, buffer + received);
+    }
+}
+
+/// <summary>
+/// Send the queued requests and wait for the response of one of them. Other responses read meanwhile are kept for receive.
+/// </summary>
+bool OS_Scheduler_Simulator::Daemon_Client::wait_for(unsigned long long request, std::vector<unsigned char>& payload, std::string* error) {
+    for (auto it = this->pending.begin(); it != this->pending.end(); it++) {
+        reader input(it->second.data(), it->second.size());
+
+        if (input.get_varint() == request) {
+            payload = std::move(it->second);
+            this->pending.erase(it);
+            return true;
+        }
+    }
+
+    if (!this->flush(error)) return false;
+
+    for (; ; ) {
+        if (!this->read_response(payload, error)) return false;
+
+        reader input(payload.data(), payload.size());
+        const unsigned long long id = input.get_varint();
+
+        if (id == request) return true;
+        this->pending.emplace_back(id, std::move(payload));
+    }
+}
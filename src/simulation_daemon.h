@@ -0,0 +1,139 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_SIMULATION_DAEMON_
+#define _OS_SCHEDULER_SIMULATOR_SIMULATION_DAEMON_
+
+#include "engine.h"
+#include "batch_runner.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+/// <summary>
+/// Long-running local server that runs simulations for other processes over a Unix domain socket (POSIX only; start() fails elsewhere).
+///
+/// Clients load workloads once, by path or inline text, and get back a workload id that every later run refers to. Loaded workloads are
+/// cached for the life of the daemon, and loading the same path or text again returns the same id. A single I/O thread polls the listening
+/// socket and every connection; all the requests that arrive in one poll round form a batch, which is split into a few tasks per worker of
+/// a Work_Stealing_Pool. Every task writes the responses of a connection with a single write, so thousands of small simulations per second
+/// cost a few system calls each rather than a thread hop and a write per run. Responses carry the id of their request and may come back in
+/// any order, so clients can pipeline requests. Connections are non-blocking: responses a client does not read yet wait in its output
+/// buffer, and a client that lets too many pile up is disconnected, so a stalled client never holds up a worker or stop().
+///
+/// Wire format: every message is a frame, a varint byte count followed by the payload. Integers are varints (zigzag-encoded when signed),
+/// doubles are 8 little-endian bytes, strings are a varint byte count followed by the bytes.
+/// - Request: id, type (request_type), then the fields of the type. load_workload: path. put_workload: workload text (Workload_File
+///   format). run: workload id, algorithm, parameter count, then every parameter as a name and a double. The parameters may include the
+///   scenario options of Batch_Runner::simulate.
+/// - Response: id of the request, status (0 if it succeeded), then an error message if it failed. Loads return the workload id and its
+///   number of processes. Runs return the execution time, the seven totals of Evaluator::results_table, and the deadline report: jobs,
+///   misses, worst lateness, total and largest tardiness, and the tardiness histogram (count followed by the buckets).
+/// </summary>
+class OS_Scheduler_Simulator::Simulation_Daemon {
+public:
+	typedef enum : unsigned char { load_workload = 1, put_workload = 2, run = 3 } request_type;
+
+	Simulation_Daemon(unsigned threads = 0);
+	~Simulation_Daemon();
+
+	Simulation_Daemon(const Simulation_Daemon&) = delete;
+	Simulation_Daemon& operator=(const Simulation_Daemon&) = delete;
+
+	bool start(const std::string& socket_path, std::string* error = nullptr);
+	void stop();
+
+	/// <summary>Get the number of requests answered since the daemon started.</summary>
+	unsigned long long get_requests() const { return this->requests.load(std::memory_order_relaxed); }
+	/// <summary>Get the number of batches dispatched to the pool since the daemon started.</summary>
+	unsigned long long get_batches() const { return this->batches.load(std::memory_order_relaxed); }
+
+private:
+	typedef struct {
+		std::once_flag loaded;
+		bool valid;
+		std::string error;
+		std::string source;                           // Path or text, until loaded.
+		bool from_file;
+		std::vector<Engine::Process_Data> processes;
+		std::shared_ptr<const Engine::Burst_Store> bursts; // Of traces, which the processes read their bursts from.
+	} workload_entry;
+
+	struct connection;
+
+	typedef struct {
+		std::shared_ptr<connection> client;
+		std::vector<unsigned char> payload;
+	} request;
+
+	void io_loop();
+	void wake_io();
+	void dispatch(std::vector<request>& batch);
+	void answer(const request& message, std::vector<unsigned char>& output);
+	unsigned long long find_workload(const std::string& key, const std::string& source, bool from_file);
+	std::shared_ptr<workload_entry> get_workload(unsigned long long id);
+
+	unsigned threads;
+	std::unique_ptr<Work_Stealing_Pool> pool;
+	std::thread io_thread;
+	std::string socket_path;
+	int listener;
+	int wake_pipe[2];
+	std::atomic<bool> stopping;
+
+	std::mutex cache_mutex;
+	std::unordered_map<std::string, unsigned long long> cache_keys;
+	std::vector<std::shared_ptr<workload_entry>> workloads;
+
+	std::atomic<unsigned long long> requests;
+	std::atomic<unsigned long long> batches;
+};
+
+/// <summary>
+/// Minimal blocking client of a Simulation_Daemon, for tests and tools. The calls that return a result wait for their own response; with
+/// send_run and receive, many runs can be in flight on the same connection.
+/// </summary>
+class OS_Scheduler_Simulator::Daemon_Client {
+public:
+	typedef struct {
+		unsigned long long request;                   // Id returned by send_run.
+		bool ok;
+		std::string error;
+		Batch_Runner::scenario_result result;
+	} response;
+
+	Daemon_Client();
+	~Daemon_Client();
+
+	Daemon_Client(const Daemon_Client&) = delete;
+	Daemon_Client& operator=(const Daemon_Client&) = delete;
+
+	bool connect(const std::string& socket_path, std::string* error = nullptr);
+	void disconnect();
+
+	bool load_workload(const std::string& path, unsigned long long& workload, size_t* processes = nullptr, std::string* error = nullptr);
+	bool put_workload(const std::string& text, unsigned long long& workload, size_t* processes = nullptr, std::string* error = nullptr);
+	bool run(unsigned long long workload, const std::string& algorithm, const std::map<std::string, double>& parameters,
+		Batch_Runner::scenario_result& result, std::string* error = nullptr);
+
+	unsigned long long send_run(unsigned long long workload, const std::string& algorithm, const std::map<std::string, double>& parameters);
+	bool flush(std::string* error = nullptr);
+	bool receive(response& next, std::string* error = nullptr);
+
+private:
+	bool request_workload(Simulation_Daemon::request_type type, const std::string& source, unsigned long long& workload, size_t* processes, std::string* error);
+	bool read_response(std::vector<unsigned char>& payload, std::string* error);
+	bool wait_for(unsigned long long request, std::vector<unsigned char>& payload, std::string* error);
+
+	int server;                                       // Connection to the daemon, or -1.
+	unsigned long long next_request;
+	std::vector<unsigned char> output;                // Requests not sent yet.
+	std::vector<unsigned char> input;                 // Bytes received and not parsed yet.
+	std::deque<std::pair<unsigned long long, std::vector<unsigned char>>> pending; // Responses read while waiting for another.
+};
+
+#endif
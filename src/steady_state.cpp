@@ -0,0 +1,312 @@
+#include "steady_state.h"
+#include "io_device.h"
+
+#include <vector>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+// Marks a process that is not in the data point (done).
+static constexpr size_t absent = std::numeric_limits<size_t>::max();
+
+/// <summary>
+/// Get the shortest even shift that maps a burst list onto itself (even, so CPU bursts map onto CPU bursts).
+/// </summary>
+/// <returns>The period, or the size of the list if it does not repeat.</returns>
+static size_t find_period(const OS_Scheduler_Simulator::Engine::Process_Data& process) {
+    const size_t size = process.get_operations_size();
+    if (size < 2) return size;
+
+    // Prefix function: the longest border of the whole list gives its shortest period.
+    std::vector<size_t> border(size, 0);
+
+    for (size_t i{ 1 }; i < size; i++) {
+        size_t k = border.at(i - 1);
+
+        while (k > 0 && process.get_operation(i) != process.get_operation(k))
+            k = border.at(k - 1);
+
+        if (process.get_operation(i) == process.get_operation(k)) k++;
+        border.at(i) = k;
+    }
+
+    size_t period = size - border.back();
+    if (period % 2 == 1) period *= 2;
+
+    return std::min(period, size);
+}
+
+/// <summary>
+/// Cycle_Detector constructor.
+/// </summary>
+/// <param name="processes">- Processes the data points refer to. They must outlive the detector.</param>
+/// <param name="max_tracked_values">- Memory bound for the states remembered. When reached, older states are forgotten, so longer cycles are missed.</param>
+OS_Scheduler_Simulator::Engine::Cycle_Detector::Cycle_Detector(const std::vector<Process_Data>& processes, size_t max_tracked_values)
+    : processes(processes), periods(), evaluated_as(), uses_devices(false), max_tracked_values(max_tracked_values), signature(), operations(processes.size(), absent), seen(),
+      tracked_values(0), searching(true), has_previous(false), previous_time(0), previous_busy(false), previous_ready(), previous_queued(), waiting_time(processes.size(), 0),
+      io_queueing_time(processes.size(), 0), unused_cpu(0),
+      detected(cycle{ .found = false, .start_time = 0, .length = 0, .repetitions = 0, .advance = {}, .waiting_time = {}, .io_queueing_time = {}, .unused_cpu = 0 }) {
+    this->periods.reserve(processes.size());
+
+    for (const Process_Data& process : processes) {
+        this->periods.push_back(find_period(process));
+        this->uses_devices = this->uses_devices || process.get_io_device() != nullptr;
+    }
+
+    // The Evaluator finds processes by name, so waiting time goes to the first process with the same name.
+    std::unordered_map<std::string, size_t> first_with_name;
+    this->evaluated_as.reserve(processes.size());
+
+    for (size_t i{ 0 }; i < processes.size(); i++)
+        this->evaluated_as.push_back(first_with_name.try_emplace(processes.at(i).get_name(), i).first->second);
+}
+
+/// <summary>
+/// Run an algorithm, skipping the cycles of its steady state. The schedule is simulated until a state repeats, then the workload without
+/// the repeated cycles is fast-forwarded the same way and the cycles are added back to its results. No timeline is kept.
+///
+/// If no cycle is found, the first run simply completes and its results are returned.
+/// </summary>
+/// <param name="algorithm">- Algorithm deciding only from the data points (see the class description).</param>
+/// <param name="processes">- Workload to run.</param>
+/// <returns>Results equal to those of a complete run.</returns>
+OS_Scheduler_Simulator::Engine::Cycle_Detector::result OS_Scheduler_Simulator::Engine::Cycle_Detector::fast_forward(const std::function<void(const std::vector<Process_Data>&, Timeline&)>& algorithm, std::vector<Process_Data>& processes) {
+    Cycle_Detector detector(processes);
+    Evaluator evaluator(processes, nullptr);
+    Timeline timeline(false);
+    size_t points{ 0 };
+
+    timeline.set_observer([&detector, &evaluator, &timeline, &points](const Data_Point& data_point) {
+        points++;
+        evaluator.add_data_point(data_point);
+        if (detector.add_data_point(data_point)) timeline.request_stop();
+    });
+
+    algorithm(processes, timeline);
+
+    // Algorithms that do not stop early just complete the run.
+    if (!detector.get_cycle().found || timeline.empty() || timeline.back()->is_done()) {
+        evaluator.finish();
+
+        return result{
+            .totals = evaluator.get_overall_totals(),
+            .execution_time = (timeline.empty()) ? 0 : timeline.back()->get_time_since_start(),
+            .unused_cpu = evaluator.get_unused_cpu_time(),
+            .per_process = evaluator.get_all_processes_data(),
+            .detected = cycle{ .found = false, .start_time = 0, .length = 0, .repetitions = 0, .advance = {}, .waiting_time = {}, .io_queueing_time = {}, .unused_cpu = 0 },
+            .simulated_points = points
+        };
+    }
+
+    // Once the processes with the shortest cycles are done, the rest of the workload can settle into another cycle.
+    std::vector<Process_Data> reduced = detector.get_reduced_workload();
+    const result reduced_result = fast_forward(algorithm, reduced);
+
+    result extrapolated = detector.extrapolate(reduced_result, processes);
+    extrapolated.simulated_points = points + reduced_result.simulated_points;
+
+    return extrapolated;
+}
+
+/// <summary>
+/// Consume the next point of the timeline.
+/// </summary>
+/// <returns>True when a cycle that can be skipped was found (only once).</returns>
+bool OS_Scheduler_Simulator::Engine::Cycle_Detector::add_data_point(const Data_Point& data_point) {
+    const unsigned time = data_point.get_time_since_start();
+
+    // Accumulate the block that ended at this point.
+    if (this->has_previous) {
+        const unsigned diff = time - this->previous_time;
+
+        for (size_t i : this->previous_ready)
+            this->waiting_time.at(i) += diff;
+
+        for (size_t i : this->previous_queued)
+            this->io_queueing_time.at(i) += diff;
+
+        if (!this->previous_busy) this->unused_cpu += diff;
+    }
+
+    this->has_previous = true;
+    this->previous_time = time;
+    this->previous_busy = data_point.is_cpu_busy();
+
+    this->previous_ready.clear();
+    for (const Running_Process& process : data_point.get_ready_list())
+        this->previous_ready.push_back(this->evaluated_as.at(this->get_index(process)));
+
+    this->previous_queued.clear();
+    if (this->uses_devices) {
+        const std::list<Running_Process> waiting_list = data_point.get_waiting_list();
+
+        IO_Device::for_each_request(waiting_list, [this](const Running_Process& process, bool in_service) {
+            if (!in_service) this->previous_queued.push_back(this->evaluated_as.at(this->get_index(process)));
+        });
+    }
+
+    if (!this->searching) return false;
+
+    this->build_signature(data_point);
+
+    auto it = this->seen.find(this->signature);
+
+    if (it == this->seen.end()) {
+        if (this->tracked_values + this->signature.size() + this->operations.size() * 2 > this->max_tracked_values) {
+            this->seen.clear();
+            this->tracked_values = 0;
+        }
+
+        this->seen.emplace(this->signature, occurrence{ .time = time, .operations = this->operations, .waiting_time = this->waiting_time, .io_queueing_time = this->io_queueing_time, .unused_cpu = this->unused_cpu });
+        this->tracked_values += this->signature.size() + this->operations.size() * 2;
+        return false;
+    }
+
+    const occurrence& first = it->second;
+    if (time == first.time) return false; // Zero-length step.
+
+    // Every process that moved must keep repeating for all the cycles skipped, so the tail still ends the same way.
+    unsigned long long repetitions = std::numeric_limits<unsigned long long>::max();
+    std::vector<size_t> advance(this->processes.size(), 0);
+
+    for (size_t i{ 0 }; i < this->processes.size(); i++) {
+        if (this->operations.at(i) == absent) continue;
+
+        advance.at(i) = this->operations.at(i) - first.operations.at(i);
+        if (advance.at(i) == 0) continue;
+
+        const size_t remaining = this->processes.at(i).get_operations_size() - 1 - this->operations.at(i);
+        repetitions = std::min<unsigned long long>(repetitions, remaining / advance.at(i));
+    }
+
+    // Some process ends within the next cycle. Once it is done, the others may settle into a new cycle, so start over.
+    if (repetitions == std::numeric_limits<unsigned long long>::max() || repetitions == 0) {
+        this->seen.clear();
+        this->tracked_values = 0;
+        return false;
+    }
+
+    this->detected.found = true;
+    this->detected.start_time = first.time;
+    this->detected.length = time - first.time;
+    this->detected.repetitions = repetitions;
+    this->detected.advance = advance;
+    this->detected.unused_cpu = this->unused_cpu - first.unused_cpu;
+    this->detected.waiting_time.assign(this->processes.size(), 0);
+    this->detected.io_queueing_time.assign(this->processes.size(), 0);
+
+    for (size_t i{ 0 }; i < this->processes.size(); i++) {
+        this->detected.waiting_time.at(i) = this->waiting_time.at(i) - first.waiting_time.at(i);
+        this->detected.io_queueing_time.at(i) = this->io_queueing_time.at(i) - first.io_queueing_time.at(i);
+    }
+
+    this->searching = false;
+    this->seen.clear();
+    this->tracked_values = 0;
+
+    return true;
+}
+
+/// <summary>
+/// Get the workload without the skipped cycles. Since the bursts are periodic, dropping the operations of the skipped cycles is the same as
+/// dropping that many operations from the end.
+/// </summary>
+std::vector<OS_Scheduler_Simulator::Engine::Process_Data> OS_Scheduler_Simulator::Engine::Cycle_Detector::get_reduced_workload() const {
+    std::vector<Process_Data> reduced;
+    reduced.reserve(this->processes.size());
+
+    for (size_t i{ 0 }; i < this->processes.size(); i++) {
+        const Process_Data& process = this->processes.at(i);
+        const size_t removed = (this->detected.found) ? static_cast<size_t>(this->detected.repetitions * this->detected.advance.at(i)) : 0;
+
+        reduced.push_back(process.get_prefix(process.get_operations_size() - removed));
+    }
+
+    return reduced;
+}
+
+/// <summary>
+/// Add the skipped cycles to the evaluation of the reduced workload. The reduced run matches the full one up to the end of the first cycle,
+/// and from there it is the full run shifted back by the skipped cycles.
+/// </summary>
+/// <param name="reduced">- Results of the reduced workload.</param>
+/// <param name="processes">- Processes the per process results refer to.</param>
+OS_Scheduler_Simulator::Engine::Cycle_Detector::result OS_Scheduler_Simulator::Engine::Cycle_Detector::extrapolate(const result& reduced, std::vector<Process_Data>& processes) const {
+    const unsigned long long skipped_time = this->detected.repetitions * this->detected.length;
+    const unsigned shift_after = this->detected.start_time + this->detected.length;
+
+    auto shift = [shift_after, skipped_time](unsigned time) -> unsigned {
+        return (time > shift_after) ? static_cast<unsigned>(time + skipped_time) : time;
+    };
+
+    result extrapolated{
+        .totals = { 0, 0, 0, 0, 0, 0, 0 },
+        .execution_time = reduced.execution_time + skipped_time,
+        .unused_cpu = reduced.unused_cpu + this->detected.repetitions * this->detected.unused_cpu,
+        .per_process = {},
+        .detected = this->detected,
+        .simulated_points = 0
+    };
+
+    for (size_t i{ 0 }; i < reduced.per_process.size(); i++) {
+        Evaluator::Process process(&processes.at(i));
+
+        process.add_total_waiting_time(static_cast<unsigned>(reduced.per_process.at(i).get_total_waiting_time() + this->detected.repetitions * this->detected.waiting_time.at(i)));
+        process.add_io_queueing_time(static_cast<unsigned>(reduced.per_process.at(i).get_io_queueing_time() + this->detected.repetitions * this->detected.io_queueing_time.at(i)));
+        process.set_response_time(shift(reduced.per_process.at(i).get_response_time()));
+        process.set_turnaround_time(shift(reduced.per_process.at(i).get_turnaround_time()));
+
+        extrapolated.totals.avg_response_time   += static_cast<double>(process.get_response_time());
+        extrapolated.totals.avg_turnaround_time += static_cast<double>(process.get_turnaround_time());
+        extrapolated.totals.avg_waiting_time    += static_cast<double>(process.get_total_waiting_time());
+        extrapolated.totals.avg_io_queueing_delay += static_cast<double>(process.get_io_queueing_time());
+
+        extrapolated.per_process.push_back(process);
+    }
+
+    extrapolated.totals.avg_response_time   /= extrapolated.per_process.size();
+    extrapolated.totals.avg_turnaround_time /= extrapolated.per_process.size();
+    extrapolated.totals.avg_waiting_time    /= extrapolated.per_process.size();
+    extrapolated.totals.avg_io_queueing_delay /= extrapolated.per_process.size();
+
+    extrapolated.totals.cpu_utilization = static_cast<double>(extrapolated.execution_time - extrapolated.unused_cpu) / static_cast<double>(extrapolated.execution_time);
+
+    // Fast-forwarded runs never charge context switches.
+    extrapolated.totals.effective_cpu_utilization = extrapolated.totals.cpu_utilization;
+    extrapolated.totals.switch_overhead = 0;
+
+    return extrapolated;
+}
+
+/// <summary>
+/// Describe the state at a point: where every process is, in order, and its position within its period.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Cycle_Detector::build_signature(const Data_Point& data_point) {
+    std::fill(this->operations.begin(), this->operations.end(), absent);
+    this->signature.clear();
+
+    auto append = [this](unsigned list, const Running_Process& process) {
+        const size_t i = this->get_index(process);
+        this->operations.at(i) = process.get_operation_index();
+
+        this->signature.push_back(list);
+        this->signature.push_back(static_cast<unsigned>(i));
+        this->signature.push_back(static_cast<unsigned>(process.get_status()));
+        this->signature.push_back(static_cast<unsigned>(process.get_operation_index() % this->periods.at(i)));
+        this->signature.push_back(process.time_in_operation());
+        this->signature.push_back(process.get_level());
+    };
+
+    if (data_point.is_cpu_busy()) append(0, data_point.get_cpu_process());
+
+    for (const Running_Process& process : data_point.get_ready_list()) append(1, process);
+    for (const Running_Process& process : data_point.get_waiting_list()) append(2, process);
+}
+
+size_t OS_Scheduler_Simulator::Engine::Cycle_Detector::get_index(const Running_Process& process) const {
+    return process.get_process_data() - this->processes.data();
+}
@@ -0,0 +1,99 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_STEADY_STATE_
+#define _OS_SCHEDULER_SIMULATOR_STEADY_STATE_
+
+#include "engine.h"
+
+#include <vector>
+#include <map>
+#include <functional>
+
+/// <summary>
+/// Detector of a repeating scheduler state, used to fast-forward periodic workloads.
+///
+/// Every process is reduced to the period of its burst list (the shortest shift that maps the list onto itself). Two points are the same
+/// state when the running process, the ready list and the waiting list hold the same processes, in the same order, at the same position of
+/// their periods. If the algorithm decides only from that state, everything between the two points repeats until some process gets close
+/// to the end of its burst list. The repeated cycles can then be dropped from the workload and added back to the results analytically.
+///
+/// This holds for FCFS, SJF, SRTF and MLFQ without a boost period. CFS and ASJF keep history outside of the data points (virtual runtimes,
+/// predictions), RR and Priority the time the running process has left in its quantum, and a boosted MLFQ the time to the next boost, so
+/// they must not be fast-forwarded.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Cycle_Detector {
+public:
+	typedef struct {
+		bool found;
+		unsigned start_time;                 // Time of the first occurrence of the repeated state.
+		unsigned length;                     // Time between two occurrences.
+		unsigned long long repetitions;      // Cycles that can be skipped.
+		std::vector<size_t> advance;         // Operations each process completes in one cycle.
+		std::vector<unsigned long long> waiting_time; // Time each process spends ready in one cycle.
+		std::vector<unsigned long long> io_queueing_time; // Time each process spends queued for an I/O device in one cycle.
+		unsigned unused_cpu;                 // Idle CPU time in one cycle.
+	} cycle;
+
+	typedef struct {
+		Evaluator::results_table totals;
+		unsigned long long execution_time;
+		unsigned long long unused_cpu;
+		std::vector<Evaluator::Process> per_process;
+		cycle detected;
+		size_t simulated_points;             // Points actually simulated, over both passes.
+	} result;
+
+	Cycle_Detector(const std::vector<Process_Data>& processes, size_t max_tracked_values = 1 << 24);
+
+	static result fast_forward(const std::function<void(const std::vector<Process_Data>&, Timeline&)>& algorithm, std::vector<Process_Data>& processes);
+
+	bool add_data_point(const Data_Point& data_point);
+
+	/// <summary>Get the cycle found, if add_data_point returned true.</summary>
+	const cycle& get_cycle() const { return this->detected; }
+
+	/// <summary>Get the period used for a process.</summary>
+	/// <returns>Number of operations after which its bursts repeat; at least the number of operations if they never do.</returns>
+	size_t get_period(size_t process) const { return this->periods.at(process); }
+
+	std::vector<Process_Data> get_reduced_workload() const;
+	result extrapolate(const result& reduced, std::vector<Process_Data>& processes) const;
+
+private:
+	typedef struct {
+		unsigned time;
+		std::vector<size_t> operations;
+		std::vector<unsigned long long> waiting_time;
+		std::vector<unsigned long long> io_queueing_time;
+		unsigned unused_cpu;
+	} occurrence;
+
+	void build_signature(const Data_Point& data_point);
+	size_t get_index(const Running_Process& process) const;
+
+	const std::vector<Process_Data>& processes;
+	std::vector<size_t> periods;
+	std::vector<size_t> evaluated_as;    // Process the Evaluator credits, since it finds processes by name.
+	bool uses_devices;
+	size_t max_tracked_values;
+
+	// Scratch state, reused by every point.
+	std::vector<unsigned> signature;
+	std::vector<size_t> operations;
+
+	std::map<std::vector<unsigned>, occurrence> seen;
+	size_t tracked_values;
+	bool searching;
+
+	// Running totals, as the Evaluator counts them.
+	bool has_previous;
+	unsigned previous_time;
+	bool previous_busy;
+	std::vector<size_t> previous_ready;
+	std::vector<size_t> previous_queued;
+	std::vector<unsigned long long> waiting_time;
+	std::vector<unsigned long long> io_queueing_time;
+	unsigned unused_cpu;
+
+	cycle detected;
+};
+
+#endif
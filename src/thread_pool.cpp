@@ -0,0 +1,137 @@
+#include "thread_pool.h"
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Identifies the pool and queue of the current worker thread, so tasks submitted by a task stay local.
+static thread_local const OS_Scheduler_Simulator::Work_Stealing_Pool* current_pool = nullptr;
+static thread_local unsigned current_worker = 0;
+
+/// <summary>
+/// Work_Stealing_Pool constructor.
+/// </summary>
+/// <param name="threads">- Number of workers. 0 uses one worker per hardware thread.</param>
+OS_Scheduler_Simulator::Work_Stealing_Pool::Work_Stealing_Pool(unsigned threads)
+    : queues(), threads(), queued(0), unfinished(0), failed(0), next_queue(0), stopping(false) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    for (unsigned i{ 0 }; i < threads; i++)
+        this->queues.push_back(std::make_unique<task_queue>());
+
+    for (unsigned i{ 0 }; i < threads; i++)
+        this->threads.push_back(std::thread(&Work_Stealing_Pool::worker_loop, this, i));
+}
+
+/// <summary>
+/// Finishes every submitted task before stopping the workers.
+/// </summary>
+OS_Scheduler_Simulator::Work_Stealing_Pool::~Work_Stealing_Pool() {
+    this->wait();
+
+    {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        this->stopping = true;
+    }
+
+    this->work_available.notify_all();
+
+    for (std::thread& thread : this->threads)
+        thread.join();
+}
+
+/// <summary>
+/// Add a task. Tasks submitted from a worker go to that worker's queue; the others are spread over all queues.
+/// </summary>
+void OS_Scheduler_Simulator::Work_Stealing_Pool::submit(std::function<void()> task) {
+    const unsigned index = (current_pool == this) ? current_worker : this->next_queue.fetch_add(1) % this->queues.size();
+
+    this->unfinished++;
+
+    {
+        std::lock_guard<std::mutex> lock(this->queues.at(index)->mutex);
+        this->queues.at(index)->tasks.push_back(std::move(task));
+    }
+
+    {
+        // Incremented under the state mutex so a worker going to sleep cannot miss it.
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        this->queued++;
+    }
+
+    this->work_available.notify_one();
+}
+
+/// <summary>
+/// Block until every submitted task (including tasks submitted by tasks) has completed.
+/// </summary>
+/// <returns>Number of tasks that ended with an exception since the previous wait.</returns>
+size_t OS_Scheduler_Simulator::Work_Stealing_Pool::wait() {
+    std::unique_lock<std::mutex> lock(this->state_mutex);
+    this->all_done.wait(lock, [this]() { return this->unfinished == 0; });
+    return this->failed.exchange(0);
+}
+
+void OS_Scheduler_Simulator::Work_Stealing_Pool::worker_loop(unsigned index) {
+    current_pool = this;
+    current_worker = index;
+
+    std::function<void()> task;
+
+    while (true) {
+        if (this->take_task(index, task)) {
+            // An exception must not end the worker: the thread would terminate the program, and wait would never return.
+            try { task(); }
+            catch (...) { this->failed++; }
+
+            task = nullptr;
+
+            if (--this->unfinished == 0) {
+                std::lock_guard<std::mutex> lock(this->state_mutex);
+                this->all_done.notify_all();
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->state_mutex);
+        this->work_available.wait(lock, [this]() { return this->stopping || this->queued > 0; });
+
+        if (this->stopping && this->queued == 0) break;
+    }
+}
+
+/// <summary>
+/// Take a task from the back of the worker's own queue, or steal one from the front of another queue.
+/// </summary>
+bool OS_Scheduler_Simulator::Work_Stealing_Pool::take_task(unsigned index, std::function<void()>& task) {
+    const size_t count = this->queues.size();
+
+    for (size_t offset{ 0 }; offset < count; offset++) {
+        task_queue& queue = *this->queues.at((index + offset) % count);
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty()) continue;
+
+        if (offset == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        this->queued--;
+        return true;
+    }
+
+    return false;
+}
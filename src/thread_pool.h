@@ -0,0 +1,56 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_THREAD_POOL_
+#define _OS_SCHEDULER_SIMULATOR_THREAD_POOL_
+
+#include "engine.h"
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/// <summary>
+/// Thread pool with one task queue per worker. Workers take their own tasks from the back of their queue and, when it is empty, steal from
+/// the front of the other queues, so long and short tasks balance out without any cost estimate. Tasks that throw are counted and
+/// reported by wait; callers report the failure through the task's own result.
+/// </summary>
+class OS_Scheduler_Simulator::Work_Stealing_Pool {
+public:
+	Work_Stealing_Pool(unsigned threads = 0);
+	~Work_Stealing_Pool();
+
+	Work_Stealing_Pool(const Work_Stealing_Pool&) = delete;
+	Work_Stealing_Pool& operator=(const Work_Stealing_Pool&) = delete;
+
+	void submit(std::function<void()> task);
+	size_t wait();
+
+	unsigned get_thread_count() const { return static_cast<unsigned>(this->threads.size()); }
+
+private:
+	typedef struct {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	} task_queue;
+
+	void worker_loop(unsigned index);
+	bool take_task(unsigned index, std::function<void()>& task);
+
+	std::vector<std::unique_ptr<task_queue>> queues;
+	std::vector<std::thread> threads;
+
+	std::atomic<size_t> queued;          // Tasks waiting in any queue.
+	std::atomic<size_t> unfinished;      // Tasks submitted and not completed yet.
+	std::atomic<size_t> failed;          // Tasks that threw since the last wait.
+	std::atomic<unsigned> next_queue;    // Round-robin target for tasks submitted from outside the pool.
+
+	std::mutex state_mutex;
+	std::condition_variable work_available;
+	std::condition_variable all_done;
+	bool stopping;
+};
+
+#endif
@@ -0,0 +1,275 @@
+#include "timeline_spill.h"
+
+#include <cstdio>
+#include <vector>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <algorithm>
+
+#ifdef _DEBUG
+#include <iostream>
+#endif // _DEBUG
+
+namespace {
+    // 64-bit offsets, so spill files can grow past 2 GB.
+    int seek(std::FILE* file, unsigned long long offset, int origin) {
+#if defined(_WIN32)
+        return _fseeki64(file, static_cast<long long>(offset), origin);
+#else
+        return fseeko(file, static_cast<off_t>(offset), origin);
+#endif
+    }
+
+    void put_varint(std::vector<unsigned char>& buffer, unsigned long long value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+
+        buffer.push_back(static_cast<unsigned char>(value));
+    }
+
+    unsigned long long get_varint(const unsigned char*& position) {
+        unsigned long long value{ 0 };
+
+        for (unsigned shift{ 0 }; ; shift += 7) {
+            const unsigned char byte = *position++;
+            value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+    }
+}
+
+/// <summary>
+/// Timeline_Spill constructor. Creates the temporary file; if that fails, is_open() is false and nothing can be spilled.
+/// </summary>
+/// <param name="first_process">- First element of the vector of processes the points refer to.</param>
+/// <param name="cache_bytes">- Memory the segments read back may take, as estimated by Data_Point::get_memory_size.</param>
+OS_Scheduler_Simulator::Engine::Timeline_Spill::Timeline_Spill(const Process_Data* first_process, size_t cache_bytes)
+    : file(std::tmpfile()), first_process(first_process), segments(), file_bytes(0), spilled_points(0), buffer(), mutex(), cache(), cache_limit(cache_bytes), cached_bytes(0), peak_cached_bytes(0) {}
+
+OS_Scheduler_Simulator::Engine::Timeline_Spill::~Timeline_Spill() {
+    if (this->file != nullptr) std::fclose(this->file);
+}
+
+/// <summary>
+/// Append a segment to the file, with the oldest points in memory. They follow the points spilled before.
+/// </summary>
+/// <param name="points">- Points of the timeline in memory.</param>
+/// <param name="count">- Points in the segment, from the first one.</param>
+/// <returns>False if the file could not be written; the points must then stay in memory.</returns>
+bool OS_Scheduler_Simulator::Engine::Timeline_Spill::write(const std::deque<Data_Point*>& points, size_t count) {
+    if (this->file == nullptr || count == 0) return false;
+
+    this->buffer.clear();
+
+    for (size_t i{ 0 }; i < count; i++) {
+        const Data_Point& data_point = *points.at(i);
+
+        put_varint(this->buffer, data_point.get_time_since_start());
+        this->encode_process(data_point.get_cpu_process());
+
+        // The queues themselves, or only their sizes for the points that did not record them.
+        put_varint(this->buffer, data_point.has_ready_queue());
+
+        if (data_point.has_ready_queue()) {
+            put_varint(this->buffer, data_point.get_ready_levels().size());
+
+            for (const Data_Point::ready_level& level : data_point.get_ready_levels()) {
+                put_varint(this->buffer, level.level);
+                put_varint(this->buffer, level.processes.size());
+                for (const Running_Process& process : level.processes) this->encode_process(process);
+            }
+
+            const std::list<Running_Process> waiting_list = data_point.get_waiting_list();
+            put_varint(this->buffer, waiting_list.size());
+            for (const Running_Process& process : waiting_list) this->encode_process(process);
+        }
+
+        else {
+            put_varint(this->buffer, data_point.get_ready_count());
+            put_varint(this->buffer, data_point.get_waiting_count());
+        }
+
+        // The changes of the ready queue, as the indices of the processes; the dispatched one plus one, 0 for none.
+        const std::optional<Data_Point::ready_changes>& changes = data_point.get_ready_changes();
+        put_varint(this->buffer, changes.has_value());
+
+        if (changes.has_value()) {
+            put_varint(this->buffer, changes->enqueued.size());
+            for (const Process_Data* process : changes->enqueued) put_varint(this->buffer, static_cast<unsigned long long>(process - this->first_process));
+            put_varint(this->buffer, (changes->dispatched != nullptr) ? static_cast<unsigned long long>(changes->dispatched - this->first_process) + 1 : 0);
+        }
+
+        // The changes of the waiting list, as the indices of the processes.
+        const std::optional<Data_Point::waiting_changes>& io_changes = data_point.get_waiting_changes();
+        put_varint(this->buffer, io_changes.has_value());
+        if (!io_changes.has_value()) continue;
+
+        for (const std::vector<const Process_Data*>* processes : { &io_changes->completed, &io_changes->started }) {
+            put_varint(this->buffer, processes->size());
+            for (const Process_Data* process : *processes) put_varint(this->buffer, static_cast<unsigned long long>(process - this->first_process));
+        }
+    }
+
+    if (seek(this->file, 0, SEEK_END) != 0 || std::fwrite(this->buffer.data(), 1, this->buffer.size(), this->file) != this->buffer.size())
+        return false;
+
+    size_t memory{ 0 };
+    for (size_t i{ 0 }; i < count; i++) memory += points.at(i)->get_memory_size();
+
+    this->segments.push_back(stored_segment{ .offset = this->file_bytes, .bytes = this->buffer.size(), .first_point = this->spilled_points, .points = count,
+        .first_time = points.front()->get_time_since_start(), .memory = memory });
+
+    this->file_bytes += this->buffer.size();
+    this->spilled_points += count;
+
+    // The encoded segment is not kept around between writes.
+    std::vector<unsigned char>().swap(this->buffer);
+    return true;
+}
+
+/// <summary>
+/// Find the segment holding a point.
+/// </summary>
+/// <param name="index">- Position of the point in the timeline, below get_spilled_points().</param>
+size_t OS_Scheduler_Simulator::Engine::Timeline_Spill::find_segment(size_t index) const {
+    auto after = std::upper_bound(this->segments.begin(), this->segments.end(), index, [](size_t index, const stored_segment& segment) { return index < segment.first_point; });
+    return static_cast<size_t>(after - this->segments.begin()) - 1;
+}
+
+/// <summary>
+/// Find the last segment starting at or before a time, or the first segment if they all start after it.
+/// </summary>
+size_t OS_Scheduler_Simulator::Engine::Timeline_Spill::find_segment_at(unsigned time) const {
+    auto after = std::upper_bound(this->segments.begin(), this->segments.end(), time, [](unsigned time, const stored_segment& segment) { return time < segment.first_time; });
+    return (after == this->segments.begin()) ? 0 : static_cast<size_t>(after - this->segments.begin()) - 1;
+}
+
+/// <summary>
+/// Read a spilled segment back, from the cache if it was read recently.
+/// </summary>
+/// <returns>The points of the segment, or nullptr if the file could not be read.</returns>
+std::shared_ptr<const std::vector<OS_Scheduler_Simulator::Engine::Data_Point>> OS_Scheduler_Simulator::Engine::Timeline_Spill::read(size_t segment) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    for (auto it = this->cache.begin(); it != this->cache.end(); it++)
+        if (it->first == segment) {
+            this->cache.splice(this->cache.begin(), this->cache, it);
+            return this->cache.front().second;
+        }
+
+    const stored_segment& stored = this->segments.at(segment);
+
+    // Evict the least recently used pages first, so the page fits with the rest; readers still holding them keep them alive.
+    while (!this->cache.empty() && this->cached_bytes + stored.memory > this->cache_limit) {
+        this->cached_bytes -= this->segments.at(this->cache.back().first).memory;
+        this->cache.pop_back();
+    }
+
+    std::vector<unsigned char> bytes(stored.bytes);
+
+    if (seek(this->file, stored.offset, SEEK_SET) != 0 || std::fread(bytes.data(), 1, bytes.size(), this->file) != bytes.size()) {
+#ifdef _DEBUG
+        std::cerr << "Could not read segment " << segment << " back from the timeline spill file." << std::endl;
+#endif // _DEBUG
+        return nullptr;
+    }
+
+    std::shared_ptr<std::vector<Data_Point>> page = std::make_shared<std::vector<Data_Point>>();
+    page->reserve(stored.points);
+
+    const unsigned char* position = bytes.data();
+    std::list<Running_Process> waiting_list;
+
+    for (size_t i{ 0 }; i < stored.points; i++) {
+        const unsigned time = static_cast<unsigned>(get_varint(position));
+        const Running_Process running = this->decode_process(position);
+
+        if (get_varint(position) != 0) {
+            std::vector<Data_Point::ready_level> ready_levels(static_cast<size_t>(get_varint(position)));
+
+            for (Data_Point::ready_level& level : ready_levels) {
+                level.level = static_cast<unsigned>(get_varint(position));
+                for (unsigned long long n = get_varint(position); n > 0; n--) level.processes.push_back(this->decode_process(position));
+            }
+
+            waiting_list.clear();
+            for (unsigned long long n = get_varint(position); n > 0; n--) waiting_list.push_back(this->decode_process(position));
+
+            page->emplace_back(time, waiting_list, std::move(ready_levels), running);
+        }
+
+        else {
+            const size_t ready_count = static_cast<size_t>(get_varint(position));
+            page->emplace_back(time, static_cast<size_t>(get_varint(position)), ready_count, running);
+        }
+
+        if (get_varint(position) != 0) {
+            Data_Point::ready_changes changes{ .enqueued = std::vector<const Process_Data*>(static_cast<size_t>(get_varint(position))), .dispatched = nullptr };
+            for (const Process_Data*& process : changes.enqueued) process = this->first_process + get_varint(position);
+
+            const unsigned long long dispatched = get_varint(position);
+            if (dispatched > 0) changes.dispatched = this->first_process + (dispatched - 1);
+
+            page->back().set_ready_changes(std::move(changes));
+        }
+
+        if (get_varint(position) != 0) {
+            Data_Point::waiting_changes io_changes{ .completed = {}, .started = {} };
+
+            for (std::vector<const Process_Data*>* processes : { &io_changes.completed, &io_changes.started }) {
+                processes->resize(static_cast<size_t>(get_varint(position)));
+                for (const Process_Data*& process : *processes) process = this->first_process + get_varint(position);
+            }
+
+            page->back().set_waiting_changes(std::move(io_changes));
+        }
+    }
+
+    this->cache.emplace_front(segment, page);
+    this->cached_bytes += stored.memory;
+    this->peak_cached_bytes = std::max(this->peak_cached_bytes, this->cached_bytes);
+    return page;
+}
+
+size_t OS_Scheduler_Simulator::Engine::Timeline_Spill::get_cached_bytes() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->cached_bytes;
+}
+
+size_t OS_Scheduler_Simulator::Engine::Timeline_Spill::get_peak_cached_bytes() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->peak_cached_bytes;
+}
+
+void OS_Scheduler_Simulator::Engine::Timeline_Spill::encode_process(const Running_Process& process) {
+    // 0 for no process, otherwise the index of the process plus one.
+    if (!process.is_valid()) {
+        put_varint(this->buffer, 0);
+        return;
+    }
+
+    put_varint(this->buffer, static_cast<unsigned long long>(process.get_process_data() - this->first_process) + 1);
+    put_varint(this->buffer, static_cast<unsigned long long>(process.get_status()));
+    put_varint(this->buffer, process.get_operation_index());
+    put_varint(this->buffer, process.time_in_operation());
+    put_varint(this->buffer, process.get_level());
+    put_varint(this->buffer, process.get_switch_overhead());
+}
+
+OS_Scheduler_Simulator::Engine::Running_Process OS_Scheduler_Simulator::Engine::Timeline_Spill::decode_process(const unsigned char*& position) const {
+    const unsigned long long index = get_varint(position);
+    if (index == 0) return Running_Process(nullptr);
+
+    const Running_Process::status_type status = static_cast<Running_Process::status_type>(get_varint(position));
+    const size_t operation = static_cast<size_t>(get_varint(position));
+    const unsigned time_in_operation = static_cast<unsigned>(get_varint(position));
+    const unsigned level = static_cast<unsigned>(get_varint(position));
+    const unsigned switch_overhead = static_cast<unsigned>(get_varint(position));
+
+    return Running_Process(this->first_process + (index - 1), status, operation, time_in_operation, level, switch_overhead);
+}
@@ -0,0 +1,81 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_TIMELINE_SPILL_
+#define _OS_SCHEDULER_SIMULATOR_TIMELINE_SPILL_
+
+#include "engine.h"
+
+#include <cstdio>
+#include <vector>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+/// <summary>
+/// Temporary file holding the segments a Timeline spilled to stay within its memory budget.
+///
+/// Points are stored in a compact format: every number is a variable-length integer, and processes are stored as their index in the
+/// vector of processes instead of a pointer, so most points take a few bytes per process. The file is created with std::tmpfile(), so it
+/// is removed when closed, even if the program is killed.
+///
+/// Segments are appended in order, each with the points that were the oldest in memory when it was written, so the points of the file are
+/// always the first points of the timeline. Only one small entry per segment is kept in memory to find them.
+///
+/// Segments read back are kept in a cache shared by every reader, limited in bytes, so the pages count against the budget of the timeline.
+/// Reads are serialized by a mutex, since snapshots are read from many threads; the pages are returned as shared pointers, so they stay
+/// valid for as long as a reader holds them.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Timeline_Spill {
+public:
+	Timeline_Spill(const Process_Data* first_process, size_t cache_bytes);
+	~Timeline_Spill();
+
+	Timeline_Spill(const Timeline_Spill&) = delete;
+	Timeline_Spill& operator=(const Timeline_Spill&) = delete;
+
+	bool is_open() const { return this->file != nullptr; }
+
+	bool write(const std::deque<Data_Point*>& points, size_t count);
+	std::shared_ptr<const std::vector<Data_Point>> read(size_t segment) const;
+
+	size_t find_segment(size_t index) const;
+	size_t find_segment_at(unsigned time) const;
+
+	size_t get_segments() const { return this->segments.size(); }
+	size_t get_first_point(size_t segment) const { return this->segments.at(segment).first_point; }
+	unsigned get_first_time(size_t segment) const { return this->segments.at(segment).first_time; }
+	size_t get_file_bytes() const { return static_cast<size_t>(this->file_bytes); }
+	size_t get_spilled_points() const { return this->spilled_points; }
+
+	size_t get_cached_bytes() const;
+	size_t get_peak_cached_bytes() const;
+
+private:
+	typedef struct {
+		unsigned long long offset;
+		size_t bytes;
+		size_t first_point;             // Position of its first point in the timeline.
+		size_t points;
+		unsigned first_time;
+		size_t memory;                  // Memory the points take once read back.
+	} stored_segment;
+
+	void encode_process(const Running_Process& process);
+	Running_Process decode_process(const unsigned char*& position) const;
+
+	std::FILE* file;
+	const Process_Data* first_process;
+
+	std::vector<stored_segment> segments; // In the order they were written.
+	unsigned long long file_bytes;
+	size_t spilled_points;
+	std::vector<unsigned char> buffer;
+
+	mutable std::mutex mutex;
+	mutable std::list<std::pair<size_t, std::shared_ptr<const std::vector<Data_Point>>>> cache; // Most recently used first.
+	size_t cache_limit;                  // Bytes of the pages cached; the latest page is kept even if it is larger.
+	mutable size_t cached_bytes;
+	mutable size_t peak_cached_bytes;
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include "trace_export.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+
+/// <summary>
+/// Format a timestamp in the shortest form that reads back exactly (streams would switch to 6 significant digits).
+/// </summary>
+static std::string json_number(double value) {
+    char buffer[32];
+    const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return std::string(buffer, result.ptr);
+}
+
+/// <summary>
+/// Trace_Exporter constructor. Nothing is written until the first data point arrives.
+/// </summary>
+/// <param name="output">- Stream receiving the JSON trace. It must outlive the exporter.</param>
+/// <param name="settings">- Time scale and title of the trace.</param>
+OS_Scheduler_Simulator::Engine::Trace_Exporter::Trace_Exporter(std::ostream& output, options settings)
+    : output(output), settings(settings), tracks(), names(), track_of(), next_states(), cpu({ none, 0 }), cpu_owner(0),
+      started(false), finished(false), last_time(0), events_written(0) {}
+
+/// <summary>
+/// Quote and escape a string for JSON output. Control characters, which JSON does not allow in strings, are written as \u00XX. The batch
+/// runner writes its JSON lines with it too.
+/// </summary>
+std::string OS_Scheduler_Simulator::Engine::Trace_Exporter::json_string(const std::string& text) {
+    static const char hex_digits[] = "0123456789abcdef";
+    std::string escaped = "\"";
+
+    for (char c : text) {
+        switch (c) {
+        case '"':  escaped += "\\\""; break;
+        case '\\': escaped += "\\\\"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\t': escaped += "\\t"; break;
+
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                escaped += "\\u00";
+                escaped += hex_digits[static_cast<unsigned char>(c) >> 4];
+                escaped += hex_digits[static_cast<unsigned char>(c) & 0xF];
+            }
+
+            else escaped += c;
+
+            break;
+        }
+    }
+
+    return escaped + "\"";
+}
+
+/// <summary>
+/// Consume the next point of the timeline, writing every interval that ends at it.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Trace_Exporter::add_data_point(const Data_Point& data_point) {
+    if (this->finished) return;
+
+    if (!this->started) {
+        this->output << "{\"traceEvents\":[\n";
+        this->output << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":" << json_string(this->settings.title) << "}}";
+        this->events_written++;
+
+        this->write_thread_name(0, "CPU");
+        this->started = true;
+    }
+
+    const unsigned time = data_point.get_time_since_start();
+
+    // Processes missing from the point are done.
+    std::fill(this->next_states.begin(), this->next_states.end(), track_state::done);
+
+    const Running_Process running = data_point.get_cpu_process();
+    size_t running_track{ 0 };
+
+    if (running.is_valid()) {
+        running_track = this->get_track(running);
+        this->next_states.at(running_track) = track_state::running;
+    }
+
+    for (const Running_Process& process : data_point.get_ready_list())
+        this->next_states.at(this->get_track(process)) = track_state::ready;
+
+    for (const Running_Process& process : data_point.get_waiting_list())
+        this->next_states.at(this->get_track(process)) = track_state::waiting;
+
+    for (size_t i{ 0 }; i < this->tracks.size(); i++)
+        this->set_state(i, this->next_states.at(i), time);
+
+    // CPU track.
+    const bool owner_changed = !running.is_valid() || this->cpu.state != track_state::running || this->cpu_owner != running_track;
+
+    if (owner_changed) {
+        if (this->cpu.state == track_state::running && time > this->cpu.since)
+            this->write_interval(0, this->names.at(this->cpu_owner), this->cpu.since, time);
+
+        this->cpu = { (running.is_valid()) ? track_state::running : track_state::none, time };
+        this->cpu_owner = running_track;
+    }
+
+    this->last_time = time;
+}
+
+/// <summary>
+/// Close the intervals still open and complete the JSON document. Further points are ignored.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Trace_Exporter::finish() {
+    if (this->finished) return;
+
+    if (!this->started) {
+        this->output << "{\"traceEvents\":[\n";
+        this->started = true;
+    }
+
+    for (size_t i{ 0 }; i < this->tracks.size(); i++)
+        this->set_state(i, track_state::done, this->last_time);
+
+    if (this->cpu.state == track_state::running && this->last_time > this->cpu.since)
+        this->write_interval(0, this->names.at(this->cpu_owner), this->cpu.since, this->last_time);
+
+    this->output << "\n]}\n";
+    this->output.flush();
+    this->finished = true;
+}
+
+/// <summary>
+/// Get the track of a process, creating it (and naming its thread in the trace) the first time the process is seen.
+/// </summary>
+size_t OS_Scheduler_Simulator::Engine::Trace_Exporter::get_track(const Running_Process& process) {
+    auto [it, inserted] = this->track_of.try_emplace(process.get_process_data(), this->tracks.size());
+
+    if (inserted) {
+        this->tracks.push_back(track{ track_state::none, 0 });
+        this->names.push_back(process.get_proc_name());
+        this->next_states.push_back(track_state::done);
+
+        this->write_thread_name(static_cast<unsigned>(it->second + 1), this->names.back());
+    }
+
+    return it->second;
+}
+
+void OS_Scheduler_Simulator::Engine::Trace_Exporter::set_state(size_t index, track_state state, unsigned time) {
+    track& current = this->tracks.at(index);
+    if (current.state == state) return;
+
+    if (time > current.since) {
+        switch (current.state) {
+        case track_state::running: this->write_interval(static_cast<unsigned>(index + 1), "Running", current.since, time); break;
+        case track_state::ready:   this->write_interval(static_cast<unsigned>(index + 1), "Ready", current.since, time); break;
+        case track_state::waiting: this->write_interval(static_cast<unsigned>(index + 1), "I/O", current.since, time); break;
+        default: break;
+        }
+    }
+
+    current = { state, time };
+}
+
+void OS_Scheduler_Simulator::Engine::Trace_Exporter::write_interval(unsigned thread_id, const std::string& name, unsigned start, unsigned end) {
+    this->write_separator();
+    this->output << "{\"name\":" << json_string(name) << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread_id
+                 << ",\"ts\":" << json_number(start * this->settings.time_unit_us) << ",\"dur\":" << json_number((end - start) * this->settings.time_unit_us) << "}";
+    this->events_written++;
+}
+
+void OS_Scheduler_Simulator::Engine::Trace_Exporter::write_thread_name(unsigned thread_id, const std::string& name) {
+    this->write_separator();
+    this->output << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread_id << ",\"args\":{\"name\":" << json_string(name) << "}}";
+    this->events_written++;
+}
+
+void OS_Scheduler_Simulator::Engine::Trace_Exporter::write_separator() {
+    if (this->events_written > 0) this->output << ",\n";
+}
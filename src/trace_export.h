@@ -0,0 +1,67 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_TRACE_EXPORT_
+#define _OS_SCHEDULER_SIMULATOR_TRACE_EXPORT_
+
+#include "engine.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ostream>
+
+/// <summary>
+/// Streaming exporter of simulated schedules as Chrome trace-event JSON, which chrome://tracing and the Perfetto UI both open.
+///
+/// Data points are consumed in order (typically as the observer of Simulation::stream_algorithm) and every interval is written as soon as
+/// it ends, so memory depends on the number of processes only. Each process gets a track with its Running, Ready and I/O intervals, and a
+/// separate CPU track shows which process held the CPU.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Trace_Exporter {
+public:
+	typedef struct {
+		double time_unit_us;             // Microseconds represented by one simulation time unit.
+		std::string title;               // Name of the trace process shown by the viewer.
+	} options;
+
+	Trace_Exporter(std::ostream& output, options settings = options{ .time_unit_us = 1, .title = "OS Scheduler Simulator" });
+
+	void add_data_point(const Data_Point& data_point);
+	void finish();
+
+	static std::string json_string(const std::string& text);
+
+	/// <summary>Get the number of trace events written so far.</summary>
+	/// <returns>Number of interval and metadata events.</returns>
+	size_t get_events_written() const { return this->events_written; }
+
+private:
+	typedef enum { none, running, ready, waiting, done } track_state;
+
+	typedef struct {
+		track_state state;
+		unsigned since;                  // Simulation time at which the current state started.
+	} track;
+
+	size_t get_track(const Running_Process& process);
+	void set_state(size_t index, track_state state, unsigned time);
+	void write_interval(unsigned thread_id, const std::string& name, unsigned start, unsigned end);
+	void write_thread_name(unsigned thread_id, const std::string& name);
+	void write_separator();
+
+	std::ostream& output;
+	options settings;
+
+	std::vector<track> tracks;           // In order of first appearance.
+	std::vector<std::string> names;
+	std::unordered_map<const Process_Data*, size_t> track_of;
+	std::vector<track_state> next_states; // Scratch space reused by every point.
+
+	track cpu;
+	size_t cpu_owner;                    // Track of the process on the CPU while cpu.state is running.
+
+	bool started;
+	bool finished;
+	unsigned last_time;
+	size_t events_written;
+};
+
+#endif
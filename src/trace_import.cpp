@@ -0,0 +1,375 @@
+#include "trace_import.h"
+#include "burst_store.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <charconv>
+#include <limits>
+#include <memory>
+#include <algorithm>
+
+#ifdef _DEBUG
+#include <iostream>
+#endif // _DEBUG
+
+// Size of the chunks read from the trace file.
+static constexpr size_t trace_chunk_size = 1 << 20;
+
+/// <summary>
+/// Parse a trace timestamp of the form "seconds.fraction" (optionally followed by ':') into nanoseconds.
+/// </summary>
+/// <param name="token">- Timestamp as it appears in the trace.</param>
+/// <param name="timestamp">- Output in nanoseconds.</param>
+/// <returns>True if the token is a valid timestamp.</returns>
+static bool parse_timestamp(std::string_view token, unsigned long long& timestamp) {
+    if (!token.empty() && token.back() == ':') token.remove_suffix(1);
+
+    const size_t dot = token.find('.');
+    unsigned long long seconds{ 0 };
+    const std::string_view integer_part = token.substr(0, dot);
+
+    if (integer_part.empty() || std::from_chars(integer_part.data(), integer_part.data() + integer_part.size(), seconds).ptr != integer_part.data() + integer_part.size())
+        return false;
+
+    unsigned long long fraction{ 0 };
+    unsigned digits{ 0 };
+
+    if (dot != std::string_view::npos) {
+        for (char c : token.substr(dot + 1)) {
+            if (c < '0' || c > '9') return false;
+            if (digits < 9) {
+                fraction = fraction * 10 + static_cast<unsigned long long>(c - '0');
+                digits++;
+            }
+        }
+    }
+
+    for (; digits < 9; digits++) fraction *= 10;
+
+    timestamp = seconds * 1000000000ULL + fraction;
+    return true;
+}
+
+/// <summary>
+/// Parse the integer that starts at the beginning of text.
+/// </summary>
+static bool parse_int(std::string_view text, int& value) {
+    return !text.empty() && std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc();
+}
+
+/// <summary>
+/// Get the value of a "key=value" field. Values end at the next space unless an explicit terminator (the next key) is given.
+/// </summary>
+static std::string_view field_value(std::string_view payload, std::string_view key, std::string_view next_key = {}) {
+    size_t start = payload.find(key);
+    if (start == std::string_view::npos) return {};
+
+    start += key.size();
+    size_t end = (next_key.empty()) ? payload.find(' ', start) : payload.find(next_key, start);
+    if (end == std::string_view::npos) end = payload.size();
+
+    return payload.substr(start, end - start);
+}
+
+/// <summary>
+/// Parse the "comm:pid [prio]" notation used by older perf versions.
+/// </summary>
+static bool parse_compact_task(std::string_view text, std::string_view& comm, int& pid) {
+    const size_t bracket = text.find(" [");
+    if (bracket != std::string_view::npos) text = text.substr(0, bracket);
+
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+
+    const size_t colon = text.rfind(':');
+    if (colon == std::string_view::npos) return false;
+
+    comm = text.substr(0, colon);
+    return parse_int(text.substr(colon + 1), pid);
+}
+
+/// <summary>
+/// Trace_Importer constructor.
+/// </summary>
+/// <param name="settings">- Conversion options (time unit, minimum burst and burst limit).</param>
+OS_Scheduler_Simulator::Engine::Trace_Importer::Trace_Importer(options settings)
+    : settings(settings), pending(), tasks(), pids(), first_timestamp_set(false), first_timestamp(0), last_timestamp(0), lines_read(0), events_read(0), store() {
+    if (this->settings.time_unit_ns == 0) this->settings.time_unit_ns = 1;
+}
+
+/// <summary>
+/// Import a trace file. The file is read in fixed-size chunks.
+/// </summary>
+/// <param name="path">- Path to an ftrace or perf sched text dump.</param>
+/// <returns>False if the file could not be opened.</returns>
+bool OS_Scheduler_Simulator::Engine::Trace_Importer::import_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+#ifdef _DEBUG
+        std::cerr << "Could not open trace file \"" << path << "\"." << std::endl;
+#endif // _DEBUG
+        return false;
+    }
+
+    this->import_stream(file);
+    return true;
+}
+
+/// <summary>
+/// Import a trace from any input stream until the end of the stream.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Trace_Importer::import_stream(std::istream& stream) {
+    std::vector<char> buffer(trace_chunk_size);
+
+    while (stream) {
+        stream.read(buffer.data(), buffer.size());
+        const std::streamsize read = stream.gcount();
+        if (read <= 0) break;
+
+        this->feed(std::string_view(buffer.data(), static_cast<size_t>(read)));
+    }
+
+    if (!this->pending.empty()) {
+        this->parse_line(this->pending);
+        this->pending.clear();
+    }
+}
+
+/// <summary>
+/// Feed the next piece of a trace. Chunks do not need to end at a line boundary.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Trace_Importer::feed(std::string_view chunk) {
+    size_t start{ 0 };
+
+    // Complete the line left over from the previous chunk.
+    if (!this->pending.empty()) {
+        const size_t newline = chunk.find('\n');
+
+        if (newline == std::string_view::npos) {
+            this->pending.append(chunk);
+            return;
+        }
+
+        this->pending.append(chunk.substr(0, newline));
+        this->parse_line(this->pending);
+        this->pending.clear();
+        start = newline + 1;
+    }
+
+    for (size_t newline = chunk.find('\n', start); newline != std::string_view::npos; newline = chunk.find('\n', start)) {
+        this->parse_line(chunk.substr(start, newline - start));
+        start = newline + 1;
+    }
+
+    this->pending.assign(chunk.substr(start));
+}
+
+void OS_Scheduler_Simulator::Engine::Trace_Importer::parse_line(std::string_view line) {
+    this->lines_read++;
+
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty() || line.front() == '#') return;
+
+    // Find the event. perf prefixes it with the subsystem ("sched:sched_switch:").
+    bool is_switch = true;
+    std::string_view event_name = "sched_switch:";
+    size_t event_pos = line.find(event_name);
+
+    if (event_pos == std::string_view::npos) {
+        is_switch = false;
+        event_name = "sched_wakeup_new:";
+        event_pos = line.find(event_name);
+    }
+
+    if (event_pos == std::string_view::npos) {
+        event_name = "sched_wakeup:";
+        event_pos = line.find(event_name);
+    }
+
+    if (event_pos == std::string_view::npos) return;
+
+    // The timestamp is the token right before the event token.
+    const size_t event_start = line.rfind(' ', event_pos);
+    if (event_start == std::string_view::npos) return;
+
+    const size_t timestamp_end = line.find_last_not_of(' ', event_start);
+    if (timestamp_end == std::string_view::npos) return;
+
+    const size_t timestamp_start = line.rfind(' ', timestamp_end);
+    const std::string_view timestamp_token = (timestamp_start == std::string_view::npos) ? line.substr(0, timestamp_end + 1) : line.substr(timestamp_start + 1, timestamp_end - timestamp_start);
+
+    unsigned long long timestamp{ 0 };
+    if (!parse_timestamp(timestamp_token, timestamp)) return;
+
+    if (!this->first_timestamp_set) {
+        this->first_timestamp = timestamp;
+        this->first_timestamp_set = true;
+    }
+
+    if (timestamp > this->last_timestamp) this->last_timestamp = timestamp;
+
+    std::string_view payload = line.substr(event_pos + event_name.size());
+    while (!payload.empty() && payload.front() == ' ') payload.remove_prefix(1);
+
+    if (is_switch) this->on_switch(payload, timestamp);
+    else this->on_wakeup(payload, timestamp);
+}
+
+void OS_Scheduler_Simulator::Engine::Trace_Importer::on_switch(std::string_view payload, unsigned long long timestamp) {
+    std::string_view prev_comm, prev_state, next_comm;
+    int prev_pid{ 0 }, next_pid{ 0 };
+
+    if (payload.find("prev_pid=") != std::string_view::npos) {
+        // ftrace and current perf: "prev_comm=a prev_pid=1 prev_prio=120 prev_state=S ==> next_comm=b next_pid=2 next_prio=120"
+        prev_comm = field_value(payload, "prev_comm=", " prev_pid=");
+        prev_state = field_value(payload, "prev_state=");
+        next_comm = field_value(payload, "next_comm=", " next_pid=");
+
+        if (!parse_int(field_value(payload, "prev_pid="), prev_pid) || !parse_int(field_value(payload, "next_pid="), next_pid)) return;
+    }
+
+    else {
+        // Older perf: "a:1 [120] S ==> b:2 [120]"
+        const size_t arrow = payload.find("==>");
+        if (arrow == std::string_view::npos) return;
+
+        std::string_view left = payload.substr(0, arrow);
+        while (!left.empty() && left.back() == ' ') left.remove_suffix(1);
+
+        const size_t state_pos = left.rfind(' ');
+        if (state_pos == std::string_view::npos) return;
+        prev_state = left.substr(state_pos + 1);
+
+        if (!parse_compact_task(left, prev_comm, prev_pid) || !parse_compact_task(payload.substr(arrow + 3), next_comm, next_pid)) return;
+    }
+
+    this->events_read++;
+
+    // PID 0 is the idle task; idle time is not part of any process.
+    if (prev_pid != 0) {
+        task& prev = this->get_task(prev_pid, prev_comm, timestamp, true);
+        task_state state = task_state::blocked;
+
+        if (!prev_state.empty() && prev_state.front() == 'R') state = task_state::runnable; // Preempted, still wants the CPU.
+        else if (!prev_state.empty() && (prev_state.front() == 'X' || prev_state.front() == 'Z')) state = task_state::exited;
+
+        this->transition(prev, state, timestamp);
+    }
+
+    if (next_pid != 0)
+        this->transition(this->get_task(next_pid, next_comm, timestamp, false), task_state::runnable, timestamp);
+}
+
+void OS_Scheduler_Simulator::Engine::Trace_Importer::on_wakeup(std::string_view payload, unsigned long long timestamp) {
+    std::string_view comm;
+    int pid{ 0 };
+
+    if (payload.find("comm=") != std::string_view::npos) {
+        // "comm=a pid=1 prio=120 target_cpu=000"
+        comm = field_value(payload, "comm=", " pid=");
+        if (!parse_int(field_value(payload, " pid="), pid)) return;
+    }
+
+    else if (!parse_compact_task(payload, comm, pid)) return; // "a:1 [120] success=1 CPU:000"
+
+    this->events_read++;
+
+    if (pid != 0)
+        this->transition(this->get_task(pid, comm, timestamp, false), task_state::runnable, timestamp);
+}
+
+/// <summary>
+/// Find the task for a PID, creating it if it was not seen before (or if the previous task with that PID exited).
+/// </summary>
+/// <param name="already_running">- True if the task is first seen leaving the CPU, so it has been runnable since the start of the trace (or
+/// since the event, if its PID was used before).</param>
+OS_Scheduler_Simulator::Engine::Trace_Importer::task& OS_Scheduler_Simulator::Engine::Trace_Importer::get_task(int pid, std::string_view comm, unsigned long long timestamp, bool already_running) {
+    auto it = this->pids.find(pid);
+
+    if (it != this->pids.end() && this->tasks.at(it->second).state != task_state::exited)
+        return this->tasks.at(it->second);
+
+    // A reused PID was held by another task until it exited, so its new task cannot have been running since the start of the trace.
+    const unsigned long long since = (already_running && it == this->pids.end()) ? this->first_timestamp : timestamp;
+
+    this->tasks.push_back(task{
+        .name = std::string(comm) + "-" + std::to_string(pid),
+        .state = task_state::runnable,
+        .since = since,
+        .arrival = since,
+        .bursts = {}
+    });
+
+    this->pids[pid] = this->tasks.size() - 1;
+    return this->tasks.back();
+}
+
+/// <summary>
+/// Move a task to a new state, closing the burst of the state it leaves.
+/// </summary>
+void OS_Scheduler_Simulator::Engine::Trace_Importer::transition(task& t, task_state state, unsigned long long timestamp) {
+    if (t.state == state || t.state == task_state::exited || t.state == task_state::truncated) return;
+
+    // Events of different CPUs may be slightly out of order, so a state can seem to end before it started.
+    const unsigned long long elapsed = (timestamp > t.since) ? timestamp - t.since : 0;
+
+    if (t.state == task_state::runnable)
+        t.bursts.push_back(this->to_burst(elapsed));
+
+    else if (t.state == task_state::blocked && state == task_state::runnable)
+        t.bursts.push_back(this->to_burst(elapsed));
+
+    // A task that exits while blocked keeps its last CPU burst as the final operation.
+    t.state = state;
+    t.since = timestamp;
+
+    if (this->settings.max_bursts_per_process != 0 && t.bursts.size() >= this->settings.max_bursts_per_process && t.bursts.size() % 2 == 1)
+        t.state = task_state::truncated;
+}
+
+unsigned OS_Scheduler_Simulator::Engine::Trace_Importer::to_burst(unsigned long long duration) const {
+    unsigned long long units = (duration + this->settings.time_unit_ns / 2) / this->settings.time_unit_ns;
+
+    if (units < this->settings.min_burst) units = this->settings.min_burst;
+    if (units > std::numeric_limits<unsigned>::max()) units = std::numeric_limits<unsigned>::max();
+
+    return static_cast<unsigned>(units);
+}
+
+/// <summary>
+/// Build the workload from everything imported so far. Tasks still runnable at the end of the trace get a final CPU burst up to the last
+/// timestamp, and tasks still blocked drop their trailing I/O (processes always end with a CPU burst). Tasks first seen after the start of
+/// the trace arrive then.
+/// </summary>
+/// <returns>One process per task, in order of first appearance.</returns>
+std::vector<OS_Scheduler_Simulator::Engine::Process_Data> OS_Scheduler_Simulator::Engine::Trace_Importer::get_processes() {
+    if (!this->pending.empty()) {
+        this->parse_line(this->pending);
+        this->pending.clear();
+    }
+
+    std::vector<Process_Data> processes;
+    processes.reserve(this->tasks.size());
+
+    this->store = (this->settings.pack_bursts) ? std::make_shared<Burst_Store>() : nullptr;
+
+    for (const task& t : this->tasks) {
+        std::vector<unsigned> bursts = t.bursts;
+
+        if (t.state == task_state::runnable) bursts.push_back(this->to_burst((this->last_timestamp > t.since) ? this->last_timestamp - t.since : 0));
+        if (bursts.empty()) bursts.push_back(this->to_burst(0));
+
+        if (this->store != nullptr) processes.push_back(Process_Data(t.name, this->store.get(), this->store->append(bursts), bursts.size()));
+        else processes.push_back(Process_Data(t.name, bursts));
+
+        // Rounded like the bursts, but a task arriving within half a unit of the start arrives with it.
+        const unsigned long long arrival = (t.arrival > this->first_timestamp) ? (t.arrival - this->first_timestamp + this->settings.time_unit_ns / 2) / this->settings.time_unit_ns : 0;
+        if (arrival > 0) processes.back().set_arrival(static_cast<unsigned>(std::min<unsigned long long>(arrival, std::numeric_limits<unsigned>::max())));
+    }
+
+    if (this->store != nullptr) this->store->shrink_to_fit();
+
+    return processes;
+}
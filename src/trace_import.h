@@ -0,0 +1,84 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_TRACE_IMPORT_
+#define _OS_SCHEDULER_SIMULATOR_TRACE_IMPORT_
+
+#include "engine.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <istream>
+
+/// <summary>
+/// Streaming importer of Linux scheduling traces (ftrace "trace" files and "perf sched script" dumps).
+///
+/// Only sched_switch and sched_wakeup/sched_wakeup_new events are used. For every task, the time between being woken up (or first seen) and
+/// being switched out in a sleeping state becomes a CPU burst (runnable and running time both count), and the time spent sleeping becomes an I/O burst.
+/// Tasks that appear after the start of the trace arrive at their first event (see Process_Data::set_arrival).
+/// The input is consumed in fixed-size chunks, so memory use depends on the number of tasks and bursts, not on the size of the trace file.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Trace_Importer {
+public:
+	typedef struct {
+		unsigned long long time_unit_ns; // Nanoseconds represented by one simulation time unit.
+		unsigned min_burst;              // Shorter bursts are rounded up to this value (the engine does not support empty bursts).
+		size_t max_bursts_per_process;   // Stop recording a task after this many bursts (0 for no limit).
+		bool pack_bursts;                // Give the processes a shared Burst_Store instead of a vector of bursts each (see get_burst_store).
+	} options;
+
+	Trace_Importer(options settings = options{ .time_unit_ns = 1000, .min_burst = 1, .max_bursts_per_process = 0, .pack_bursts = false });
+
+	bool import_file(const std::string& path);
+	void import_stream(std::istream& stream);
+	void feed(std::string_view chunk);
+
+	std::vector<Process_Data> get_processes();
+
+	/// <summary>Get the store the processes of the last get_processes read their bursts from, with pack_bursts. It must be kept while the
+	/// processes or their copies are used; the importer keeps it until get_processes is called again.</summary>
+	std::shared_ptr<const Burst_Store> get_burst_store() const { return this->store; }
+
+	/// <summary>Get the number of lines consumed so far.</summary>
+	/// <returns>Number of lines read from the input.</returns>
+	size_t get_lines_read() const { return this->lines_read; }
+
+	/// <summary>Get the number of scheduling events used to build the workload.</summary>
+	/// <returns>Number of sched_switch and sched_wakeup events parsed.</returns>
+	size_t get_events_read() const { return this->events_read; }
+
+private:
+	typedef enum { runnable, blocked, exited, truncated } task_state;
+
+	typedef struct {
+		std::string name;
+		task_state state;
+		unsigned long long since;        // Timestamp (ns) at which the current state started.
+		unsigned long long arrival;      // Timestamp (ns) of the first event of the task, or of the trace if it was running then.
+		std::vector<unsigned> bursts;
+	} task;
+
+	void parse_line(std::string_view line);
+	void on_switch(std::string_view payload, unsigned long long timestamp);
+	void on_wakeup(std::string_view payload, unsigned long long timestamp);
+
+	task& get_task(int pid, std::string_view comm, unsigned long long timestamp, bool already_running);
+	void transition(task& t, task_state state, unsigned long long timestamp);
+	unsigned to_burst(unsigned long long duration) const;
+
+	options settings;
+	std::string pending;                 // Incomplete line carried between chunks.
+
+	std::vector<task> tasks;             // In order of first appearance.
+	std::unordered_map<int, size_t> pids;
+
+	bool first_timestamp_set;
+	unsigned long long first_timestamp;
+	unsigned long long last_timestamp;
+
+	size_t lines_read;
+	size_t events_read;
+
+	std::shared_ptr<Burst_Store> store;  // nullptr without pack_bursts.
+};
+
+#endif
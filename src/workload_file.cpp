@@ -0,0 +1,342 @@
+#include "workload_file.h"
+#include "trace_import.h"
+#include "io_device.h"
+#include "process_group.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+
+/// <summary>
+/// Load a workload file, detecting whether it is a workload text file or a scheduling trace.
+/// </summary>
+/// <param name="path">- Path to the file.</param>
+/// <param name="processes">- Loaded processes are appended here.</param>
+/// <param name="error">- Optional description of the problem if loading fails.</param>
+/// <param name="store">- Optional; receives the Burst_Store the bursts of a trace are packed in, which must be kept while the processes are
+/// used. Without it, the bursts of traces are not packed.</param>
+/// <returns>True if the workload was loaded.</returns>
+bool OS_Scheduler_Simulator::Engine::Workload_File::load(const std::string& path, std::vector<Process_Data>& processes, std::string* error, std::shared_ptr<const Burst_Store>* store) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        if (error != nullptr) *error = "could not open \"" + path + "\"";
+        return false;
+    }
+
+    // Traces are recognized by their events in the first few kilobytes.
+    std::string head(4096, '\0');
+    file.read(head.data(), head.size());
+    head.resize(static_cast<size_t>(file.gcount()));
+
+    file.clear();
+    file.seekg(0);
+
+    if (head.find("sched_switch:") != std::string::npos || head.find("sched_wakeup:") != std::string::npos) {
+        // Traces can have many tasks, so their bursts are packed when the caller can keep the store.
+        Trace_Importer importer(Trace_Importer::options{ .time_unit_ns = 1000, .min_burst = 1, .max_bursts_per_process = 0, .pack_bursts = store != nullptr });
+        importer.import_stream(file);
+
+        std::vector<Process_Data> imported = importer.get_processes();
+        processes.insert(processes.end(), std::make_move_iterator(imported.begin()), std::make_move_iterator(imported.end()));
+
+        if (store != nullptr) *store = importer.get_burst_store();
+        return true;
+    }
+
+    return parse(file, processes, error);
+}
+
+/// <summary>
+/// Parse a workload in the text format.
+/// </summary>
+/// <param name="stream">- Input with one process per line.</param>
+/// <param name="processes">- Parsed processes are appended here.</param>
+/// <param name="error">- Optional description of the first invalid line.</param>
+/// <returns>True if every line was valid.</returns>
+bool OS_Scheduler_Simulator::Engine::Workload_File::parse(std::istream& stream, std::vector<Process_Data>& processes, std::string* error) {
+    std::string line;
+    unsigned line_number{ 0 };
+    std::map<std::string, std::shared_ptr<const IO_Device>> devices;
+    std::map<std::string, std::shared_ptr<const Process_Group>> groups;
+    std::map<std::string, unsigned> barriers;
+    std::map<std::string, unsigned> process_indices; // Latest process with every name.
+
+    // Barrier ids continue after the ones of the processes already loaded.
+    unsigned last_barrier{ 0 };
+
+    for (const Process_Data& process : processes) {
+        last_barrier = std::max(last_barrier, process.get_barrier());
+        for (unsigned barrier : process.get_awaited_barriers()) last_barrier = std::max(last_barrier, barrier);
+    }
+
+    while (std::getline(stream, line)) {
+        line_number++;
+
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.resize(comment);
+
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) continue; // Blank line.
+
+        // "@device name [channels=N]" declares an I/O device for the processes after it.
+        if (name == "@device") {
+            std::string device_name, field;
+            unsigned long channels{ 1 };
+
+            if (!(fields >> device_name)) {
+                if (error != nullptr) *error = "line " + std::to_string(line_number) + ": device without a name";
+                return false;
+            }
+
+            while (fields >> field) {
+                size_t parsed{ 0 };
+
+                if (field.rfind("channels=", 0) == 0) {
+                    try { channels = std::stoul(field.substr(9), &parsed); }
+                    catch (...) { parsed = 0; }
+                }
+
+                if (parsed == 0 || parsed != field.size() - 9 || channels == 0) {
+                    if (error != nullptr) *error = "line " + std::to_string(line_number) + ": invalid device option \"" + field + "\"";
+                    return false;
+                }
+            }
+
+            devices[device_name] = std::make_shared<const IO_Device>(device_name, static_cast<unsigned>(channels));
+            continue;
+        }
+
+        // "@group name [parent=P] [weight=N] [quota=N] [period=N]" declares a group for the groups and processes after it.
+        if (name == "@group") {
+            std::string group_name, field;
+            std::shared_ptr<const Process_Group> parent;
+            std::map<std::string, unsigned long> options{ { "weight", 1024 }, { "quota", 0 }, { "period", 100 } };
+
+            if (!(fields >> group_name)) {
+                if (error != nullptr) *error = "line " + std::to_string(line_number) + ": group without a name";
+                return false;
+            }
+
+            while (fields >> field) {
+                const size_t equals = field.find('=');
+                const std::string key = field.substr(0, equals);
+
+                if (equals != std::string::npos && key == "parent") {
+                    auto it = groups.find(field.substr(equals + 1));
+
+                    if (it == groups.end()) {
+                        if (error != nullptr) *error = "line " + std::to_string(line_number) + ": unknown group \"" + field.substr(equals + 1) + "\"";
+                        return false;
+                    }
+
+                    parent = it->second;
+                    continue;
+                }
+
+                size_t parsed{ 0 };
+                auto option = options.find(key);
+
+                if (equals != std::string::npos && option != options.end()) {
+                    try { option->second = std::stoul(field.substr(equals + 1), &parsed); }
+                    catch (...) { parsed = 0; }
+                }
+
+                if (parsed == 0 || parsed != field.size() - equals - 1 || (key != "quota" && option->second == 0)) {
+                    if (error != nullptr) *error = "line " + std::to_string(line_number) + ": invalid group option \"" + field + "\"";
+                    return false;
+                }
+            }
+
+            groups[group_name] = std::make_shared<const Process_Group>(group_name, parent, static_cast<unsigned>(options.at("weight")),
+                static_cast<unsigned>(options.at("quota")), static_cast<unsigned>(options.at("period")));
+            continue;
+        }
+
+        // "@barrier name" declares a barrier, for the processes after it to join or wait for.
+        if (name == "@barrier") {
+            std::string barrier_name, field;
+
+            if (!(fields >> barrier_name)) {
+                if (error != nullptr) *error = "line " + std::to_string(line_number) + ": barrier without a name";
+                return false;
+            }
+
+            if (fields >> field) {
+                if (error != nullptr) *error = "line " + std::to_string(line_number) + ": invalid barrier option \"" + field + "\"";
+                return false;
+            }
+
+            barriers[barrier_name] = ++last_barrier;
+            continue;
+        }
+
+        std::vector<unsigned> bursts;
+        int nice{ 0 };
+        std::shared_ptr<const IO_Device> device;
+        std::shared_ptr<const Process_Group> group;
+        std::vector<unsigned> deadlines;
+        unsigned long period{ 0 };
+        unsigned long arrival{ 0 };
+        unsigned barrier{ 0 };
+        std::vector<unsigned> predecessors;
+        std::vector<unsigned> awaited_barriers;
+        std::string field;
+
+        while (fields >> field) {
+            if (field.rfind("nice=", 0) == 0) {
+                nice = std::stoi(field.substr(5));
+                continue;
+            }
+
+            if (field.rfind("device=", 0) == 0) {
+                auto it = devices.find(field.substr(7));
+
+                if (it == devices.end()) {
+                    if (error != nullptr) *error = "line " + std::to_string(line_number) + ": unknown device \"" + field.substr(7) + "\"";
+                    return false;
+                }
+
+                device = it->second;
+                continue;
+            }
+
+            if (field.rfind("group=", 0) == 0) {
+                auto it = groups.find(field.substr(6));
+
+                if (it == groups.end()) {
+                    if (error != nullptr) *error = "line " + std::to_string(line_number) + ": unknown group \"" + field.substr(6) + "\"";
+                    return false;
+                }
+
+                group = it->second;
+                continue;
+            }
+
+            // "deadline=N" for every CPU burst, or "deadline=N,M,..." for each CPU burst in order (the last one repeats).
+            if (field.rfind("deadline=", 0) == 0) {
+                std::istringstream values(field.substr(9));
+                std::string value;
+
+                while (std::getline(values, value, ',')) {
+                    size_t parsed{ 0 };
+                    unsigned long deadline{ 0 };
+
+                    try { deadline = std::stoul(value, &parsed); }
+                    catch (...) { parsed = 0; }
+
+                    if (parsed == 0 || parsed != value.size()) {
+                        if (error != nullptr) *error = "line " + std::to_string(line_number) + ": invalid deadline \"" + field + "\"";
+                        return false;
+                    }
+
+                    deadlines.push_back(static_cast<unsigned>(deadline));
+                }
+
+                continue;
+            }
+
+            if (field.rfind("barrier=", 0) == 0) {
+                auto it = barriers.find(field.substr(8));
+
+                if (it == barriers.end()) {
+                    if (error != nullptr) *error = "line " + std::to_string(line_number) + ": unknown barrier \"" + field.substr(8) + "\"";
+                    return false;
+                }
+
+                barrier = it->second;
+                continue;
+            }
+
+            // "after=A,B,..." waits for earlier processes (the latest one with each name) or for barriers.
+            if (field.rfind("after=", 0) == 0) {
+                std::istringstream values(field.substr(6));
+                std::string value;
+
+                while (std::getline(values, value, ',')) {
+                    auto barrier_it = barriers.find(value);
+                    auto process_it = process_indices.find(value);
+
+                    if (barrier_it != barriers.end()) awaited_barriers.push_back(barrier_it->second);
+                    else if (process_it != process_indices.end()) predecessors.push_back(process_it->second);
+
+                    else {
+                        if (error != nullptr) *error = "line " + std::to_string(line_number) + ": unknown process or barrier \"" + value + "\"";
+                        return false;
+                    }
+                }
+
+                continue;
+            }
+
+            if (field.rfind("arrival=", 0) == 0) {
+                size_t parsed{ 0 };
+
+                try { arrival = std::stoul(field.substr(8), &parsed); }
+                catch (...) { parsed = 0; }
+
+                if (parsed == 0 || parsed != field.size() - 8 || arrival > std::numeric_limits<unsigned>::max()) {
+                    if (error != nullptr) *error = "line " + std::to_string(line_number) + ": invalid arrival \"" + field + "\"";
+                    return false;
+                }
+
+                continue;
+            }
+
+            if (field.rfind("period=", 0) == 0) {
+                size_t parsed{ 0 };
+
+                try { period = std::stoul(field.substr(7), &parsed); }
+                catch (...) { parsed = 0; }
+
+                if (parsed == 0 || parsed != field.size() - 7) {
+                    if (error != nullptr) *error = "line " + std::to_string(line_number) + ": invalid period \"" + field + "\"";
+                    return false;
+                }
+
+                continue;
+            }
+
+            size_t parsed{ 0 };
+            unsigned long burst{ 0 };
+
+            try { burst = std::stoul(field, &parsed); }
+            catch (...) { parsed = 0; }
+
+            if (parsed != field.size() || burst == 0) {
+                if (error != nullptr) *error = "line " + std::to_string(line_number) + ": invalid burst \"" + field + "\"";
+                return false;
+            }
+
+            bursts.push_back(static_cast<unsigned>(burst));
+        }
+
+        // Processes start and end with a CPU burst.
+        if (bursts.size() % 2 == 0) {
+            if (error != nullptr) *error = "line " + std::to_string(line_number) + ": process \"" + name + "\" needs an odd number of bursts";
+            return false;
+        }
+
+        processes.push_back(Process_Data(name, bursts));
+        processes.back().set_nice(nice);
+
+        // The other settings are only set when given, so processes without them do not allocate room for them.
+        if (device != nullptr) processes.back().set_io_device(device);
+        if (group != nullptr) processes.back().set_group(group);
+        if (!deadlines.empty()) processes.back().set_deadlines(deadlines);
+        if (period > 0) processes.back().set_period(static_cast<unsigned>(period));
+        if (arrival > 0) processes.back().set_arrival(static_cast<unsigned>(arrival));
+        if (barrier != 0) processes.back().set_barrier(barrier);
+        if (!predecessors.empty()) processes.back().set_predecessors(predecessors);
+        if (!awaited_barriers.empty()) processes.back().set_awaited_barriers(awaited_barriers);
+        process_indices[name] = static_cast<unsigned>(processes.size() - 1);
+    }
+
+    return true;
+}
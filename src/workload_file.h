@@ -0,0 +1,29 @@
+#ifndef _OS_SCHEDULER_SIMULATOR_WORKLOAD_FILE_
+#define _OS_SCHEDULER_SIMULATOR_WORKLOAD_FILE_
+
+#include "engine.h"
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <memory>
+
+/// <summary>
+/// Loader for workload files. Two formats are accepted:
+///
+/// - Workload text: one process per line, "name [nice=N] [arrival=N] [device=D] [group=G] [deadline=N[,N...]] [period=N] [after=A[,B...]] [barrier=B] burst burst ...", with '#'
+///   starting a comment. I/O devices are declared before the processes that use them with "@device D [channels=N]"; processes without a
+///   device do their I/O in parallel. Groups are declared the same way with "@group G [parent=P] [weight=N] [quota=N] [period=N]" (the
+///   period defaults to 100; see Process_Group). Deadlines are relative to the time each CPU burst becomes ready (see Process_Data::get_deadline).
+///   "after=A[,B...]" makes a process wait until earlier processes (the latest one with each name) and barriers are done, and "barrier=B"
+///   makes it a member of a barrier declared before with "@barrier B" (see Dependency_Graph). "arrival=N" submits the process at time N
+///   instead of at the start.
+/// - Linux scheduling traces (ftrace or perf sched dumps), detected by their sched_switch events and read with the Trace_Importer.
+/// </summary>
+class OS_Scheduler_Simulator::Engine::Workload_File {
+public:
+	static bool load(const std::string& path, std::vector<Process_Data>& processes, std::string* error = nullptr, std::shared_ptr<const Burst_Store>* store = nullptr);
+	static bool parse(std::istream& stream, std::vector<Process_Data>& processes, std::string* error = nullptr);
+};
+
+#endif